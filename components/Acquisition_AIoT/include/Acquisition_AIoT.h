@@ -0,0 +1,77 @@
+#ifndef ACQUISITION_AIOT_H
+#define ACQUISITION_AIOT_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "SampleRing_AIoT.h"
+#include "BusScheduler_AIoT.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Enlace con los nodos de sensores (ajustar según cableado) ---
+#define ACQ_UART_NUM            1
+#define ACQ_UART_TX_PIN         17
+#define ACQ_UART_RX_PIN         18
+#define ACQ_UART_BAUD           921600
+
+// --- Tarea de adquisición ---
+#define ACQ_TASK_CORE           1       // Núcleo 1: lejos de LVGL y WiFi
+#define ACQ_TASK_PRIO           20
+#define ACQ_TASK_STACK          4096
+#define ACQ_SAMPLE_PERIOD_US    1000    // 1 kHz por canal
+#define ACQ_RING_BLOCKS         64      // ~135 KiB en PSRAM
+
+// --- Sondeo multi-nodo (solo si se registran nodos con Acquisition_AIoT_Add_Node) ---
+#define ACQ_BUS_MAX_IN_FLIGHT   2       // TX y RX separadas: el siguiente sondeo sale con la respuesta anterior en la línea
+#define ACQ_NODE_TIMEOUT_US     5000    // Respuesta del nodo, sin contar la transmisión de la trama
+#define ACQ_NODE_RETRIES        2
+
+/**
+ * @brief Contadores de la tarea de adquisición
+ */
+typedef struct {
+    uint32_t frames;            // Tramas válidas recibidas
+    uint32_t blocks;            // Bloques publicados en el anillo
+    uint32_t ring_overruns;     // Bloques perdidos porque el anillo estaba lleno (SampleRing_stats_t.overruns)
+    uint32_t crc_errors;
+    uint32_t seq_lost_frames;
+    uint32_t stale_responses;   // Respuestas de sondeo sin petición pendiente con su secuencia
+} Acquisition_stats_t;
+
+/**
+ * @brief Registra un nodo para sondeo (llamar antes de Acquisition_AIoT_Start)
+ *
+ * Sin nodos registrados la tarea trabaja en modo streaming: los nodos envían
+ * tramas por su cuenta. Con nodos, la tarea los sondea con el planificador.
+ */
+esp_err_t Acquisition_AIoT_Add_Node(uint8_t address, uint32_t period_us);
+
+/**
+ * @brief Arranca la tarea de adquisición (UART -> tramas -> anillo de bloques)
+ * @param ring Anillo destino; la tarea es su único productor
+ */
+esp_err_t Acquisition_AIoT_Start(SampleRing_t *ring);
+
+/**
+ * @brief Copia los contadores de adquisición
+ */
+void Acquisition_AIoT_Get_Stats(Acquisition_stats_t *stats);
+
+/**
+ * @brief Estadísticas de sondeo del nodo 'index' (latencias p50/p90/p99)
+ * @return false si no existe ese nodo
+ */
+bool Acquisition_AIoT_Get_Node_Stats(int index, BusSched_node_stats_t *stats);
+
+/**
+ * @brief Ocupación del bus en por mil (solo en modo sondeo)
+ */
+uint32_t Acquisition_AIoT_Get_Bus_Utilisation(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ACQUISITION_AIOT_H
@@ -0,0 +1,172 @@
+#include "Acquisition_AIoT.h"
+#include "UARTn_AIoT.h"
+#include "SensorFrame_AIoT.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "TaskMonitor_AIoT.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "Acquisition";
+
+static SampleRing_t *s_ring = NULL;
+static UARTn_handle_t s_uart = NULL;
+static SensorFrame_decoder_t s_decoder;     // ~2.5 KiB: estático, fuera de la pila
+static Acquisition_stats_t s_stats;
+static BusSched_t s_bus;                    // Planificador de sondeo (modo multi-nodo)
+static bool s_bus_ready = false;
+
+// Desintercala la trama (s0[ch_a, ch_b...], s1[...]) en arreglos por canal
+static void frame_to_block(const SensorFrame_view_t *view, SampleRing_block_t *block, int64_t now_us) {
+    uint8_t channels[SRING_CHANNELS];
+    uint8_t k = 0;
+    for (uint8_t ch = 0; ch < SRING_CHANNELS; ch++) {
+        if (view->channel_mask & (1u << ch)) channels[k++] = ch;
+    }
+
+    uint8_t count = view->samples_per_channel;
+    if (count > SRING_BLOCK_SAMPLES) count = SRING_BLOCK_SAMPLES;
+
+    size_t idx = 0;
+    for (uint8_t s = 0; s < count; s++) {
+        for (uint8_t j = 0; j < k; j++) {
+            block->data[channels[j]][s] = SensorFrame_sample(view, idx++);
+        }
+    }
+
+    block->node = view->node;
+    block->channel_mask = view->channel_mask;
+    block->count = count;
+    block->node_time_us = view->node_time_us;
+    block->sample_period_us = ACQ_SAMPLE_PERIOD_US;
+    // La trama llega completa al final de su última muestra
+    block->timestamp_us = now_us - (int64_t)count * ACQ_SAMPLE_PERIOD_US;
+}
+
+// Envía todas las peticiones que el planificador libere ahora (pipeline)
+static void bus_dispatch(int64_t now) {
+    uint8_t request[SFRAME_POLL_LEN];
+    uint8_t address;
+    uint16_t seq;
+
+    BusSched_check_timeouts(&s_bus, now);
+    while (BusSched_next_request(&s_bus, now, &address, &seq)) {
+        size_t len = SensorFrame_encode_poll(request, sizeof(request), address, seq, SFRAME_MAX_SAMPLES);
+        if (UARTn_write_async(s_uart, request, len, NULL, NULL) == ESP_OK) {
+            BusSched_on_sent(&s_bus, len);
+        }
+    }
+}
+
+static void acquisition_task(void *arg) {
+    SensorFrame_view_t view;
+    int mon_id = TaskMon_register("acq", 0);
+
+    for (;;) {
+        TaskMon_begin(mon_id);
+        if (s_bus.node_count) bus_dispatch(esp_timer_get_time());
+
+        if (SensorFrame_poll(&s_decoder, s_uart, &view)) {
+            int64_t now = esp_timer_get_time();
+            s_stats.frames++;
+
+            if (s_bus.node_count) {
+                uint8_t fill_q8 = (uint8_t)((view.samples_per_channel * 255u) / SFRAME_MAX_SAMPLES);
+                // Una respuesta tardía (secuencia de un intento ya vencido) no cierra la
+                // petición pendiente; sus muestras son válidas y se publican igual
+                if (!BusSched_on_response(&s_bus, view.node, view.seq, view.frame_len, fill_q8, now)) {
+                    s_stats.stale_responses++;
+                }
+            }
+
+            // Con el anillo lleno SampleRing_acquire cuenta el overrun
+            SampleRing_block_t *block = SampleRing_acquire(s_ring);
+            if (block) {
+                frame_to_block(&view, block, now);
+                SampleRing_commit(s_ring);
+                s_stats.blocks++;
+            }
+            continue;
+        }
+
+        // Sin trama completa: dormir hasta que llegue un byte más o toque sondear
+        uint32_t wait_ms = 100;
+        if (s_bus.node_count) {
+            uint32_t next_us = BusSched_time_to_next_event(&s_bus, esp_timer_get_time());
+            if (next_us / 1000 < wait_ms) wait_ms = next_us / 1000 + 1;
+        }
+        TaskMon_end(mon_id);
+        UARTn_wait_rx(s_uart, UARTn_available(s_uart) + 1, wait_ms);
+    }
+}
+
+esp_err_t Acquisition_AIoT_Add_Node(uint8_t address, uint32_t period_us) {
+    if (s_uart) return ESP_ERR_INVALID_STATE;   // El planificador es de la tarea una vez arrancada
+    if (!s_bus_ready) {
+        BusSched_config_t cfg = { .max_in_flight = ACQ_BUS_MAX_IN_FLIGHT, .baud_rate = ACQ_UART_BAUD };
+        BusSched_init(&s_bus, &cfg, esp_timer_get_time());
+        s_bus_ready = true;
+    }
+    // La latencia se mide hasta el último byte: una trama máxima tarda ~22 ms a 921600 baud,
+    // y con varias peticiones en vuelo la respuesta puede esperar detrás de las demás
+    uint32_t timeout_us = ACQ_NODE_TIMEOUT_US + ACQ_BUS_MAX_IN_FLIGHT *
+                          (uint32_t)((uint64_t)SFRAME_MAX_FRAME_LEN * 10 * 1000000 / ACQ_UART_BAUD);
+    return (BusSched_add_node(&s_bus, address, period_us, timeout_us, ACQ_NODE_RETRIES) >= 0)
+           ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t Acquisition_AIoT_Start(SampleRing_t *ring) {
+    if (!ring) return ESP_ERR_INVALID_ARG;
+    if (s_uart) return ESP_ERR_INVALID_STATE;
+
+    UARTn_config_t cfg = UARTN_CONFIG_DEFAULT(ACQ_UART_NUM, ACQ_UART_TX_PIN, ACQ_UART_RX_PIN, ACQ_UART_BAUD);
+    cfg.rx_buffer_size = 8192;
+    cfg.rx_ring_size = 8192;
+    cfg.rx_full_threshold = 96;     // Menos interrupciones a 921600 baud
+    cfg.tx_ring_size = 256;         // Peticiones de sondeo con UARTn_write_async
+    cfg.task_core = ACQ_TASK_CORE;
+
+    s_uart = UARTn_create_with_config(&cfg);
+    if (!s_uart) return ESP_ERR_NO_MEM;
+
+    esp_err_t err = UARTn_init(s_uart);
+    if (err != ESP_OK) {
+        UARTn_destroy(s_uart);
+        s_uart = NULL;
+        return err;
+    }
+
+    s_ring = ring;
+    SensorFrame_decoder_init(&s_decoder);
+
+    if (xTaskCreatePinnedToCore(acquisition_task, "acq", ACQ_TASK_STACK, NULL,
+                                ACQ_TASK_PRIO, NULL, ACQ_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "No se pudo crear la tarea de adquisición");
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Adquisición activa en núcleo %d (UART%d @ %d baud)", ACQ_TASK_CORE, ACQ_UART_NUM, ACQ_UART_BAUD);
+    return ESP_OK;
+}
+
+void Acquisition_AIoT_Get_Stats(Acquisition_stats_t *stats) {
+    if (!stats) return;
+    *stats = s_stats;
+    if (s_ring) {
+        SampleRing_stats_t ring;
+        SampleRing_get_stats(s_ring, &ring);
+        stats->ring_overruns = ring.overruns;
+    }
+    stats->crc_errors = s_decoder.stats.crc_errors;
+    stats->seq_lost_frames = s_decoder.stats.seq_lost_frames;
+}
+
+bool Acquisition_AIoT_Get_Node_Stats(int index, BusSched_node_stats_t *stats) {
+    if (!stats || index < 0 || index >= s_bus.node_count) return false;
+    BusSched_get_node_stats(&s_bus, index, stats);
+    return true;
+}
+
+uint32_t Acquisition_AIoT_Get_Bus_Utilisation(void) {
+    return s_bus.node_count ? BusSched_utilisation_permille(&s_bus, esp_timer_get_time()) : 0;
+}
@@ -0,0 +1,144 @@
+#ifndef BUSSCHEDULER_AIOT_H
+#define BUSSCHEDULER_AIOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Planificador de sondeo multi-nodo sobre un bus serie compartido
+//
+// Núcleo sin dependencias de ESP-IDF: el tiempo lo entrega el llamador, así que
+// puede ejecutarse contra un simulador de nodos en Linux. El transporte (UART)
+// queda fuera: el planificador solo decide a quién preguntar y cuándo.
+//
+// - Hasta 'max_in_flight' peticiones simultáneas a nodos distintos (pipeline).
+// - Timeout y reintentos por nodo.
+// - Periodo adaptativo: se acorta si el nodo responde con el buffer lleno y se
+//   alarga si responde casi vacío o no responde.
+// - Histograma logarítmico de latencias para percentiles p50/p90/p99.
+// -----------------------------------------------------------------------------
+
+#define BUS_MAX_NODES           16
+#define BUS_HIST_BUCKETS        96      // 4 sub-cubetas por octava, hasta ~16 s
+
+/**
+ * @brief Configuración global del bus
+ */
+typedef struct {
+    uint8_t max_in_flight;      // 1 para RS-485 semidúplex; >1 si los nodos responden por turnos
+    uint32_t baud_rate;         // Para estimar la ocupación del bus
+} BusSched_config_t;
+
+/**
+ * @brief Contadores y latencias de un nodo
+ */
+typedef struct {
+    uint8_t address;
+    uint32_t period_us;         // Periodo de sondeo actual (adaptativo)
+    uint32_t requests;
+    uint32_t responses;
+    uint32_t timeouts;
+    uint32_t failures;          // Reintentos agotados
+    uint32_t stale;             // Respuestas descartadas por secuencia vieja (llegaron tras el timeout)
+    uint32_t latency_p50_us;
+    uint32_t latency_p90_us;
+    uint32_t latency_p99_us;
+    uint32_t latency_max_us;
+} BusSched_node_stats_t;
+
+typedef struct {
+    uint8_t address;
+    uint32_t period_us;
+    uint32_t min_period_us;
+    uint32_t max_period_us;
+    uint32_t timeout_us;
+    uint8_t max_retries;
+    // Estado
+    bool in_flight;
+    uint8_t retries;
+    uint16_t seq;
+    int64_t next_due_us;
+    int64_t sent_at_us;
+    // Estadísticas
+    uint32_t requests;
+    uint32_t responses;
+    uint32_t timeouts;
+    uint32_t failures;
+    uint32_t stale;
+    uint32_t latency_max_us;
+    uint32_t hist_total;
+    uint32_t hist[BUS_HIST_BUCKETS];
+} BusSched_node_t;
+
+/**
+ * @brief Estado del planificador (sin memoria dinámica)
+ */
+typedef struct {
+    BusSched_config_t cfg;
+    BusSched_node_t nodes[BUS_MAX_NODES];
+    uint8_t node_count;
+    uint8_t in_flight;
+    int64_t start_us;
+    uint64_t busy_bits;         // Bits transmitidos en ambos sentidos
+} BusSched_t;
+
+void BusSched_init(BusSched_t *s, const BusSched_config_t *cfg, int64_t now_us);
+
+/**
+ * @brief Añade un nodo al ciclo de sondeo
+ * @return Índice del nodo o -1 si no hay cupo
+ */
+int BusSched_add_node(BusSched_t *s, uint8_t address, uint32_t period_us,
+                      uint32_t timeout_us, uint8_t max_retries);
+
+/**
+ * @brief Siguiente petición a enviar ahora (el nodo vencido más antiguo)
+ * @return true si hay que enviar una petición a 'address' con secuencia 'seq'
+ */
+bool BusSched_next_request(BusSched_t *s, int64_t now_us, uint8_t *address, uint16_t *seq);
+
+/**
+ * @brief Informa los bytes de la petición realmente enviada (ocupación del bus)
+ */
+void BusSched_on_sent(BusSched_t *s, size_t request_bytes);
+
+/**
+ * @brief Registra la respuesta de un nodo
+ * @param seq     Secuencia que trae la respuesta (el nodo repite la de la petición)
+ * @param fill_q8 Llenado del buffer del nodo en la respuesta (0..255)
+ * @return false si no había una petición pendiente para ese nodo o si 'seq' no
+ *         es la de la petición pendiente (respuesta tardía a un intento anterior)
+ */
+bool BusSched_on_response(BusSched_t *s, uint8_t address, uint16_t seq, size_t response_bytes,
+                          uint8_t fill_q8, int64_t now_us);
+
+/**
+ * @brief Procesa timeouts vencidos (reintento inmediato o abandono del ciclo)
+ */
+void BusSched_check_timeouts(BusSched_t *s, int64_t now_us);
+
+/**
+ * @brief Microsegundos hasta el próximo evento (envío o timeout); 0 = ya
+ */
+uint32_t BusSched_time_to_next_event(const BusSched_t *s, int64_t now_us);
+
+/**
+ * @brief Estadísticas del nodo 'index' con percentiles de latencia
+ */
+void BusSched_get_node_stats(const BusSched_t *s, int index, BusSched_node_stats_t *stats);
+
+/**
+ * @brief Ocupación del bus desde el inicio, en por mil (0..1000)
+ */
+uint32_t BusSched_utilisation_permille(const BusSched_t *s, int64_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BUSSCHEDULER_AIOT_H
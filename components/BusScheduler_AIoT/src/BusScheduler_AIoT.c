@@ -0,0 +1,210 @@
+#include "BusScheduler_AIoT.h"
+#include <string.h>
+
+// Bits por byte en la línea (8N1)
+#define BUS_BITS_PER_BYTE   10
+
+// Umbrales de llenado para adaptar el periodo
+#define BUS_FILL_HIGH_Q8    192     // > 75 %: el nodo acumula datos, preguntar antes
+#define BUS_FILL_LOW_Q8     64      // < 25 %: se pregunta demasiado, espaciar
+
+// -----------------------------------------------------------------------------
+// Histograma logarítmico: 4 sub-cubetas por octava (error relativo < 25 %)
+// -----------------------------------------------------------------------------
+
+static int hist_bucket(uint32_t us) {
+    if (us < 4) return (int)us;
+    int e = 31 - __builtin_clz(us);                 // e >= 2
+    int mant = (int)((us >> (e - 2)) & 3);
+    int b = (e - 1) * 4 + mant;
+    return (b < BUS_HIST_BUCKETS) ? b : BUS_HIST_BUCKETS - 1;
+}
+
+// Límite superior (en us) representado por una cubeta
+static uint32_t hist_upper(int b) {
+    if (b < 4) return (uint32_t)b;
+    int e = b / 4 + 1;
+    int mant = b % 4;
+    return (uint32_t)((4 + mant + 1) << (e - 2)) - 1;
+}
+
+static uint32_t hist_percentile(const BusSched_node_t *n, uint32_t permille) {
+    if (n->hist_total == 0) return 0;
+    uint32_t target = (uint32_t)(((uint64_t)n->hist_total * permille + 999) / 1000);
+    uint32_t acc = 0;
+    for (int b = 0; b < BUS_HIST_BUCKETS; b++) {
+        acc += n->hist[b];
+        if (acc >= target) {
+            uint32_t v = hist_upper(b);
+            return (v < n->latency_max_us) ? v : n->latency_max_us;
+        }
+    }
+    return n->latency_max_us;
+}
+
+static BusSched_node_t *find_node(BusSched_t *s, uint8_t address) {
+    for (int i = 0; i < s->node_count; i++) {
+        if (s->nodes[i].address == address) return &s->nodes[i];
+    }
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+// API
+// -----------------------------------------------------------------------------
+
+void BusSched_init(BusSched_t *s, const BusSched_config_t *cfg, int64_t now_us) {
+    memset(s, 0, sizeof(*s));
+    s->cfg = *cfg;
+    if (s->cfg.max_in_flight == 0) s->cfg.max_in_flight = 1;
+    s->start_us = now_us;
+}
+
+int BusSched_add_node(BusSched_t *s, uint8_t address, uint32_t period_us,
+                      uint32_t timeout_us, uint8_t max_retries) {
+    if (s->node_count >= BUS_MAX_NODES || find_node(s, address)) return -1;
+
+    BusSched_node_t *n = &s->nodes[s->node_count];
+    memset(n, 0, sizeof(*n));
+    n->address = address;
+    n->period_us = period_us;
+    n->min_period_us = period_us / 8 ? period_us / 8 : 1;
+    n->max_period_us = period_us * 8;
+    n->timeout_us = timeout_us;
+    n->max_retries = max_retries;
+    // Escalonamos el primer sondeo para no arrancar todos a la vez
+    n->next_due_us = s->start_us + (int64_t)s->node_count * (period_us / BUS_MAX_NODES);
+    return s->node_count++;
+}
+
+bool BusSched_next_request(BusSched_t *s, int64_t now_us, uint8_t *address, uint16_t *seq) {
+    if (s->in_flight >= s->cfg.max_in_flight) return false;
+
+    // EDF: el nodo con el vencimiento más antiguo primero
+    BusSched_node_t *best = NULL;
+    for (int i = 0; i < s->node_count; i++) {
+        BusSched_node_t *n = &s->nodes[i];
+        if (n->in_flight || n->next_due_us > now_us) continue;
+        if (!best || n->next_due_us < best->next_due_us) best = n;
+    }
+    if (!best) return false;
+
+    best->in_flight = true;
+    best->sent_at_us = now_us;
+    best->seq++;
+    best->requests++;
+    s->in_flight++;
+
+    *address = best->address;
+    *seq = best->seq;
+    return true;
+}
+
+void BusSched_on_sent(BusSched_t *s, size_t request_bytes) {
+    s->busy_bits += (uint64_t)request_bytes * BUS_BITS_PER_BYTE;
+}
+
+bool BusSched_on_response(BusSched_t *s, uint8_t address, uint16_t seq, size_t response_bytes,
+                          uint8_t fill_q8, int64_t now_us) {
+    s->busy_bits += (uint64_t)response_bytes * BUS_BITS_PER_BYTE;
+
+    BusSched_node_t *n = find_node(s, address);
+    if (!n) return false;
+    // Respuesta a una petición ya vencida: no cierra la pendiente ni cuenta latencia
+    if (!n->in_flight || seq != n->seq) {
+        n->stale++;
+        return false;
+    }
+
+    uint32_t latency = (uint32_t)(now_us - n->sent_at_us);
+    n->hist[hist_bucket(latency)]++;
+    n->hist_total++;
+    if (latency > n->latency_max_us) n->latency_max_us = latency;
+
+    n->in_flight = false;
+    n->retries = 0;
+    n->responses++;
+    s->in_flight--;
+
+    // Periodo adaptativo (AIMD): baja rápido si el nodo se llena, sube despacio si va vacío
+    if (fill_q8 > BUS_FILL_HIGH_Q8) {
+        n->period_us -= n->period_us / 4;
+        if (n->period_us < n->min_period_us) n->period_us = n->min_period_us;
+    } else if (fill_q8 < BUS_FILL_LOW_Q8) {
+        n->period_us += n->period_us / 8;
+        if (n->period_us > n->max_period_us) n->period_us = n->max_period_us;
+    }
+
+    // Próximo sondeo anclado al envío anterior para no acumular deriva
+    n->next_due_us = n->sent_at_us + n->period_us;
+    if (n->next_due_us < now_us) n->next_due_us = now_us;
+    return true;
+}
+
+void BusSched_check_timeouts(BusSched_t *s, int64_t now_us) {
+    for (int i = 0; i < s->node_count; i++) {
+        BusSched_node_t *n = &s->nodes[i];
+        if (!n->in_flight || now_us - n->sent_at_us < (int64_t)n->timeout_us) continue;
+
+        n->in_flight = false;
+        n->timeouts++;
+        s->in_flight--;
+
+        if (n->retries < n->max_retries) {
+            n->retries++;
+            n->next_due_us = now_us;            // Reintento inmediato
+        } else {
+            // Nodo caído: abandonamos este ciclo y espaciamos los sondeos
+            n->retries = 0;
+            n->failures++;
+            n->period_us *= 2;
+            if (n->period_us > n->max_period_us) n->period_us = n->max_period_us;
+            n->next_due_us = now_us + n->period_us;
+        }
+    }
+}
+
+uint32_t BusSched_time_to_next_event(const BusSched_t *s, int64_t now_us) {
+    int64_t next = INT64_MAX;
+    for (int i = 0; i < s->node_count; i++) {
+        const BusSched_node_t *n = &s->nodes[i];
+        int64_t t;
+        if (n->in_flight) {
+            t = n->sent_at_us + n->timeout_us;
+        } else if (s->in_flight < s->cfg.max_in_flight) {
+            t = n->next_due_us;
+        } else {
+            continue;
+        }
+        if (t < next) next = t;
+    }
+    if (next == INT64_MAX) return UINT32_MAX;
+    if (next <= now_us) return 0;
+    int64_t d = next - now_us;
+    return (d > UINT32_MAX) ? UINT32_MAX : (uint32_t)d;
+}
+
+void BusSched_get_node_stats(const BusSched_t *s, int index, BusSched_node_stats_t *stats) {
+    if (index < 0 || index >= s->node_count || !stats) return;
+    const BusSched_node_t *n = &s->nodes[index];
+    stats->address = n->address;
+    stats->period_us = n->period_us;
+    stats->requests = n->requests;
+    stats->responses = n->responses;
+    stats->timeouts = n->timeouts;
+    stats->failures = n->failures;
+    stats->stale = n->stale;
+    stats->latency_p50_us = hist_percentile(n, 500);
+    stats->latency_p90_us = hist_percentile(n, 900);
+    stats->latency_p99_us = hist_percentile(n, 990);
+    stats->latency_max_us = n->latency_max_us;
+}
+
+uint32_t BusSched_utilisation_permille(const BusSched_t *s, int64_t now_us) {
+    int64_t elapsed = now_us - s->start_us;
+    if (elapsed <= 0 || s->cfg.baud_rate == 0) return 0;
+    uint64_t capacity_bits = (uint64_t)elapsed * s->cfg.baud_rate / 1000000;
+    if (capacity_bits == 0) return 0;
+    uint64_t pm = s->busy_bits * 1000 / capacity_bits;
+    return (pm > 1000) ? 1000 : (uint32_t)pm;
+}
@@ -0,0 +1,198 @@
+#ifndef CNN1D_AIOT_H
+#define CNN1D_AIOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "SampleRing_AIoT.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Motor de inferencia 1D-CNN cuantizado a int8
+//
+// - Activaciones int8 con cuantización afín por tensor (escala, punto cero),
+//   disposición [tiempo][canal]: la ventana receptiva de una convolución es
+//   un bloque contiguo de kernel*canales bytes.
+// - Pesos int8 simétricos por canal de salida, sesgos int32 y recuantización
+//   en punto fijo (multiplicador Q31 + desplazamiento).
+// - Sin memoria dinámica: CNN1D_plan calcula las formas y el tamaño de la
+//   arena (dos buffers ping-pong) antes de ejecutar.
+// - Convoluciones 'valid' (sin relleno).
+// -----------------------------------------------------------------------------
+
+#define CNN1D_MAX_LAYERS        16
+#define CNN1D_MAX_CHANNELS      128     // Canales por paso temporal en cualquier capa
+
+typedef enum {
+    CNN1D_LAYER_CONV1D,                 // pesos [out][kernel][in]
+    CNN1D_LAYER_DWCONV1D,               // pesos [kernel][canal], multiplicador de profundidad 1
+    CNN1D_LAYER_MAXPOOL1D,
+    CNN1D_LAYER_AVGPOOL1D,
+    CNN1D_LAYER_DENSE,                  // aplana la entrada: pesos [out][longitud*canales]
+} CNN1D_layer_type_t;
+
+/**
+ * @brief Recuantización: real = multiplier * 2^(shift - 31)
+ */
+typedef struct {
+    int32_t multiplier;
+    int8_t shift;
+} CNN1D_requant_t;
+
+typedef struct {
+    CNN1D_layer_type_t type;
+    uint16_t kernel;                    // Ventana (convolución / pooling)
+    uint16_t stride;
+    uint16_t out_channels;              // Solo CONV1D y DENSE
+    bool relu;                          // ReLU fusionada en la salida
+    const int8_t *weights;
+    const int32_t *bias;                // Uno por canal de salida (puede ser NULL)
+    const CNN1D_requant_t *requant;     // Uno por canal de salida
+    float out_scale;                    // Cuantización de la salida (pooling: igual a la entrada)
+    int8_t out_zero_point;
+} CNN1D_layer_t;
+
+typedef struct {
+    uint16_t input_length;
+    uint16_t input_channels;
+    float input_scale;
+    int8_t input_zero_point;
+    uint8_t layer_count;
+    const CNN1D_layer_t *layers;
+} CNN1D_model_t;
+
+/**
+ * @brief Formas de cada tensor y reparto de la arena
+ */
+typedef struct {
+    uint16_t length[CNN1D_MAX_LAYERS + 1];      // [0] = entrada
+    uint16_t channels[CNN1D_MAX_LAYERS + 1];
+    size_t buffer_size;                         // Mayor activación intermedia (bytes)
+    size_t arena_size;                          // Bytes que CNN1D_run necesita
+} CNN1D_plan_t;
+
+/**
+ * @brief Valida el modelo y calcula formas y tamaño de arena
+ * @return false si el modelo es inconsistente
+ */
+bool CNN1D_plan(const CNN1D_model_t *model, CNN1D_plan_t *plan);
+
+/**
+ * @brief Ejecuta el modelo sobre una entrada int8 [input_length][input_channels]
+ *
+ * @param arena Memoria de trabajo de al menos plan->arena_size bytes
+ * @return Puntero a la salida dentro de la arena (válido hasta la próxima llamada) o NULL
+ */
+const int8_t *CNN1D_run(const CNN1D_model_t *model, const CNN1D_plan_t *plan,
+                        int8_t *arena, size_t arena_size, const int8_t *input);
+
+/**
+ * @brief Producto escalar int8 con acumulador int32 (núcleo de CONV1D y DENSE)
+ *
+ * Definido débil: un puerto puede sustituirlo por una versión vectorial.
+ */
+int32_t CNN1D_dot_s8(const int8_t *a, const int8_t *b, size_t n);
+
+/**
+ * @brief Convierte un valor de salida int8 a unidades reales
+ */
+static inline float CNN1D_dequantize(const CNN1D_model_t *model, int8_t v) {
+    const CNN1D_layer_t *last = &model->layers[model->layer_count - 1];
+    return (float)(v - last->out_zero_point) * last->out_scale;
+}
+
+// --- VENTANA DESLIZANTE SOBRE EL ANILLO DE MUESTRAS --------------------------
+
+#define CNN1D_NODE_ANY          0xFF    // Sigue al primer nodo que llegue
+
+/**
+ * @brief Ventana [length][canales] int8 siempre contigua (buffer espejado 2x)
+ */
+typedef struct {
+    int8_t *buf;                        // 2 * length * channels bytes
+    uint16_t length;
+    uint16_t hop;                       // Muestras nuevas entre inferencias
+    uint16_t channel_mask;              // Canales del bloque que entran al modelo
+    uint8_t node;                       // Nodo que alimenta la ventana o CNN1D_NODE_ANY
+    uint8_t channels;
+    uint8_t channel_index[SRING_CHANNELS];
+    int32_t gain_q16;                   // Cuentas ADC -> int8 (Q16)
+    int8_t zero_point;
+    uint16_t pos;                       // Próxima fila a escribir
+    uint16_t since_ready;
+    uint32_t filled;
+    bool ready;
+} CNN1D_window_t;
+
+/**
+ * @brief Prepara la ventana
+ *
+ * @param storage       2 * length * popcount(channel_mask) bytes
+ * @param node          Nodo de origen o CNN1D_NODE_ANY (los bloques de otros
+ *                      nodos se saltan: mezclarlos rompería la serie)
+ * @param count_scale   Unidades reales por cuenta ADC
+ * @param model         Aporta escala y punto cero de la entrada
+ */
+bool CNN1D_window_init(CNN1D_window_t *w, int8_t *storage, uint16_t hop, uint16_t channel_mask,
+                       uint8_t node, float count_scale, const CNN1D_model_t *model);
+
+/**
+ * @brief Añade muestras de un bloque desde 'from' hasta completar un salto
+ * @return Índice de la siguiente muestra sin consumir del bloque
+ */
+size_t CNN1D_window_push(CNN1D_window_t *w, const SampleRing_block_t *block, size_t from);
+
+/**
+ * @brief Entrada del modelo si hay una ventana nueva lista, o NULL
+ */
+const int8_t *CNN1D_window_take(CNN1D_window_t *w);
+
+// --- TAREA (ESP32) -----------------------------------------------------------
+
+#ifdef ESP_PLATFORM
+#include "esp_err.h"
+
+#define CNN1D_TASK_CORE         1
+#define CNN1D_TASK_PRIO         10      // Por debajo de adquisición y detector
+#define CNN1D_TASK_STACK        4096
+
+typedef struct {
+    const CNN1D_model_t *model;
+    int8_t *arena;                      // Estática, del tamaño de CNN1D_plan
+    size_t arena_size;
+    int8_t *window_storage;
+    uint16_t hop;
+    uint16_t channel_mask;
+    uint8_t node;                       // Nodo a analizar o CNN1D_NODE_ANY
+    float count_scale;
+} CNN1D_task_config_t;
+
+typedef struct {
+    uint32_t inferences;
+    uint32_t last_us;                   // Latencia de la última ventana
+    uint32_t max_us;
+    int64_t last_timestamp_us;          // esp_timer al terminar la última inferencia
+} CNN1D_stats_t;
+
+/**
+ * @brief Arranca la tarea de inferencia como consumidor del anillo de muestras
+ */
+esp_err_t CNN1D_AIoT_Start(SampleRing_t *ring, const CNN1D_task_config_t *cfg);
+
+/**
+ * @brief Copia la última salida del modelo ya descuantizada
+ * @return Número de valores copiados
+ */
+size_t CNN1D_AIoT_Get_Output(float *out, size_t max_values);
+
+void CNN1D_AIoT_Get_Stats(CNN1D_stats_t *stats);
+#endif // ESP_PLATFORM
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CNN1D_AIOT_H
@@ -0,0 +1,320 @@
+#include "CNN1D_AIoT.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "TaskMonitor_AIoT.h"
+static const char *TAG = "CNN1D";
+#endif
+
+// -----------------------------------------------------------------------------
+// Aritmética de punto fijo (mismo redondeo que los modelos cuantizados de TFLite)
+// -----------------------------------------------------------------------------
+
+// Multiplicación alta con duplicado, redondeo y saturación
+static inline int32_t mul_q31(int32_t a, int32_t b) {
+    if (a == INT32_MIN && b == INT32_MIN) return INT32_MAX;
+    int64_t ab = (int64_t)a * b;
+    int32_t nudge = (ab >= 0) ? (1 << 30) : (1 - (1 << 30));
+    return (int32_t)((ab + nudge) / (1ll << 31));
+}
+
+// División por 2^exp redondeando al más cercano
+static inline int32_t shift_round(int32_t x, int exp) {
+    if (exp <= 0) return x;
+    int32_t mask = (int32_t)((1u << exp) - 1);
+    int32_t rem = x & mask;
+    int32_t threshold = (mask >> 1) + (x < 0);
+    return (x >> exp) + (rem > threshold);
+}
+
+static inline int8_t requantize(int32_t acc, const CNN1D_requant_t *rq, int32_t zp, int32_t lo) {
+    int left = rq->shift > 0 ? rq->shift : 0;
+    int right = rq->shift > 0 ? 0 : -rq->shift;
+    int32_t v = shift_round(mul_q31(acc * (1 << left), rq->multiplier), right) + zp;
+    if (v < lo) v = lo;
+    if (v > 127) v = 127;
+    return (int8_t)v;
+}
+
+// -----------------------------------------------------------------------------
+// Núcleos
+// -----------------------------------------------------------------------------
+
+__attribute__((weak)) int32_t CNN1D_dot_s8(const int8_t *a, const int8_t *b, size_t n) {
+    int32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += (int32_t)a[i] * b[i];
+        s1 += (int32_t)a[i + 1] * b[i + 1];
+        s2 += (int32_t)a[i + 2] * b[i + 2];
+        s3 += (int32_t)a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++) s0 += (int32_t)a[i] * b[i];
+    return s0 + s1 + s2 + s3;
+}
+
+static int32_t sum_s8(const int8_t *w, size_t n) {
+    int32_t s = 0;
+    for (size_t i = 0; i < n; i++) s += w[i];
+    return s;
+}
+
+// CONV1D y DENSE comparten núcleo: DENSE es una convolución de una sola posición
+static void conv1d(const CNN1D_layer_t *ly, const int8_t *in, uint16_t len_in, uint16_t ch_in,
+                   int32_t zp_in, int8_t *out, uint16_t len_out) {
+    const size_t n = (size_t)ly->kernel * ch_in;
+    const size_t step = (size_t)ly->stride * ch_in;
+    const uint16_t ch_out = ly->out_channels;
+    const int32_t lo = ly->relu ? ly->out_zero_point : -128;
+
+    for (uint16_t o = 0; o < ch_out; o++) {
+        const int8_t *w = ly->weights + (size_t)o * n;
+        // sum((x - zp) * w) = dot(x, w) - zp * sum(w): la corrección es constante por canal
+        int32_t corr = (ly->bias ? ly->bias[o] : 0) - zp_in * sum_s8(w, n);
+        const int8_t *x = in;
+        for (uint16_t t = 0; t < len_out; t++, x += step) {
+            int32_t acc = CNN1D_dot_s8(x, w, n) + corr;
+            out[(size_t)t * ch_out + o] = requantize(acc, &ly->requant[o], ly->out_zero_point, lo);
+        }
+    }
+    (void)len_in;
+}
+
+static void dwconv1d(const CNN1D_layer_t *ly, const int8_t *in, uint16_t ch,
+                     int32_t zp_in, int8_t *out, uint16_t len_out) {
+    int32_t acc[CNN1D_MAX_CHANNELS];
+    const int32_t lo = ly->relu ? ly->out_zero_point : -128;
+
+    for (uint16_t t = 0; t < len_out; t++) {
+        for (uint16_t c = 0; c < ch; c++) acc[c] = ly->bias ? ly->bias[c] : 0;
+        const int8_t *x = in + (size_t)t * ly->stride * ch;
+        for (uint16_t k = 0; k < ly->kernel; k++, x += ch) {
+            const int8_t *w = ly->weights + (size_t)k * ch;
+            for (uint16_t c = 0; c < ch; c++) acc[c] += ((int32_t)x[c] - zp_in) * w[c];
+        }
+        int8_t *y = out + (size_t)t * ch;
+        for (uint16_t c = 0; c < ch; c++) y[c] = requantize(acc[c], &ly->requant[c], ly->out_zero_point, lo);
+    }
+}
+
+static void pool1d(const CNN1D_layer_t *ly, const int8_t *in, uint16_t ch, int8_t *out, uint16_t len_out) {
+    const bool is_max = (ly->type == CNN1D_LAYER_MAXPOOL1D);
+    const int32_t k = ly->kernel;
+
+    for (uint16_t t = 0; t < len_out; t++) {
+        const int8_t *x = in + (size_t)t * ly->stride * ch;
+        int8_t *y = out + (size_t)t * ch;
+        for (uint16_t c = 0; c < ch; c++) {
+            int32_t v = is_max ? -128 : 0;
+            for (int32_t j = 0; j < k; j++) {
+                int32_t s = x[(size_t)j * ch + c];
+                if (is_max) { if (s > v) v = s; } else { v += s; }
+            }
+            if (!is_max) v = (v >= 0) ? (v + k / 2) / k : (v - k / 2) / k;
+            y[c] = (int8_t)v;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Planificación y ejecución
+// -----------------------------------------------------------------------------
+
+bool CNN1D_plan(const CNN1D_model_t *model, CNN1D_plan_t *plan) {
+    if (!model || !plan || !model->layers) return false;
+    if (model->layer_count == 0 || model->layer_count > CNN1D_MAX_LAYERS) return false;
+
+    memset(plan, 0, sizeof(*plan));
+    uint16_t len = model->input_length;
+    uint16_t ch = model->input_channels;
+    plan->length[0] = len;
+    plan->channels[0] = ch;
+
+    for (uint8_t i = 0; i < model->layer_count; i++) {
+        const CNN1D_layer_t *ly = &model->layers[i];
+        if (len == 0 || ch == 0 || ch > CNN1D_MAX_CHANNELS) return false;
+
+        switch (ly->type) {
+        case CNN1D_LAYER_CONV1D:
+        case CNN1D_LAYER_DWCONV1D:
+        case CNN1D_LAYER_MAXPOOL1D:
+        case CNN1D_LAYER_AVGPOOL1D:
+            if (ly->kernel == 0 || ly->stride == 0 || ly->kernel > len) return false;
+            len = (uint16_t)((len - ly->kernel) / ly->stride + 1);
+            if (ly->type == CNN1D_LAYER_CONV1D) ch = ly->out_channels;
+            break;
+        case CNN1D_LAYER_DENSE:
+            len = 1;
+            ch = ly->out_channels;
+            break;
+        default:
+            return false;
+        }
+        if ((ly->type == CNN1D_LAYER_CONV1D || ly->type == CNN1D_LAYER_DWCONV1D ||
+             ly->type == CNN1D_LAYER_DENSE) && (!ly->weights || !ly->requant)) return false;
+        if (ch == 0 || ch > CNN1D_MAX_CHANNELS) return false;
+
+        plan->length[i + 1] = len;
+        plan->channels[i + 1] = ch;
+        size_t bytes = (size_t)len * ch;
+        if (bytes > plan->buffer_size) plan->buffer_size = bytes;
+    }
+
+    plan->buffer_size = (plan->buffer_size + 3) & ~(size_t)3;
+    plan->arena_size = 2 * plan->buffer_size;
+    return true;
+}
+
+const int8_t *CNN1D_run(const CNN1D_model_t *model, const CNN1D_plan_t *plan,
+                        int8_t *arena, size_t arena_size, const int8_t *input) {
+    if (!arena || !input || arena_size < plan->arena_size) return NULL;
+
+    const int8_t *in = input;
+    int32_t zp = model->input_zero_point;
+
+    for (uint8_t i = 0; i < model->layer_count; i++) {
+        const CNN1D_layer_t *ly = &model->layers[i];
+        int8_t *out = arena + (i & 1) * plan->buffer_size;     // Ping-pong
+        uint16_t len_in = plan->length[i], ch_in = plan->channels[i];
+        uint16_t len_out = plan->length[i + 1];
+
+        switch (ly->type) {
+        case CNN1D_LAYER_CONV1D:
+            conv1d(ly, in, len_in, ch_in, zp, out, len_out);
+            zp = ly->out_zero_point;
+            break;
+        case CNN1D_LAYER_DENSE: {
+            CNN1D_layer_t flat = *ly;
+            flat.kernel = len_in;
+            flat.stride = 1;
+            conv1d(&flat, in, len_in, ch_in, zp, out, 1);
+            zp = ly->out_zero_point;
+            break;
+        }
+        case CNN1D_LAYER_DWCONV1D:
+            dwconv1d(ly, in, ch_in, zp, out, len_out);
+            zp = ly->out_zero_point;
+            break;
+        case CNN1D_LAYER_MAXPOOL1D:
+        case CNN1D_LAYER_AVGPOOL1D:
+            pool1d(ly, in, ch_in, out, len_out);
+            break;
+        }
+        in = out;
+    }
+    return in;
+}
+
+// -----------------------------------------------------------------------------
+// Tarea (ESP32)
+// -----------------------------------------------------------------------------
+
+#ifdef ESP_PLATFORM
+
+static CNN1D_task_config_t s_cfg;
+static CNN1D_plan_t s_plan;
+static CNN1D_window_t s_window;
+static SampleRing_t *s_ring = NULL;
+static int s_consumer = -1;
+static CNN1D_stats_t s_stats;
+static int8_t s_output[CNN1D_MAX_CHANNELS];
+static size_t s_output_len = 0;
+static portMUX_TYPE s_output_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void cnn_task(void *arg) {
+    (void)arg;
+    int mon_id = TaskMon_register("cnn", 0);
+    for (;;) {
+        const SampleRing_block_t *block = SampleRing_peek(s_ring, s_consumer);
+        if (!block) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+        TaskMon_begin(mon_id);
+
+        size_t i = 0;
+        while (i < block->count) {
+            i = CNN1D_window_push(&s_window, block, i);
+            const int8_t *input = CNN1D_window_take(&s_window);
+            if (!input) continue;
+
+            int64_t t0 = esp_timer_get_time();
+            const int8_t *y = CNN1D_run(s_cfg.model, &s_plan, s_cfg.arena, s_cfg.arena_size, input);
+            int64_t t1 = esp_timer_get_time();
+            if (!y) continue;
+
+            size_t n = (size_t)s_plan.length[s_cfg.model->layer_count] * s_plan.channels[s_cfg.model->layer_count];
+            if (n > sizeof(s_output)) n = sizeof(s_output);
+            taskENTER_CRITICAL(&s_output_lock);
+            memcpy(s_output, y, n);
+            s_output_len = n;
+            taskEXIT_CRITICAL(&s_output_lock);
+
+            s_stats.inferences++;
+            s_stats.last_us = (uint32_t)(t1 - t0);
+            if (s_stats.last_us > s_stats.max_us) s_stats.max_us = s_stats.last_us;
+            s_stats.last_timestamp_us = t1;
+        }
+        SampleRing_release(s_ring, s_consumer);
+        TaskMon_end(mon_id);
+    }
+}
+
+esp_err_t CNN1D_AIoT_Start(SampleRing_t *ring, const CNN1D_task_config_t *cfg) {
+    if (!ring || !cfg || !cfg->model || !cfg->arena || !cfg->window_storage) return ESP_ERR_INVALID_ARG;
+    if (s_ring) return ESP_ERR_INVALID_STATE;
+
+    s_cfg = *cfg;
+    if (!CNN1D_plan(cfg->model, &s_plan)) {
+        ESP_LOGE(TAG, "Modelo inválido");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (cfg->arena_size < s_plan.arena_size) {
+        ESP_LOGE(TAG, "Arena insuficiente: %u < %u bytes", (unsigned)cfg->arena_size, (unsigned)s_plan.arena_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (!CNN1D_window_init(&s_window, cfg->window_storage, cfg->hop, cfg->channel_mask, cfg->node,
+                           cfg->count_scale, cfg->model)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_consumer = SampleRing_register_consumer(ring, "cnn1d");
+    if (s_consumer < 0) return ESP_ERR_NO_MEM;
+    s_ring = ring;
+
+    if (xTaskCreatePinnedToCore(cnn_task, "cnn1d", CNN1D_TASK_STACK, NULL,
+                                CNN1D_TASK_PRIO, NULL, CNN1D_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "No se pudo crear la tarea de inferencia");
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Inferencia activa: %u capas, arena %u bytes, ventana %u x %u",
+             cfg->model->layer_count, (unsigned)s_plan.arena_size,
+             cfg->model->input_length, cfg->model->input_channels);
+    return ESP_OK;
+}
+
+size_t CNN1D_AIoT_Get_Output(float *out, size_t max_values) {
+    if (!s_ring || !out) return 0;
+    int8_t copy[CNN1D_MAX_CHANNELS];
+    size_t n;
+
+    taskENTER_CRITICAL(&s_output_lock);
+    n = (s_output_len < max_values) ? s_output_len : max_values;
+    memcpy(copy, s_output, n);
+    taskEXIT_CRITICAL(&s_output_lock);
+
+    for (size_t i = 0; i < n; i++) out[i] = CNN1D_dequantize(s_cfg.model, copy[i]);
+    return n;
+}
+
+void CNN1D_AIoT_Get_Stats(CNN1D_stats_t *stats) {
+    if (!stats) return;
+    *stats = s_stats;
+}
+
+#endif // ESP_PLATFORM
@@ -0,0 +1,67 @@
+#include "CNN1D_AIoT.h"
+#include <string.h>
+
+// La ventana se escribe dos veces (fila i y fila i + length), así las últimas
+// 'length' filas siempre forman un bloque contiguo que el modelo lee sin copia.
+
+bool CNN1D_window_init(CNN1D_window_t *w, int8_t *storage, uint16_t hop, uint16_t channel_mask,
+                       uint8_t node, float count_scale, const CNN1D_model_t *model) {
+    if (!w || !storage || !model || model->input_scale <= 0.0f) return false;
+
+    memset(w, 0, sizeof(*w));
+    for (uint8_t ch = 0; ch < SRING_CHANNELS; ch++) {
+        if (channel_mask & (1u << ch)) w->channel_index[w->channels++] = ch;
+    }
+    if (w->channels != model->input_channels || model->input_length == 0) return false;
+
+    w->buf = storage;
+    w->length = model->input_length;
+    w->hop = (hop == 0 || hop > w->length) ? w->length : hop;
+    w->channel_mask = channel_mask;
+    w->node = node;
+    w->gain_q16 = (int32_t)(count_scale / model->input_scale * 65536.0f + 0.5f);
+    w->zero_point = model->input_zero_point;
+    memset(storage, w->zero_point, (size_t)2 * w->length * w->channels);
+    return true;
+}
+
+size_t CNN1D_window_push(CNN1D_window_t *w, const SampleRing_block_t *block, size_t from) {
+    const uint8_t channels = w->channels;
+    const size_t row_bytes = channels;
+    const size_t mirror = (size_t)w->length * row_bytes;
+
+    // Una ventana es la serie de un solo nodo
+    if (w->node == CNN1D_NODE_ANY) w->node = block->node;
+    if (block->node != w->node) return block->count;
+
+    // Un bloque sin todos los canales del modelo no puede alimentar la ventana
+    if ((block->channel_mask & w->channel_mask) != w->channel_mask) return block->count;
+
+    size_t i = from;
+    for (; i < block->count; i++) {
+        int8_t *row = w->buf + (size_t)w->pos * row_bytes;
+        for (uint8_t c = 0; c < channels; c++) {
+            int32_t v = (int32_t)(((int64_t)block->data[w->channel_index[c]][i] * w->gain_q16 + 32768) >> 16) + w->zero_point;
+            if (v < -128) v = -128;
+            if (v > 127) v = 127;
+            row[c] = (int8_t)v;
+            row[mirror + c] = (int8_t)v;
+        }
+        if (++w->pos == w->length) w->pos = 0;
+        if (w->filled < w->length) w->filled++;
+
+        if (++w->since_ready >= w->hop && w->filled == w->length) {
+            w->since_ready = 0;
+            w->ready = true;
+            return i + 1;
+        }
+    }
+    return i;
+}
+
+const int8_t *CNN1D_window_take(CNN1D_window_t *w) {
+    if (!w->ready) return NULL;
+    w->ready = false;
+    // La fila más antigua es 'pos': desde ahí hay 'length' filas contiguas
+    return w->buf + (size_t)w->pos * w->channels;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Caché de imágenes predecodificadas (decodificador de imágenes de LVGL)
+//
+// - Las imágenes de EEZ están en flash como ARGB8888 (4 B/píxel) y el render
+//   las lee a través de la caché en cada repintado, compitiendo con el DMA
+//   del panel por el bus SPI compartido de flash y PSRAM.
+// - Este decodificador intercepta las fuentes en variable (lv_image_dsc_t)
+//   de 32/24 bits y las convierte, al arrancar o en el primer uso, al
+//   formato nativo del panel: RGB565 (2 B/píxel) si son opacas o RGB565A8
+//   (3 B/píxel, alfa en un plano aparte) si tienen transparencia.
+// - El presupuesto de memoria es fijo (AIOT_ASSET_CACHE_BYTES); al superarlo
+//   se expulsan las entradas menos usadas recientemente que no estén en uso.
+// - Todo se llama desde la tarea de LVGL.
+// -----------------------------------------------------------------------------
+
+#ifndef AIOT_ASSET_CACHE_BYTES
+#define AIOT_ASSET_CACHE_BYTES      (256 * 1024)
+#endif
+#ifndef AIOT_ASSET_CACHE_IN_PSRAM
+#define AIOT_ASSET_CACHE_IN_PSRAM   1           // 0 = SRAM interna
+#endif
+#define AIOT_ASSET_CACHE_ENTRIES    16
+#ifndef AIOT_ASSET_CACHE_BENCHMARK
+#define AIOT_ASSET_CACHE_BENCHMARK  0           // 1 = medir repintado al arrancar la UI
+#endif
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;                    // Decodificaciones
+    uint32_t evictions;
+    uint32_t bypass;                    // Fuentes que no caben o sin memoria
+    uint32_t entries;
+    uint32_t bytes_used;
+    uint32_t bytes_budget;
+    uint32_t decode_us;                 // Tiempo total de decodificación
+} Asset_cache_stats_t;
+
+/**
+ * @brief Registra el decodificador en LVGL (después de lv_init)
+ */
+void Asset_Cache_AIoT_Init(void);
+
+/**
+ * @brief Decodifica una imagen ya en el arranque
+ * @return false si el formato no se cachea o no cabe en el presupuesto
+ */
+bool Asset_Cache_AIoT_Preload(const lv_image_dsc_t *src);
+
+/**
+ * @brief Activa o desactiva la caché (desactivada, LVGL lee de flash como antes)
+ */
+void Asset_Cache_AIoT_Set_Enabled(bool enabled);
+
+void Asset_Cache_AIoT_Get_Stats(Asset_cache_stats_t *stats);
+
+/**
+ * @brief Mide el repintado completo de la pantalla activa sin y con caché
+ * @param frames Repintados por medida
+ * @param us_off Media por repintado leyendo de flash
+ * @param us_on  Media por repintado con la caché
+ */
+void Asset_Cache_AIoT_Benchmark(uint32_t frames, uint32_t *us_off, uint32_t *us_on);
+
+#ifdef __cplusplus
+}
+#endif
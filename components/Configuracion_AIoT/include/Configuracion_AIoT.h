@@ -1,13 +1,40 @@
 #pragma once
+#include <stdint.h>
+#include <stdbool.h>
 #include "esp_err.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Contadores del pipeline de pantalla (para comparar modos de render)
+typedef struct {
+    uint8_t render_mode;        // AIOT_RENDER_PARTIAL / DIRECT / FULL
+    uint32_t frames;            // Refrescos de LVGL completados
+    uint32_t vsyncs;            // Interrupciones VSYNC del panel (solo DIRECT / FULL)
+    uint32_t frame_avg_us;      // Refresco de LVGL (REFR_START..REFR_READY), media móvil
+    uint32_t frame_max_us;
+    uint32_t flush_avg_us;      // Tiempo dentro de flush_cb por frame (entrega, sin esperar)
+    uint32_t flush_max_us;
+    uint32_t flush_timeouts;    // Esperas de fin de transferencia agotadas
+    // Solo con AIOT_DISPLAY_PROFILE (0 si no)
+    uint32_t render_avg_us;     // Dibujo de LVGL por frame, sin flush ni esperas
+    uint32_t render_max_us;
+    uint32_t transfer_avg_us;   // Del flush al aviso del panel, sumado por frame
+    uint32_t transfer_max_us;
+} Display_stats_t;
+
 // Inicializa todo el hardware (Pantalla, Touch, I2C, etc.) y LVGL
 esp_err_t Configuracion_AIoT_Init(void);
 
+// Barrido del panel con la pantalla suspendida (on = false) o activa.
+// Devuelve ESP_ERR_NOT_SUPPORTED si el panel no tiene pin DISP: el barrido
+// sigue, solo con el reloj reducido
+esp_err_t Configuracion_AIoT_Set_Scanout(bool on);
+
+// Copia los contadores de pantalla
+void Configuracion_AIoT_Get_Display_Stats(Display_stats_t *stats);
+
 #ifdef __cplusplus
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "lvgl.h"
+#include "System_Defines_AIoT.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Seguimiento de zonas invalidadas (daño) por frame
+//
+// - Registra cada invalidación de LVGL (LV_EVENT_INVALIDATE_AREA) del frame
+//   en curso, recortada a la pantalla.
+// - Fusiona rectángulos que se tocan o solapan cuando la caja que los
+//   envuelve no desperdicia más de 1/8 de su superficie (p. ej. dos líneas
+//   de texto apiladas del mismo ancho), y si no cabe otro rectángulo fusiona
+//   el par que menos crece.
+// - Al cerrar el frame suma los píxeles dañados a estadísticas y a un mapa de
+//   calor de celdas de DAMAGE_CELL_PX x DAMAGE_CELL_PX.
+// -----------------------------------------------------------------------------
+
+#define DAMAGE_MAX_RECTS        16
+#define DAMAGE_CELL_PX          16
+#define DAMAGE_GRID_W           ((AIOT_LCD_H_RES + DAMAGE_CELL_PX - 1) / DAMAGE_CELL_PX)
+#define DAMAGE_GRID_H           ((AIOT_LCD_V_RES + DAMAGE_CELL_PX - 1) / DAMAGE_CELL_PX)
+
+typedef struct {
+    uint32_t frames;                // Frames cerrados
+    uint32_t damaged_frames;        // Frames con algo que repintar
+    uint32_t invalidations;         // Llamadas de invalidación recibidas (total)
+    uint32_t last_invalidations;    // ... en el último frame con daño
+    uint32_t last_rects;            // Rectángulos tras fusionar, último frame con daño
+    uint32_t last_px;               // Píxeles dañados, último frame con daño
+    uint32_t avg_px;                // Media móvil por frame con daño
+    uint32_t max_px;
+    uint64_t total_px;
+} Display_damage_stats_t;
+
+/**
+ * @brief Anota una zona invalidada en el frame en curso
+ */
+void Display_Damage_add(const lv_area_t *area);
+
+/**
+ * @brief Cierra el frame: fusiona, acumula estadísticas y mapa de calor
+ */
+void Display_Damage_frame_end(void);
+
+void Display_Damage_get_stats(Display_damage_stats_t *stats);
+
+/**
+ * @brief Copia el mapa de calor (píxeles dañados acumulados por celda, por filas)
+ * @return Celdas copiadas (DAMAGE_GRID_W * DAMAGE_GRID_H si cap es suficiente)
+ */
+size_t Display_Damage_get_heatmap(uint32_t *cells, size_t cap);
+
+/**
+ * @brief Copia los rectángulos del último frame con daño
+ * @return Número de rectángulos
+ */
+size_t Display_Damage_get_last_rects(lv_area_t *rects, size_t cap);
+
+/**
+ * @brief Pone a cero estadísticas y mapa de calor
+ */
+void Display_Damage_reset(void);
+
+/**
+ * @brief Vuelca el mapa de calor al log (una fila de caracteres por fila de celdas)
+ */
+void Display_Damage_log_heatmap(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Estado de energía de la pantalla
+//
+// - Suspendida: LVGL no registra invalidaciones (nada que dibujar), el
+//   barrido del panel baja a DTUNE_SUSPEND_PCLK_HZ y la tarea de UI da una
+//   vuelta cada DPOWER_IDLE_PERIOD_MS (temporizadores de LVGL, flujo EEZ y
+//   etiquetas a ritmo lento).
+// - Despertar: el flanco de PENIRQ del táctil (enganche en el ISR del
+//   driver) despierta la tarea de UI al momento; se reactiva el barrido, se
+//   invalida la pantalla entera y se dibuja un frame completo en la misma
+//   vuelta.
+// - Latencia: del IRQ (o de la petición, si la despierta otra cosa) al fin
+//   de ese frame.
+// - Todas las funciones salvo el ISR se llaman desde la tarea de UI.
+// -----------------------------------------------------------------------------
+
+#define DPOWER_IDLE_PERIOD_MS       250     // Vuelta de la tarea de UI en reposo
+
+typedef struct {
+    bool on;
+    uint32_t suspends;
+    uint32_t wakes;
+    uint32_t touch_wakes;                   // Despertares por el IRQ del táctil
+    uint32_t wake_last_us;                  // IRQ / petición -> frame completo
+    uint32_t wake_avg_us;                   // Media móvil
+    uint32_t wake_max_us;
+    uint32_t suspended_ms;                  // Tiempo total suspendida
+    bool scanout_off;                       // El panel apaga la salida (pin DISP)
+} Display_power_stats_t;
+
+void Display_Power_AIoT_Init(lv_display_t *disp);
+
+/**
+ * @brief Enganche del ISR de PENIRQ del táctil (solo actúa en reposo)
+ * @return true si despertó a una tarea de más prioridad
+ */
+bool Display_Power_on_touch_irq(void);
+
+/**
+ * @brief Suspende el render y reduce el barrido (tras apagar la retroiluminación)
+ */
+void Display_Power_suspend(void);
+
+/**
+ * @brief Reactiva el barrido y dibuja un frame completo; sin efecto si ya
+ * estaba activa
+ */
+void Display_Power_resume(void);
+
+/**
+ * @brief Atiende un despertar pendiente del IRQ del táctil
+ * Llamar tras Frame_Sched_wait. Marca actividad en LVGL para que
+ * IO_Task_Manager encienda la retroiluminación en la misma vuelta.
+ * @return true si la pantalla se acaba de despertar
+ */
+bool Display_Power_poll(void);
+
+bool Display_Power_is_on(void);
+
+void Display_Power_get_stats(Display_power_stats_t *stats);
+void Display_Power_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
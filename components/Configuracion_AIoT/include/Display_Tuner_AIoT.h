@@ -0,0 +1,103 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_lcd_panel_rgb.h"
+#include "System_Defines_AIoT.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Ajuste adaptativo del reloj de píxel y del bounce buffer del panel RGB
+//
+// - Fallos de recarga: en modo bounce cada mitad del buffer se rellena desde
+//   PSRAM en una ISR y debe terminar antes de que el DMA agote la otra mitad
+//   (un bloque de bounce_lines líneas de barrido). Se mide el tiempo entre
+//   VSYNC y el fin de relleno del frame; si supera el mínimo observado en más
+//   de un bloque de barrido, alguna recarga llegó tarde y se cuenta un fallo.
+// - Ancho de banda PSRAM: lectura de barrido (frames x pantalla) más los
+//   bytes dibujados por LVGL, por segundo.
+// - Carga: reposo, WiFi activo o render intenso. Cada clase guarda su propio
+//   reloj y su techo estable.
+// - Reloj: baja un escalón al primer fallo (el techo de la clase pasa a ser
+//   el escalón inferior) y sube un escalón tras varias ventanas limpias, sin
+//   pasar del techo.
+// - Re-prueba del techo por clase: la primera a los ~10 minutos; cada vez que
+//   vuelve a fallar sin superar el techo anterior el intervalo se duplica
+//   (hasta ~5 horas) y vuelve al mínimo si la clase consigue subir.
+// - Bounce buffer: solo cambia al reiniciar (hay que recrear el panel); se
+//   amplía si hay fallos incluso con el reloj mínimo. Los techos aprendidos
+//   con otro bounce buffer se descartan al arrancar.
+// - Los valores elegidos se guardan en NVS y se aplican al arrancar.
+// - Pantalla suspendida: el barrido sigue (el periférico RGB no tiene pausa)
+//   pero con DTUNE_SUSPEND_PCLK_HZ, sin evaluar ventanas. Es el mínimo del
+//   ajuste: por debajo no está validado que el NV3047 mantenga la imagen.
+// -----------------------------------------------------------------------------
+
+#define DTUNE_WINDOW_US             2000000     // Ventana de evaluación
+#define DTUNE_STABLE_WINDOWS        5           // Ventanas limpias antes de subir el reloj
+#define DTUNE_REPROBE_WINDOWS       300         // Primera re-prueba del techo (~10 min)
+#define DTUNE_REPROBE_MAX_WINDOWS   (DTUNE_REPROBE_WINDOWS * 32)   // Tope del retroceso (~5 h)
+#define DTUNE_HEAVY_RENDER_BPS      (2u * 1024u * 1024u)    // Render que cuenta como carga alta
+#define DTUNE_SUSPEND_PCLK_HZ       AIOT_LCD_PIXEL_CLOCK_MIN_HZ    // Reloj con la pantalla suspendida
+
+typedef enum {
+    DTUNE_LOAD_IDLE,
+    DTUNE_LOAD_WIFI,
+    DTUNE_LOAD_RENDER,
+    DTUNE_LOAD_COUNT,
+} Display_load_t;
+
+typedef struct {
+    uint32_t pclk_hz;
+    uint8_t bounce_lines;                   // En uso (el próximo arranque puede usar otro)
+    uint8_t bounce_lines_next;
+    Display_load_t load;
+    uint32_t vsyncs;
+    uint32_t refill_misses;                 // Total desde el arranque
+    uint32_t window_misses;                 // Última ventana evaluada
+    uint32_t fill_baseline_us;              // VSYNC -> fin de relleno, mínimo observado
+    uint32_t slack_us;                      // Barrido de un bloque de bounce
+    uint32_t scanout_bps;                   // Lectura de PSRAM por el barrido
+    uint32_t render_bps;                    // Escritura de PSRAM por LVGL (estimada)
+    uint32_t pclk_changes;
+    bool suspended;
+} Display_tuner_stats_t;
+
+/**
+ * @brief Lee de NVS el reloj y el bounce buffer a usar al crear el panel
+ */
+void Display_Tuner_load(uint32_t *pclk_hz, uint8_t *bounce_lines);
+
+/**
+ * @brief Arranca la telemetría con el panel ya creado
+ */
+void Display_Tuner_start(esp_lcd_panel_handle_t panel, uint32_t pclk_hz, uint8_t bounce_lines);
+
+/**
+ * @brief Indica si la radio está activa (clase de carga WiFi)
+ */
+void Display_Tuner_set_wifi_active(bool active);
+
+/**
+ * @brief Reduce el reloj de barrido al suspender la pantalla y lo restaura
+ * al volver (efectivo en el VSYNC siguiente)
+ */
+void Display_Tuner_set_suspended(bool suspended);
+
+/**
+ * @brief Evalúa la ventana y ajusta el reloj (llamar desde la tarea de UI)
+ */
+void Display_Tuner_update(void);
+
+void Display_Tuner_get_stats(Display_tuner_stats_t *stats);
+
+// Enganches del driver de pantalla (ISR del panel y flush de LVGL)
+void Display_Tuner_on_vsync(void);
+void Display_Tuner_on_frame_finish(void);
+void Display_Tuner_add_render_bytes(uint32_t bytes);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Núcleos RGB565 para el render por software de LVGL
+//
+// - Relleno, copia y mezcla alfa sobre RGB565, enganchados al renderizador
+//   SW de LVGL mediante LV_DRAW_SW_ASM_CUSTOM (ver Draw_Accel_AIoT_lvgl.h).
+//   Lo que no cubren estos núcleos sigue por el código C de LVGL.
+// - Recorren la memoria por palabras de 32 bits (2 píxeles por escritura) y
+//   saltan o copian de 4 en 4 los tramos de máscara totalmente transparentes
+//   u opacos, que son la mayoría en bordes suavizados y texto.
+// - La mezcla reproduce bit a bit lv_color_16_16_mix de LVGL, de modo que el
+//   resultado es idéntico al del camino C (comprobable en Linux, donde el
+//   módulo compila tal cual).
+// - Las copias opacas van por memcpy: por DMA la tarea de LVGL tendría que
+//   esperar a que terminase cada copia, sin nada que solapar con ella.
+// - C portable, sin instrucciones PIE del ESP32-S3: el mismo código se
+//   compara en Linux con el de LVGL (tools/ui_host, draw_accel_check).
+// - Strides en bytes, como en LVGL.
+// -----------------------------------------------------------------------------
+
+#ifndef AIOT_DRAW_ACCEL_ENABLE
+#define AIOT_DRAW_ACCEL_ENABLE      1
+#endif
+
+typedef struct {
+    uint32_t fills;
+    uint32_t blends;                    // Mezclas con opacidad o máscara
+    uint32_t copies;
+} Draw_accel_stats_t;
+
+/**
+ * @brief Informa del estado de los núcleos al arrancar
+ */
+void Draw_Accel_AIoT_Init(void);
+
+/**
+ * @brief Desactivado, LVGL usa su propio código C (para comparar)
+ */
+void Draw_Accel_AIoT_Set_Enabled(bool enabled);
+bool Draw_Accel_AIoT_Is_Enabled(void);
+
+void Draw_Accel_AIoT_Get_Stats(Draw_accel_stats_t *stats);
+
+// Relleno con un color: opa 255 cubre, mask opcional (NULL = sin máscara)
+void Draw_Accel_fill_rgb565(uint8_t *dst, int32_t w, int32_t h, int32_t dst_stride, uint16_t color,
+                            uint8_t opa, const uint8_t *mask, int32_t mask_stride);
+
+// Imagen RGB565 sobre RGB565 (mezcla normal): opa 255 y sin máscara es una copia
+void Draw_Accel_blit_rgb565(uint8_t *dst, int32_t dst_stride, const uint8_t *src, int32_t src_stride,
+                            int32_t w, int32_t h, uint8_t opa, const uint8_t *mask, int32_t mask_stride);
+
+#ifdef __cplusplus
+}
+#endif
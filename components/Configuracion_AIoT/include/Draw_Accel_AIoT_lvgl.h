@@ -0,0 +1,35 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Enganche de Draw_Accel_AIoT en el renderizador SW de LVGL
+//
+// LVGL lo incluye en sus fuentes de mezcla (LV_DRAW_SW_ASM_CUSTOM_INCLUDE en
+// sdkconfig). Cada macro devuelve LV_RESULT_INVALID si el núcleo no se usa,
+// y LVGL sigue entonces por su propio código C.
+// -----------------------------------------------------------------------------
+#include "Draw_Accel_AIoT.h"
+
+static inline lv_result_t aiot_fill_rgb565(lv_draw_sw_blend_fill_dsc_t *dsc) {
+    if (!Draw_Accel_AIoT_Is_Enabled()) return LV_RESULT_INVALID;
+    Draw_Accel_fill_rgb565((uint8_t *)dsc->dest_buf, dsc->dest_w, dsc->dest_h, dsc->dest_stride,
+                           lv_color_to_u16(dsc->color), dsc->opa >= LV_OPA_MAX ? 255 : dsc->opa,
+                           dsc->mask_buf, dsc->mask_stride);
+    return LV_RESULT_OK;
+}
+
+static inline lv_result_t aiot_blit_rgb565(lv_draw_sw_blend_image_dsc_t *dsc) {
+    if (!Draw_Accel_AIoT_Is_Enabled()) return LV_RESULT_INVALID;
+    Draw_Accel_blit_rgb565((uint8_t *)dsc->dest_buf, dsc->dest_stride, (const uint8_t *)dsc->src_buf,
+                           dsc->src_stride, dsc->dest_w, dsc->dest_h, dsc->opa >= LV_OPA_MAX ? 255 : dsc->opa,
+                           dsc->mask_buf, dsc->mask_stride);
+    return LV_RESULT_OK;
+}
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc)                           aiot_fill_rgb565(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc)                  aiot_fill_rgb565(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc)                 aiot_fill_rgb565(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc)              aiot_fill_rgb565(dsc)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565(dsc)                   aiot_blit_rgb565(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)          aiot_blit_rgb565(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)         aiot_blit_rgb565(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)      aiot_blit_rgb565(dsc)
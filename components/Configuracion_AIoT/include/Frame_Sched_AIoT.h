@@ -0,0 +1,113 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Planificador de frames al ritmo del VSYNC del panel
+//
+// - Ranura de frame: cada FRAME_SCHED_DIVISOR interrupciones VSYNC. La tarea
+//   de UI duerme hasta la ranura siguiente (semáforo dado desde el ISR) en
+//   lugar de despertar cada 1-10 ms.
+// - Render: el temporizador de refresco de LVGL queda aparcado (periodo
+//   máximo) y se arma una sola vez por ranura, y solo si hubo invalidaciones.
+//   Nunca se dibuja un frame que el panel no llegue a mostrar.
+// - Presupuesto: FRAME_SCHED_BUDGET_PCT de la ranura medida. El trabajo
+//   aplazable de la tarea de UI consulta el plazo y sigue en el frame
+//   siguiente (como mucho FRAME_SCHED_MAX_DEFER frames seguidos).
+// - Sin VSYNC (modo PARTIAL, panel parado) se sigue a LV_DEF_REFR_PERIOD.
+// - Divisor 0: planificador desactivado, LVGL refresca con su temporizador.
+// - Reposo (pantalla suspendida): vueltas cada idle_period ms sin render;
+//   Frame_Sched_kick_from_isr despierta la tarea antes de tiempo.
+// -----------------------------------------------------------------------------
+
+#define FRAME_SCHED_DIVISOR         1       // Render como mucho cada N VSYNC
+#define FRAME_SCHED_BUDGET_PCT      75      // CPU por frame (% de la ranura)
+#define FRAME_SCHED_MAX_DEFER       4       // Frames seguidos aplazando trabajo
+#define FRAME_SCHED_FALLBACK_MS     LV_DEF_REFR_PERIOD
+#define FRAME_SCHED_MIN_SLEEP_MS    100     // Si la tarea va siempre tarde, cede un tick cada este tiempo
+
+typedef struct {
+    uint8_t divisor;
+    uint32_t vsyncs;
+    uint32_t slots;                         // Ranuras de frame del panel
+    uint32_t frames;                        // Vueltas de la tarea de UI
+    uint32_t renders;                       // Refrescos de LVGL armados por el planificador
+    uint32_t dropped;                       // Ranuras perdidas con algo que dibujar (tarea ocupada)
+    uint32_t late;                          // Frames por encima del presupuesto
+    uint32_t deferred;                      // Frames con trabajo aplazado
+    uint32_t forced;                        // Trabajo ejecutado pese al plazo (límite de aplazamientos)
+    uint32_t vsync_timeouts;                // Esperas resueltas por tiempo (sin VSYNC)
+    uint32_t idle_frames;                   // Vueltas en reposo (incluidas en frames)
+    uint32_t kicks;                         // Despertares desde ISR en reposo
+    uint32_t slot_us;                       // Duración de la ranura (media móvil)
+    uint32_t budget_us;
+    uint32_t frame_avg_us;                  // CPU por frame (wait..end), media móvil
+    uint32_t frame_max_us;
+} Frame_sched_stats_t;
+
+/**
+ * @brief Aparca el temporizador de refresco de la pantalla (tras lv_display_create)
+ */
+void Frame_Sched_AIoT_Init(lv_display_t *disp);
+
+/**
+ * @brief Enganche del ISR de VSYNC del panel
+ * @return true si despertó a una tarea de más prioridad (ceder al salir del ISR)
+ */
+bool Frame_Sched_on_vsync(void);
+
+/**
+ * @brief Despierta la tarea de UI desde otra ISR (p. ej. el toque en reposo)
+ * @return true si hay que ceder al salir del ISR
+ */
+bool Frame_Sched_kick_from_isr(void);
+
+/**
+ * @brief Duerme hasta la siguiente ranura de frame y abre el frame
+ * Arma el refresco de LVGL si hay zonas invalidadas: el lv_timer_handler
+ * siguiente dibuja. Llamar al principio de cada vuelta de la tarea de UI.
+ * @param lvgl_next_ms Retorno del último lv_timer_handler; solo se usa con el
+ *                     planificador desactivado (espera acotada a 1-10 ms)
+ */
+void Frame_Sched_wait(uint32_t lvgl_next_ms);
+
+/**
+ * @brief Cierra el frame (mide la CPU usada frente al presupuesto)
+ */
+void Frame_Sched_end(void);
+
+/**
+ * @brief Fin del presupuesto del frame en curso (esp_timer, µs)
+ */
+int64_t Frame_Sched_deadline_us(void);
+
+/**
+ * @brief Indica si el trabajo aplazable debe esperar al frame siguiente
+ * Devuelve false tras FRAME_SCHED_MAX_DEFER aplazamientos seguidos.
+ */
+bool Frame_Sched_should_defer(void);
+
+/**
+ * @brief Cambia el divisor de VSYNC (0 = planificador desactivado)
+ */
+void Frame_Sched_set_divisor(uint8_t divisor);
+
+void Frame_Sched_set_budget_pct(uint8_t pct);
+
+/**
+ * @brief Modo reposo: una vuelta cada period_ms sin armar refrescos
+ * (0 = vuelta al ritmo del VSYNC, con la pantalla marcada para dibujar)
+ */
+void Frame_Sched_set_idle_period(uint32_t period_ms);
+
+void Frame_Sched_get_stats(Frame_sched_stats_t *stats);
+void Frame_Sched_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Grabación y reproducción de la entrada táctil (latencia toque -> redibujo)
+//
+// - Se intercala entre LVGL y el callback de lectura del táctil: cada
+//   lv_indev_data_t leído se sella con lv_tick y se guarda en un anillo en
+//   PSRAM (las lecturas en reposo repetidas no se guardan: el hueco queda en
+//   las marcas de tiempo).
+// - Reproducción: LVGL lee la traza en lugar del táctil, al mismo ritmo en
+//   que se grabó y sin perder flancos; el táctil real se sigue vaciando y se
+//   descarta. Funciona igual en el equipo y en tools/ui_host (ui_bench).
+// - Latencia por evento: de cada flanco (pulsar / soltar) entregado a LVGL
+//   al final del primer refresco que redibuja algo. Se mide siempre; en
+//   grabación y reproducción además se anota en la entrada de la traza.
+// - Volcado: una línea "INREC,t_ms,x,y,pulsado,latencia_us" por entrada,
+//   el mismo formato que carga Input_Rec_AIoT_Parse_Line.
+// - Todo se ejecuta en la tarea de UI (callbacks de LVGL): sin bloqueos.
+// -----------------------------------------------------------------------------
+
+#define INREC_CAPACITY              16384   // Entradas del anillo (16 B cada una, PSRAM)
+#define INREC_LATENCY_TIMEOUT_MS    1000    // Flanco sin redibujo en este tiempo: no cuenta
+#define INREC_BOOT_MODE             0       // 1 = graba desde el arranque, vuelca y reproduce
+#define INREC_BOOT_RECORD_MS        60000   // Duración de esa grabación
+
+typedef enum {
+    INREC_MODE_OFF = 0,                     // Paso directo (solo latencia en vivo)
+    INREC_MODE_RECORD,
+    INREC_MODE_REPLAY,
+} Input_rec_mode_t;
+
+typedef struct {
+    uint32_t t_ms;                          // lv_tick de la lectura
+    int16_t x;
+    int16_t y;
+    uint8_t pressed;
+    uint8_t reserved[3];
+    uint32_t latency_us;                    // Flancos: hasta el redibujo (0 = sin medir)
+} Input_rec_entry_t;
+
+typedef struct {
+    uint8_t mode;                           // Input_rec_mode_t
+    uint32_t entries;                       // En el anillo
+    uint32_t capacity;
+    uint32_t overwritten;                   // Entradas antiguas pisadas al grabar
+    uint32_t replays;                       // Reproducciones completas
+    uint32_t events;                        // Flancos con latencia medida
+    uint32_t no_redraw;                     // Flancos sin redibujo (o sin medir)
+    uint32_t latency_last_us;
+    uint32_t latency_avg_us;                // Media móvil
+    uint32_t latency_max_us;
+} Input_rec_stats_t;
+
+/**
+ * @brief Se intercala en la lectura del indev (tras lv_indev_set_read_cb)
+ * @param disp   Pantalla cuyo refresco cierra la medida de latencia
+ * @param source Callback de lectura real (p. ej. xpt2046_read_cb_lvgl9)
+ */
+void Input_Rec_AIoT_Init(lv_display_t *disp, lv_indev_t *indev, lv_indev_read_cb_t source);
+
+/**
+ * @brief Empieza a grabar (vacía el anillo; lo reserva en PSRAM la primera vez)
+ */
+bool Input_Rec_AIoT_Start_Record(void);
+
+/**
+ * @brief Termina la grabación o la reproducción en curso
+ */
+void Input_Rec_AIoT_Stop(void);
+
+/**
+ * @brief Reproduce la traza del anillo desde el principio
+ * @return false si está vacía
+ */
+bool Input_Rec_AIoT_Replay(void);
+
+/**
+ * @brief Sustituye el anillo por una traza (p. ej. leída de un volcado)
+ */
+bool Input_Rec_AIoT_Load(const Input_rec_entry_t *entries, size_t count);
+
+/**
+ * @brief Entrada i de la traza, de la más antigua a la más reciente
+ */
+bool Input_Rec_AIoT_Get(size_t i, Input_rec_entry_t *entry);
+
+/**
+ * @brief Línea de volcado de una entrada (sin salto de línea)
+ */
+int Input_Rec_AIoT_Format_Line(const Input_rec_entry_t *entry, char *buf, size_t len);
+
+/**
+ * @brief Lee una entrada de una línea que contenga "INREC," (prefijos de log admitidos)
+ */
+bool Input_Rec_AIoT_Parse_Line(const char *line, Input_rec_entry_t *entry);
+
+/**
+ * @brief Vuelca la traza al log, una línea por entrada
+ */
+void Input_Rec_AIoT_Dump(void);
+
+Input_rec_mode_t Input_Rec_AIoT_Get_Mode(void);
+void Input_Rec_AIoT_Get_Stats(Input_rec_stats_t *stats);
+void Input_Rec_AIoT_Log_Stats(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,11 +5,30 @@
 #pragma once
 
 // --- Configuración Física del Panel LCD (NV3047) ---
-// Frecuencia de Reloj de Píxel: 10 MHz es el punto óptimo para 480x272 en ESP32-S3 con PSRAM Quad
+// Frecuencia de Reloj de Píxel: 10 MHz es el techo para 480x272 en ESP32-S3 con PSRAM Quad.
+// El valor real lo elige Display_Tuner_AIoT entre MIN y el techo, en escalones de 1 MHz,
+// arrancando en BOOT (7 MHz, estable con WiFi activo) si NVS no tiene nada guardado.
 #define AIOT_LCD_PIXEL_CLOCK_HZ     (10 * 1000 * 1000) 
+#define AIOT_LCD_PIXEL_CLOCK_MIN_HZ (6 * 1000 * 1000)
+#define AIOT_LCD_PIXEL_CLOCK_BOOT_HZ (7 * 1000 * 1000)
+#define AIOT_LCD_PIXEL_CLOCK_STEP_HZ (1 * 1000 * 1000)
 #define AIOT_LCD_H_RES              480
 #define AIOT_LCD_V_RES              272
 
+// Sincronismos del NV3047
+#define AIOT_LCD_HSYNC_BACK_PORCH   43
+#define AIOT_LCD_HSYNC_FRONT_PORCH  8
+#define AIOT_LCD_HSYNC_PULSE_WIDTH  4
+#define AIOT_LCD_VSYNC_BACK_PORCH   12
+#define AIOT_LCD_VSYNC_FRONT_PORCH  8
+#define AIOT_LCD_VSYNC_PULSE_WIDTH  4
+#define AIOT_LCD_H_TOTAL            (AIOT_LCD_H_RES + AIOT_LCD_HSYNC_BACK_PORCH + AIOT_LCD_HSYNC_FRONT_PORCH + AIOT_LCD_HSYNC_PULSE_WIDTH)
+#define AIOT_LCD_V_TOTAL            (AIOT_LCD_V_RES + AIOT_LCD_VSYNC_BACK_PORCH + AIOT_LCD_VSYNC_FRONT_PORCH + AIOT_LCD_VSYNC_PULSE_WIDTH)
+
+// Bounce buffer (líneas por mitad, SRAM interna). El driver exige que el
+// framebuffer sea múltiplo del bounce buffer: divisores de 272 líneas.
+#define AIOT_LCD_BOUNCE_LINES_OPTIONS   { 8, 16, 34 }
+
 // Definición de Pines (Mapeo estricto para CrowPanel 4.3 Basic)
 #define AIOT_PIN_NUM_BK_LIGHT       2
 #define AIOT_PIN_NUM_HSYNC          39
@@ -49,4 +68,22 @@
 // Tamaño del buffer de dibujo LVGL (1/10 de pantalla en SRAM interna para máximo rendimiento)
 #define AIOT_LVGL_BUF_SIZE          (AIOT_LCD_H_RES * 40 * sizeof(uint16_t))
 
+// Modo de render de LVGL:
+//  - PARTIAL: franjas en SRAM interna copiadas al único framebuffer del panel
+//             (doble escritura)
+//  - DIRECT:  LVGL dibuja en los dos framebuffers PSRAM del panel y solo repinta
+//             las zonas sucias; el cambio de buffer se hace en VSYNC
+//  - FULL:    como DIRECT pero repinta la pantalla entera en cada frame
+#define AIOT_RENDER_PARTIAL         0
+#define AIOT_RENDER_DIRECT          1
+#define AIOT_RENDER_FULL            2
+#ifndef AIOT_LVGL_RENDER_MODE
+#define AIOT_LVGL_RENDER_MODE       AIOT_RENDER_DIRECT
+#endif
+
+// Medición de render frente a transferencia por frame (marca tiempos en el ISR del panel)
+#ifndef AIOT_DISPLAY_PROFILE
+#define AIOT_DISPLAY_PROFILE        0
+#endif
+
 #endif // __SYSTEM_DEFINES_AIOT_H__
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdbool.h>
+#include "Touch_Filter_AIoT.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Calibración del táctil en pantalla
+//
+// - Tres cruces (10 %/10 %, 90 %/50 %, 50 %/90 %) en la capa superior de
+//   LVGL, por encima de cualquier pantalla de EEZ.
+// - Por cada cruz se promedian las posiciones filtradas sin calibrar de
+//   toda la pulsación (al menos TCAL_MIN_READS lecturas).
+// - Con los tres puntos se calcula la matriz afín, se aplica al driver y se
+//   guarda en NVS; al arrancar se carga (sin ella: conversión fija original).
+// - Sin toques durante TCAL_TIMEOUT_MS se cancela y sigue la matriz anterior.
+// - Todas las funciones se llaman desde la tarea de UI.
+// -----------------------------------------------------------------------------
+
+#define TCAL_TIMEOUT_MS         30000
+#define TCAL_MIN_READS          4       // Lecturas de LVGL por cruz
+#define TCAL_HOLD_MS            3000    // Pulsación larga que abre la calibración (UI)
+
+/**
+ * @brief Carga la calibración de NVS y la aplica al driver (tras xpt2046_init_driver)
+ * @return true si había una calibración guardada
+ */
+bool Touch_Calib_AIoT_Init(void);
+
+/**
+ * @brief Abre el proceso de calibración (sin efecto si ya está abierto)
+ */
+void Touch_Calib_AIoT_Start(void);
+
+/**
+ * @brief Abre la calibración al mantener pulsado obj durante TCAL_HOLD_MS
+ * (lo hace pulsable si no lo era)
+ */
+void Touch_Calib_AIoT_Attach_Hold(lv_obj_t *obj);
+
+bool Touch_Calib_AIoT_Is_Running(void);
+
+#ifdef __cplusplus
+}
+#endif
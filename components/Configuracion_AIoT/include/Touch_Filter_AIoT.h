@@ -0,0 +1,122 @@
+#ifndef TOUCH_FILTER_AIOT_H
+#define TOUCH_FILTER_AIOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Procesado de las muestras del táctil resistivo (aritmética entera, sin
+// dependencias de ESP-IDF: se compila igual en el PC para reproducir trazas)
+//
+// Por muestra (una ráfaga de conversiones del XPT2046):
+//  1. Presión: z = Z1 + 4095 - Z2. Por debajo del umbral la muestra se
+//     descarta (toque ligero = posición inestable). Histéresis: durante una
+//     pulsación basta con 3/4 del umbral.
+//  2. Mediana de las N conversiones de X y de Y. Si el rango intercuartil
+//     supera spread_max (contacto ruidoso o en movimiento) se descarta.
+//  3. IIR adaptativo en Q4: alfa pequeña con el dedo quieto (quita el
+//     temblor) y alfa = 1 en cuanto el salto supera unas decenas de cuentas
+//     (sin retraso al arrastrar). El primer punto de la pulsación no se filtra.
+//  4. Calibración afín de 3 puntos (Q16), de cuentas del ADC a píxeles.
+// -----------------------------------------------------------------------------
+
+#define TFILT_MAX_SAMPLES       8
+#define TFILT_ADC_MAX           4095
+
+typedef struct {
+    uint16_t x[TFILT_MAX_SAMPLES];
+    uint16_t y[TFILT_MAX_SAMPLES];
+    uint8_t n;                              // Conversiones válidas de X e Y
+    uint16_t z1;
+    uint16_t z2;
+} Touch_raw_t;
+
+typedef struct {
+    uint16_t z_threshold;                   // Presión mínima para empezar una pulsación
+    uint16_t spread_max;                    // Rango intercuartil máximo (cuentas)
+    uint8_t alpha_min_q8;                   // Alfa del IIR con el dedo quieto (/256)
+    uint8_t alpha_gain_q8;                  // Alfa añadida por cuenta de salto (/256)
+} Touch_filter_config_t;
+
+#define TOUCH_FILTER_CONFIG_DEFAULT() {     \
+    .z_threshold = 350,                     \
+    .spread_max = 48,                       \
+    .alpha_min_q8 = 48,                     \
+    .alpha_gain_q8 = 4,                     \
+}
+
+typedef struct {
+    uint32_t samples;
+    uint32_t accepted;
+    uint32_t low_pressure;                  // Descartadas por presión
+    uint32_t noisy;                         // Descartadas por dispersión
+} Touch_filter_stats_t;
+
+typedef struct {
+    Touch_filter_config_t cfg;
+    int32_t fx;                             // Estado del IIR (cuentas, Q4)
+    int32_t fy;
+    bool tracking;                          // Dentro de una pulsación
+    Touch_filter_stats_t stats;
+} Touch_filter_t;
+
+/**
+ * @brief Matriz afín en Q16: X = (a*x + b*y + c) >> 16, Y = (d*x + e*y + f) >> 16
+ */
+typedef struct {
+    int32_t a, b, c;
+    int32_t d, e, f;
+} Touch_calib_t;
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+} Touch_point_t;
+
+/**
+ * @param cfg NULL = TOUCH_FILTER_CONFIG_DEFAULT()
+ */
+void Touch_filter_init(Touch_filter_t *flt, const Touch_filter_config_t *cfg);
+
+/**
+ * @brief Fin de la pulsación (lápiz levantado): la siguiente empieza sin historia
+ */
+void Touch_filter_reset(Touch_filter_t *flt);
+
+/**
+ * @brief Presión de la muestra (0 = sin contacto)
+ */
+uint16_t Touch_filter_pressure(uint16_t z1, uint16_t z2);
+
+/**
+ * @brief Procesa una muestra
+ * @param out Posición filtrada en cuentas del ADC (sin calibrar)
+ * @return false si la muestra se descarta (out sin cambios)
+ */
+bool Touch_filter_process(Touch_filter_t *flt, const Touch_raw_t *raw, Touch_point_t *out);
+
+/**
+ * @brief Matriz equivalente a la conversión fija original (200-3900 / 240-3800)
+ */
+void Touch_calib_default(Touch_calib_t *cal, int32_t h_res, int32_t v_res);
+
+/**
+ * @brief Calcula la matriz a partir de tres puntos (cuentas del ADC -> píxeles)
+ * @return false si los puntos están alineados o son casi iguales
+ */
+bool Touch_calib_compute(Touch_calib_t *cal, const Touch_point_t raw[3], const Touch_point_t screen[3]);
+
+/**
+ * @brief Aplica la matriz y limita el resultado a la pantalla
+ */
+Touch_point_t Touch_calib_apply(const Touch_calib_t *cal, Touch_point_t raw, int32_t h_res, int32_t v_res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TOUCH_FILTER_AIOT_H
@@ -3,26 +3,95 @@
 #include "lvgl.h"
 #include "driver/spi_master.h"
 #include "driver/gpio.h"
+#include "Touch_Filter_AIoT.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// -----------------------------------------------------------------------------
+// Táctil XPT2046 por interrupción
+//
+// - El flanco de bajada de PENIRQ despierta una tarea de muestreo (nada de
+//   sondeo del pin ni SPI dentro del temporizador de LVGL).
+// - Cada muestra es una sola transacción SPI por DMA, encolada, con todas
+//   las conversiones encadenadas (Z1, Z2 y XPT2046_SAMPLES de X e Y, 16
+//   relojes por conversión). La tarea duerme mientras dura.
+// - Con el lápiz abajo se muestrea cada XPT2046_SAMPLE_PERIOD_MS. Cada
+//   muestra pasa por Touch_Filter_AIoT (presión, mediana, IIR) y por la
+//   matriz de calibración; los puntos y la liberación van a una cola SPSC
+//   lock-free.
+// - El callback de lectura de LVGL solo desencola (no bloquea).
+// - Latencia: del flanco de PENIRQ a la entrega del primer punto a LVGL.
+// -----------------------------------------------------------------------------
+
+#define XPT2046_TASK_CORE           0
+#define XPT2046_TASK_PRIO           6       // Por encima de la UI: la muestra no espera al render
+#define XPT2046_TASK_STACK          3072
+#define XPT2046_SAMPLES             5       // Conversiones de X e Y por muestra (impar: mediana)
+#define XPT2046_SAMPLE_PERIOD_MS    10      // Muestreo con el lápiz abajo
+#define XPT2046_QUEUE_LEN           16      // Potencia de dos
+#define XPT2046_TRACE               0       // 1 = volcar las muestras crudas al log (trazas para el PC)
+
+/**
+ * @brief Enganche llamado en el ISR de PENIRQ (debe estar en IRAM)
+ * @return true si despertó a una tarea de más prioridad
+ */
+typedef bool (*xpt2046_irq_hook_t)(void);
+
+typedef struct {
+    uint32_t irqs;                          // Flancos de PENIRQ (incluye los de las conversiones)
+    uint32_t strokes;                       // Pulsaciones completas
+    uint32_t batches;                       // Transacciones SPI (una por muestra)
+    uint32_t points;                        // Puntos encolados
+    uint32_t dropped;                       // Puntos descartados con la cola llena
+    uint32_t rejected;                      // Muestras con el lápiz levantado a mitad
+    Touch_filter_stats_t filter;            // Descartes por presión / dispersión
+    uint32_t spi_errors;
+    uint32_t queue_high_water;
+    uint32_t batch_avg_us;                  // Duración de la transacción, media móvil
+    uint32_t batch_max_us;
+    uint32_t latency_last_us;               // PENIRQ -> primer punto leído por LVGL
+    uint32_t latency_avg_us;
+    uint32_t latency_max_us;
+} xpt2046_stats_t;
+
 /**
  * @brief Inicializa el driver XPT2046
- * @param host  Host SPI (ej. SPI2_HOST)
+ * @param host  Host SPI (ej. SPI2_HOST), con DMA
  * @param cs_pin Pin Chip Select
  * @param irq_pin Pin de Interrupción (IRQ)
  */
 void xpt2046_init_driver(spi_host_device_t host, int cs_pin, int irq_pin);
 
 /**
- * @brief Callback de lectura para LVGL 9
+ * @brief Callback de lectura para LVGL 9 (desencola, no bloquea)
  * @param indev Driver de entrada de LVGL
  * @param data  Estructura de datos para rellenar (coordenadas)
  */
 void xpt2046_read_cb_lvgl9(lv_indev_t * indev, lv_indev_data_t * data);
 
+/**
+ * @brief Registra un enganche en el ISR de PENIRQ (p. ej. despertar la pantalla)
+ */
+void xpt2046_set_irq_hook(xpt2046_irq_hook_t hook);
+
+/**
+ * @brief Cambia la matriz de calibración (cuentas del ADC -> píxeles)
+ */
+void xpt2046_set_calibration(const Touch_calib_t *cal);
+void xpt2046_get_calibration(Touch_calib_t *cal);
+
+/**
+ * @brief Última posición entregada a LVGL en cuentas del ADC, filtrada y
+ * sin calibrar (para el proceso de calibración)
+ * @return false si aún no hay ninguna
+ */
+bool xpt2046_get_raw_point(Touch_point_t *raw);
+
+void xpt2046_get_stats(xpt2046_stats_t *stats);
+void xpt2046_log_stats(void);
+
 #ifdef __cplusplus
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,281 @@
+#include "Asset_Cache_AIoT.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "Asset_Cache";
+
+#if AIOT_ASSET_CACHE_IN_PSRAM
+#define ASSET_CACHE_CAPS    (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#else
+#define ASSET_CACHE_CAPS    (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#endif
+
+typedef struct {
+    const lv_image_dsc_t *src;          // Clave: descriptor original en flash
+    lv_draw_buf_t buf;                  // Envoltorio LVGL sobre data (no propietario)
+    uint8_t *data;
+    uint32_t size;
+    uint32_t last_use;                  // Reloj LRU
+    uint16_t refs;                      // Aperturas sin cerrar: no se puede expulsar
+    bool fresh;                         // Recién decodificada: la próxima apertura no es acierto
+} asset_entry_t;
+
+// Todo se llama desde la tarea de LVGL: sin bloqueos
+static asset_entry_t entries[AIOT_ASSET_CACHE_ENTRIES];
+static uint32_t lru_clock = 0;
+static bool enabled = true;
+static lv_image_decoder_t *decoder = NULL;
+static Asset_cache_stats_t st = { .bytes_budget = AIOT_ASSET_CACHE_BYTES };
+
+// -----------------------------------------------------------------------------
+// Conversión a RGB565 nativo
+// -----------------------------------------------------------------------------
+
+static inline uint16_t to_565(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+static bool src_supported(const lv_image_dsc_t *src) {
+    if (!src || !src->data || !src->header.w || !src->header.h) return false;
+    switch (src->header.cf) {
+        case LV_COLOR_FORMAT_ARGB8888:
+        case LV_COLOR_FORMAT_XRGB8888:
+        case LV_COLOR_FORMAT_RGB888:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static uint32_t src_stride(const lv_image_dsc_t *src) {
+    if (src->header.stride) return src->header.stride;
+    return (uint32_t)src->header.w * (src->header.cf == LV_COLOR_FORMAT_RGB888 ? 3u : 4u);
+}
+
+// Opaca si no hay alfa o todos los píxeles tienen alfa 0xFF
+static bool src_opaque(const lv_image_dsc_t *src) {
+    if (src->header.cf != LV_COLOR_FORMAT_ARGB8888) return true;
+    uint32_t stride = src_stride(src);
+    for (uint32_t y = 0; y < src->header.h; y++) {
+        const uint8_t *p = src->data + y * stride;
+        for (uint32_t x = 0; x < src->header.w; x++) {
+            if (p[x * 4 + 3] != 0xFF) return false;
+        }
+    }
+    return true;
+}
+
+static inline lv_color_format_t cached_cf(bool opaque) {
+    return opaque ? LV_COLOR_FORMAT_RGB565 : LV_COLOR_FORMAT_RGB565A8;
+}
+
+static inline uint32_t cached_size(const lv_image_dsc_t *src, bool opaque) {
+    return (uint32_t)src->header.w * src->header.h * (opaque ? 2u : 3u);
+}
+
+// Orden de bytes de LVGL: ARGB8888/XRGB8888 = B,G,R,A y RGB888 = B,G,R.
+// RGB565A8: plano RGB565 (stride w*2) seguido del plano de alfa (stride w)
+static void convert(const lv_image_dsc_t *src, uint8_t *dst, bool opaque) {
+    uint32_t w = src->header.w, h = src->header.h;
+    uint32_t stride = src_stride(src);
+    uint32_t bpp = src->header.cf == LV_COLOR_FORMAT_RGB888 ? 3u : 4u;
+    uint16_t *rgb = (uint16_t *)dst;
+    uint8_t *alpha = dst + w * h * 2u;
+
+    for (uint32_t y = 0; y < h; y++) {
+        const uint8_t *p = src->data + y * stride;
+        for (uint32_t x = 0; x < w; x++, p += bpp) {
+            *rgb++ = to_565(p[2], p[1], p[0]);
+            if (!opaque) *alpha++ = p[3];
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Entradas y expulsión LRU
+// -----------------------------------------------------------------------------
+
+static asset_entry_t *entry_find(const lv_image_dsc_t *src) {
+    for (int i = 0; i < AIOT_ASSET_CACHE_ENTRIES; i++) {
+        if (entries[i].src == src) return &entries[i];
+    }
+    return NULL;
+}
+
+static void entry_free(asset_entry_t *e) {
+    heap_caps_free(e->data);
+    st.bytes_used -= e->size;
+    st.entries--;
+    memset(e, 0, sizeof(*e));
+}
+
+// Expulsa la entrada libre menos usada; false si todas están abiertas
+static bool evict_one(void) {
+    asset_entry_t *victim = NULL;
+    for (int i = 0; i < AIOT_ASSET_CACHE_ENTRIES; i++) {
+        asset_entry_t *e = &entries[i];
+        if (!e->src || e->refs) continue;
+        if (!victim || e->last_use < victim->last_use) victim = e;
+    }
+    if (!victim) return false;
+    entry_free(victim);
+    st.evictions++;
+    return true;
+}
+
+static asset_entry_t *entry_load(const lv_image_dsc_t *src) {
+    asset_entry_t *e = entry_find(src);
+    if (e) {
+        e->last_use = ++lru_clock;
+        return e;
+    }
+
+    // Ni opaca cabría: no merece recorrer el alfa
+    if (cached_size(src, true) > AIOT_ASSET_CACHE_BYTES) {
+        st.bypass++;
+        return NULL;
+    }
+    bool opaque = src_opaque(src);
+    uint32_t size = cached_size(src, opaque);
+    if (size > AIOT_ASSET_CACHE_BYTES) {
+        st.bypass++;
+        return NULL;
+    }
+
+    // Hueco en presupuesto y en la tabla
+    while (st.bytes_used + size > AIOT_ASSET_CACHE_BYTES || st.entries >= AIOT_ASSET_CACHE_ENTRIES) {
+        if (!evict_one()) {
+            st.bypass++;
+            return NULL;
+        }
+    }
+
+    uint8_t *data = heap_caps_malloc(size, ASSET_CACHE_CAPS);
+    while (!data && evict_one()) data = heap_caps_malloc(size, ASSET_CACHE_CAPS);
+    if (!data) {
+        st.bypass++;
+        return NULL;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    convert(src, data, opaque);
+    st.decode_us += (uint32_t)(esp_timer_get_time() - t0);
+
+    e = entry_find(NULL);
+    e->src = src;
+    e->data = data;
+    e->size = size;
+    e->refs = 0;
+    e->fresh = true;
+    e->last_use = ++lru_clock;
+    lv_draw_buf_init(&e->buf, src->header.w, src->header.h, cached_cf(opaque),
+                     src->header.w * 2u, data, size);
+
+    st.misses++;
+    st.entries++;
+    st.bytes_used += size;
+    return e;
+}
+
+// -----------------------------------------------------------------------------
+// Decodificador LVGL
+// -----------------------------------------------------------------------------
+
+static lv_result_t decoder_info(lv_image_decoder_t *dec, lv_image_decoder_dsc_t *dsc, lv_image_header_t *header) {
+    (void)dec;
+    if (!enabled || dsc->src_type != LV_IMAGE_SRC_VARIABLE) return LV_RESULT_INVALID;
+    const lv_image_dsc_t *src = (const lv_image_dsc_t *)dsc->src;
+    if (!src_supported(src)) return LV_RESULT_INVALID;
+
+    // LVGL abre con el decodificador cuyo info aceptó, sin probar otros si
+    // open falla: la decodificación (primer uso) se hace aquí y si no cabe
+    // la imagen se sigue leyendo de flash con el decodificador integrado
+    asset_entry_t *e = entry_load(src);
+    if (!e) return LV_RESULT_INVALID;
+
+    *header = e->buf.header;
+    header->flags = 0;
+    return LV_RESULT_OK;
+}
+
+static lv_result_t decoder_open(lv_image_decoder_t *dec, lv_image_decoder_dsc_t *dsc) {
+    (void)dec;
+    asset_entry_t *e = entry_find((const lv_image_dsc_t *)dsc->src);
+    if (!e) return LV_RESULT_INVALID;
+    if (e->fresh) e->fresh = false;
+    else st.hits++;
+    e->refs++;
+    e->last_use = ++lru_clock;
+    dsc->user_data = e;
+    dsc->decoded = &e->buf;
+    return LV_RESULT_OK;
+}
+
+static void decoder_close(lv_image_decoder_t *dec, lv_image_decoder_dsc_t *dsc) {
+    (void)dec;
+    asset_entry_t *e = (asset_entry_t *)dsc->user_data;
+    if (e && e->refs) e->refs--;
+}
+
+// -----------------------------------------------------------------------------
+// API
+// -----------------------------------------------------------------------------
+
+void Asset_Cache_AIoT_Init(void) {
+    if (decoder) return;
+    // El último decodificador creado es el primero que consulta LVGL
+    decoder = lv_image_decoder_create();
+    lv_image_decoder_set_info_cb(decoder, decoder_info);
+    lv_image_decoder_set_open_cb(decoder, decoder_open);
+    lv_image_decoder_set_close_cb(decoder, decoder_close);
+    ESP_LOGI(TAG, "Caché de imágenes: %u KB en %s", AIOT_ASSET_CACHE_BYTES / 1024,
+             AIOT_ASSET_CACHE_IN_PSRAM ? "PSRAM" : "SRAM interna");
+}
+
+bool Asset_Cache_AIoT_Preload(const lv_image_dsc_t *src) {
+    if (!src_supported(src)) return false;
+    asset_entry_t *e = entry_load(src);
+    if (!e) {
+        ESP_LOGW(TAG, "Imagen %ux%u no cacheada", (unsigned)src->header.w, (unsigned)src->header.h);
+        return false;
+    }
+    e->fresh = false;                   // El primer dibujo ya es un acierto
+    return true;
+}
+
+void Asset_Cache_AIoT_Set_Enabled(bool en) {
+    enabled = en;
+}
+
+void Asset_Cache_AIoT_Get_Stats(Asset_cache_stats_t *stats) {
+    if (stats) *stats = st;
+}
+
+static uint32_t bench_redraw(uint32_t frames) {
+    lv_obj_t *scr = lv_screen_active();
+    int64_t t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < frames; i++) {
+        lv_obj_invalidate(scr);
+        lv_refr_now(NULL);
+    }
+    return (uint32_t)((esp_timer_get_time() - t0) / (frames ? frames : 1));
+}
+
+void Asset_Cache_AIoT_Benchmark(uint32_t frames, uint32_t *us_off, uint32_t *us_on) {
+    bool prev = enabled;
+
+    enabled = false;
+    uint32_t off = bench_redraw(frames);
+    enabled = true;
+    bench_redraw(1);                    // Primer uso: decodifica lo que falte
+    uint32_t on = bench_redraw(frames);
+    enabled = prev;
+
+    ESP_LOGI(TAG, "Repintado completo: %lu us desde flash, %lu us con caché (%lu KB, %lu aciertos, %lu fallos)",
+             (unsigned long)off, (unsigned long)on, (unsigned long)(st.bytes_used / 1024),
+             (unsigned long)st.hits, (unsigned long)st.misses);
+    if (us_off) *us_off = off;
+    if (us_on) *us_on = on;
+}
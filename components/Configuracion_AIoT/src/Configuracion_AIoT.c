@@ -1,6 +1,14 @@
 #include "Configuracion_AIoT.h"
 #include "System_Defines_AIoT.h"
 #include "xpt2046_lvgl9.h" 
+#include "Display_Tuner_AIoT.h"
+#include "Display_Damage_AIoT.h"
+#include "Asset_Cache_AIoT.h"
+#include "Draw_Accel_AIoT.h"
+#include "Frame_Sched_AIoT.h"
+#include "Display_Power_AIoT.h"
+#include "Touch_Calib_AIoT.h"
+#include "Input_Rec_AIoT.h"
 
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_rgb.h"
@@ -10,8 +18,10 @@
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "esp_heap_caps.h"
+#include "esp_attr.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "lvgl.h"
 
 static const char *TAG = "Config_AIoT";
@@ -22,7 +32,13 @@ static const char *TAG = "Config_AIoT";
 #define MY_DISP_HSYNC   39
 #define MY_DISP_DE      40
 #define MY_DISP_BL      2
-#define NUM_FBS 2 // 1
+// Framebuffers del panel en PSRAM: DIRECT/FULL dibujan en dos y alternan; en
+// PARTIAL LVGL usa franjas en SRAM interna y el panel solo necesita uno
+#if AIOT_LVGL_RENDER_MODE == AIOT_RENDER_PARTIAL
+#define NUM_FBS 1
+#else
+#define NUM_FBS 2
+#endif
 
 // TOUCH SPI
 #define MY_TOUCH_HOST   SPI2_HOST
@@ -32,35 +48,208 @@ static const char *TAG = "Config_AIoT";
 #define MY_TOUCH_CS     0   
 #define MY_TOUCH_IRQ    36
 
-// Resolución
-#define PCLK_HZ (7 * 1000 * 1000)  // 7 MHz
-#define H_RES 480
-#define V_RES 272
+// Resolución (reloj de píxel y bounce buffer: Display_Tuner_AIoT)
+#define H_RES AIOT_LCD_H_RES
+#define V_RES AIOT_LCD_V_RES
 
-// Buffer x8 Líneas
+// Franjas de LVGL en modo PARTIAL: x8 Líneas
 #define BUFFER_LINES 8 // 8 
 
 static esp_lcd_panel_handle_t panel_handle = NULL;
 static lv_display_t *lv_disp = NULL;
 static lv_indev_t *lv_indev = NULL;
 
+// Contadores de pantalla
+static Display_stats_t disp_stats = { .render_mode = AIOT_LVGL_RENDER_MODE };
+static int64_t t_refr_start = 0;
+
+static inline uint32_t stats_ewma(uint32_t avg, uint32_t x) {
+    return (uint32_t)((int32_t)avg + (((int32_t)x - (int32_t)avg) >> 3));
+}
+
 static void lvgl_tick_task(void *arg) {
     lv_tick_inc(2); 
 }
 
+// -----------------------------------------------------------------------------
+// Flush asíncrono
+//
+// El flush entrega el buffer al panel y vuelve sin esperar. El callback del
+// panel avisa cuando el buffer se puede reutilizar y LVGL se bloquea en
+// flush_wait_cb solo cuando necesita ese buffer, de modo que el render de la
+// siguiente franja (o frame) se solapa con la transferencia.
+//  - PARTIAL: on_color_trans_done, la franja ya está en el framebuffer. Si el
+//    driver copia con la CPU, llega dentro de draw_bitmap (contexto de tarea).
+//  - DIRECT / FULL: draw_bitmap con un framebuffer solo lo marca como activo;
+//    el cambio se hace efectivo al empezar el siguiente frame, y el buffer
+//    anterior queda libre en on_bounce_frame_finish.
+// -----------------------------------------------------------------------------
+#define FLUSH_TIMEOUT_MS 100
+static SemaphoreHandle_t sem_flush_done = NULL;
+static volatile bool flush_pending = false;
+
+#if AIOT_DISPLAY_PROFILE
+static int64_t t_seg_start = 0;             // Inicio del tramo de render en curso
+static uint32_t render_acc_us = 0;
+static volatile int64_t t_xfer_start = 0;
+static volatile uint32_t xfer_acc_us = 0;
+static volatile bool xfer_last = false;
+#endif
+
+// Libera el buffer en transferencia; 'woken' es NULL fuera de una ISR
+static IRAM_ATTR void flush_done(BaseType_t *woken) {
+#if AIOT_DISPLAY_PROFILE
+    xfer_acc_us += (uint32_t)(esp_timer_get_time() - t_xfer_start);
+    if (xfer_last) {
+        disp_stats.transfer_avg_us = stats_ewma(disp_stats.transfer_avg_us, xfer_acc_us);
+        if (xfer_acc_us > disp_stats.transfer_max_us) disp_stats.transfer_max_us = xfer_acc_us;
+        xfer_acc_us = 0;
+    }
+#endif
+    if (woken) xSemaphoreGiveFromISR(sem_flush_done, woken);
+    else xSemaphoreGive(sem_flush_done);
+}
+
+static IRAM_ATTR bool lcd_on_vsync(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx) {
+    disp_stats.vsyncs++;
+    Display_Tuner_on_vsync();
+    return Frame_Sched_on_vsync();
+}
+
+#if AIOT_LVGL_RENDER_MODE == AIOT_RENDER_PARTIAL
+static IRAM_ATTR bool lcd_on_trans_done(esp_lcd_panel_handle_t panel, void *user_ctx) {
+    if (!xPortInIsrContext()) {
+        flush_done(NULL);
+        return false;
+    }
+    BaseType_t woken = pdFALSE;
+    flush_done(&woken);
+    return woken == pdTRUE;
+}
+#endif
+
+static IRAM_ATTR bool lcd_on_frame_finish(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx) {
+    BaseType_t woken = pdFALSE;
+    Display_Tuner_on_frame_finish();
+#if AIOT_LVGL_RENDER_MODE != AIOT_RENDER_PARTIAL
+    if (flush_pending) {
+        flush_pending = false;
+        flush_done(&woken);
+    }
+#endif
+    return woken == pdTRUE;
+}
+
 static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
     esp_lcd_panel_handle_t panel_handle = (esp_lcd_panel_handle_t)lv_display_get_user_data(disp);
-    int x1 = area->x1;
-    int y1 = area->y1;
-    int x2 = area->x2;
-    int y2 = area->y2;
-    esp_lcd_panel_draw_bitmap(panel_handle, x1, y1, x2 + 1, y2 + 1, px_map);
-    lv_display_flush_ready(disp);
+    int64_t t0 = esp_timer_get_time();
+    bool last = lv_display_flush_is_last(disp);
+    // Escritura de PSRAM estimada: zona dibujada (en DIRECT, más su copia al otro buffer)
+    uint32_t area_bytes = (uint32_t)(area->x2 - area->x1 + 1) * (uint32_t)(area->y2 - area->y1 + 1) * sizeof(uint16_t);
+    Display_Tuner_add_render_bytes(AIOT_LVGL_RENDER_MODE == AIOT_RENDER_DIRECT ? 2u * area_bytes : area_bytes);
+
+#if AIOT_DISPLAY_PROFILE
+    render_acc_us += (uint32_t)(t0 - t_seg_start);
+    t_xfer_start = t0;
+    xfer_last = last;
+#endif
+
+    // Un aviso que llegó después del timeout de flush_wait_cb sigue en el
+    // semáforo y liberaría antes de tiempo el buffer que se entrega ahora
+    xSemaphoreTake(sem_flush_done, 0);
+
+#if AIOT_LVGL_RENDER_MODE == AIOT_RENDER_PARTIAL
+    // Copia la franja al framebuffer del panel; termina en on_color_trans_done
+    esp_lcd_panel_draw_bitmap(panel_handle, area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map);
+#else
+    if (!last) {
+        // Zonas intermedias: ya están en el framebuffer, nada que transferir
+        lv_display_flush_ready(disp);
+    } else {
+        // Primero el cambio de buffer y luego la marca: si el fin de frame
+        // llega entre ambos, se libera un frame más tarde (nunca antes)
+        esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, H_RES, V_RES, px_map);
+        flush_pending = true;
+    }
+#endif
+
+    // Tiempo dentro del flush acumulado por frame
+    static uint32_t flush_acc_us = 0;
+    int64_t t1 = esp_timer_get_time();
+    flush_acc_us += (uint32_t)(t1 - t0);
+    if (last) {
+        disp_stats.flush_avg_us = stats_ewma(disp_stats.flush_avg_us, flush_acc_us);
+        if (flush_acc_us > disp_stats.flush_max_us) disp_stats.flush_max_us = flush_acc_us;
+        flush_acc_us = 0;
+    }
+
+#if AIOT_DISPLAY_PROFILE
+    t_seg_start = t1;
+    if (last) {
+        disp_stats.render_avg_us = stats_ewma(disp_stats.render_avg_us, render_acc_us);
+        if (render_acc_us > disp_stats.render_max_us) disp_stats.render_max_us = render_acc_us;
+        render_acc_us = 0;
+    }
+#endif
+}
+
+// LVGL necesita un buffer que sigue en transferencia: esperar al callback del panel
+static void lvgl_flush_wait_cb(lv_display_t *disp) {
+#if AIOT_DISPLAY_PROFILE
+    render_acc_us += (uint32_t)(esp_timer_get_time() - t_seg_start);
+#endif
+    if (xSemaphoreTake(sem_flush_done, pdMS_TO_TICKS(FLUSH_TIMEOUT_MS)) != pdTRUE) {
+        flush_pending = false;
+        disp_stats.flush_timeouts++;
+    }
+#if AIOT_DISPLAY_PROFILE
+    t_seg_start = esp_timer_get_time();
+#endif
+}
+
+static void lvgl_refr_event_cb(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_INVALIDATE_AREA) {
+        Display_Damage_add((const lv_area_t *)lv_event_get_param(e));
+        return;
+    }
+    if (code == LV_EVENT_REFR_START) {
+        t_refr_start = esp_timer_get_time();
+#if AIOT_DISPLAY_PROFILE
+        t_seg_start = t_refr_start;
+        render_acc_us = 0;
+#endif
+        return;
+    }
+    // LV_EVENT_REFR_READY
+    Display_Damage_frame_end();
+    if (!t_refr_start) return;
+    uint32_t dt = (uint32_t)(esp_timer_get_time() - t_refr_start);
+    t_refr_start = 0;
+    disp_stats.frames++;
+    disp_stats.frame_avg_us = stats_ewma(disp_stats.frame_avg_us, dt);
+    if (dt > disp_stats.frame_max_us) disp_stats.frame_max_us = dt;
+}
+
+void Configuracion_AIoT_Get_Display_Stats(Display_stats_t *stats) {
+    if (stats) *stats = disp_stats;
+}
+
+esp_err_t Configuracion_AIoT_Set_Scanout(bool on) {
+    if (!panel_handle) return ESP_ERR_INVALID_STATE;
+    // El periférico RGB no se puede pausar: reloj de barrido mínimo y, si el
+    // panel tiene pin DISP, la salida apagada
+    Display_Tuner_set_suspended(!on);
+    return esp_lcd_panel_disp_on_off(panel_handle, on);
 }
 
 // ESTA ES LA FUNCIÓN QUE TE FALTA
 esp_err_t Configuracion_AIoT_Init(void) {
-    ESP_LOGI(TAG, "Iniciando Hardware (7MHz / Buffer x8)...");
+    // Reloj y bounce buffer guardados por el ajuste adaptativo (o los de arranque)
+    uint32_t pclk_hz;
+    uint8_t bounce_lines;
+    Display_Tuner_load(&pclk_hz, &bounce_lines);
+    ESP_LOGI(TAG, "Iniciando Hardware (%lu Hz / Bounce x%u)...", (unsigned long)pclk_hz, bounce_lines);
 
     // 1. Configurar Panel RGB
     esp_lcd_rgb_panel_config_t panel_config = {
@@ -79,21 +268,34 @@ esp_err_t Configuracion_AIoT_Init(void) {
             GPIO_NUM_48, GPIO_NUM_47, GPIO_NUM_21, GPIO_NUM_14
         },
         .timings = {
-            .pclk_hz = PCLK_HZ, // 7 MHz
+            .pclk_hz = pclk_hz,
             .h_res = H_RES,
             .v_res = V_RES,
-            .hsync_back_porch = 43, .hsync_front_porch = 8, .hsync_pulse_width = 4,
-            .vsync_back_porch = 12, .vsync_front_porch = 8, .vsync_pulse_width = 4,
+            .hsync_back_porch = AIOT_LCD_HSYNC_BACK_PORCH, .hsync_front_porch = AIOT_LCD_HSYNC_FRONT_PORCH,
+            .hsync_pulse_width = AIOT_LCD_HSYNC_PULSE_WIDTH,
+            .vsync_back_porch = AIOT_LCD_VSYNC_BACK_PORCH, .vsync_front_porch = AIOT_LCD_VSYNC_FRONT_PORCH,
+            .vsync_pulse_width = AIOT_LCD_VSYNC_PULSE_WIDTH,
             .flags.pclk_active_neg = 1,
         },
         .flags.fb_in_psram = 1, 
-        .bounce_buffer_size_px = H_RES * BUFFER_LINES, // Buffer x8 (Estable)
+        .bounce_buffer_size_px = H_RES * bounce_lines,
     };
 
     ESP_ERROR_CHECK(esp_lcd_new_rgb_panel(&panel_config, &panel_handle));
     ESP_ERROR_CHECK(esp_lcd_panel_reset(panel_handle));
     ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle));
 
+    sem_flush_done = xSemaphoreCreateBinary();
+    if (!sem_flush_done) return ESP_ERR_NO_MEM;
+    esp_lcd_rgb_panel_event_callbacks_t cbs = {
+        .on_vsync = lcd_on_vsync,
+        .on_bounce_frame_finish = lcd_on_frame_finish,
+#if AIOT_LVGL_RENDER_MODE == AIOT_RENDER_PARTIAL
+        .on_color_trans_done = lcd_on_trans_done,
+#endif
+    };
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(panel_handle, &cbs, NULL));
+
     // 2. Backlight ON
     gpio_config_t bl_conf = {
         .pin_bit_mask = (1ULL << MY_DISP_BL),
@@ -116,6 +318,8 @@ esp_err_t Configuracion_AIoT_Init(void) {
 
     // 5. LVGL
     lv_init();
+    Asset_Cache_AIoT_Init();
+    Draw_Accel_AIoT_Init();
     
     const esp_timer_create_args_t lvgl_tick_timer_args = { .callback = &lvgl_tick_task, .name = "lvgl_tick" };
     esp_timer_handle_t lvgl_tick_timer = NULL;
@@ -125,16 +329,45 @@ esp_err_t Configuracion_AIoT_Init(void) {
     lv_disp = lv_display_create(480, 272);
     lv_display_set_user_data(lv_disp, panel_handle);
     lv_display_set_flush_cb(lv_disp, lvgl_flush_cb);
+    lv_display_set_flush_wait_cb(lv_disp, lvgl_flush_wait_cb);
+    lv_display_add_event_cb(lv_disp, lvgl_refr_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(lv_disp, lvgl_refr_event_cb, LV_EVENT_REFR_READY, NULL);
+    lv_display_add_event_cb(lv_disp, lvgl_refr_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
 
+#if AIOT_LVGL_RENDER_MODE == AIOT_RENDER_PARTIAL
     void *buf1 = heap_caps_malloc(H_RES * BUFFER_LINES * sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
     void *buf2 = heap_caps_malloc(H_RES * BUFFER_LINES * sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
     
     lv_display_set_buffers(lv_disp, buf1, buf2, H_RES * BUFFER_LINES * sizeof(uint16_t), LV_DISPLAY_RENDER_MODE_PARTIAL);
+#else
+    // LVGL dibuja directamente en los dos framebuffers PSRAM del panel; en
+    // DIRECT LVGL copia las zonas sucias del frame anterior al otro buffer
+    void *fb0 = NULL, *fb1 = NULL;
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_handle, NUM_FBS, &fb0, &fb1));
+    lv_display_set_buffers(lv_disp, fb0, fb1, H_RES * V_RES * sizeof(uint16_t),
+                           AIOT_LVGL_RENDER_MODE == AIOT_RENDER_FULL ? LV_DISPLAY_RENDER_MODE_FULL
+                                                                     : LV_DISPLAY_RENDER_MODE_DIRECT);
+#endif
+    ESP_LOGI(TAG, "Modo de render LVGL: %d", AIOT_LVGL_RENDER_MODE);
+
+    // Refresco de LVGL al ritmo del VSYNC (una vez por ranura de frame)
+    Frame_Sched_AIoT_Init(lv_disp);
+
+    Display_Tuner_start(panel_handle, pclk_hz, bounce_lines);
 
     // Conectar Touch
     lv_indev = lv_indev_create();
     lv_indev_set_type(lv_indev, LV_INDEV_TYPE_POINTER);
     lv_indev_set_read_cb(lv_indev, xpt2046_read_cb_lvgl9);
+    // Lectura no bloqueante (solo desencola): al ritmo del muestreo del táctil
+    lv_timer_set_period(lv_indev_get_read_timer(lv_indev), XPT2046_SAMPLE_PERIOD_MS);
+    // Grabación / reproducción de la entrada y latencia toque -> redibujo
+    Input_Rec_AIoT_Init(lv_disp, lv_indev, xpt2046_read_cb_lvgl9);
+    Touch_Calib_AIoT_Init();
+
+    // Suspensión de pantalla; el IRQ del táctil la despierta
+    Display_Power_AIoT_Init(lv_disp);
+    xpt2046_set_irq_hook(Display_Power_on_touch_irq);
 
     return ESP_OK;
 }
\ No newline at end of file
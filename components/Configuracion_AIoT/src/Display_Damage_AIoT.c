@@ -0,0 +1,183 @@
+#include "Display_Damage_AIoT.h"
+#include <string.h>
+#include "esp_log.h"
+
+static const char *TAG = "Disp_Damage";
+
+// Todo se llama desde la tarea de LVGL: sin bloqueos
+static lv_area_t rects[DAMAGE_MAX_RECTS];
+static uint32_t rect_count = 0;
+static uint32_t frame_invalidations = 0;
+
+static lv_area_t last_rects[DAMAGE_MAX_RECTS];
+static uint32_t last_rect_count = 0;
+
+static Display_damage_stats_t st;
+static uint32_t heat[DAMAGE_GRID_H][DAMAGE_GRID_W];
+
+static inline uint32_t area_px(const lv_area_t *a) {
+    return (uint32_t)(a->x2 - a->x1 + 1) * (uint32_t)(a->y2 - a->y1 + 1);
+}
+
+static inline void bbox(const lv_area_t *a, const lv_area_t *b, lv_area_t *out) {
+    out->x1 = a->x1 < b->x1 ? a->x1 : b->x1;
+    out->y1 = a->y1 < b->y1 ? a->y1 : b->y1;
+    out->x2 = a->x2 > b->x2 ? a->x2 : b->x2;
+    out->y2 = a->y2 > b->y2 ? a->y2 : b->y2;
+}
+
+static uint32_t overlap_px(const lv_area_t *a, const lv_area_t *b) {
+    int32_t x1 = a->x1 > b->x1 ? a->x1 : b->x1;
+    int32_t y1 = a->y1 > b->y1 ? a->y1 : b->y1;
+    int32_t x2 = a->x2 < b->x2 ? a->x2 : b->x2;
+    int32_t y2 = a->y2 < b->y2 ? a->y2 : b->y2;
+    if (x2 < x1 || y2 < y1) return 0;
+    return (uint32_t)(x2 - x1 + 1) * (uint32_t)(y2 - y1 + 1);
+}
+
+// Se tocan o solapan y la caja envolvente desperdicia como mucho 1/8
+static bool should_merge(const lv_area_t *a, const lv_area_t *b) {
+    if (a->x1 > b->x2 + 1 || b->x1 > a->x2 + 1) return false;
+    if (a->y1 > b->y2 + 1 || b->y1 > a->y2 + 1) return false;
+    lv_area_t box;
+    bbox(a, b, &box);
+    uint32_t box_px = area_px(&box);
+    uint32_t union_px = area_px(a) + area_px(b) - overlap_px(a, b);
+    return box_px - union_px <= box_px / 8u;
+}
+
+// -----------------------------------------------------------------------------
+// Registro por frame
+// -----------------------------------------------------------------------------
+
+void Display_Damage_add(const lv_area_t *area) {
+    lv_area_t a = *area;
+    if (a.x1 < 0) a.x1 = 0;
+    if (a.y1 < 0) a.y1 = 0;
+    if (a.x2 > AIOT_LCD_H_RES - 1) a.x2 = AIOT_LCD_H_RES - 1;
+    if (a.y2 > AIOT_LCD_V_RES - 1) a.y2 = AIOT_LCD_V_RES - 1;
+    if (a.x2 < a.x1 || a.y2 < a.y1) return;
+
+    st.invalidations++;
+    frame_invalidations++;
+
+    // Absorber todo lo que se pueda; el resultado puede habilitar otra fusión
+    bool merged;
+    do {
+        merged = false;
+        for (uint32_t i = 0; i < rect_count; i++) {
+            if (should_merge(&rects[i], &a)) {
+                bbox(&rects[i], &a, &a);
+                rects[i] = rects[--rect_count];
+                merged = true;
+                break;
+            }
+        }
+    } while (merged);
+
+    if (rect_count < DAMAGE_MAX_RECTS) {
+        rects[rect_count++] = a;
+        return;
+    }
+
+    // Lista llena: fusionar con el rectángulo que menos crece
+    uint32_t best = 0, best_growth = UINT32_MAX;
+    for (uint32_t i = 0; i < rect_count; i++) {
+        lv_area_t box;
+        bbox(&rects[i], &a, &box);
+        uint32_t growth = area_px(&box) - area_px(&rects[i]);
+        if (growth < best_growth) {
+            best_growth = growth;
+            best = i;
+        }
+    }
+    bbox(&rects[best], &a, &rects[best]);
+}
+
+static void heat_add(const lv_area_t *a) {
+    for (int32_t cy = a->y1 / DAMAGE_CELL_PX; cy <= a->y2 / DAMAGE_CELL_PX; cy++) {
+        int32_t y1 = cy * DAMAGE_CELL_PX, y2 = y1 + DAMAGE_CELL_PX - 1;
+        if (y1 < a->y1) y1 = a->y1;
+        if (y2 > a->y2) y2 = a->y2;
+        for (int32_t cx = a->x1 / DAMAGE_CELL_PX; cx <= a->x2 / DAMAGE_CELL_PX; cx++) {
+            int32_t x1 = cx * DAMAGE_CELL_PX, x2 = x1 + DAMAGE_CELL_PX - 1;
+            if (x1 < a->x1) x1 = a->x1;
+            if (x2 > a->x2) x2 = a->x2;
+            heat[cy][cx] += (uint32_t)(x2 - x1 + 1) * (uint32_t)(y2 - y1 + 1);
+        }
+    }
+}
+
+void Display_Damage_frame_end(void) {
+    st.frames++;
+    if (rect_count == 0) return;
+
+    uint32_t px = 0;
+    for (uint32_t i = 0; i < rect_count; i++) {
+        px += area_px(&rects[i]);
+        heat_add(&rects[i]);
+    }
+
+    st.damaged_frames++;
+    st.last_invalidations = frame_invalidations;
+    st.last_rects = rect_count;
+    st.last_px = px;
+    st.avg_px = st.damaged_frames == 1 ? px : (uint32_t)((int32_t)st.avg_px + (((int32_t)px - (int32_t)st.avg_px) >> 3));
+    if (px > st.max_px) st.max_px = px;
+    st.total_px += px;
+
+    memcpy(last_rects, rects, rect_count * sizeof(rects[0]));
+    last_rect_count = rect_count;
+    rect_count = 0;
+    frame_invalidations = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Consulta
+// -----------------------------------------------------------------------------
+
+void Display_Damage_get_stats(Display_damage_stats_t *stats) {
+    if (stats) *stats = st;
+}
+
+size_t Display_Damage_get_heatmap(uint32_t *cells, size_t cap) {
+    size_t n = (size_t)DAMAGE_GRID_W * DAMAGE_GRID_H;
+    if (n > cap) n = cap;
+    memcpy(cells, heat, n * sizeof(uint32_t));
+    return n;
+}
+
+size_t Display_Damage_get_last_rects(lv_area_t *out, size_t cap) {
+    size_t n = last_rect_count < cap ? last_rect_count : cap;
+    memcpy(out, last_rects, n * sizeof(lv_area_t));
+    return n;
+}
+
+void Display_Damage_reset(void) {
+    memset(&st, 0, sizeof(st));
+    memset(heat, 0, sizeof(heat));
+    last_rect_count = 0;
+}
+
+void Display_Damage_log_heatmap(void) {
+    static const char ramp[] = " .:-=+*#%@";
+    uint32_t max = 0;
+    for (int y = 0; y < DAMAGE_GRID_H; y++)
+        for (int x = 0; x < DAMAGE_GRID_W; x++)
+            if (heat[y][x] > max) max = heat[y][x];
+
+    ESP_LOGI(TAG, "Daño: %lu frames (%lu con daño), media %lu px, máx %lu px, celda máx %lu px",
+             (unsigned long)st.frames, (unsigned long)st.damaged_frames, (unsigned long)st.avg_px,
+             (unsigned long)st.max_px, (unsigned long)max);
+    if (!max) return;
+
+    char line[DAMAGE_GRID_W + 1];
+    for (int y = 0; y < DAMAGE_GRID_H; y++) {
+        for (int x = 0; x < DAMAGE_GRID_W; x++) {
+            uint32_t v = heat[y][x];
+            line[x] = v ? ramp[1 + (uint64_t)(v - 1) * (sizeof(ramp) - 2) / max] : ramp[0];
+        }
+        line[DAMAGE_GRID_W] = '\0';
+        ESP_LOGI(TAG, "|%s|", line);
+    }
+}
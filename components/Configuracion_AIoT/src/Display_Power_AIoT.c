@@ -0,0 +1,110 @@
+#include "Display_Power_AIoT.h"
+#include "Configuracion_AIoT.h"
+#include "Frame_Sched_AIoT.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "Disp_Power";
+
+static lv_display_t *disp = NULL;
+static int64_t t_suspend_us = 0;
+static Display_power_stats_t st = { .on = true };
+
+// Estado compartido con el ISR del táctil
+static volatile bool wake_pending = false;
+static volatile int64_t t_irq_us = 0;
+
+static inline uint32_t ewma(uint32_t avg, uint32_t x) {
+    return (uint32_t)((int32_t)avg + (((int32_t)x - (int32_t)avg) >> 3));
+}
+
+IRAM_ATTR bool Display_Power_on_touch_irq(void) {
+    // Solo en reposo y solo el primer flanco: la latencia se mide desde el toque
+    if (st.on || wake_pending) return false;
+    t_irq_us = esp_timer_get_time();
+    wake_pending = true;
+    return Frame_Sched_kick_from_isr();
+}
+
+// -----------------------------------------------------------------------------
+// API
+// -----------------------------------------------------------------------------
+
+void Display_Power_AIoT_Init(lv_display_t *d) {
+    disp = d;
+}
+
+void Display_Power_suspend(void) {
+    if (!disp || !st.on) return;
+    wake_pending = false;
+    st.on = false;
+    st.suspends++;
+    t_suspend_us = esp_timer_get_time();
+
+    // Nada que dibujar: los cambios de widgets no generan zonas sucias
+    lv_display_enable_invalidation(disp, false);
+    st.scanout_off = Configuracion_AIoT_Set_Scanout(false) == ESP_OK;
+    Frame_Sched_set_idle_period(DPOWER_IDLE_PERIOD_MS);
+    ESP_LOGI(TAG, "Pantalla suspendida (vuelta de UI cada %d ms)", DPOWER_IDLE_PERIOD_MS);
+}
+
+void Display_Power_resume(void) {
+    if (!disp || st.on) return;
+    bool by_touch = wake_pending;
+    int64_t t0 = by_touch ? t_irq_us : esp_timer_get_time();
+    wake_pending = false;
+
+    Configuracion_AIoT_Set_Scanout(true);
+    Frame_Sched_set_idle_period(0);
+    lv_display_enable_invalidation(disp, true);
+
+    // Frame completo ya, sin esperar a la ranura siguiente
+    lv_obj_invalidate(lv_display_get_screen_active(disp));
+    lv_refr_now(disp);
+
+    int64_t t1 = esp_timer_get_time();
+    uint32_t dt = (uint32_t)(t1 - t0);
+    st.on = true;
+    st.wakes++;
+    if (by_touch) st.touch_wakes++;
+    st.wake_last_us = dt;
+    st.wake_avg_us = st.wake_avg_us ? ewma(st.wake_avg_us, dt) : dt;
+    if (dt > st.wake_max_us) st.wake_max_us = dt;
+    st.suspended_ms += (uint32_t)((t1 - t_suspend_us) / 1000);
+    ESP_LOGI(TAG, "Pantalla activa en %lu us (%s)", (unsigned long)dt, by_touch ? "toque" : "actividad");
+}
+
+bool Display_Power_poll(void) {
+    if (!wake_pending) return false;
+    if (st.on) {
+        wake_pending = false;
+        return false;
+    }
+    Display_Power_resume();
+    // Reinicia la inactividad: IO_Task_Manager enciende la retroiluminación
+    lv_display_trigger_activity(disp);
+    return true;
+}
+
+bool Display_Power_is_on(void) {
+    return st.on;
+}
+
+void Display_Power_get_stats(Display_power_stats_t *stats) {
+    if (!stats) return;
+    *stats = st;
+    if (!st.on) stats->suspended_ms += (uint32_t)((esp_timer_get_time() - t_suspend_us) / 1000);
+}
+
+void Display_Power_log_stats(void) {
+    Display_power_stats_t s;
+    Display_Power_get_stats(&s);
+    ESP_LOGI(TAG, "%s, suspensiones %lu, despertares %lu (%lu por toque), latencia %lu us "
+             "(media %lu, máx %lu), suspendida %lu s, salida del panel %s",
+             s.on ? "activa" : "suspendida", (unsigned long)s.suspends, (unsigned long)s.wakes,
+             (unsigned long)s.touch_wakes, (unsigned long)s.wake_last_us, (unsigned long)s.wake_avg_us,
+             (unsigned long)s.wake_max_us, (unsigned long)(s.suspended_ms / 1000),
+             s.scanout_off ? "apagada" : "solo reloj reducido");
+}
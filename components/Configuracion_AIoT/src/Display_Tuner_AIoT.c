@@ -0,0 +1,318 @@
+#include "Display_Tuner_AIoT.h"
+#include "System_Defines_AIoT.h"
+#include <string.h>
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "Disp_Tuner";
+
+#define DTUNE_NVS_NAMESPACE     "disp_tune"
+#define DTUNE_NVS_KEY           "cfg"
+#define DTUNE_NVS_VERSION       2
+
+#define DTUNE_PCLK_STEPS \
+    ((AIOT_LCD_PIXEL_CLOCK_HZ - AIOT_LCD_PIXEL_CLOCK_MIN_HZ) / AIOT_LCD_PIXEL_CLOCK_STEP_HZ + 1)
+
+static const uint8_t bounce_options[] = AIOT_LCD_BOUNCE_LINES_OPTIONS;
+#define DTUNE_BOUNCE_COUNT      (sizeof(bounce_options) / sizeof(bounce_options[0]))
+
+// Lo que se guarda en NVS
+typedef struct {
+    uint8_t version;
+    uint8_t bounce_idx;
+    uint8_t pclk_idx[DTUNE_LOAD_COUNT];
+    uint8_t ceil_idx[DTUNE_LOAD_COUNT];
+    uint8_t ceil_bounce_idx;            // Bounce buffer con el que se aprendieron los techos
+} dtune_saved_t;
+
+static dtune_saved_t saved;
+static esp_lcd_panel_handle_t panel = NULL;
+static uint8_t pclk_idx = 0;            // Escalón aplicado ahora
+static uint8_t bounce_idx_boot = 0;     // Bounce buffer con el que se creó el panel
+static Display_load_t load = DTUNE_LOAD_IDLE;
+static bool wifi_active = false;
+static bool suspended = false;
+static uint32_t stable_windows = 0;
+static uint32_t window_count = 0;       // Ventanas evaluadas desde el arranque
+// Re-prueba del techo por clase (retroceso exponencial)
+#define DTUNE_NO_REPROBE        0xFF
+static uint32_t reprobe_at[DTUNE_LOAD_COUNT];
+static uint32_t reprobe_interval[DTUNE_LOAD_COUNT];
+static uint8_t reprobe_from[DTUNE_LOAD_COUNT];         // Techo antes de la re-prueba en curso
+static bool probing = false;            // Subida pendiente de confirmar
+static bool skip_window = true;         // Ventana contaminada (arranque, cambio de reloj, escritura NVS)
+static int64_t window_start_us = 0;
+static Display_tuner_stats_t st;
+
+// Estado compartido con las ISR del panel
+static portMUX_TYPE isr_lock = portMUX_INITIALIZER_UNLOCKED;
+static volatile int64_t t_vsync = 0;
+static volatile uint32_t isr_vsyncs = 0;
+static volatile uint32_t isr_misses = 0;
+static volatile uint32_t isr_fill_min = UINT32_MAX;    // Mínimo de la ventana en curso
+static volatile uint32_t fill_baseline = 0;            // 0 = aún sin referencia
+static volatile uint32_t slack_us = 0;
+static volatile uint32_t render_bytes = 0;
+
+static inline uint32_t idx_to_pclk(uint8_t idx) {
+    return AIOT_LCD_PIXEL_CLOCK_MIN_HZ + (uint32_t)idx * AIOT_LCD_PIXEL_CLOCK_STEP_HZ;
+}
+
+static uint8_t pclk_to_idx(uint32_t hz) {
+    if (hz <= AIOT_LCD_PIXEL_CLOCK_MIN_HZ) return 0;
+    uint32_t idx = (hz - AIOT_LCD_PIXEL_CLOCK_MIN_HZ) / AIOT_LCD_PIXEL_CLOCK_STEP_HZ;
+    return (uint8_t)(idx < DTUNE_PCLK_STEPS ? idx : DTUNE_PCLK_STEPS - 1);
+}
+
+static void saved_defaults(void) {
+    memset(&saved, 0, sizeof(saved));
+    saved.version = DTUNE_NVS_VERSION;
+    for (int c = 0; c < DTUNE_LOAD_COUNT; c++) {
+        saved.pclk_idx[c] = pclk_to_idx(AIOT_LCD_PIXEL_CLOCK_BOOT_HZ);
+        saved.ceil_idx[c] = DTUNE_PCLK_STEPS - 1;
+    }
+}
+
+static void saved_store(void) {
+    nvs_handle_t h;
+    if (nvs_open(DTUNE_NVS_NAMESPACE, NVS_READWRITE, &h) != ESP_OK) return;
+    if (nvs_set_blob(h, DTUNE_NVS_KEY, &saved, sizeof(saved)) == ESP_OK) nvs_commit(h);
+    nvs_close(h);
+    // La escritura en flash suspende la caché y con ella el relleno de bounce
+    skip_window = true;
+}
+
+// -----------------------------------------------------------------------------
+// Arranque
+// -----------------------------------------------------------------------------
+
+void Display_Tuner_load(uint32_t *pclk_hz, uint8_t *bounce_lines) {
+    saved_defaults();
+
+    nvs_handle_t h;
+    if (nvs_open(DTUNE_NVS_NAMESPACE, NVS_READONLY, &h) == ESP_OK) {
+        dtune_saved_t tmp;
+        size_t len = sizeof(tmp);
+        if (nvs_get_blob(h, DTUNE_NVS_KEY, &tmp, &len) == ESP_OK && len == sizeof(tmp) &&
+            tmp.version == DTUNE_NVS_VERSION && tmp.bounce_idx < DTUNE_BOUNCE_COUNT) {
+            saved = tmp;
+            // Con otro bounce buffer los techos aprendidos ya no valen
+            bool reset_ceil = saved.ceil_bounce_idx != saved.bounce_idx;
+            saved.ceil_bounce_idx = saved.bounce_idx;
+            for (int c = 0; c < DTUNE_LOAD_COUNT; c++) {
+                if (reset_ceil || saved.ceil_idx[c] >= DTUNE_PCLK_STEPS) saved.ceil_idx[c] = DTUNE_PCLK_STEPS - 1;
+                if (saved.pclk_idx[c] > saved.ceil_idx[c]) saved.pclk_idx[c] = saved.ceil_idx[c];
+            }
+        }
+        nvs_close(h);
+    }
+
+    *pclk_hz = idx_to_pclk(saved.pclk_idx[DTUNE_LOAD_IDLE]);
+    *bounce_lines = bounce_options[saved.bounce_idx];
+}
+
+static void apply_pclk(uint8_t idx) {
+    if (idx == pclk_idx) return;
+    if (esp_lcd_rgb_panel_set_pclk(panel, idx_to_pclk(idx)) != ESP_OK) return;
+    pclk_idx = idx;
+    st.pclk_changes++;
+    // Otro reloj, otra referencia de tiempos
+    taskENTER_CRITICAL(&isr_lock);
+    fill_baseline = 0;
+    isr_fill_min = UINT32_MAX;
+    slack_us = (uint32_t)((uint64_t)bounce_options[bounce_idx_boot] * AIOT_LCD_H_TOTAL * 1000000u / idx_to_pclk(idx));
+    taskEXIT_CRITICAL(&isr_lock);
+    skip_window = true;
+    ESP_LOGI(TAG, "Reloj de píxel %lu Hz (carga %d)", (unsigned long)idx_to_pclk(idx), (int)load);
+}
+
+void Display_Tuner_start(esp_lcd_panel_handle_t p, uint32_t pclk_hz, uint8_t bounce_lines) {
+    panel = p;
+    pclk_idx = pclk_to_idx(pclk_hz);
+    bounce_idx_boot = saved.bounce_idx;
+    for (uint8_t i = 0; i < DTUNE_BOUNCE_COUNT; i++) {
+        if (bounce_options[i] == bounce_lines) bounce_idx_boot = i;
+    }
+    slack_us = (uint32_t)((uint64_t)bounce_lines * AIOT_LCD_H_TOTAL * 1000000u / pclk_hz);
+    for (int c = 0; c < DTUNE_LOAD_COUNT; c++) {
+        reprobe_interval[c] = DTUNE_REPROBE_WINDOWS;
+        reprobe_at[c] = DTUNE_REPROBE_WINDOWS;
+        reprobe_from[c] = DTUNE_NO_REPROBE;
+    }
+    window_start_us = esp_timer_get_time();
+    ESP_LOGI(TAG, "Inicio: %lu Hz, bounce %u líneas", (unsigned long)pclk_hz, bounce_lines);
+}
+
+void Display_Tuner_set_wifi_active(bool active) {
+    wifi_active = active;
+}
+
+void Display_Tuner_set_suspended(bool s) {
+    if (!panel || s == suspended) return;
+    suspended = s;
+    uint32_t hz = s ? DTUNE_SUSPEND_PCLK_HZ : idx_to_pclk(pclk_idx);
+    if (esp_lcd_rgb_panel_set_pclk(panel, hz) != ESP_OK) {
+        ESP_LOGW(TAG, "Reloj de píxel %lu Hz no aplicado", (unsigned long)hz);
+    }
+    if (s) return;
+    // Lo medido con el reloj lento no vale: ventana nueva y descartada
+    taskENTER_CRITICAL(&isr_lock);
+    isr_vsyncs = 0;
+    isr_misses = 0;
+    isr_fill_min = UINT32_MAX;
+    render_bytes = 0;
+    taskEXIT_CRITICAL(&isr_lock);
+    window_start_us = esp_timer_get_time();
+    skip_window = true;
+}
+
+// -----------------------------------------------------------------------------
+// Enganches del driver
+// -----------------------------------------------------------------------------
+
+IRAM_ATTR void Display_Tuner_on_vsync(void) {
+    taskENTER_CRITICAL_ISR(&isr_lock);
+    t_vsync = esp_timer_get_time();
+    isr_vsyncs++;
+    taskEXIT_CRITICAL_ISR(&isr_lock);
+}
+
+IRAM_ATTR void Display_Tuner_on_frame_finish(void) {
+    taskENTER_CRITICAL_ISR(&isr_lock);
+    if (t_vsync) {
+        uint32_t d = (uint32_t)(esp_timer_get_time() - t_vsync);
+        if (d < isr_fill_min) isr_fill_min = d;
+        if (fill_baseline && d > fill_baseline + slack_us) isr_misses++;
+    }
+    taskEXIT_CRITICAL_ISR(&isr_lock);
+}
+
+void Display_Tuner_add_render_bytes(uint32_t bytes) {
+    // Mismo hilo que Display_Tuner_update (tarea de UI)
+    render_bytes += bytes;
+}
+
+// -----------------------------------------------------------------------------
+// Evaluación por ventanas
+// -----------------------------------------------------------------------------
+
+// Programa la próxima re-prueba del techo de 'cls' al fijarlo en 'ceil': si
+// la re-prueba en curso no pasó del techo anterior, el intervalo se duplica
+static void schedule_reprobe(Display_load_t cls, uint8_t ceil) {
+    if (reprobe_from[cls] != DTUNE_NO_REPROBE && ceil <= reprobe_from[cls]) {
+        reprobe_interval[cls] *= 2;
+        if (reprobe_interval[cls] > DTUNE_REPROBE_MAX_WINDOWS) reprobe_interval[cls] = DTUNE_REPROBE_MAX_WINDOWS;
+    } else {
+        reprobe_interval[cls] = DTUNE_REPROBE_WINDOWS;
+    }
+    reprobe_from[cls] = DTUNE_NO_REPROBE;
+    reprobe_at[cls] = window_count + reprobe_interval[cls];
+}
+
+void Display_Tuner_update(void) {
+    if (!panel || suspended) return;
+    int64_t now = esp_timer_get_time();
+    int64_t span = now - window_start_us;
+    if (span < DTUNE_WINDOW_US) return;
+    window_start_us = now;
+
+    taskENTER_CRITICAL(&isr_lock);
+    uint32_t vsyncs = isr_vsyncs;
+    uint32_t misses = isr_misses;
+    uint32_t fill_min = isr_fill_min;
+    uint32_t rbytes = render_bytes;
+    isr_vsyncs = 0;
+    isr_misses = 0;
+    isr_fill_min = UINT32_MAX;
+    render_bytes = 0;
+    // La referencia es el relleno más rápido visto con este reloj
+    if (fill_min != UINT32_MAX && (!fill_baseline || fill_min < fill_baseline)) fill_baseline = fill_min;
+    taskEXIT_CRITICAL(&isr_lock);
+
+    st.vsyncs += vsyncs;
+    st.scanout_bps = (uint32_t)((uint64_t)vsyncs * AIOT_LCD_H_RES * AIOT_LCD_V_RES * 2u * 1000000u / (uint64_t)span);
+    st.render_bps = (uint32_t)((uint64_t)rbytes * 1000000u / (uint64_t)span);
+
+    if (skip_window) {
+        skip_window = false;
+        return;
+    }
+    window_count++;
+    st.refill_misses += misses;
+    st.window_misses = misses;
+
+    // Clase de carga de esta ventana
+    Display_load_t cls = st.render_bps > DTUNE_HEAVY_RENDER_BPS ? DTUNE_LOAD_RENDER
+                       : wifi_active                           ? DTUNE_LOAD_WIFI
+                                                               : DTUNE_LOAD_IDLE;
+    if (cls != load) {
+        load = cls;
+        stable_windows = 0;
+        probing = false;
+        apply_pclk(saved.pclk_idx[cls]);
+        return;
+    }
+
+    bool dirty = false;
+    if (misses) {
+        stable_windows = 0;
+        probing = false;
+        if (pclk_idx > 0) {
+            // Este escalón no es estable con esta carga: techo justo debajo
+            schedule_reprobe(cls, pclk_idx - 1);
+            saved.ceil_idx[cls] = pclk_idx - 1;
+            saved.pclk_idx[cls] = pclk_idx - 1;
+            apply_pclk(pclk_idx - 1);
+            ESP_LOGW(TAG, "%lu fallos de recarga: techo %lu Hz", (unsigned long)misses,
+                     (unsigned long)idx_to_pclk(saved.ceil_idx[cls]));
+            dirty = true;
+        } else if (saved.bounce_idx + 1u < DTUNE_BOUNCE_COUNT && saved.bounce_idx == bounce_idx_boot) {
+            // Ni con el reloj mínimo: más margen de bounce en el próximo arranque
+            saved.bounce_idx++;
+            ESP_LOGW(TAG, "Fallos con el reloj mínimo: bounce de %u líneas tras reiniciar",
+                     bounce_options[saved.bounce_idx]);
+            dirty = true;
+        }
+    } else if (++stable_windows >= DTUNE_STABLE_WINDOWS) {
+        stable_windows = 0;
+        if (probing) {
+            // La subida aguantó: es el nuevo punto de trabajo de la clase
+            probing = false;
+            saved.pclk_idx[cls] = pclk_idx;
+            if (reprobe_from[cls] != DTUNE_NO_REPROBE && pclk_idx > reprobe_from[cls]) {
+                // La re-prueba superó el techo anterior: intervalo al mínimo
+                reprobe_from[cls] = DTUNE_NO_REPROBE;
+                reprobe_interval[cls] = DTUNE_REPROBE_WINDOWS;
+            }
+            dirty = true;
+        } else if (pclk_idx < saved.ceil_idx[cls]) {
+            probing = true;
+            apply_pclk(pclk_idx + 1);
+        }
+    }
+
+    for (int c = 0; c < DTUNE_LOAD_COUNT; c++) {
+        if (reprobe_from[c] != DTUNE_NO_REPROBE || saved.ceil_idx[c] >= DTUNE_PCLK_STEPS - 1) continue;
+        if ((int32_t)(window_count - reprobe_at[c]) < 0) continue;
+        reprobe_from[c] = saved.ceil_idx[c];
+        saved.ceil_idx[c] = DTUNE_PCLK_STEPS - 1;
+    }
+
+    if (dirty) saved_store();
+}
+
+void Display_Tuner_get_stats(Display_tuner_stats_t *stats) {
+    if (!stats) return;
+    st.pclk_hz = suspended ? DTUNE_SUSPEND_PCLK_HZ : idx_to_pclk(pclk_idx);
+    st.suspended = suspended;
+    st.bounce_lines = bounce_options[bounce_idx_boot];
+    st.bounce_lines_next = bounce_options[saved.bounce_idx];
+    st.load = load;
+    st.fill_baseline_us = fill_baseline;
+    st.slack_us = slack_us;
+    *stats = st;
+}
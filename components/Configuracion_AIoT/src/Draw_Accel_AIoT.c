@@ -0,0 +1,203 @@
+#include "Draw_Accel_AIoT.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_log.h"
+
+static const char *TAG = "Draw_Accel";
+#endif
+
+// Todo se llama desde la tarea de LVGL
+static bool enabled = AIOT_DRAW_ACCEL_ENABLE;
+static Draw_accel_stats_t st;
+
+// -----------------------------------------------------------------------------
+// Mezcla (idéntica a lv_color_16_16_mix)
+// -----------------------------------------------------------------------------
+
+#define MIX_MASK    0x07E0F81Fu     // G en la mitad alta, R y B en la baja
+
+static inline uint32_t spread(uint16_t c) {
+    return ((uint32_t)c | ((uint32_t)c << 16)) & MIX_MASK;
+}
+
+static inline uint16_t unspread(uint32_t v) {
+    return (uint16_t)((v >> 16) | v);
+}
+
+static inline uint16_t mix(uint16_t fg, uint16_t bg, uint8_t a) {
+    if (a == 255) return fg;
+    if (a == 0) return bg;
+    if (fg == bg) return fg;
+    uint32_t m = ((uint32_t)a + 4) >> 3;
+    uint32_t b = spread(bg);
+    return unspread(((((spread(fg) - b) * m) >> 5) + b) & MIX_MASK);
+}
+
+// Como LV_OPA_MIX2
+static inline uint8_t opa_mix(uint8_t a, uint8_t b) {
+    return (uint8_t)(((uint32_t)a * b) >> 8);
+}
+
+// -----------------------------------------------------------------------------
+// Relleno
+// -----------------------------------------------------------------------------
+
+static void fill_row(uint16_t *d, int32_t w, uint16_t color) {
+    // Hasta alinear a 4 bytes, luego 2 píxeles por palabra (8 por vuelta)
+    if (((uintptr_t)d & 3) && w) {
+        *d++ = color;
+        w--;
+    }
+    uint32_t c2 = (uint32_t)color | ((uint32_t)color << 16);
+    uint32_t *d32 = (uint32_t *)d;
+    int32_t pairs = w >> 1;
+    while (pairs >= 4) {
+        d32[0] = c2; d32[1] = c2; d32[2] = c2; d32[3] = c2;
+        d32 += 4;
+        pairs -= 4;
+    }
+    while (pairs--) *d32++ = c2;
+    if (w & 1) *(uint16_t *)d32 = color;
+}
+
+void Draw_Accel_fill_rgb565(uint8_t *dst, int32_t w, int32_t h, int32_t dst_stride, uint16_t color,
+                            uint8_t opa, const uint8_t *mask, int32_t mask_stride) {
+    if (opa == 0) return;
+
+    if (!mask && opa == 255) {
+        st.fills++;
+        for (int32_t y = 0; y < h; y++, dst += dst_stride) fill_row((uint16_t *)dst, w, color);
+        return;
+    }
+
+    st.blends++;
+    if (!mask) {
+        // Opacidad uniforme: el fondo suele repetirse, se reutiliza el último resultado
+        for (int32_t y = 0; y < h; y++, dst += dst_stride) {
+            uint16_t *d = (uint16_t *)dst;
+            uint16_t last_bg = (uint16_t)~d[0], last_res = 0;
+            for (int32_t x = 0; x < w; x++) {
+                if (d[x] != last_bg) {
+                    last_bg = d[x];
+                    last_res = mix(color, last_bg, opa);
+                }
+                d[x] = last_res;
+            }
+        }
+        return;
+    }
+
+    for (int32_t y = 0; y < h; y++, dst += dst_stride, mask += mask_stride) {
+        uint16_t *d = (uint16_t *)dst;
+        int32_t x = 0;
+        if (opa == 255) {
+            // Tramos de 4 bytes de máscara vacíos o llenos sin mezclar
+            while (x < w && ((uintptr_t)(mask + x) & 3)) {
+                d[x] = mix(color, d[x], mask[x]);
+                x++;
+            }
+            for (; x + 4 <= w; x += 4) {
+                uint32_t m4 = *(const uint32_t *)(mask + x);
+                if (m4 == 0) continue;
+                if (m4 == 0xFFFFFFFFu) {
+                    d[x] = color; d[x + 1] = color; d[x + 2] = color; d[x + 3] = color;
+                    continue;
+                }
+                d[x] = mix(color, d[x], mask[x]);
+                d[x + 1] = mix(color, d[x + 1], mask[x + 1]);
+                d[x + 2] = mix(color, d[x + 2], mask[x + 2]);
+                d[x + 3] = mix(color, d[x + 3], mask[x + 3]);
+            }
+            for (; x < w; x++) d[x] = mix(color, d[x], mask[x]);
+        } else {
+            for (; x < w; x++) {
+                if (mask[x]) d[x] = mix(color, d[x], opa_mix(mask[x], opa));
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Copia y mezcla de imágenes
+// -----------------------------------------------------------------------------
+
+static void copy_rows(uint8_t *dst, int32_t dst_stride, const uint8_t *src, int32_t src_stride,
+                      int32_t w, int32_t h) {
+    uint32_t row = (uint32_t)w * 2u;
+    if ((uint32_t)dst_stride == row && (uint32_t)src_stride == row) {
+        // Bloque contiguo
+        memcpy(dst, src, row * (uint32_t)h);
+        return;
+    }
+    for (int32_t y = 0; y < h; y++, dst += dst_stride, src += src_stride) memcpy(dst, src, row);
+}
+
+void Draw_Accel_blit_rgb565(uint8_t *dst, int32_t dst_stride, const uint8_t *src, int32_t src_stride,
+                            int32_t w, int32_t h, uint8_t opa, const uint8_t *mask, int32_t mask_stride) {
+    if (opa == 0) return;
+
+    if (!mask && opa == 255) {
+        st.copies++;
+        copy_rows(dst, dst_stride, src, src_stride, w, h);
+        return;
+    }
+
+    st.blends++;
+    for (int32_t y = 0; y < h; y++, dst += dst_stride, src += src_stride) {
+        uint16_t *d = (uint16_t *)dst;
+        const uint16_t *s = (const uint16_t *)src;
+        if (!mask) {
+            for (int32_t x = 0; x < w; x++) d[x] = mix(s[x], d[x], opa);
+            continue;
+        }
+
+        int32_t x = 0;
+        if (opa == 255) {
+            while (x < w && ((uintptr_t)(mask + x) & 3)) {
+                d[x] = mix(s[x], d[x], mask[x]);
+                x++;
+            }
+            for (; x + 4 <= w; x += 4) {
+                uint32_t m4 = *(const uint32_t *)(mask + x);
+                if (m4 == 0) continue;
+                if (m4 == 0xFFFFFFFFu) {
+                    d[x] = s[x]; d[x + 1] = s[x + 1]; d[x + 2] = s[x + 2]; d[x + 3] = s[x + 3];
+                    continue;
+                }
+                d[x] = mix(s[x], d[x], mask[x]);
+                d[x + 1] = mix(s[x + 1], d[x + 1], mask[x + 1]);
+                d[x + 2] = mix(s[x + 2], d[x + 2], mask[x + 2]);
+                d[x + 3] = mix(s[x + 3], d[x + 3], mask[x + 3]);
+            }
+            for (; x < w; x++) d[x] = mix(s[x], d[x], mask[x]);
+        } else {
+            for (; x < w; x++) {
+                if (mask[x]) d[x] = mix(s[x], d[x], opa_mix(mask[x], opa));
+            }
+        }
+        mask += mask_stride;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// API
+// -----------------------------------------------------------------------------
+
+void Draw_Accel_AIoT_Init(void) {
+#ifdef ESP_PLATFORM
+    ESP_LOGI(TAG, "Núcleos RGB565 %s", enabled ? "activos" : "inactivos");
+#endif
+}
+
+void Draw_Accel_AIoT_Set_Enabled(bool en) {
+    enabled = en;
+}
+
+bool Draw_Accel_AIoT_Is_Enabled(void) {
+    return enabled;
+}
+
+void Draw_Accel_AIoT_Get_Stats(Draw_accel_stats_t *stats) {
+    if (stats) *stats = st;
+}
@@ -0,0 +1,244 @@
+#include "Frame_Sched_AIoT.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "Frame_Sched";
+
+#define FSCHED_TIMER_PARKED     0x7FFFFFFFu     // Periodo del refresco de LVGL fuera de las ranuras
+#define FSCHED_OFF_MAX_DELAY_MS 10              // Planificador desactivado: como la vuelta original
+
+static lv_display_t *disp = NULL;
+static lv_timer_t *refr_timer = NULL;
+static SemaphoreHandle_t sem_slot = NULL;
+static uint8_t budget_pct = FRAME_SCHED_BUDGET_PCT;
+
+// Estado de la tarea de UI
+static bool dirty = true;                       // Invalidaciones sin dibujar
+static bool have_vsync = false;                 // Llegan VSYNC (si no, ritmo de reserva)
+static uint32_t last_slots = 0;
+static uint32_t defer_run = 0;
+static TickType_t last_sleep_tick = 0;
+static int64_t frame_start_us = 0;
+static int64_t deadline_us = INT64_MAX;
+static Frame_sched_stats_t st;
+
+// Estado compartido con el ISR de VSYNC (un solo escritor en cada lado)
+static volatile uint8_t divisor = FRAME_SCHED_DIVISOR;
+static volatile uint32_t idle_period_ms = 0;    // 0 = ritmo del VSYNC
+static volatile uint32_t isr_kicks = 0;
+static volatile uint32_t isr_vsyncs = 0;
+static volatile uint32_t isr_slots = 0;
+static volatile uint32_t isr_period_us = 0;
+static uint8_t isr_div_count = 0;
+static int64_t isr_t_vsync = 0;
+
+static inline uint32_t ewma(uint32_t avg, uint32_t x) {
+    return (uint32_t)((int32_t)avg + (((int32_t)x - (int32_t)avg) >> 3));
+}
+
+static TickType_t ms_to_ticks(uint32_t ms) {
+    // Con tick de 100 Hz pdMS_TO_TICKS redondea a 0 las esperas cortas
+    TickType_t ticks = pdMS_TO_TICKS(ms);
+    return ticks ? ticks : 1;
+}
+
+// -----------------------------------------------------------------------------
+// Eventos de la pantalla
+// -----------------------------------------------------------------------------
+
+static void disp_event_cb(lv_event_t *e) {
+    // INVALIDATE_AREA: algo que dibujar; REFR_START: LVGL ya lo está dibujando
+    // (las invalidaciones durante el render las descarta LVGL)
+    dirty = lv_event_get_code(e) == LV_EVENT_INVALIDATE_AREA;
+}
+
+IRAM_ATTR bool Frame_Sched_on_vsync(void) {
+    int64_t now = esp_timer_get_time();
+    if (isr_t_vsync) {
+        uint32_t d = (uint32_t)(now - isr_t_vsync);
+        isr_period_us = isr_period_us ? ewma(isr_period_us, d) : d;
+    }
+    isr_t_vsync = now;
+    isr_vsyncs++;
+
+    uint8_t div = divisor;
+    if (!sem_slot || div == 0 || idle_period_ms || ++isr_div_count < div) return false;
+    isr_div_count = 0;
+    isr_slots++;
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(sem_slot, &woken);
+    return woken == pdTRUE;
+}
+
+IRAM_ATTR bool Frame_Sched_kick_from_isr(void) {
+    if (!sem_slot) return false;
+    isr_kicks++;
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(sem_slot, &woken);
+    return woken == pdTRUE;
+}
+
+// -----------------------------------------------------------------------------
+// API
+// -----------------------------------------------------------------------------
+
+void Frame_Sched_AIoT_Init(lv_display_t *d) {
+    if (disp) return;
+    sem_slot = xSemaphoreCreateBinary();
+    refr_timer = lv_display_get_refr_timer(d);
+    if (!sem_slot || !refr_timer) {
+        ESP_LOGW(TAG, "Sin semáforo o temporizador de refresco: refresco libre de LVGL");
+        divisor = 0;
+        return;
+    }
+    disp = d;
+    lv_display_add_event_cb(disp, disp_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_add_event_cb(disp, disp_event_cb, LV_EVENT_REFR_START, NULL);
+    Frame_Sched_set_divisor(FRAME_SCHED_DIVISOR);
+    last_sleep_tick = xTaskGetTickCount();
+    ESP_LOGI(TAG, "Render cada %u VSYNC, presupuesto %u%% de la ranura", FRAME_SCHED_DIVISOR, budget_pct);
+}
+
+void Frame_Sched_wait(uint32_t lvgl_next_ms) {
+    uint32_t idle_ms = idle_period_ms;
+    if (idle_ms) {
+        // Reposo: sin VSYNC ni render, solo temporizadores de LVGL y flujo a
+        // ritmo lento hasta el periodo o un despertar desde ISR
+        if (sem_slot) xSemaphoreTake(sem_slot, ms_to_ticks(idle_ms));
+        else vTaskDelay(ms_to_ticks(idle_ms));
+        last_sleep_tick = xTaskGetTickCount();
+        last_slots = isr_slots;
+        frame_start_us = esp_timer_get_time();
+        deadline_us = INT64_MAX;
+        st.idle_frames++;
+        st.frames++;
+        return;
+    }
+
+    if (!disp || divisor == 0) {
+        // Desactivado: dormir hasta que LVGL tenga trabajo, acotado
+        if (lvgl_next_ms > FSCHED_OFF_MAX_DELAY_MS) lvgl_next_ms = FSCHED_OFF_MAX_DELAY_MS;
+        vTaskDelay(ms_to_ticks(lvgl_next_ms));
+        frame_start_us = esp_timer_get_time();
+        deadline_us = INT64_MAX;
+        st.frames++;
+        return;
+    }
+
+    TickType_t now_tick = xTaskGetTickCount();
+    if (xSemaphoreTake(sem_slot, 0) == pdTRUE) {
+        // La ranura ya pasó mientras se trabajaba: sin dormir. Si ocurre
+        // siempre, ceder un tick de vez en cuando (tarea idle y red del núcleo 0)
+        if ((now_tick - last_sleep_tick) >= ms_to_ticks(FRAME_SCHED_MIN_SLEEP_MS)) {
+            vTaskDelay(1);
+            last_sleep_tick = xTaskGetTickCount();
+        }
+    } else {
+        uint32_t slot_ms = have_vsync ? (st.slot_us + 999) / 1000 : 0;
+        uint32_t timeout_ms = have_vsync ? 2 * slot_ms : FRAME_SCHED_FALLBACK_MS;
+        if (xSemaphoreTake(sem_slot, ms_to_ticks(timeout_ms)) != pdTRUE) {
+            st.vsync_timeouts++;
+            have_vsync = false;
+        }
+        last_sleep_tick = xTaskGetTickCount();
+    }
+
+    // Ranuras que pasaron sin atender mientras había algo que dibujar
+    uint32_t slots = isr_slots;
+    if (st.frames == 0) last_slots = slots;     // Las de ui_init no cuentan
+    uint32_t missed = slots - last_slots;
+    if (missed > 1 && dirty) st.dropped += missed - 1;
+    if (missed) have_vsync = true;
+    last_slots = slots;
+
+    // Un refresco por ranura, solo con zonas invalidadas (si no, LVGL tiene
+    // el temporizador en pausa y no haría nada)
+    if (dirty) {
+        lv_timer_ready(refr_timer);
+        st.renders++;
+    }
+
+    uint32_t period = isr_period_us;
+    st.slot_us = have_vsync && period ? period * divisor : FRAME_SCHED_FALLBACK_MS * 1000u;
+    st.budget_us = st.slot_us / 100u * budget_pct;
+    frame_start_us = esp_timer_get_time();
+    deadline_us = frame_start_us + st.budget_us;
+    st.frames++;
+}
+
+void Frame_Sched_end(void) {
+    uint32_t dt = (uint32_t)(esp_timer_get_time() - frame_start_us);
+    st.frame_avg_us = st.frame_avg_us ? ewma(st.frame_avg_us, dt) : dt;
+    if (dt > st.frame_max_us) st.frame_max_us = dt;
+    if (deadline_us != INT64_MAX && dt > st.budget_us) st.late++;
+}
+
+int64_t Frame_Sched_deadline_us(void) {
+    return deadline_us;
+}
+
+bool Frame_Sched_should_defer(void) {
+    if (esp_timer_get_time() < deadline_us) {
+        defer_run = 0;
+        return false;
+    }
+    if (defer_run >= FRAME_SCHED_MAX_DEFER) {
+        // No aplazar para siempre: el trabajo se hace aunque el frame llegue tarde
+        defer_run = 0;
+        st.forced++;
+        return false;
+    }
+    defer_run++;
+    st.deferred++;
+    return true;
+}
+
+void Frame_Sched_set_divisor(uint8_t d) {
+    divisor = d;
+    isr_div_count = 0;
+    if (!refr_timer) return;
+    // Desactivado: LVGL vuelve a refrescar con su propio temporizador
+    lv_timer_set_period(refr_timer, d ? FSCHED_TIMER_PARKED : LV_DEF_REFR_PERIOD);
+    if (d) dirty = true;
+}
+
+void Frame_Sched_set_budget_pct(uint8_t pct) {
+    if (pct == 0 || pct > 100) return;
+    budget_pct = pct;
+}
+
+void Frame_Sched_set_idle_period(uint32_t period_ms) {
+    if (period_ms == idle_period_ms) return;
+    idle_period_ms = period_ms;
+    if (period_ms) return;
+    // Al salir la ranura vuelve a contar desde el VSYNC siguiente
+    isr_div_count = 0;
+    last_slots = isr_slots;
+    dirty = true;
+}
+
+void Frame_Sched_get_stats(Frame_sched_stats_t *stats) {
+    if (!stats) return;
+    *stats = st;
+    stats->kicks = isr_kicks;
+    stats->divisor = divisor;
+    stats->vsyncs = isr_vsyncs;
+    stats->slots = isr_slots;
+}
+
+void Frame_Sched_log_stats(void) {
+    Frame_sched_stats_t s;
+    Frame_Sched_get_stats(&s);
+    ESP_LOGI(TAG, "div %u, ranura %lu us (presupuesto %lu), frames %lu, renders %lu, perdidos %lu, "
+             "tarde %lu, aplazados %lu/%lu forzados, sin VSYNC %lu, reposo %lu (%lu despertares), "
+             "CPU/frame %lu us (máx %lu)",
+             s.divisor, (unsigned long)s.slot_us, (unsigned long)s.budget_us, (unsigned long)s.frames,
+             (unsigned long)s.renders, (unsigned long)s.dropped, (unsigned long)s.late,
+             (unsigned long)s.deferred, (unsigned long)s.forced, (unsigned long)s.vsync_timeouts,
+             (unsigned long)s.idle_frames, (unsigned long)s.kicks,
+             (unsigned long)s.frame_avg_us, (unsigned long)s.frame_max_us);
+}
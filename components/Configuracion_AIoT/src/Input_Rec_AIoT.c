@@ -0,0 +1,334 @@
+#include "Input_Rec_AIoT.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "Input_Rec";
+
+static lv_indev_read_cb_t source_cb = NULL;
+static Input_rec_mode_t mode = INREC_MODE_OFF;
+static Input_rec_stats_t st;
+
+// Anillo de la traza (PSRAM, reservado al primer uso)
+static Input_rec_entry_t *ring = NULL;
+static uint32_t head = 0;                   // Siguiente escritura
+static uint32_t count = 0;
+static bool last_stored_pressed = false;
+
+// Reproducción
+static struct {
+    uint32_t idx;                           // Entrada entregada a LVGL
+    uint32_t t_start;                       // lv_tick al empezar
+    uint32_t t_base;                        // t_ms de la primera entrada
+    bool started;
+    bool finished;                          // Traza entregada: falta la última latencia
+} rp;
+
+// Latencia del último flanco
+static struct {
+    bool pending;
+    bool dirty;                             // Hubo invalidación tras el flanco
+    int64_t t_edge_us;
+    uint32_t t_edge_ms;
+    Input_rec_entry_t *entry;               // Donde anotarla (NULL en vivo)
+} lat;
+static bool last_pressed = false;
+
+static inline uint32_t ewma(uint32_t avg, uint32_t x) {
+    return (uint32_t)((int32_t)avg + (((int32_t)x - (int32_t)avg) >> 3));
+}
+
+static inline Input_rec_entry_t *entry_at(uint32_t i) {
+    return &ring[(head + INREC_CAPACITY - count + i) % INREC_CAPACITY];
+}
+
+static bool ring_alloc(void) {
+    if (ring) return true;
+    ring = heap_caps_malloc(INREC_CAPACITY * sizeof(Input_rec_entry_t), MALLOC_CAP_SPIRAM);
+    if (!ring) ring = heap_caps_malloc(INREC_CAPACITY * sizeof(Input_rec_entry_t), MALLOC_CAP_DEFAULT);
+    if (!ring) ESP_LOGE(TAG, "Sin memoria para %d entradas", INREC_CAPACITY);
+    return ring != NULL;
+}
+
+// -----------------------------------------------------------------------------
+// Latencia flanco -> redibujo
+// -----------------------------------------------------------------------------
+
+static void latency_edge(Input_rec_entry_t *entry) {
+    if (lat.pending) st.no_redraw++;        // El anterior no llegó a redibujarse
+    lat.pending = true;
+    lat.dirty = false;
+    lat.t_edge_us = esp_timer_get_time();
+    lat.t_edge_ms = lv_tick_get();
+    lat.entry = entry;
+    if (entry) entry->latency_us = 0;
+}
+
+static void replay_report(void);
+
+static void disp_event_cb(lv_event_t *e) {
+    if (lat.pending) {
+        if (lv_event_get_code(e) == LV_EVENT_INVALIDATE_AREA) {
+            lat.dirty = true;
+            return;
+        }
+        // LV_EVENT_REFR_READY
+        if (lat.dirty) {
+            uint32_t dt = (uint32_t)(esp_timer_get_time() - lat.t_edge_us);
+            lat.pending = false;
+            if (lat.entry) lat.entry->latency_us = dt ? dt : 1;
+            st.events++;
+            st.latency_last_us = dt;
+            st.latency_avg_us = st.latency_avg_us ? ewma(st.latency_avg_us, dt) : dt;
+            if (dt > st.latency_max_us) st.latency_max_us = dt;
+        } else if (lv_tick_elaps(lat.t_edge_ms) >= INREC_LATENCY_TIMEOUT_MS) {
+            lat.pending = false;
+            st.no_redraw++;
+        }
+    }
+    // Fin de la reproducción cuando el último flanco ya tiene su medida
+    if (mode == INREC_MODE_REPLAY && rp.finished && !lat.pending) {
+        mode = INREC_MODE_OFF;
+        st.replays++;
+        replay_report();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Grabación / reproducción
+// -----------------------------------------------------------------------------
+
+static Input_rec_entry_t *record(const lv_indev_data_t *data) {
+    bool pressed = data->state == LV_INDEV_STATE_PRESSED;
+    // En reposo solo la primera lectura suelta
+    if (!pressed && !last_stored_pressed && count) return NULL;
+    last_stored_pressed = pressed;
+
+    Input_rec_entry_t *e = &ring[head];
+    head = (head + 1) % INREC_CAPACITY;
+    if (count < INREC_CAPACITY) count++;
+    else st.overwritten++;
+    *e = (Input_rec_entry_t){
+        .t_ms = lv_tick_get(),
+        .x = (int16_t)data->point.x,
+        .y = (int16_t)data->point.y,
+        .pressed = pressed,
+    };
+    return e;
+}
+
+static Input_rec_entry_t *replay(lv_indev_data_t *data) {
+    Input_rec_entry_t *cur = entry_at(rp.idx);
+    Input_rec_entry_t *edge = NULL;
+    if (!rp.started) {
+        rp.started = true;
+        edge = cur;
+    } else if (!rp.finished) {
+        uint32_t t = rp.t_base + lv_tick_elaps(rp.t_start);
+        // Avanza hasta el instante actual sin saltarse un flanco
+        while (rp.idx + 1 < count) {
+            Input_rec_entry_t *next = entry_at(rp.idx + 1);
+            if ((int32_t)(next->t_ms - t) > 0) break;
+            rp.idx++;
+            bool changed = next->pressed != cur->pressed;
+            cur = next;
+            if (changed) {
+                edge = cur;
+                break;
+            }
+        }
+        // Última entrada ya entregada: se suelta el puntero y se espera su redibujo
+        if (!edge && rp.idx + 1 >= count && (int32_t)(cur->t_ms - t) <= 0) rp.finished = true;
+    }
+    data->point.x = cur->x;
+    data->point.y = cur->y;
+    data->state = cur->pressed && !rp.finished ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    data->continue_reading = false;
+    return edge;
+}
+
+static void read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+    Input_rec_entry_t *entry = NULL;
+    if (mode == INREC_MODE_REPLAY) {
+        // El táctil real se vacía y se descarta
+        lv_indev_data_t discard = { 0 };
+        if (source_cb) source_cb(indev, &discard);
+        entry = replay(data);
+    } else {
+        if (source_cb) source_cb(indev, data);
+        if (mode == INREC_MODE_RECORD) entry = record(data);
+    }
+    bool pressed = data->state == LV_INDEV_STATE_PRESSED;
+    if (pressed != last_pressed) {
+        last_pressed = pressed;
+        latency_edge(entry);
+    }
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Resumen de la reproducción con los flancos anotados en la traza
+static void replay_report(void) {
+    uint32_t edges = 0, n = 0;
+    uint32_t *v = malloc((count ? count : 1) * sizeof(uint32_t));
+    bool prev = false;
+    for (uint32_t i = 0; i < count; i++) {
+        const Input_rec_entry_t *e = entry_at(i);
+        if (e->pressed != prev) {
+            edges++;
+            if (e->latency_us && v) v[n++] = e->latency_us;
+        }
+        prev = e->pressed;
+    }
+    if (!v || !n) {
+        ESP_LOGW(TAG, "Reproducción terminada: %lu flancos, ninguno redibujado", (unsigned long)edges);
+        free(v);
+        return;
+    }
+    qsort(v, n, sizeof(uint32_t), cmp_u32);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) sum += v[i];
+    ESP_LOGI(TAG, "Reproducción terminada: %lu flancos, %lu redibujados, toque -> redibujo "
+             "media %lu us, p50 %lu, p95 %lu, máx %lu",
+             (unsigned long)edges, (unsigned long)n, (unsigned long)(sum / n), (unsigned long)v[n / 2],
+             (unsigned long)v[(n * 95) / 100], (unsigned long)v[n - 1]);
+    free(v);
+}
+
+#if INREC_BOOT_MODE
+// Grabación de arranque: al terminar se vuelca (para el PC) y se reproduce
+static void boot_timer_cb(lv_timer_t *t) {
+    Input_Rec_AIoT_Stop();
+    Input_Rec_AIoT_Dump();
+    Input_Rec_AIoT_Replay();
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// API
+// -----------------------------------------------------------------------------
+
+void Input_Rec_AIoT_Init(lv_display_t *disp, lv_indev_t *indev, lv_indev_read_cb_t source) {
+    source_cb = source;
+    st.capacity = INREC_CAPACITY;
+    lv_indev_set_read_cb(indev, read_cb);
+    lv_display_add_event_cb(disp, disp_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_add_event_cb(disp, disp_event_cb, LV_EVENT_REFR_READY, NULL);
+#if INREC_BOOT_MODE
+    if (Input_Rec_AIoT_Start_Record()) {
+        lv_timer_t *t = lv_timer_create(boot_timer_cb, INREC_BOOT_RECORD_MS, NULL);
+        lv_timer_set_repeat_count(t, 1);
+    }
+#endif
+}
+
+bool Input_Rec_AIoT_Start_Record(void) {
+    if (!ring_alloc()) return false;
+    head = count = 0;
+    st.overwritten = 0;
+    last_stored_pressed = false;
+    lat.pending = false;
+    mode = INREC_MODE_RECORD;
+    ESP_LOGI(TAG, "Grabando (máx. %d entradas)", INREC_CAPACITY);
+    return true;
+}
+
+void Input_Rec_AIoT_Stop(void) {
+    if (mode == INREC_MODE_RECORD) {
+        ESP_LOGI(TAG, "Grabación terminada: %lu entradas", (unsigned long)count);
+    } else if (mode == INREC_MODE_REPLAY) {
+        ESP_LOGI(TAG, "Reproducción interrumpida en %lu/%lu", (unsigned long)rp.idx, (unsigned long)count);
+    }
+    mode = INREC_MODE_OFF;
+    lat.pending = false;
+}
+
+bool Input_Rec_AIoT_Replay(void) {
+    if (!count) return false;
+    for (uint32_t i = 0; i < count; i++) entry_at(i)->latency_us = 0;
+    rp.idx = 0;
+    rp.t_start = lv_tick_get();
+    rp.t_base = entry_at(0)->t_ms;
+    rp.started = false;
+    rp.finished = false;
+    lat.pending = false;
+    mode = INREC_MODE_REPLAY;
+    ESP_LOGI(TAG, "Reproduciendo %lu entradas (%lu ms)", (unsigned long)count,
+             (unsigned long)(entry_at(count - 1)->t_ms - rp.t_base));
+    return true;
+}
+
+bool Input_Rec_AIoT_Load(const Input_rec_entry_t *entries, size_t n) {
+    if (!entries || !n || !ring_alloc()) return false;
+    if (n > INREC_CAPACITY) {
+        ESP_LOGW(TAG, "Traza de %u entradas: se cargan las primeras %d", (unsigned)n, INREC_CAPACITY);
+        n = INREC_CAPACITY;
+    }
+    Input_Rec_AIoT_Stop();
+    memcpy(ring, entries, n * sizeof(Input_rec_entry_t));
+    head = (uint32_t)n % INREC_CAPACITY;
+    count = (uint32_t)n;
+    st.overwritten = 0;
+    return true;
+}
+
+bool Input_Rec_AIoT_Get(size_t i, Input_rec_entry_t *entry) {
+    if (i >= count || !entry) return false;
+    *entry = *entry_at((uint32_t)i);
+    return true;
+}
+
+int Input_Rec_AIoT_Format_Line(const Input_rec_entry_t *e, char *buf, size_t len) {
+    return snprintf(buf, len, "INREC,%lu,%d,%d,%u,%lu", (unsigned long)e->t_ms, e->x, e->y, e->pressed,
+                    (unsigned long)e->latency_us);
+}
+
+bool Input_Rec_AIoT_Parse_Line(const char *line, Input_rec_entry_t *entry) {
+    const char *p = line ? strstr(line, "INREC,") : NULL;
+    if (!p || !entry) return false;
+    unsigned long t, l = 0;
+    int x, y;
+    unsigned pr;
+    if (sscanf(p + 6, "%lu,%d,%d,%u,%lu", &t, &x, &y, &pr, &l) < 4) return false;
+    *entry = (Input_rec_entry_t){
+        .t_ms = (uint32_t)t, .x = (int16_t)x, .y = (int16_t)y, .pressed = pr != 0, .latency_us = (uint32_t)l,
+    };
+    return true;
+}
+
+void Input_Rec_AIoT_Dump(void) {
+    char line[64];
+    ESP_LOGI(TAG, "Traza: %lu entradas", (unsigned long)count);
+    for (uint32_t i = 0; i < count; i++) {
+        Input_Rec_AIoT_Format_Line(entry_at(i), line, sizeof(line));
+        ESP_LOGI(TAG, "%s", line);
+    }
+}
+
+Input_rec_mode_t Input_Rec_AIoT_Get_Mode(void) {
+    return mode;
+}
+
+void Input_Rec_AIoT_Get_Stats(Input_rec_stats_t *stats) {
+    if (!stats) return;
+    st.mode = (uint8_t)mode;
+    st.entries = count;
+    *stats = st;
+}
+
+void Input_Rec_AIoT_Log_Stats(void) {
+    static const char *names[] = { "paso directo", "grabando", "reproduciendo" };
+    Input_rec_stats_t s;
+    Input_Rec_AIoT_Get_Stats(&s);
+    ESP_LOGI(TAG, "%s, traza %lu/%lu (%lu pisadas), reproducciones %lu, toque -> redibujo: %lu flancos, "
+             "%lu sin redibujo, %lu us (media %lu, máx %lu)",
+             names[s.mode], (unsigned long)s.entries, (unsigned long)s.capacity, (unsigned long)s.overwritten,
+             (unsigned long)s.replays, (unsigned long)s.events, (unsigned long)s.no_redraw,
+             (unsigned long)s.latency_last_us, (unsigned long)s.latency_avg_us, (unsigned long)s.latency_max_us);
+}
@@ -0,0 +1,204 @@
+#include "Touch_Calib_AIoT.h"
+#include "xpt2046_lvgl9.h"
+#include "System_Defines_AIoT.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "lvgl.h"
+
+static const char *TAG = "Touch_Calib";
+
+#define TCAL_NVS_NAMESPACE      "touch_cal"
+#define TCAL_NVS_KEY            "cal"
+#define TCAL_NVS_VERSION        1
+#define TCAL_CROSS_PX           24
+
+// Lo que se guarda en NVS
+typedef struct {
+    uint8_t version;
+    Touch_calib_t cal;
+} tcal_saved_t;
+
+static const Touch_point_t targets[3] = {
+    { AIOT_LCD_H_RES / 10,     AIOT_LCD_V_RES / 10 },
+    { AIOT_LCD_H_RES * 9 / 10, AIOT_LCD_V_RES / 2 },
+    { AIOT_LCD_H_RES / 2,      AIOT_LCD_V_RES * 9 / 10 },
+};
+
+static lv_obj_t *overlay = NULL;
+static lv_obj_t *cross_h = NULL;
+static lv_obj_t *cross_v = NULL;
+static lv_obj_t *label = NULL;
+static lv_timer_t *timeout_timer = NULL;
+static uint8_t step = 0;
+static Touch_point_t measured[3];
+static int32_t acc_x = 0, acc_y = 0;
+static uint32_t acc_n = 0;
+
+// -----------------------------------------------------------------------------
+// NVS
+// -----------------------------------------------------------------------------
+
+static bool saved_load(Touch_calib_t *cal) {
+    nvs_handle_t h;
+    if (nvs_open(TCAL_NVS_NAMESPACE, NVS_READONLY, &h) != ESP_OK) return false;
+    tcal_saved_t tmp;
+    size_t len = sizeof(tmp);
+    bool ok = nvs_get_blob(h, TCAL_NVS_KEY, &tmp, &len) == ESP_OK && len == sizeof(tmp) &&
+              tmp.version == TCAL_NVS_VERSION;
+    nvs_close(h);
+    if (ok) *cal = tmp.cal;
+    return ok;
+}
+
+static void saved_store(const Touch_calib_t *cal) {
+    nvs_handle_t h;
+    if (nvs_open(TCAL_NVS_NAMESPACE, NVS_READWRITE, &h) != ESP_OK) {
+        ESP_LOGW(TAG, "NVS no disponible: calibración solo hasta reiniciar");
+        return;
+    }
+    tcal_saved_t tmp = { .version = TCAL_NVS_VERSION, .cal = *cal };
+    if (nvs_set_blob(h, TCAL_NVS_KEY, &tmp, sizeof(tmp)) == ESP_OK) nvs_commit(h);
+    nvs_close(h);
+}
+
+// -----------------------------------------------------------------------------
+// Proceso en pantalla
+// -----------------------------------------------------------------------------
+
+static void show_step(void) {
+    const Touch_point_t *t = &targets[step];
+    lv_obj_set_pos(cross_h, t->x - TCAL_CROSS_PX / 2, t->y - 1);
+    lv_obj_set_pos(cross_v, t->x - 1, t->y - TCAL_CROSS_PX / 2);
+    lv_label_set_text_fmt(label, "Calibración del táctil (%u/3)\nToque el centro de la cruz", step + 1);
+    acc_x = acc_y = 0;
+    acc_n = 0;
+}
+
+static void close_overlay(void) {
+    if (timeout_timer) lv_timer_delete(timeout_timer);
+    timeout_timer = NULL;
+    // Se cierra desde su propio evento RELEASED: borrado diferido
+    if (overlay) lv_obj_delete_async(overlay);
+    overlay = cross_h = cross_v = label = NULL;
+}
+
+static void finish(void) {
+    Touch_calib_t cal;
+    if (!Touch_calib_compute(&cal, measured, targets)) {
+        // Puntos casi alineados o iguales: repetir desde el primero
+        ESP_LOGW(TAG, "Puntos no válidos, se repite la calibración");
+        step = 0;
+        show_step();
+        return;
+    }
+    xpt2046_set_calibration(&cal);
+    saved_store(&cal);
+    ESP_LOGI(TAG, "Calibración guardada: [%ld %ld %ld | %ld %ld %ld] Q16",
+             (long)cal.a, (long)cal.b, (long)cal.c, (long)cal.d, (long)cal.e, (long)cal.f);
+    close_overlay();
+}
+
+static void overlay_event_cb(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    Touch_point_t raw;
+    if (code == LV_EVENT_PRESSED) {
+        acc_x = acc_y = 0;
+        acc_n = 0;
+        if (timeout_timer) lv_timer_reset(timeout_timer);
+    } else if (code == LV_EVENT_PRESSING) {
+        if (xpt2046_get_raw_point(&raw)) {
+            acc_x += raw.x;
+            acc_y += raw.y;
+            acc_n++;
+        }
+    } else if (code == LV_EVENT_RELEASED) {
+        if (acc_n < TCAL_MIN_READS) return;     // Toque demasiado corto: repetir la cruz
+        measured[step].x = acc_x / (int32_t)acc_n;
+        measured[step].y = acc_y / (int32_t)acc_n;
+        if (++step < 3) show_step();
+        else finish();
+    }
+}
+
+static void timeout_cb(lv_timer_t *t) {
+    ESP_LOGW(TAG, "Calibración cancelada (sin toques)");
+    close_overlay();
+}
+
+static void hold_event_cb(lv_event_t *e) {
+    static uint32_t t_press = 0;
+    static bool fired = false;
+    if (lv_event_get_code(e) == LV_EVENT_PRESSED) {
+        t_press = lv_tick_get();
+        fired = false;
+    } else if (!fired && lv_tick_elaps(t_press) >= TCAL_HOLD_MS) {
+        fired = true;
+        Touch_Calib_AIoT_Start();
+    }
+}
+
+static lv_obj_t *cross_line(lv_obj_t *parent, int32_t w, int32_t h) {
+    lv_obj_t *o = lv_obj_create(parent);
+    lv_obj_remove_style_all(o);
+    lv_obj_set_size(o, w, h);
+    lv_obj_set_style_bg_color(o, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(o, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_remove_flag(o, LV_OBJ_FLAG_CLICKABLE);
+    return o;
+}
+
+// -----------------------------------------------------------------------------
+// API
+// -----------------------------------------------------------------------------
+
+bool Touch_Calib_AIoT_Init(void) {
+    Touch_calib_t cal;
+    if (!saved_load(&cal)) {
+        ESP_LOGI(TAG, "Sin calibración en NVS: conversión fija");
+        return false;
+    }
+    xpt2046_set_calibration(&cal);
+    ESP_LOGI(TAG, "Calibración cargada de NVS");
+    return true;
+}
+
+void Touch_Calib_AIoT_Start(void) {
+    if (overlay) return;
+    overlay = lv_obj_create(lv_layer_top());
+    lv_obj_remove_style_all(overlay);
+    lv_obj_set_size(overlay, AIOT_LCD_H_RES, AIOT_LCD_V_RES);
+    lv_obj_set_style_bg_color(overlay, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(overlay, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_add_flag(overlay, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_remove_flag(overlay, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_event_cb(overlay, overlay_event_cb, LV_EVENT_PRESSED, NULL);
+    lv_obj_add_event_cb(overlay, overlay_event_cb, LV_EVENT_PRESSING, NULL);
+    lv_obj_add_event_cb(overlay, overlay_event_cb, LV_EVENT_RELEASED, NULL);
+
+    label = lv_label_create(overlay);
+    lv_obj_set_style_text_color(label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+    lv_obj_align(label, LV_ALIGN_CENTER, 0, -20);
+    cross_h = cross_line(overlay, TCAL_CROSS_PX, 2);
+    cross_v = cross_line(overlay, 2, TCAL_CROSS_PX);
+
+    timeout_timer = lv_timer_create(timeout_cb, TCAL_TIMEOUT_MS, NULL);
+    // Una sola vuelta y sin borrado automático: siempre lo borra close_overlay
+    lv_timer_set_repeat_count(timeout_timer, 1);
+    lv_timer_set_auto_delete(timeout_timer, false);
+
+    step = 0;
+    show_step();
+    ESP_LOGI(TAG, "Calibración iniciada");
+}
+
+void Touch_Calib_AIoT_Attach_Hold(lv_obj_t *obj) {
+    if (!obj) return;
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(obj, hold_event_cb, LV_EVENT_PRESSED, NULL);
+    lv_obj_add_event_cb(obj, hold_event_cb, LV_EVENT_LONG_PRESSED_REPEAT, NULL);
+}
+
+bool Touch_Calib_AIoT_Is_Running(void) {
+    return overlay != NULL;
+}
@@ -0,0 +1,147 @@
+#include "Touch_Filter_AIoT.h"
+#include <string.h>
+
+#define TFILT_Q             4               // Estado del IIR en Q4
+#define TFILT_MIN_DET       4096            // Determinante mínimo (cuentas^2) para calibrar
+
+// -----------------------------------------------------------------------------
+// Filtro
+// -----------------------------------------------------------------------------
+
+void Touch_filter_init(Touch_filter_t *flt, const Touch_filter_config_t *cfg) {
+    Touch_filter_config_t def = TOUCH_FILTER_CONFIG_DEFAULT();
+    memset(flt, 0, sizeof(*flt));
+    flt->cfg = cfg ? *cfg : def;
+}
+
+void Touch_filter_reset(Touch_filter_t *flt) {
+    flt->tracking = false;
+}
+
+uint16_t Touch_filter_pressure(uint16_t z1, uint16_t z2) {
+    // Z1 sube y Z2 baja al apretar; sin contacto Z1 = 0 y Z2 = 4095
+    int32_t z = (int32_t)z1 + TFILT_ADC_MAX - (int32_t)z2;
+    if (z < 0) z = 0;
+    if (z > TFILT_ADC_MAX) z = TFILT_ADC_MAX;
+    return (uint16_t)z;
+}
+
+// Ordena en el sitio (N <= 8: inserción) y devuelve la mediana y el rango intercuartil
+static uint16_t median_spread(uint16_t *v, uint8_t n, uint16_t *spread) {
+    for (uint8_t i = 1; i < n; i++) {
+        uint16_t key = v[i];
+        int8_t j = (int8_t)(i - 1);
+        while (j >= 0 && v[j] > key) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = key;
+    }
+    *spread = (uint16_t)(v[n - 1 - n / 4] - v[n / 4]);
+    return v[n / 2];
+}
+
+static int32_t iir_step(const Touch_filter_config_t *cfg, int32_t state, int32_t x) {
+    int32_t target = x << TFILT_Q;
+    int32_t diff = target - state;
+    int32_t jump = (diff < 0 ? -diff : diff) >> TFILT_Q;
+    int32_t alpha = cfg->alpha_min_q8 + jump * cfg->alpha_gain_q8;
+    if (alpha >= 256) return target;
+    return state + ((diff * alpha) >> 8);
+}
+
+bool Touch_filter_process(Touch_filter_t *flt, const Touch_raw_t *raw, Touch_point_t *out) {
+    flt->stats.samples++;
+    uint8_t n = raw->n;
+    if (n == 0 || n > TFILT_MAX_SAMPLES) return false;
+
+    uint16_t threshold = flt->cfg.z_threshold;
+    if (flt->tracking) threshold = (uint16_t)(threshold - threshold / 4);
+    if (Touch_filter_pressure(raw->z1, raw->z2) < threshold) {
+        flt->stats.low_pressure++;
+        return false;
+    }
+
+    uint16_t xs[TFILT_MAX_SAMPLES], ys[TFILT_MAX_SAMPLES];
+    memcpy(xs, raw->x, n * sizeof(uint16_t));
+    memcpy(ys, raw->y, n * sizeof(uint16_t));
+    uint16_t sx, sy;
+    int32_t mx = median_spread(xs, n, &sx);
+    int32_t my = median_spread(ys, n, &sy);
+    if (sx > flt->cfg.spread_max || sy > flt->cfg.spread_max) {
+        flt->stats.noisy++;
+        return false;
+    }
+
+    if (!flt->tracking) {
+        flt->fx = mx << TFILT_Q;
+        flt->fy = my << TFILT_Q;
+        flt->tracking = true;
+    } else {
+        flt->fx = iir_step(&flt->cfg, flt->fx, mx);
+        flt->fy = iir_step(&flt->cfg, flt->fy, my);
+    }
+    // Redondeo al entero más cercano
+    out->x = (flt->fx + (1 << (TFILT_Q - 1))) >> TFILT_Q;
+    out->y = (flt->fy + (1 << (TFILT_Q - 1))) >> TFILT_Q;
+    flt->stats.accepted++;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Calibración
+// -----------------------------------------------------------------------------
+
+void Touch_calib_default(Touch_calib_t *cal, int32_t h_res, int32_t v_res) {
+    // X = (x - 200) * h_res / 3700, Y = (y - 240) * v_res / 3560
+    cal->a = (int32_t)(((int64_t)h_res << 16) / 3700);
+    cal->b = 0;
+    cal->c = -200 * cal->a;
+    cal->d = 0;
+    cal->e = (int32_t)(((int64_t)v_res << 16) / 3560);
+    cal->f = -240 * cal->e;
+}
+
+static int32_t div_round(int64_t num, int64_t den) {
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    return (int32_t)(num >= 0 ? (num + den / 2) / den : (num - den / 2) / den);
+}
+
+bool Touch_calib_compute(Touch_calib_t *cal, const Touch_point_t raw[3], const Touch_point_t screen[3]) {
+    // Sistema de 3 ecuaciones por eje (regla de Cramer) sobre los puntos
+    // relativos al tercero; los productos de cuentas por píxeles caben en 64 bits
+    int64_t x0 = raw[0].x - raw[2].x, y0 = raw[0].y - raw[2].y;
+    int64_t x1 = raw[1].x - raw[2].x, y1 = raw[1].y - raw[2].y;
+    int64_t det = x0 * y1 - x1 * y0;
+    if (det > -TFILT_MIN_DET && det < TFILT_MIN_DET) return false;
+
+    int64_t X0 = screen[0].x - screen[2].x, X1 = screen[1].x - screen[2].x;
+    int64_t Y0 = screen[0].y - screen[2].y, Y1 = screen[1].y - screen[2].y;
+
+    Touch_calib_t m;
+    m.a = div_round((X0 * y1 - X1 * y0) << 16, det);
+    m.b = div_round((x0 * X1 - x1 * X0) << 16, det);
+    m.d = div_round((Y0 * y1 - Y1 * y0) << 16, det);
+    m.e = div_round((x0 * Y1 - x1 * Y0) << 16, det);
+    // El tercer punto fija la traslación
+    m.c = (int32_t)(((int64_t)screen[2].x << 16) - (int64_t)m.a * raw[2].x - (int64_t)m.b * raw[2].y);
+    m.f = (int32_t)(((int64_t)screen[2].y << 16) - (int64_t)m.d * raw[2].x - (int64_t)m.e * raw[2].y);
+    *cal = m;
+    return true;
+}
+
+Touch_point_t Touch_calib_apply(const Touch_calib_t *cal, Touch_point_t raw, int32_t h_res, int32_t v_res) {
+    const int64_t half = 1 << 15;
+    Touch_point_t p = {
+        .x = (int32_t)(((int64_t)cal->a * raw.x + (int64_t)cal->b * raw.y + cal->c + half) >> 16),
+        .y = (int32_t)(((int64_t)cal->d * raw.x + (int64_t)cal->e * raw.y + cal->f + half) >> 16),
+    };
+    if (p.x < 0) p.x = 0;
+    if (p.x > h_res - 1) p.x = h_res - 1;
+    if (p.y < 0) p.y = 0;
+    if (p.y > v_res - 1) p.y = v_res - 1;
+    return p;
+}
@@ -1,108 +1,355 @@
 #include "xpt2046_lvgl9.h"
+#include "TaskMonitor_AIoT.h"
 #include "driver/gpio.h"
+#include "esp_attr.h"
 #include "esp_log.h"
-#include "esp_rom_sys.h" // Para esp_rom_delay_us
+#include "esp_heap_caps.h"
+#include <stdio.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
-// static const char *TAG = "XPT2046";
+static const char *TAG = "XPT2046";
 
 static spi_device_handle_t touch_spi_handle;
 static int touch_irq_pin;
 
+// Control: S=1, A2-A0, 12 bits, diferencial, PD=00 (PENIRQ activo entre conversiones)
+#define CMD_Z1_READ 0xB0
+#define CMD_Z2_READ 0xC0
 #define CMD_X_READ  0xD0
 #define CMD_Y_READ  0x90
-#define  CLOCK_SPEED_HZ (4 * 1000 * 1000) // 1 MHz
+#define  CLOCK_SPEED_HZ (4 * 1000 * 1000) // 4 MHz
 
 // Resolución
-#define PCLK_HZ (7 * 1000 * 1000)  // 7 MHz
 #define H_RES 480
 #define V_RES 272
 
-static int16_t spi_transfer_cmd(uint8_t cmd)
-{
-    uint8_t data_out[3] = {cmd, 0x00, 0x00};
-    uint8_t data_in[3] = {0, 0, 0};
-
-    spi_transaction_t t = {
-        .length = 24,
-        .tx_buffer = data_out,
-        .rx_buffer = data_in,
-        .flags = 0
+// Transacción encadenada: cada byte de control viaja en el byte bajo de la
+// lectura anterior (16 relojes por conversión) y un byte final recoge la última
+#define BATCH_CONV      (2 + 2 * XPT2046_SAMPLES)
+#define BATCH_BYTES     (2 * BATCH_CONV + 1)
+#define BATCH_BUF_LEN   ((BATCH_BYTES + 3) & ~3)    // Múltiplo de palabra para el DMA
+#define BATCH_TIMEOUT_MS 20
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t raw_x;                          // Cuentas del ADC filtradas, sin calibrar
+    int16_t raw_y;
+    bool pressed;
+    int64_t t_irq_us;                       // Solo en el primer punto de la pulsación
+} touch_event_t;
+
+// Cola SPSC: tarea de muestreo -> tarea de UI
+static touch_event_t queue[XPT2046_QUEUE_LEN];
+static atomic_uint q_head;                  // Escrito solo por la tarea de muestreo
+static atomic_uint q_tail;                  // Escrito solo por la tarea de UI
+
+static TaskHandle_t touch_task_handle = NULL;
+static uint8_t *batch_tx = NULL;
+static uint8_t *batch_rx = NULL;
+static spi_transaction_t batch_trans;      // El driver la guarda hasta devolverla
+static xpt2046_stats_t st;
+
+// Procesado (tarea de muestreo) y calibración (la cambia la tarea de UI)
+static Touch_filter_t filter;
+static Touch_calib_t calib;
+static portMUX_TYPE calib_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Última posición sin calibrar entregada a LVGL (tarea de UI)
+static Touch_point_t last_raw;
+static bool have_raw = false;
+
+// Estado compartido con el ISR
+static volatile xpt2046_irq_hook_t irq_hook = NULL;
+static volatile bool sampling = false;
+static volatile int64_t isr_t_irq = 0;
+static volatile uint32_t isr_irqs = 0;
+
+static inline uint32_t ewma(uint32_t avg, uint32_t x) {
+    return (uint32_t)((int32_t)avg + (((int32_t)x - (int32_t)avg) >> 3));
+}
+
+static IRAM_ATTR void pen_irq_isr(void *arg) {
+    BaseType_t woken = pdFALSE;
+    isr_irqs++;
+    // Las conversiones también mueven PENIRQ: solo cuenta el primer flanco
+    if (!sampling) isr_t_irq = esp_timer_get_time();
+    if (touch_task_handle) vTaskNotifyGiveFromISR(touch_task_handle, &woken);
+    xpt2046_irq_hook_t hook = irq_hook;
+    if (hook && hook()) woken = pdTRUE;
+    if (woken == pdTRUE) portYIELD_FROM_ISR();
+}
+
+// -----------------------------------------------------------------------------
+// Cola
+// -----------------------------------------------------------------------------
+
+static bool queue_push(const touch_event_t *ev) {
+    unsigned head = atomic_load_explicit(&q_head, memory_order_relaxed);
+    unsigned used = head - atomic_load_explicit(&q_tail, memory_order_acquire);
+    if (used >= XPT2046_QUEUE_LEN) return false;
+    queue[head & (XPT2046_QUEUE_LEN - 1)] = *ev;
+    atomic_store_explicit(&q_head, head + 1, memory_order_release);
+    if (used + 1 > st.queue_high_water) st.queue_high_water = used + 1;
+    return true;
+}
+
+static bool queue_pop(touch_event_t *ev) {
+    unsigned tail = atomic_load_explicit(&q_tail, memory_order_relaxed);
+    if (tail == atomic_load_explicit(&q_head, memory_order_acquire)) return false;
+    *ev = queue[tail & (XPT2046_QUEUE_LEN - 1)];
+    atomic_store_explicit(&q_tail, tail + 1, memory_order_release);
+    return true;
+}
+
+static bool queue_empty(void) {
+    return atomic_load_explicit(&q_tail, memory_order_relaxed) ==
+           atomic_load_explicit(&q_head, memory_order_acquire);
+}
+
+// -----------------------------------------------------------------------------
+// Muestreo
+// -----------------------------------------------------------------------------
+
+// Orden de las conversiones: Z1, Z2, X x N, Y x N
+static void batch_prepare(void) {
+    _Static_assert(XPT2046_SAMPLES <= TFILT_MAX_SAMPLES, "Demasiadas conversiones por muestra");
+    memset(batch_tx, 0, BATCH_BUF_LEN);
+    batch_tx[0] = CMD_Z1_READ;
+    batch_tx[2] = CMD_Z2_READ;
+    for (int i = 0; i < XPT2046_SAMPLES; i++) {
+        batch_tx[2 * (2 + i)] = CMD_X_READ;
+        batch_tx[2 * (2 + XPT2046_SAMPLES + i)] = CMD_Y_READ;
+    }
+}
+
+static inline uint16_t batch_value(int conv) {
+    return (uint16_t)(((batch_rx[2 * conv + 1] << 8) | batch_rx[2 * conv + 2]) >> 3);
+}
+
+// Una transacción por DMA con todas las conversiones; la tarea duerme mientras
+static bool batch_read(Touch_raw_t *raw) {
+    batch_trans = (spi_transaction_t){
+        .length = BATCH_BYTES * 8,
+        .tx_buffer = batch_tx,
+        .rx_buffer = batch_rx,
     };
-    esp_err_t ret = spi_device_polling_transmit(touch_spi_handle, &t);
-    if (ret != ESP_OK) return -1;
-    int16_t val = ((data_in[1] << 8) | data_in[2]) >> 3;
-    return val;
+    spi_transaction_t *done = NULL;
+    int64_t t0 = esp_timer_get_time();
+    if (spi_device_queue_trans(touch_spi_handle, &batch_trans, pdMS_TO_TICKS(BATCH_TIMEOUT_MS)) != ESP_OK) {
+        st.spi_errors++;
+        return false;
+    }
+    if (spi_device_get_trans_result(touch_spi_handle, &done, pdMS_TO_TICKS(BATCH_TIMEOUT_MS)) != ESP_OK) {
+        // Sigue en la cola (bus ocupado por otro dispositivo): se espera a que
+        // termine para no reutilizar batch_trans ni batch_rx con el DMA en curso
+        spi_device_get_trans_result(touch_spi_handle, &done, portMAX_DELAY);
+        st.spi_errors++;
+        return false;
+    }
+    uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+    st.batches++;
+    st.batch_avg_us = st.batch_avg_us ? ewma(st.batch_avg_us, dt) : dt;
+    if (dt > st.batch_max_us) st.batch_max_us = dt;
+
+    raw->n = XPT2046_SAMPLES;
+    raw->z1 = batch_value(0);
+    raw->z2 = batch_value(1);
+    for (int i = 0; i < XPT2046_SAMPLES; i++) {
+        raw->x[i] = batch_value(2 + i);
+        raw->y[i] = batch_value(2 + XPT2046_SAMPLES + i);
+    }
+#if XPT2046_TRACE
+    // Una línea por muestra: "XPT,z1,z2,x0..xN-1,y0..yN-1" (tools/ui_host/touch_replay)
+    char line[16 + 2 * TFILT_MAX_SAMPLES * 6];
+    int len = snprintf(line, sizeof(line), "XPT,%u,%u", raw->z1, raw->z2);
+    for (int i = 0; i < XPT2046_SAMPLES; i++) len += snprintf(line + len, sizeof(line) - len, ",%u", raw->x[i]);
+    for (int i = 0; i < XPT2046_SAMPLES; i++) len += snprintf(line + len, sizeof(line) - len, ",%u", raw->y[i]);
+    ESP_LOGI(TAG, "%s", line);
+#endif
+    return true;
+}
+
+static void touch_task(void *arg) {
+    int mon_id = TaskMon_register("touch", 0);
+    for (;;) {
+        // Dormir hasta el flanco de PENIRQ (salvo que el lápiz ya esté abajo)
+        if (gpio_get_level(touch_irq_pin) != 0) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        int64_t t_irq = isr_t_irq;
+        sampling = true;
+
+        touch_event_t ev = { .pressed = true, .t_irq_us = t_irq ? t_irq : esp_timer_get_time() };
+        bool down = false;
+        while (gpio_get_level(touch_irq_pin) == 0) {
+            TaskMon_begin(mon_id);
+            Touch_raw_t raw;
+            Touch_point_t pos;
+            // Muestra válida solo si el lápiz sigue abajo al terminar (rebote / levantado a mitad)
+            if (batch_read(&raw)) {
+                if (gpio_get_level(touch_irq_pin) != 0) {
+                    st.rejected++;
+                } else if (Touch_filter_process(&filter, &raw, &pos)) {
+                    taskENTER_CRITICAL(&calib_lock);
+                    Touch_calib_t cal = calib;
+                    taskEXIT_CRITICAL(&calib_lock);
+                    Touch_point_t scr = Touch_calib_apply(&cal, pos, H_RES, V_RES);
+                    ev.x = (int16_t)scr.x;
+                    ev.y = (int16_t)scr.y;
+                    ev.raw_x = (int16_t)pos.x;
+                    ev.raw_y = (int16_t)pos.y;
+                    if (queue_push(&ev)) {
+                        st.points++;
+                        ev.t_irq_us = 0;
+                        down = true;
+                    } else {
+                        st.dropped++;
+                    }
+                }
+            }
+            TaskMon_end(mon_id);
+            vTaskDelay(pdMS_TO_TICKS(XPT2046_SAMPLE_PERIOD_MS));
+        }
+
+        Touch_filter_reset(&filter);
+#if XPT2046_TRACE
+        ESP_LOGI(TAG, "XPT,UP");
+#endif
+        if (down) {
+            // La liberación no se pierde: esperar hueco en la cola
+            ev.pressed = false;
+            ev.t_irq_us = 0;
+            while (!queue_push(&ev)) vTaskDelay(1);
+            st.strokes++;
+        }
+        sampling = false;
+        isr_t_irq = 0;
+        // Flancos generados por las propias conversiones
+        ulTaskNotifyTake(pdTRUE, 0);
+    }
 }
 
-void xpt2046_init_driver(spi_host_device_t host, int cs_pin, int irq_pin) 
+// -----------------------------------------------------------------------------
+// API
+// -----------------------------------------------------------------------------
+
+void xpt2046_init_driver(spi_host_device_t host, int cs_pin, int irq_pin)
 {
     touch_irq_pin = irq_pin;
     gpio_config_t io_conf = {};
-    io_conf.intr_type = GPIO_INTR_DISABLE;
+    io_conf.intr_type = GPIO_INTR_NEGEDGE;
     io_conf.mode = GPIO_MODE_INPUT;
     io_conf.pin_bit_mask = (1ULL << irq_pin);
-    io_conf.pull_up_en = 1; 
+    io_conf.pull_up_en = 1;
     gpio_config(&io_conf);
 
     spi_device_interface_config_t devcfg = {
-        .clock_speed_hz = CLOCK_SPEED_HZ, 
+        .clock_speed_hz = CLOCK_SPEED_HZ,
         .mode = 0,
         .spics_io_num = cs_pin,
         .queue_size = 1,
     };
     ESP_ERROR_CHECK(spi_bus_add_device(host, &devcfg, &touch_spi_handle));
-}
 
-long map(long x, long in_min, long in_max, long out_min, long out_max) {
-  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+    batch_tx = heap_caps_calloc(1, BATCH_BUF_LEN, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    batch_rx = heap_caps_calloc(1, BATCH_BUF_LEN, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!batch_tx || !batch_rx) {
+        ESP_LOGE(TAG, "Sin memoria DMA para el táctil");
+        return;
+    }
+    batch_prepare();
+    Touch_filter_init(&filter, NULL);
+    Touch_calib_default(&calib, H_RES, V_RES);
+
+    if (xTaskCreatePinnedToCore(touch_task, "touch", XPT2046_TASK_STACK, NULL,
+                                XPT2046_TASK_PRIO, &touch_task_handle, XPT2046_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "No se pudo crear la tarea del táctil");
+        return;
+    }
+
+    esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "Sin servicio de ISR GPIO (%s)", esp_err_to_name(err));
+        return;
+    }
+    ESP_ERROR_CHECK(gpio_isr_handler_add((gpio_num_t)irq_pin, pen_irq_isr, NULL));
+    ESP_LOGI(TAG, "Táctil por IRQ: %d conversiones por transacción DMA (%d bytes)", BATCH_CONV, BATCH_BYTES);
 }
 
-void xpt2046_read_cb_lvgl9(lv_indev_t * indev, lv_indev_data_t * data)
-{
-    static int64_t t_press_us = 0;
-    static bool pending = false;
+void xpt2046_set_irq_hook(xpt2046_irq_hook_t hook) {
+    irq_hook = hook;
+}
 
-    if (gpio_get_level(touch_irq_pin) == 0) {
+void xpt2046_set_calibration(const Touch_calib_t *cal) {
+    if (!cal) return;
+    taskENTER_CRITICAL(&calib_lock);
+    calib = *cal;
+    taskEXIT_CRITICAL(&calib_lock);
+}
 
-        int64_t now = esp_timer_get_time();
+void xpt2046_get_calibration(Touch_calib_t *cal) {
+    if (!cal) return;
+    taskENTER_CRITICAL(&calib_lock);
+    *cal = calib;
+    taskEXIT_CRITICAL(&calib_lock);
+}
 
-        // Debounce no bloqueante: exige presión estable ~2ms
-        if (!pending) {
-            pending = true;
-            t_press_us = now;
-            data->state = LV_INDEV_STATE_RELEASED;
-            return;
-        }
-        if ((now - t_press_us) < 2000) {
-            data->state = LV_INDEV_STATE_RELEASED;
-            return;
-        }
+bool xpt2046_get_raw_point(Touch_point_t *raw) {
+    if (!have_raw || !raw) return false;
+    *raw = last_raw;
+    return true;
+}
 
-        // Ya estable -> leer y promediar
-        int32_t avg_x = 0, avg_y = 0;
-        const int samples = 4;
+void xpt2046_read_cb_lvgl9(lv_indev_t * indev, lv_indev_data_t * data)
+{
+    // Sin evento nuevo se repite el último estado (LVGL lo necesita para arrastres)
+    static lv_point_t last_point = { 0, 0 };
+    static bool last_pressed = false;
 
-        for (int i = 0; i < samples; i++) {
-            avg_x += spi_transfer_cmd(CMD_X_READ);
-            avg_y += spi_transfer_cmd(CMD_Y_READ);
+    touch_event_t ev;
+    if (queue_pop(&ev)) {
+        if (ev.pressed) {
+            last_point.x = ev.x;
+            last_point.y = ev.y;
+            last_raw.x = ev.raw_x;
+            last_raw.y = ev.raw_y;
+            have_raw = true;
         }
+        last_pressed = ev.pressed;
+        if (ev.t_irq_us) {
+            uint32_t dt = (uint32_t)(esp_timer_get_time() - ev.t_irq_us);
+            st.latency_last_us = dt;
+            st.latency_avg_us = st.latency_avg_us ? ewma(st.latency_avg_us, dt) : dt;
+            if (dt > st.latency_max_us) st.latency_max_us = dt;
+        }
+        // Una pulsación corta (punto + liberación) no se funde en una sola lectura
+        data->continue_reading = !queue_empty();
+    }
 
-        int32_t cal_x = map(avg_x / samples, 200, 3900, 0, H_RES);
-        int32_t cal_y = map(avg_y / samples, 240, 3800, 0, V_RES);
-
-        if (cal_x < 0) cal_x = 0;
-        if (cal_x > H_RES-1) cal_x = H_RES-1;
-        if (cal_y < 0) cal_y = 0;
-        if (cal_y > V_RES-1) cal_y = V_RES-1;
+    data->point = last_point;
+    data->state = last_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
 
-        data->point.x = cal_x;
-        data->point.y = cal_y;
-        data->state = LV_INDEV_STATE_PRESSED;
-        return;
-    }
+void xpt2046_get_stats(xpt2046_stats_t *stats) {
+    if (!stats) return;
+    *stats = st;
+    stats->irqs = isr_irqs;
+    stats->filter = filter.stats;
+}
 
-    pending = false;
-    data->state = LV_INDEV_STATE_RELEASED;
-}
\ No newline at end of file
+void xpt2046_log_stats(void) {
+    xpt2046_stats_t s;
+    xpt2046_get_stats(&s);
+    ESP_LOGI(TAG, "IRQ %lu, pulsaciones %lu, muestras %lu (SPI %lu us, máx %lu), puntos %lu, "
+             "descartados %lu, rechazados %lu (presión %lu, ruido %lu), errores SPI %lu, cola máx %lu, "
+             "latencia %lu us (media %lu, máx %lu)",
+             (unsigned long)s.irqs, (unsigned long)s.strokes, (unsigned long)s.batches,
+             (unsigned long)s.batch_avg_us, (unsigned long)s.batch_max_us, (unsigned long)s.points,
+             (unsigned long)s.dropped, (unsigned long)s.rejected, (unsigned long)s.filter.low_pressure,
+             (unsigned long)s.filter.noisy, (unsigned long)s.spi_errors,
+             (unsigned long)s.queue_high_water, (unsigned long)s.latency_last_us,
+             (unsigned long)s.latency_avg_us, (unsigned long)s.latency_max_us);
+}
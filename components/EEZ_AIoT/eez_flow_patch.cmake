@@ -0,0 +1,67 @@
+# File: components/EEZ_AIoT/eez_flow_patch.cmake
+# Description: Builds ui/eez-flow.cpp with sections replaced by the src/eez_flow_*.inc files.
+# Standards: CMake >= 3.16 (included by this component and by tools/ui_host)
+#
+# ui/ is regenerated by EEZ Studio, so the file is never edited in place: a
+# copy with the sections swapped is written to the build directory and
+# compiled instead. Regenerating the UI re-runs the patch. If EEZ Studio
+# changes the markers of a section, the original code of that section is
+# built and a warning is printed.
+#
+#   flow/expression.cpp -> src/eez_flow_eval.inc   (pre-decoded evaluator)
+#   flow/queue.cpp      -> src/eez_flow_queue.inc  (flat execution queue)
+#   start()             -> calls evalStart() after initGlobalVariables()
+#                          (without it the evaluator stays interpreter only)
+
+set(EEZ_AIOT_DIR "${CMAKE_CURRENT_LIST_DIR}")
+
+# Replaces in text_var the section that starts at the "// <section>" banner
+# and ends at the "// <next>" banner with an #include of inc
+function(eez_flow_swap_section text_var section next inc)
+    set(sep "// -----------------------------------------------------------------------------\n")
+    set(text "${${text_var}}")
+    string(FIND "${text}" "${sep}// ${section}\n${sep}" begin)
+    string(FIND "${text}" "${sep}// ${next}\n${sep}" end)
+    if(begin EQUAL -1 OR end EQUAL -1 OR end LESS begin)
+        message(WARNING "eez-flow.cpp: ${section} section not found, building the original code")
+        return()
+    endif()
+    string(SUBSTRING "${text}" 0 ${begin} head)
+    string(SUBSTRING "${text}" ${end} -1 tail)
+    set(${text_var} "${head}#include \"${inc}\"\n${tail}" PARENT_SCOPE)
+endfunction()
+
+# Inserts line after the first occurrence of anchor in text_var
+function(eez_flow_insert_after text_var anchor line)
+    set(text "${${text_var}}")
+    string(FIND "${text}" "${anchor}" pos)
+    if(pos EQUAL -1)
+        message(WARNING "eez-flow.cpp: anchor for \"${line}\" not found, line not inserted")
+        return()
+    endif()
+    string(LENGTH "${anchor}" len)
+    math(EXPR pos "${pos} + ${len}")
+    string(SUBSTRING "${text}" 0 ${pos} head)
+    string(SUBSTRING "${text}" ${pos} -1 tail)
+    set(${text_var} "${head}${line}\n${tail}" PARENT_SCOPE)
+endfunction()
+
+# Sets out_var to the eez-flow.cpp to compile
+function(eez_flow_patch out_var)
+    set(src "${EEZ_AIOT_DIR}/ui/eez-flow.cpp")
+    set(out "${CMAKE_CURRENT_BINARY_DIR}/eez_flow/eez-flow.cpp")
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${src}")
+
+    file(READ "${src}" text)
+    eez_flow_swap_section(text "flow/expression.cpp" "flow/flow.cpp" "eez_flow_eval.inc")
+    eez_flow_swap_section(text "flow/queue.cpp" "flow/watch_list.cpp" "eez_flow_queue.inc")
+    # The evaluator rebuilds its table whenever the main assets start
+    string(FIND "${text}" "#include \"eez_flow_eval.inc\"" eval_pos)
+    if(NOT eval_pos EQUAL -1)
+        eez_flow_insert_after(text "    initGlobalVariables(assets);\n" "    evalStart(assets);")
+    endif()
+    file(WRITE "${out}.tmp" "${text}")
+    # Only touch the copy when it changes (no rebuild on every configure)
+    configure_file("${out}.tmp" "${out}" COPYONLY)
+    set(${out_var} "${out}" PARENT_SCOPE)
+endfunction()
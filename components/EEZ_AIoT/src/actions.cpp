@@ -8,10 +8,15 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include <string.h> // For strlen
+#include <stdlib.h> // For free
 
 // Hardware Module
 #include "IO_AIoT.h" 
 
+// Live pressure plot
+#include "SampleRing_AIoT.h"
+#include "Waveform_AIoT.h"
+
 // C Linkage Headers
 extern "C" {
     #include "WiFi_AIoT.h"
@@ -19,6 +24,11 @@ extern "C" {
 
 static const char *TAG = "UI_ACTIONS";
 
+#define WAVE_STATS_PERIOD_MS 60000
+
+// End of the current frame's CPU budget (set by the UI task before each call)
+static int64_t g_frame_deadline_us = INT64_MAX;
+
 enum ConnectionMethod {
     METHOD_WIFI_MULTI = 0,
     METHOD_BLUETOOTH  = 1,
@@ -29,36 +39,43 @@ enum ConnectionMethod {
 // 1. HELPER FUNCTIONS
 // -------------------------------------------------------------------------
 
+// Writes only when the value changes: every LVGL setter invalidates the
+// whole object, even when the new value equals the old one.
+static void helper_set_label(lv_obj_t *obj, const char *text) {
+    if (!obj) return;
+    if (strcmp(lv_label_get_text(obj), text) == 0) return;
+    lv_label_set_text(obj, text);
+}
+
+static void helper_set_bg_color(lv_obj_t *obj, lv_color_t color) {
+    if (!obj) return;
+    if (lv_color_eq(lv_obj_get_style_bg_color(obj, LV_PART_MAIN), color)) return;
+    lv_obj_set_style_bg_color(obj, color, LV_PART_MAIN);
+}
+
 static void helper_update_visuals() {
     bool is_wifi_connected = get_wifi_is_connected();
     set_var_connec(is_wifi_connected);
 
     if (is_wifi_connected) {
-        if (objects.ui_lab_ssid) lv_label_set_text(objects.ui_lab_ssid, get_wifi_ssid());
-        if (objects.ui_lab_ip)   lv_label_set_text(objects.ui_lab_ip, get_wifi_ip());
-        if (objects.ui_lab_dns)  lv_label_set_text(objects.ui_lab_dns, get_wifi_dns());
-        if (objects.ui_lab_mac)  lv_label_set_text(objects.ui_lab_mac, get_wifi_mac());
+        helper_set_label(objects.ui_lab_ssid, get_wifi_ssid());
+        helper_set_label(objects.ui_lab_ip, get_wifi_ip());
+        helper_set_label(objects.ui_lab_dns, get_wifi_dns());
+        helper_set_label(objects.ui_lab_mac, get_wifi_mac());
     } else {
-        if (objects.ui_lab_ssid) lv_label_set_text(objects.ui_lab_ssid, "Disconnected");
-        if (objects.ui_lab_ip)   lv_label_set_text(objects.ui_lab_ip, "0.0.0.0");
+        helper_set_label(objects.ui_lab_ssid, "Disconnected");
+        helper_set_label(objects.ui_lab_ip, "0.0.0.0");
     }
 
     // --- COLOR SYNC LOGIC (Green=Connected / Red=Disconnected) ---
     lv_color_t target_color = (is_wifi_connected) ? lv_color_hex(0x008000) : lv_color_hex(0xFF0000);
 
     // 1. Button Tab 1
-    if (objects.bt_conectado_main3_tab1) {
-        lv_obj_set_style_bg_color(objects.bt_conectado_main3_tab1, target_color, LV_PART_MAIN);
-    }
+    helper_set_bg_color(objects.bt_conectado_main3_tab1, target_color);
     // 2. Button Tab 2
-    if (objects.bt_conectado_main3_tab2) {
-        lv_obj_set_style_bg_color(objects.bt_conectado_main3_tab2, target_color, LV_PART_MAIN);
-    }
-    
+    helper_set_bg_color(objects.bt_conectado_main3_tab2, target_color);
     // 3. WiFi Timer Label/Button
-    if (objects.bt_dhms_wi_fi) {
-        lv_obj_set_style_bg_color(objects.bt_dhms_wi_fi, target_color, LV_PART_MAIN);
-    }
+    helper_set_bg_color(objects.bt_dhms_wi_fi, target_color);
 }
 
 static void helper_perform_connect() {
@@ -79,9 +96,9 @@ static void helper_perform_connect() {
     }
 
     if (method == METHOD_WIFI_MULTI || method == METHOD_BOTH) {
-        if (strlen(ssid_buffer) > 0) wifi_connect(ssid_buffer, (char*)pass_ptr);
+        // Queued to the network task; the periodic task refreshes the colors
+        if (strlen(ssid_buffer) > 0) WiFi_Request_Connect(ssid_buffer, pass_ptr);
     }
-    vTaskDelay(pdMS_TO_TICKS(200)); 
     helper_update_visuals();
 }
 
@@ -100,11 +117,8 @@ void action_fn_connec(lv_event_t * e) {
     if (objects.drop_down_1) method = lv_dropdown_get_selected(objects.drop_down_1);
 
     if (method == METHOD_WIFI_MULTI || method == METHOD_BOTH) {
-        char *list = wifi_scan_networks_get_list();
-        if (list && objects.text_area_ssid) {
-            lv_dropdown_set_options(objects.text_area_ssid, list);
-            free(list);
-        }
+        // Non-blocking: the list is picked up by ui_update_periodic_task
+        if (!WiFi_Request_Scan()) ESP_LOGW(TAG, "Scan request dropped");
     }
     static bool tk_linked = false;
     if (!tk_linked && objects.keyboard) {
@@ -133,7 +147,7 @@ void action_fn_update_suspension(lv_event_t * e) {
 }
 
 // -------------------------------------------------------------------------
-// 4. ACTION FUNCTION (REQUIRED BY LINKER)
+// 3. ACTION FUNCTION (REQUIRED BY LINKER)
 // -------------------------------------------------------------------------
 
 /**
@@ -148,12 +162,76 @@ void action_fn_label_dhms_wi_fi(lv_event_t * e) {
 
 
 // -------------------------------------------------------------------------
-// 3. PERIODIC TASK (LOGIC UPDATED HERE)
+// 4. PRESSURE WAVEFORM PAGE
 // -------------------------------------------------------------------------
+
+static lv_obj_t *g_waveform = NULL;
+
+static void event_wave_channels_cb(lv_event_t * e) {
+    lv_obj_t *btnm = (lv_obj_t *)lv_event_get_target(e);
+    uint32_t id = lv_buttonmatrix_get_selected_button(btnm);
+    if (id == LV_BUTTONMATRIX_BUTTON_NONE) return;
+    bool on = lv_buttonmatrix_has_button_ctrl(btnm, id, LV_BUTTONMATRIX_CTRL_CHECKED);
+    Waveform_AIoT_set_channel_enabled(g_waveform, (uint8_t)id, on);
+}
+
+/**
+ * @brief Adds a "Presiones" tab to the EEZ tab view with the 16-channel plot
+ * and one toggle per channel. Called once from the UI task after ui_init().
+ */
+extern "C" void ui_waveform_attach(SampleRing_t *ring) {
+    if (g_waveform || !ring || !objects.tab_view_main2) return;
+
+    lv_obj_t *page = lv_tabview_add_tab(objects.tab_view_main2, "Presiones");
+    lv_obj_set_flex_flow(page, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_style_pad_all(page, 4, LV_PART_MAIN);
+    lv_obj_set_style_pad_row(page, 4, LV_PART_MAIN);
+    lv_obj_remove_flag(page, LV_OBJ_FLAG_SCROLLABLE);
+
+    g_waveform = Waveform_AIoT_create(page, ring, NULL);
+    if (!g_waveform) {
+        ESP_LOGE(TAG, "Waveform widget not created");
+        return;
+    }
+    lv_obj_set_width(g_waveform, LV_PCT(100));
+    lv_obj_set_flex_grow(g_waveform, 1);
+
+    static const char *channel_map[] = {
+        "1", "2", "3", "4", "5", "6", "7", "8",
+        "9", "10", "11", "12", "13", "14", "15", "16", ""
+    };
+    lv_obj_t *btnm = lv_buttonmatrix_create(page);
+    lv_buttonmatrix_set_map(btnm, channel_map);
+    lv_buttonmatrix_set_button_ctrl_all(btnm, LV_BUTTONMATRIX_CTRL_CHECKABLE);
+    for (uint8_t ch = 0; ch < WAVE_CHANNELS; ch++) {
+        if (Waveform_AIoT_get_channel_enabled(g_waveform, ch)) {
+            lv_buttonmatrix_set_button_ctrl(btnm, ch, LV_BUTTONMATRIX_CTRL_CHECKED);
+        }
+    }
+    lv_obj_set_size(btnm, LV_PCT(100), 34);
+    lv_obj_set_style_pad_all(btnm, 2, LV_PART_MAIN);
+    lv_obj_set_style_pad_column(btnm, 2, LV_PART_MAIN);
+    lv_obj_add_event_cb(btnm, event_wave_channels_cb, LV_EVENT_VALUE_CHANGED, NULL);
+}
+
+// -------------------------------------------------------------------------
+// 5. PERIODIC TASK (LOGIC UPDATED HERE)
+// -------------------------------------------------------------------------
+
+/**
+ * @brief Deadline (esp_timer, us) for the splittable work of the next
+ * ui_update_periodic_task() call. INT64_MAX = no limit.
+ */
+extern "C" void ui_set_frame_deadline(int64_t deadline_us)
+{
+    g_frame_deadline_us = deadline_us;
+}
+
 extern "C" void ui_update_periodic_task(void)
 {
     static uint32_t last_clock_update = 0;
     static uint32_t last_wifi_update = 0;
+    static uint32_t last_wave_stats = 0;
     static bool initial_sync_done = false;
 
     uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
@@ -188,9 +266,9 @@ extern "C" void ui_update_periodic_task(void)
         set_var_label_dhms_1(time_str);
         set_var_label_dhms_2(time_str);
         
-        // Safety direct update
-        if (objects.label_dhms_1) lv_label_set_text(objects.label_dhms_1, time_str);
-        if (objects.label_dhms_2) lv_label_set_text(objects.label_dhms_2, time_str);
+        // Safety direct update (skipped when the EEZ tick already wrote it)
+        helper_set_label(objects.label_dhms_1, time_str);
+        helper_set_label(objects.label_dhms_2, time_str);
 
         // 2. WiFi Connection Timer (FINAL FIX)
         // Gets the time string (00:00:00 or current time)
@@ -198,7 +276,7 @@ extern "C" void ui_update_periodic_task(void)
         WiFi_Get_Connection_Time_String(wifi_time_str, sizeof(wifi_time_str));
         
         // CRITICAL: Update the LVGL object directly to make it "walk" and reset to zero.
-        if (objects.label_dhms_wi_fi) lv_label_set_text(objects.label_dhms_wi_fi, wifi_time_str);
+        helper_set_label(objects.label_dhms_wi_fi, wifi_time_str);
 
         // Update the EEZ Studio variable (for consistency)
         set_var_label_dhms_wi_fi(wifi_time_str);
@@ -211,5 +289,20 @@ extern "C" void ui_update_periodic_task(void)
         last_wifi_update = now;
     }
 
+    // --- E. ASYNC SCAN RESULT ---
+    char *scan_list = WiFi_Take_Scan_Result();
+    if (scan_list) {
+        if (objects.text_area_ssid) lv_dropdown_set_options(objects.text_area_ssid, scan_list);
+        free(scan_list);
+    }
+
+    // --- F. LIVE PRESSURE PLOT (only the new columns are rendered; the rest
+    //        of the backlog waits for the next frame past the deadline) ---
+    Waveform_AIoT_update_until(g_waveform, g_frame_deadline_us);
+    if (g_waveform && (now - last_wave_stats) >= WAVE_STATS_PERIOD_MS) {
+        Waveform_AIoT_log_stats(g_waveform);
+        last_wave_stats = now;
+    }
+
     IO_Set_Brillo_Manual(get_var_slider_porcentaje());
 }
\ No newline at end of file
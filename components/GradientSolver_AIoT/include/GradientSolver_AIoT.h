@@ -0,0 +1,100 @@
+#ifndef GRADIENTSOLVER_AIOT_H
+#define GRADIENTSOLVER_AIOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "MOC_AIoT.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Régimen permanente por el Método del Gradiente (Todini & Pilati)
+//
+// - Incógnitas: alturas en las uniones; los depósitos tienen altura fija.
+// - Pérdidas de Darcy-Weisbach (f constante) más pérdidas menores K (válvulas).
+// - En cada iteración se resuelve A H = F con A simétrica definida positiva,
+//   guardada en perfil (skyline) tras reordenar las uniones con Cuthill-McKee
+//   inverso, y factorizada con Cholesky (L L^T) dentro del mismo perfil.
+// - Refactorización incremental: la matriz usa la pendiente de cada tubería
+//   congelada mientras no cambie más de GGA_REFRESH_TOL. La fila i de L solo
+//   depende de las filas <= i, así que basta refactorizar desde la primera
+//   fila afectada (cambiar una válvula toca dos filas).
+// - Toda la memoria se reserva en GGA_create / GGA_finalize: resolver no asigna.
+// -----------------------------------------------------------------------------
+
+#define GGA_REFRESH_TOL         0.25    // Cambio relativo de pendiente que obliga a refactorizar
+#define GGA_CLOSED              (-1.0)  // Coeficiente K de una válvula cerrada
+
+typedef struct GGA GGA_t;
+
+typedef struct {
+    uint32_t solves;
+    uint32_t iterations;                // De la última resolución
+    uint32_t rows_factored;             // De la última resolución
+    uint32_t profile_size;              // Entradas del perfil (incluye diagonal)
+    double residual;                    // Sum|dQ| / Sum|Q| final
+} GGA_stats_t;
+
+/**
+ * @brief Reserva una red con capacidad fija
+ */
+GGA_t *GGA_create(uint16_t max_nodes, uint16_t max_links);
+
+void GGA_destroy(GGA_t *g);
+
+/**
+ * @brief Nodos: depósito (altura fija) o unión con demanda (m^3/s, positiva = consumo)
+ * @return Índice del nodo o -1
+ */
+int GGA_add_reservoir(GGA_t *g, double head);
+int GGA_add_junction(GGA_t *g, double demand);
+
+/**
+ * @brief Tubería from -> to (Darcy-Weisbach con f constante)
+ * @return Índice del enlace o -1
+ */
+int GGA_add_pipe(GGA_t *g, uint16_t from, uint16_t to, double length, double diameter, double friction);
+
+/**
+ * @brief Fija el ordenamiento, el perfil de la matriz y reserva la factorización
+ * @return false si la topología es inválida o falta memoria
+ */
+bool GGA_finalize(GGA_t *g);
+
+/**
+ * @brief Coeficiente de pérdida menor del enlace (ajuste de válvula); GGA_CLOSED = cerrada
+ */
+void GGA_set_minor_loss(GGA_t *g, uint16_t link, double k);
+
+void GGA_set_demand(GGA_t *g, uint16_t node, double demand);
+
+/**
+ * @brief Resuelve partiendo de la solución anterior
+ * @param tol Sum|dQ| / Sum|Q| para dar por convergido (p. ej. 1e-6)
+ * @return Iteraciones usadas, o -1 si no converge o la matriz no es definida positiva
+ */
+int GGA_solve(GGA_t *g, int max_iter, double tol);
+
+double GGA_head(const GGA_t *g, uint16_t node);
+double GGA_flow(const GGA_t *g, uint16_t link);
+void GGA_get_stats(const GGA_t *g, GGA_stats_t *stats);
+
+/**
+ * @brief Siembra las condiciones iniciales de un solver MOC con la solución
+ *
+ * El MOC debe haberse construido con los mismos índices: la tubería i del MOC
+ * es el enlace i y el nodo k del MOC es el nodo k. Una válvula del MOC en el
+ * nodo k se calibra con el caudal que le llega y con H_k - altura de descarga;
+ * en la red del gradiente se modela con un enlace adicional (de índice mayor
+ * que las tuberías del MOC) hacia un depósito a la altura de descarga.
+ */
+bool GGA_seed_moc(const GGA_t *g, MOC_solver_t *moc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GRADIENTSOLVER_AIOT_H
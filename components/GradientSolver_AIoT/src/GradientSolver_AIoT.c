@@ -0,0 +1,428 @@
+#include "GradientSolver_AIoT.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+static const char *TAG = "GradientSolver";
+#endif
+
+#define GGA_GRAVITY         9.81
+#define GGA_PI              3.14159265358979
+#define GGA_RQ_TOL          1e-7    // Pendiente mínima dh/dQ (flujo casi nulo)
+#define GGA_CLOSED_P        1e-8    // 1 / (dh/dQ) de un enlace cerrado
+#define GGA_INIT_VELOCITY   0.3     // m/s, caudal inicial de la primera resolución
+
+struct GGA {
+    uint16_t max_nodes, max_links;
+    uint16_t node_count, link_count;
+    // Nodos
+    double *head;
+    double *demand;
+    uint8_t *fixed;
+    int32_t *row;               // Nodo -> fila de la matriz (-1 en depósitos)
+    // Enlaces
+    uint16_t *from, *to;
+    double *r;                  // Coeficiente de fricción: h = r Q|Q|
+    double *m;                  // Pérdida menor: h = m Q|Q| (m < 0 = cerrado)
+    double *area;
+    double *q;
+    double *p_mat;              // 1 / (dh/dQ) usado en la matriz (congelado entre refrescos)
+    double *y;                  // p_mat * h(Q) de la iteración en curso
+    // Sistema (perfil / skyline)
+    uint16_t n;
+    int32_t *row_node;
+    uint16_t *first;            // Primera columna almacenada de cada fila
+    uint32_t *diag;             // Índice de la diagonal de cada fila en a / l
+    double *a, *l, *f, *x;
+    uint32_t profile;
+    int32_t dirty;              // Primera fila a refactorizar (n = ninguna)
+    bool ready;
+    GGA_stats_t stats;
+};
+
+// -----------------------------------------------------------------------------
+// Memoria (una sola vez, en PSRAM si existe)
+// -----------------------------------------------------------------------------
+
+static void *gga_alloc(size_t bytes) {
+    if (bytes == 0) bytes = 1;
+#ifdef ESP_PLATFORM
+    void *p = heap_caps_calloc(1, bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!p) p = heap_caps_calloc(1, bytes, MALLOC_CAP_8BIT);
+    return p;
+#else
+    return calloc(1, bytes);
+#endif
+}
+
+static void gga_free(void *p) {
+#ifdef ESP_PLATFORM
+    heap_caps_free(p);
+#else
+    free(p);
+#endif
+}
+
+GGA_t *GGA_create(uint16_t max_nodes, uint16_t max_links) {
+    GGA_t *g = gga_alloc(sizeof(GGA_t));
+    if (!g) return NULL;
+    g->max_nodes = max_nodes;
+    g->max_links = max_links;
+
+    g->head = gga_alloc(max_nodes * sizeof(double));
+    g->demand = gga_alloc(max_nodes * sizeof(double));
+    g->fixed = gga_alloc(max_nodes);
+    g->row = gga_alloc(max_nodes * sizeof(int32_t));
+    g->row_node = gga_alloc(max_nodes * sizeof(int32_t));
+    g->first = gga_alloc(max_nodes * sizeof(uint16_t));
+    g->diag = gga_alloc(max_nodes * sizeof(uint32_t));
+    g->f = gga_alloc(max_nodes * sizeof(double));
+    g->x = gga_alloc(max_nodes * sizeof(double));
+    g->from = gga_alloc(max_links * sizeof(uint16_t));
+    g->to = gga_alloc(max_links * sizeof(uint16_t));
+    g->r = gga_alloc(max_links * sizeof(double));
+    g->m = gga_alloc(max_links * sizeof(double));
+    g->area = gga_alloc(max_links * sizeof(double));
+    g->q = gga_alloc(max_links * sizeof(double));
+    g->p_mat = gga_alloc(max_links * sizeof(double));
+    g->y = gga_alloc(max_links * sizeof(double));
+
+    if (!g->head || !g->demand || !g->fixed || !g->row || !g->row_node || !g->first || !g->diag ||
+        !g->f || !g->x || !g->from || !g->to || !g->r || !g->m || !g->area || !g->q ||
+        !g->p_mat || !g->y) {
+        GGA_destroy(g);
+        return NULL;
+    }
+    return g;
+}
+
+void GGA_destroy(GGA_t *g) {
+    if (!g) return;
+    void *arrays[] = { g->head, g->demand, g->fixed, g->row, g->row_node, g->first, g->diag,
+                       g->f, g->x, g->from, g->to, g->r, g->m, g->area, g->q, g->p_mat, g->y,
+                       g->a, g->l };
+    for (size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++) {
+        if (arrays[i]) gga_free(arrays[i]);
+    }
+    gga_free(g);
+}
+
+// -----------------------------------------------------------------------------
+// Construcción
+// -----------------------------------------------------------------------------
+
+static int add_node(GGA_t *g, bool fixed, double head, double demand) {
+    if (g->ready || g->node_count >= g->max_nodes) return -1;
+    g->fixed[g->node_count] = fixed;
+    g->head[g->node_count] = head;
+    g->demand[g->node_count] = demand;
+    return g->node_count++;
+}
+
+int GGA_add_reservoir(GGA_t *g, double head) {
+    return add_node(g, true, head, 0.0);
+}
+
+int GGA_add_junction(GGA_t *g, double demand) {
+    return add_node(g, false, 0.0, demand);
+}
+
+int GGA_add_pipe(GGA_t *g, uint16_t from, uint16_t to, double length, double diameter, double friction) {
+    if (g->ready || g->link_count >= g->max_links) return -1;
+    if (from >= g->node_count || to >= g->node_count || from == to || diameter <= 0.0) return -1;
+
+    uint16_t k = g->link_count;
+    double area = GGA_PI * diameter * diameter / 4.0;
+    g->from[k] = from;
+    g->to[k] = to;
+    g->area[k] = area;
+    g->r[k] = friction * length / (2.0 * GGA_GRAVITY * diameter * area * area);
+    g->m[k] = 0.0;
+    return g->link_count++;
+}
+
+void GGA_set_minor_loss(GGA_t *g, uint16_t link, double k) {
+    if (link >= g->link_count) return;
+    // h = K v^2 / 2g = K Q^2 / (2 g A^2)
+    g->m[link] = (k < 0.0) ? GGA_CLOSED : k / (2.0 * GGA_GRAVITY * g->area[link] * g->area[link]);
+}
+
+void GGA_set_demand(GGA_t *g, uint16_t node, double demand) {
+    if (node < g->node_count && !g->fixed[node]) g->demand[node] = demand;
+}
+
+// Cuthill-McKee inverso sobre las uniones para estrechar el perfil
+static bool order_rcm(GGA_t *g) {
+    uint16_t nn = g->node_count;
+    uint32_t *deg = gga_alloc((nn + 1u) * sizeof(uint32_t));
+    uint16_t *adj = gga_alloc((2u * g->link_count + 1u) * sizeof(uint16_t));
+    uint16_t *queue = gga_alloc((nn + 1u) * sizeof(uint16_t));
+    uint8_t *seen = gga_alloc(nn + 1u);
+    bool ok = deg && adj && queue && seen;
+
+    if (ok) {
+        // Adyacencia CSR entre uniones (deg[i+1] acumula el grado del nodo i)
+        for (uint16_t k = 0; k < g->link_count; k++) {
+            if (g->fixed[g->from[k]] || g->fixed[g->to[k]]) continue;
+            deg[g->from[k] + 1]++;
+            deg[g->to[k] + 1]++;
+        }
+        for (uint16_t i = 0; i < nn; i++) deg[i + 1] += deg[i];
+        uint32_t *fill = gga_alloc((nn + 1u) * sizeof(uint32_t));
+        ok = fill != NULL;
+        if (ok) {
+            for (uint16_t k = 0; k < g->link_count; k++) {
+                uint16_t u = g->from[k], v = g->to[k];
+                if (g->fixed[u] || g->fixed[v]) continue;
+                adj[deg[u] + fill[u]++] = v;
+                adj[deg[v] + fill[v]++] = u;
+            }
+            gga_free(fill);
+        }
+    }
+
+    if (ok) {
+        uint16_t count = 0;
+        for (uint16_t i = 0; i < nn; i++) if (g->fixed[i]) seen[i] = 1;
+        while (count < g->n) {
+            // Semilla: unión sin visitar de menor grado (aproximación a un nodo periférico)
+            int seed = -1;
+            for (uint16_t i = 0; i < nn; i++) {
+                if (seen[i]) continue;
+                if (seed < 0 || deg[i + 1] - deg[i] < deg[seed + 1] - deg[seed]) seed = i;
+            }
+            uint16_t head = count;
+            queue[count++] = (uint16_t)seed;
+            seen[seed] = 1;
+            while (head < count) {
+                uint16_t u = queue[head++];
+                uint16_t start = count;
+                for (uint32_t e = deg[u]; e < deg[u + 1]; e++) {
+                    uint16_t v = adj[e];
+                    if (seen[v]) continue;
+                    seen[v] = 1;
+                    // Vecinos nuevos ordenados por grado creciente (inserción)
+                    uint16_t pos = count++;
+                    while (pos > start && deg[queue[pos - 1] + 1] - deg[queue[pos - 1]] > deg[v + 1] - deg[v]) {
+                        queue[pos] = queue[pos - 1];
+                        pos--;
+                    }
+                    queue[pos] = v;
+                }
+            }
+        }
+        for (uint16_t i = 0; i < g->n; i++) {
+            uint16_t node = queue[i];
+            uint16_t rw = (uint16_t)(g->n - 1 - i);
+            g->row[node] = rw;
+            g->row_node[rw] = node;
+        }
+    }
+
+    if (deg) gga_free(deg);
+    if (adj) gga_free(adj);
+    if (queue) gga_free(queue);
+    if (seen) gga_free(seen);
+    return ok;
+}
+
+bool GGA_finalize(GGA_t *g) {
+    if (g->ready || g->link_count == 0) return false;
+
+    g->n = 0;
+    for (uint16_t i = 0; i < g->node_count; i++) {
+        g->row[i] = -1;
+        if (!g->fixed[i]) g->n++;
+    }
+    if (g->n && !order_rcm(g)) return false;
+
+    // Perfil: cada fila guarda desde la columna del vecino más lejano hasta la diagonal
+    for (uint16_t rw = 0; rw < g->n; rw++) g->first[rw] = rw;
+    for (uint16_t k = 0; k < g->link_count; k++) {
+        int32_t ru = g->row[g->from[k]], rv = g->row[g->to[k]];
+        if (ru < 0 || rv < 0) continue;
+        int32_t hi = ru > rv ? ru : rv, lo = ru > rv ? rv : ru;
+        if (lo < g->first[hi]) g->first[hi] = (uint16_t)lo;
+    }
+    uint32_t total = 0;
+    for (uint16_t rw = 0; rw < g->n; rw++) {
+        total += (uint32_t)(rw - g->first[rw]) + 1;
+        g->diag[rw] = total - 1;
+    }
+    g->profile = total;
+    g->a = gga_alloc(total * sizeof(double));
+    g->l = gga_alloc(total * sizeof(double));
+    if (!g->a || !g->l) return false;
+
+    for (uint16_t k = 0; k < g->link_count; k++) {
+        g->q[k] = g->area[k] * GGA_INIT_VELOCITY;
+        g->p_mat[k] = 0.0;
+    }
+    g->dirty = 0;
+    g->stats.profile_size = total;
+    g->ready = true;
+#ifdef ESP_PLATFORM
+    ESP_LOGI(TAG, "Red: %u nodos, %u enlaces, perfil %u entradas", g->node_count, g->link_count, (unsigned)total);
+#endif
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Resolución
+// -----------------------------------------------------------------------------
+
+#define AT(v, rw, c) ((v)[g->diag[rw] - ((rw) - (c))])
+
+// Fila 'rw' del perfil: ROW(v, rw)[c - first[rw]] = v(rw, c)
+#define ROW(v, rw) (&(v)[g->diag[rw] - ((rw) - g->first[rw])])
+
+// Ensambla A H = F con las pendientes congeladas y marca las filas que cambian
+static void assemble(GGA_t *g) {
+    memset(g->a, 0, g->profile * sizeof(double));
+    memset(g->f, 0, g->n * sizeof(double));
+
+    for (uint16_t i = 0; i < g->node_count; i++) {
+        if (g->row[i] >= 0) g->f[g->row[i]] -= g->demand[i];
+    }
+
+    for (uint16_t k = 0; k < g->link_count; k++) {
+        double q = g->q[k];
+        double p, h;
+        if (g->m[k] < 0.0) {
+            p = GGA_CLOSED_P;
+            h = q / GGA_CLOSED_P;       // Así q - y = 0: la matriz impone Q = p dH
+        } else {
+            double rr = g->r[k] + g->m[k];
+            double dhdq = 2.0 * rr * fabs(q);
+            if (dhdq < GGA_RQ_TOL) dhdq = GGA_RQ_TOL;
+            p = 1.0 / dhdq;
+            h = rr * q * fabs(q);
+        }
+
+        int32_t ru = g->row[g->from[k]], rv = g->row[g->to[k]];
+        if (g->p_mat[k] == 0.0 || fabs(p - g->p_mat[k]) > GGA_REFRESH_TOL * g->p_mat[k]) {
+            g->p_mat[k] = p;
+            int32_t lo = (ru < 0) ? rv : (rv < 0) ? ru : (ru < rv ? ru : rv);
+            if (lo >= 0 && lo < g->dirty) g->dirty = lo;
+        }
+        p = g->p_mat[k];
+        g->y[k] = (g->m[k] < 0.0) ? q : p * h;
+
+        double qy = q - g->y[k];
+        if (ru >= 0) {
+            AT(g->a, ru, ru) += p;
+            g->f[ru] -= qy;
+            if (rv < 0) g->f[ru] += p * g->head[g->to[k]];
+        }
+        if (rv >= 0) {
+            AT(g->a, rv, rv) += p;
+            g->f[rv] += qy;
+            if (ru < 0) g->f[rv] += p * g->head[g->from[k]];
+        }
+        if (ru >= 0 && rv >= 0) {
+            if (ru > rv) AT(g->a, ru, rv) -= p;
+            else AT(g->a, rv, ru) -= p;
+        }
+    }
+}
+
+// Cholesky en perfil desde la fila 'start': las filas anteriores de L no cambian
+static bool factor_from(GGA_t *g, uint16_t start) {
+    for (uint16_t rw = start; rw < g->n; rw++) {
+        uint16_t fr = g->first[rw];
+        double *lr = ROW(g->l, rw);
+        const double *ar = ROW(g->a, rw);
+        for (uint16_t c = fr; c < rw; c++) {
+            uint16_t fc = g->first[c];
+            const double *lc = ROW(g->l, c);
+            uint16_t k0 = fr > fc ? fr : fc;
+            double s = ar[c - fr];
+            for (uint16_t k = k0; k < c; k++) s -= lr[k - fr] * lc[k - fc];
+            lr[c - fr] = s / lc[c - fc];
+        }
+        double d = ar[rw - fr];
+        for (uint16_t k = fr; k < rw; k++) d -= lr[k - fr] * lr[k - fr];
+        if (d <= 0.0) return false;
+        lr[rw - fr] = sqrt(d);
+    }
+    g->stats.rows_factored += g->n - start;
+    return true;
+}
+
+static void substitute(GGA_t *g) {
+    double *x = g->x;
+    memcpy(x, g->f, g->n * sizeof(double));
+    for (uint16_t rw = 0; rw < g->n; rw++) {
+        uint16_t fr = g->first[rw];
+        const double *lr = ROW(g->l, rw);
+        double s = x[rw];
+        for (uint16_t c = fr; c < rw; c++) s -= lr[c - fr] * x[c];
+        x[rw] = s / lr[rw - fr];
+    }
+    for (int32_t rw = g->n - 1; rw >= 0; rw--) {
+        uint16_t fr = g->first[rw];
+        const double *lr = ROW(g->l, rw);
+        x[rw] /= lr[rw - fr];
+        for (uint16_t c = fr; c < rw; c++) x[c] -= lr[c - fr] * x[rw];
+    }
+}
+
+int GGA_solve(GGA_t *g, int max_iter, double tol) {
+    if (!g || !g->ready) return -1;
+    g->stats.rows_factored = 0;
+    g->stats.solves++;
+
+    for (int it = 1; it <= max_iter; it++) {
+        assemble(g);
+        if (g->dirty < g->n) {
+            if (!factor_from(g, (uint16_t)g->dirty)) return -1;
+            g->dirty = g->n;
+        }
+        substitute(g);
+        for (uint16_t rw = 0; rw < g->n; rw++) g->head[g->row_node[rw]] = g->x[rw];
+
+        double sum_dq = 0.0, sum_q = 0.0;
+        for (uint16_t k = 0; k < g->link_count; k++) {
+            double qn = g->q[k] - g->y[k] + g->p_mat[k] * (g->head[g->from[k]] - g->head[g->to[k]]);
+            sum_dq += fabs(qn - g->q[k]);
+            sum_q += fabs(qn);
+            g->q[k] = qn;
+        }
+        g->stats.iterations = (uint32_t)it;
+        g->stats.residual = (sum_q > 0.0) ? sum_dq / sum_q : sum_dq;
+        if (g->stats.residual < tol) return it;
+    }
+    return -1;
+}
+
+double GGA_head(const GGA_t *g, uint16_t node) {
+    return (node < g->node_count) ? g->head[node] : 0.0;
+}
+
+double GGA_flow(const GGA_t *g, uint16_t link) {
+    return (link < g->link_count) ? g->q[link] : 0.0;
+}
+
+void GGA_get_stats(const GGA_t *g, GGA_stats_t *stats) {
+    if (g && stats) *stats = g->stats;
+}
+
+bool GGA_seed_moc(const GGA_t *g, MOC_solver_t *moc) {
+    if (!g || !moc || !moc->ready) return false;
+    if (moc->pipe_count > g->link_count || moc->node_count > g->node_count) return false;
+
+    for (uint8_t i = 0; i < moc->pipe_count; i++) {
+        MOC_set_pipe_steady(moc, i, (float)g->q[i], (float)g->head[moc->pipes[i].from]);
+    }
+    for (uint8_t k = 0; k < moc->node_count; k++) {
+        if (moc->nodes[k].type != MOC_NODE_VALVE) continue;
+        for (uint8_t i = 0; i < moc->pipe_count; i++) {
+            if (moc->pipes[i].to != k) continue;
+            MOC_set_valve_steady(moc, k, (float)g->q[i], (float)(g->head[k] - moc->nodes[k].head));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,181 @@
+#ifndef HAMMERDETECT_AIOT_H
+#define HAMMERDETECT_AIOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "SampleRing_AIoT.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Detector de golpe de ariete (transitorios de presión) por canal
+//
+// Por cada muestra y canal, en O(1) y aritmética entera:
+//  - Media y varianza móviles (EWMA en Q8: media en cuentas, varianza en cuentas^2)
+//  - dp/dt entre muestras consecutivas
+//  - Desviación respecto a la media contra k*sigma y contra el umbral de
+//    Joukowsky (dP = rho * a * dv), convertido a cuentas al configurar
+//  - Durante una alarma la media no aprende del transitorio; si la señal
+//    sigue fuera de umbral 'rebase_samples' muestras (un escalón que se
+//    queda, como una válvula que pasa a otro régimen), la media se reinicia
+//    al nivel nuevo y el canal se rearma tras 'holdoff_samples' tranquilas
+//
+// El estado está en arreglos por canal (estructura de arreglos) y el bucle
+// interno recorre las muestras contiguas de un canal del bloque.
+// -----------------------------------------------------------------------------
+
+#define HDET_CHANNELS           SRING_CHANNELS
+#define HDET_MAX_NODES          4       // Nodos con estado propio (se asignan por orden de llegada)
+#define HDET_EVENT_QUEUE        32      // Potencia de dos
+
+// --- Tarea (ESP32) ---
+#define HDET_TASK_CORE          1       // Junto a la adquisición, lejos de la UI
+#define HDET_TASK_PRIO          15      // Por debajo de la adquisición
+#define HDET_TASK_STACK         4096
+
+/**
+ * @brief Motivos de alarma (máscara de bits)
+ */
+typedef enum {
+    HDET_ALARM_DEVIATION = 1 << 0,      // |p - media| > k * sigma
+    HDET_ALARM_SURGE     = 1 << 1,      // |p - media| > fracción del pulso de Joukowsky
+    HDET_ALARM_RATE      = 1 << 2,      // |dp/dt| > límite
+} HammerDetect_alarm_t;
+
+/**
+ * @brief Parámetros físicos y de detección
+ */
+typedef struct {
+    float pa_per_count;                 // Escala del transductor (Pa por cuenta ADC)
+    float fluid_density;                // rho (kg/m^3)
+    float wave_speed;                   // a, celeridad de la onda (m/s)
+    float velocity_step;                // dv, cambio brusco de velocidad a vigilar (m/s)
+    float joukowsky_fraction;           // Fracción de rho*a*dv que dispara la alarma
+    float rate_limit_pa_s;              // Límite de |dp/dt| (Pa/s)
+    float sigma_k;                      // k para la alarma estadística
+    uint32_t sample_period_us;          // Periodo de muestreo
+    uint8_t mean_shift;                 // Ventana EWMA = 2^mean_shift muestras
+    uint16_t warmup_samples;            // Muestras antes de habilitar alarmas
+    uint16_t holdoff_samples;           // Muestras tranquilas para rearmar un canal
+    uint16_t rebase_samples;            // Muestras en alarma antes de tomar el nivel como nueva media
+} HammerDetect_config_t;
+
+#define HAMMERDETECT_CONFIG_DEFAULT() { \
+    .pa_per_count = 100.0f,             \
+    .fluid_density = 998.0f,            \
+    .wave_speed = 1000.0f,              \
+    .velocity_step = 0.5f,              \
+    .joukowsky_fraction = 0.5f,         \
+    .rate_limit_pa_s = 5.0e7f,          \
+    .sigma_k = 6.0f,                    \
+    .sample_period_us = 1000,           \
+    .mean_shift = 8,                    \
+    .warmup_samples = 512,              \
+    .holdoff_samples = 200,             \
+    .rebase_samples = 1000,             \
+}
+
+/**
+ * @brief Evento de alarma (inicio de un transitorio en un canal)
+ */
+typedef struct {
+    int64_t timestamp_us;               // esp_timer de la muestra que disparó
+    uint8_t node;
+    uint8_t channel;
+    uint8_t flags;                      // HammerDetect_alarm_t
+    int16_t sample;                     // Cuentas ADC
+    int32_t deviation;                  // p - media (cuentas)
+    int32_t rate;                       // dp por muestra (cuentas)
+} HammerDetect_event_t;
+
+typedef struct {
+    uint64_t samples;
+    uint32_t blocks;
+    uint32_t events;
+    uint32_t events_dropped;            // Cola de eventos llena
+    uint32_t unknown_nodes;             // Bloques de nodos sin hueco de estado
+    uint32_t rebaselines;               // Medias reiniciadas tras un escalón persistente
+} HammerDetect_stats_t;
+
+/**
+ * @brief Umbrales precalculados en cuentas (solo enteros en el camino caliente)
+ */
+typedef struct {
+    int32_t surge_counts;
+    int32_t rate_counts;
+    uint32_t sigma_k2_q8;               // k^2 en Q8
+} HammerDetect_thresholds_t;
+
+/**
+ * @brief Estado por nodo, un elemento por canal
+ */
+typedef struct {
+    int32_t mean_q8[HDET_CHANNELS];     // Media EWMA en Q8
+    uint32_t var_q8[HDET_CHANNELS];     // Varianza EWMA en Q8
+    int16_t prev[HDET_CHANNELS];
+    uint16_t quiet[HDET_CHANNELS];      // Muestras tranquilas desde la última alarma
+    uint16_t held[HDET_CHANNELS];       // Muestras fuera de umbral desde la alarma o el último reinicio
+    uint32_t seen[HDET_CHANNELS];
+    uint8_t alarmed[HDET_CHANNELS];
+    uint8_t address;
+    bool used;
+} HammerDetect_node_t;
+
+typedef struct {
+    HammerDetect_config_t cfg;
+    HammerDetect_thresholds_t th;
+    HammerDetect_node_t nodes[HDET_MAX_NODES];
+    // Cola SPSC de eventos: la llena el detector, la vacía la UI / red
+    HammerDetect_event_t events[HDET_EVENT_QUEUE];
+    atomic_uint ev_head;
+    atomic_uint ev_tail;
+    HammerDetect_stats_t stats;
+} HammerDetect_t;
+
+// --- NÚCLEO PORTABLE ---------------------------------------------------------
+
+/**
+ * @brief Inicializa el detector y precalcula los umbrales en cuentas
+ */
+void HammerDetect_init(HammerDetect_t *det, const HammerDetect_config_t *cfg);
+
+/**
+ * @brief Procesa un bloque del anillo de muestras
+ * @return Eventos emitidos por este bloque
+ */
+int HammerDetect_process_block(HammerDetect_t *det, const SampleRing_block_t *block);
+
+/**
+ * @brief Extrae el evento más antiguo (desde otra tarea)
+ * @return false si no hay eventos
+ */
+bool HammerDetect_pop_event(HammerDetect_t *det, HammerDetect_event_t *event);
+
+// --- TAREA (ESP32) -----------------------------------------------------------
+
+#ifdef ESP_PLATFORM
+#include "esp_err.h"
+
+/**
+ * @brief Arranca la tarea del detector como consumidor del anillo de muestras
+ * @param cfg NULL para HAMMERDETECT_CONFIG_DEFAULT
+ */
+esp_err_t HammerDetect_AIoT_Start(SampleRing_t *ring, const HammerDetect_config_t *cfg);
+
+/**
+ * @brief Siguiente alarma pendiente de la tarea del detector
+ */
+bool HammerDetect_AIoT_Pop_Event(HammerDetect_event_t *event);
+
+void HammerDetect_AIoT_Get_Stats(HammerDetect_stats_t *stats);
+#endif // ESP_PLATFORM
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HAMMERDETECT_AIOT_H
@@ -0,0 +1,247 @@
+#include "HammerDetect_AIoT.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "TaskMonitor_AIoT.h"
+static const char *TAG = "HammerDetect";
+#endif
+
+// -----------------------------------------------------------------------------
+// Núcleo
+// -----------------------------------------------------------------------------
+
+static int32_t clamp_counts(float v) {
+    if (v < 1.0f) return 1;
+    if (v > 65535.0f) return 65535;
+    return (int32_t)(v + 0.5f);
+}
+
+void HammerDetect_init(HammerDetect_t *det, const HammerDetect_config_t *cfg) {
+    memset(det, 0, sizeof(*det));
+    det->cfg = *cfg;
+    if (det->cfg.mean_shift == 0 || det->cfg.mean_shift > 15) det->cfg.mean_shift = 8;
+    if (det->cfg.pa_per_count <= 0.0f) det->cfg.pa_per_count = 1.0f;
+    if (det->cfg.rebase_samples == 0) det->cfg.rebase_samples = 1000;
+
+    // Joukowsky: dP = rho * a * dv (Pa). La alarma salta a una fracción de ese pulso.
+    float surge_pa = cfg->fluid_density * cfg->wave_speed * cfg->velocity_step * cfg->joukowsky_fraction;
+    det->th.surge_counts = clamp_counts(surge_pa / det->cfg.pa_per_count);
+
+    // dp/dt (Pa/s) -> cuentas por muestra
+    float rate_pa_per_sample = cfg->rate_limit_pa_s * (float)cfg->sample_period_us * 1e-6f;
+    det->th.rate_counts = clamp_counts(rate_pa_per_sample / det->cfg.pa_per_count);
+
+    det->th.sigma_k2_q8 = (uint32_t)(cfg->sigma_k * cfg->sigma_k * 256.0f + 0.5f);
+
+    atomic_init(&det->ev_head, 0);
+    atomic_init(&det->ev_tail, 0);
+}
+
+static HammerDetect_node_t *node_state(HammerDetect_t *det, uint8_t address) {
+    HammerDetect_node_t *free_slot = NULL;
+    for (int i = 0; i < HDET_MAX_NODES; i++) {
+        HammerDetect_node_t *n = &det->nodes[i];
+        if (n->used && n->address == address) return n;
+        if (!n->used && !free_slot) free_slot = n;
+    }
+    if (free_slot) {
+        free_slot->used = true;
+        free_slot->address = address;
+    }
+    return free_slot;
+}
+
+static void push_event(HammerDetect_t *det, const HammerDetect_event_t *ev) {
+    unsigned head = atomic_load_explicit(&det->ev_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&det->ev_tail, memory_order_acquire);
+    if (head - tail >= HDET_EVENT_QUEUE) {
+        det->stats.events_dropped++;
+        return;
+    }
+    det->events[head & (HDET_EVENT_QUEUE - 1)] = *ev;
+    atomic_store_explicit(&det->ev_head, head + 1, memory_order_release);
+    det->stats.events++;
+}
+
+// Un canal de un bloque: el estado vive en registros durante el bucle
+static int process_channel(HammerDetect_t *det, HammerDetect_node_t *n, uint8_t ch,
+                           const int16_t *x, uint8_t count, const SampleRing_block_t *block) {
+    const HammerDetect_thresholds_t th = det->th;
+    const uint8_t shift = det->cfg.mean_shift;
+    const uint32_t warmup = det->cfg.warmup_samples;
+    const uint16_t holdoff = det->cfg.holdoff_samples;
+    const uint16_t rebase = det->cfg.rebase_samples;
+
+    int32_t mean_q8 = n->mean_q8[ch];
+    uint32_t var_q8 = n->var_q8[ch];
+    int32_t prev = n->prev[ch];
+    uint16_t quiet = n->quiet[ch];
+    uint16_t held = n->held[ch];
+    uint32_t seen = n->seen[ch];
+    uint8_t alarmed = n->alarmed[ch];
+    int emitted = 0;
+
+    if (seen == 0 && count) {
+        mean_q8 = (int32_t)x[0] << 8;
+        prev = x[0];
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        int32_t s = x[i];
+        int32_t dev = s - (mean_q8 >> 8);
+        int32_t rate = s - prev;
+        prev = s;
+
+        uint32_t adev = (uint32_t)(dev < 0 ? -dev : dev);
+        uint32_t d2 = adev * adev;      // |dev| <= 65535: cabe en 32 bits
+        if (d2 > 0xFFFFFF) d2 = 0xFFFFFF;   // Así d2 en Q8 también cabe en 32 bits
+        uint8_t flags = 0;
+
+        if (seen >= warmup) {
+            // d2 > k^2 * var, con k^2 y var en Q8 (suelo de 1 cuenta^2)
+            uint32_t v = (var_q8 > 256) ? var_q8 : 256;
+            if (((uint64_t)d2 << 16) > (uint64_t)th.sigma_k2_q8 * v) flags |= HDET_ALARM_DEVIATION;
+            if ((int32_t)adev > th.surge_counts) flags |= HDET_ALARM_SURGE;
+            if ((rate < 0 ? -rate : rate) > th.rate_counts) flags |= HDET_ALARM_RATE;
+        } else {
+            seen++;
+        }
+
+        if (flags) {
+            quiet = 0;
+            if (!alarmed) {
+                alarmed = 1;
+                HammerDetect_event_t ev = {
+                    .timestamp_us = block->timestamp_us + (int64_t)i * block->sample_period_us,
+                    .node = block->node,
+                    .channel = ch,
+                    .flags = flags,
+                    .sample = (int16_t)s,
+                    .deviation = dev,
+                    .rate = rate,
+                };
+                push_event(det, &ev);
+                emitted++;
+            } else if (++held >= rebase) {
+                // Escalón persistente: el nivel actual pasa a ser la media y
+                // el rearme cuenta desde aquí
+                mean_q8 = s << 8;
+                held = 0;
+                det->stats.rebaselines++;
+            }
+            continue;                   // La línea base no aprende del transitorio
+        }
+
+        if (alarmed && ++quiet >= holdoff) {
+            alarmed = 0;
+            quiet = 0;
+            held = 0;
+        }
+
+        mean_q8 += (((int32_t)s << 8) - mean_q8) >> shift;
+        var_q8 = (uint32_t)((int64_t)var_q8 + (((int64_t)(d2 << 8) - (int64_t)var_q8) >> shift));
+    }
+
+    n->mean_q8[ch] = mean_q8;
+    n->var_q8[ch] = var_q8;
+    n->prev[ch] = (int16_t)prev;
+    n->quiet[ch] = quiet;
+    n->held[ch] = held;
+    n->seen[ch] = seen;
+    n->alarmed[ch] = alarmed;
+    return emitted;
+}
+
+int HammerDetect_process_block(HammerDetect_t *det, const SampleRing_block_t *block) {
+    HammerDetect_node_t *n = node_state(det, block->node);
+    if (!n) {
+        det->stats.unknown_nodes++;
+        return 0;
+    }
+
+    int emitted = 0;
+    for (uint8_t ch = 0; ch < HDET_CHANNELS; ch++) {
+        if (!(block->channel_mask & (1u << ch))) continue;
+        emitted += process_channel(det, n, ch, block->data[ch], block->count, block);
+        det->stats.samples += block->count;
+    }
+    det->stats.blocks++;
+    return emitted;
+}
+
+bool HammerDetect_pop_event(HammerDetect_t *det, HammerDetect_event_t *event) {
+    unsigned tail = atomic_load_explicit(&det->ev_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&det->ev_head, memory_order_acquire);
+    if (tail == head) return false;
+    *event = det->events[tail & (HDET_EVENT_QUEUE - 1)];
+    atomic_store_explicit(&det->ev_tail, tail + 1, memory_order_release);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Tarea (ESP32)
+// -----------------------------------------------------------------------------
+
+#ifdef ESP_PLATFORM
+
+static HammerDetect_t s_detector;
+static SampleRing_t *s_ring = NULL;
+static int s_consumer = -1;
+
+static void hammer_task(void *arg) {
+    (void)arg;
+    int mon_id = TaskMon_register("hammer", 0);
+    for (;;) {
+        const SampleRing_block_t *block = SampleRing_peek(s_ring, s_consumer);
+        if (!block) {
+            // Un bloque son decenas de ms de señal: no hace falta despertar antes
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+        TaskMon_begin(mon_id);
+
+        if (HammerDetect_process_block(&s_detector, block) > 0) {
+            ESP_LOGW(TAG, "Transitorio en nodo %u (%u alarmas acumuladas)",
+                     block->node, (unsigned)s_detector.stats.events);
+        }
+        SampleRing_release(s_ring, s_consumer);
+        TaskMon_end(mon_id);
+    }
+}
+
+esp_err_t HammerDetect_AIoT_Start(SampleRing_t *ring, const HammerDetect_config_t *cfg) {
+    if (!ring) return ESP_ERR_INVALID_ARG;
+    if (s_ring) return ESP_ERR_INVALID_STATE;
+
+    HammerDetect_config_t def = HAMMERDETECT_CONFIG_DEFAULT();
+    HammerDetect_init(&s_detector, cfg ? cfg : &def);
+
+    s_consumer = SampleRing_register_consumer(ring, "hammer");
+    if (s_consumer < 0) return ESP_ERR_NO_MEM;
+    s_ring = ring;
+
+    if (xTaskCreatePinnedToCore(hammer_task, "hammer", HDET_TASK_STACK, NULL,
+                                HDET_TASK_PRIO, NULL, HDET_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "No se pudo crear la tarea del detector");
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Detector activo: sobrepresión %ld cuentas, dp/dt %ld cuentas/muestra",
+             (long)s_detector.th.surge_counts, (long)s_detector.th.rate_counts);
+    return ESP_OK;
+}
+
+bool HammerDetect_AIoT_Pop_Event(HammerDetect_event_t *event) {
+    if (!s_ring || !event) return false;
+    return HammerDetect_pop_event(&s_detector, event);
+}
+
+void HammerDetect_AIoT_Get_Stats(HammerDetect_stats_t *stats) {
+    if (!stats) return;
+    *stats = s_detector.stats;
+}
+
+#endif // ESP_PLATFORM
@@ -30,6 +30,24 @@ void IO_Set_Brillo_Manual(int32_t percentage);
  */
 void IO_Set_Tiempo_Suspension(int32_t index);
 
+/**
+ * @brief Called on every screen suspend / wake transition.
+ * @param dimmed true when the backlight has just been switched off
+ */
+typedef void (*IO_Suspend_Callback_t)(bool dimmed);
+
+/**
+ * @brief Registers the transition callback (display / CPU power hooks).
+ * Runs in the task that calls IO_Task_Manager, before the backlight comes
+ * back on when waking.
+ */
+void IO_Set_Suspend_Callback(IO_Suspend_Callback_t cb);
+
+/**
+ * @brief Returns true while the screen is suspended (backlight off).
+ */
+bool IO_Is_Suspended(void);
+
 /**
  * @brief Main logic for Power Management State Machine.
  * Must be called in the main loop.
@@ -22,6 +22,7 @@ static const char *TAG = "IO_AIOT";
 static int32_t g_current_brightness_percent = 100;
 static uint32_t g_suspension_timeout_ms = 0; // 0 = Disabled
 static bool g_is_dimmed = false;
+static IO_Suspend_Callback_t g_suspend_cb = NULL;
 
 // --- PWM FUNCTION ---
 static void apply_pwm_brightness(int percent) {
@@ -102,13 +103,33 @@ void IO_Get_Uptime(char *buffer, size_t len) {
     else snprintf(buffer, len, "%02d:%02d:%02d", hours, minutes, seconds);
 }
 
+// --- SUSPEND HOOKS ---
+void IO_Set_Suspend_Callback(IO_Suspend_Callback_t cb) {
+    g_suspend_cb = cb;
+}
+
+bool IO_Is_Suspended(void) {
+    return g_is_dimmed;
+}
+
+// Display / CPU first, backlight last when waking (no stale frame shown)
+static void set_dimmed(bool dimmed) {
+    g_is_dimmed = dimmed;
+    if (dimmed) {
+        apply_pwm_brightness(0); // Absolute Zero
+        if (g_suspend_cb) g_suspend_cb(true);
+    } else {
+        if (g_suspend_cb) g_suspend_cb(false);
+        apply_pwm_brightness(g_current_brightness_percent);
+    }
+}
+
 // --- STATE MACHINE (TASK MANAGER) ---
 void IO_Task_Manager(void) {
     // If timeout is 0 (Never), ensure screen is ON
     if (g_suspension_timeout_ms == 0) {
         if (g_is_dimmed) {
-            g_is_dimmed = false;
-            apply_pwm_brightness(g_current_brightness_percent);
+            set_dimmed(false);
         }
         return;
     }
@@ -119,15 +140,13 @@ void IO_Task_Manager(void) {
     if (inactive_ms > g_suspension_timeout_ms) {
         // --- SUSPEND (OFF) ---
         if (!g_is_dimmed) {
-            g_is_dimmed = true;
-            apply_pwm_brightness(0); // Absolute Zero
+            set_dimmed(true);
             ESP_LOGI(TAG, "System suspended (Screen OFF). Timeout: %d ms", (int)g_suspension_timeout_ms);
         }
     } else {
         // --- WAKE UP (ON) ---
         if (g_is_dimmed) {
-            g_is_dimmed = false;
-            apply_pwm_brightness(g_current_brightness_percent);
+            set_dimmed(false);
             ESP_LOGI(TAG, "System Woke Up!");
         }
     }
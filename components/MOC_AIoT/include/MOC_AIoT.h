@@ -0,0 +1,144 @@
+#ifndef MOC_AIOT_H
+#define MOC_AIOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Método de las Características (MOC) para redes de tuberías
+//
+// - Paso de tiempo fijo: cada tubería se divide en N tramos con N = L / (a dt)
+//   y se ajusta la celeridad a L / (N dt) para que las características caigan
+//   exactamente en la malla.
+// - Malla en estructura de arreglos: H y Q de todos los puntos de todas las
+//   tuberías en arreglos globales contiguos, con doble buffer (viejo / nuevo).
+// - Paso incremental: MOC_step procesa como mucho 'max_points' puntos
+//   interiores y devuelve true cuando el paso completo ha terminado, para
+//   repartir un paso entre varias vueltas del bucle principal.
+// - Contornos: depósito (altura fija), unión (continuidad con demanda, un
+//   extremo muerto es una unión con una sola tubería) y válvula aguas abajo.
+// - Sin memoria dinámica; precisión simple (FPU del ESP32-S3).
+// -----------------------------------------------------------------------------
+
+#define MOC_MAX_PIPES           16
+#define MOC_MAX_NODES           16
+#define MOC_MAX_POINTS          1024    // Puntos de malla entre todas las tuberías
+#define MOC_GRAVITY             9.81f
+
+typedef enum {
+    MOC_NODE_RESERVOIR,                 // Altura piezométrica fija
+    MOC_NODE_JUNCTION,                  // Suma de caudales = demanda
+    MOC_NODE_VALVE,                     // Extremo aguas abajo de una tubería, descarga a 'head'
+} MOC_node_type_t;
+
+typedef struct {
+    MOC_node_type_t type;
+    float head;                         // Depósito: altura fija. Válvula: altura aguas abajo
+    float demand;                       // Unión: caudal extraído (m^3/s)
+    // Válvula: Q = Cv * tau * sqrt(dH), con Cv del régimen permanente (Q0, dH0)
+    float valve_cv2;                    // (Q0 / sqrt(dH0))^2 / 2, sin tau
+    float tau;                          // Apertura relativa 0..1
+    uint8_t pipe_count;
+} MOC_node_t;
+
+typedef struct {
+    uint8_t from;                       // Nodo aguas arriba
+    uint8_t to;                         // Nodo aguas abajo
+    float length;                       // m
+    float diameter;                     // m
+    float wave_speed;                   // Celeridad pedida (m/s)
+    float friction;                     // Darcy-Weisbach
+    // Calculado en MOC_finalize
+    uint16_t first;                     // Índice del primer punto en los arreglos globales
+    uint16_t reaches;                   // N tramos (N + 1 puntos)
+    float wave_speed_adj;               // Celeridad ajustada a la malla
+    float B;                            // a / (g A)
+    float R;                            // f dx / (2 g D A^2)
+} MOC_pipe_t;
+
+typedef struct {
+    uint64_t steps;
+    uint64_t point_updates;             // Puntos interiores + extremos actualizados
+} MOC_stats_t;
+
+typedef struct {
+    float dt;
+    float time;                         // Tiempo simulado (s)
+    MOC_pipe_t pipes[MOC_MAX_PIPES];
+    MOC_node_t nodes[MOC_MAX_NODES];
+    uint8_t pipe_count;
+    uint8_t node_count;
+    uint16_t point_count;
+    bool ready;
+    // Malla (estructura de arreglos, doble buffer)
+    float h[2][MOC_MAX_POINTS];
+    float q[2][MOC_MAX_POINTS];
+    float node_h[MOC_MAX_NODES];
+    uint8_t cur;                        // Buffer con el instante actual
+    // Progreso del paso en curso
+    uint8_t cursor_pipe;
+    uint16_t cursor_point;
+    MOC_stats_t stats;
+} MOC_solver_t;
+
+/**
+ * @brief Inicializa un solver vacío
+ */
+void MOC_init(MOC_solver_t *s);
+
+/**
+ * @brief Añade un nodo de contorno
+ * @return Índice del nodo o -1 si no hay sitio
+ */
+int MOC_add_node(MOC_solver_t *s, MOC_node_type_t type, float head, float demand);
+
+/**
+ * @brief Añade una tubería entre dos nodos (sentido positivo from -> to)
+ * @return Índice de la tubería o -1
+ */
+int MOC_add_pipe(MOC_solver_t *s, uint8_t from, uint8_t to, float length, float diameter,
+                 float wave_speed, float friction);
+
+/**
+ * @brief Fija el paso de tiempo y construye la malla
+ * @return false si una tubería queda sin tramos, la malla no cabe o una
+ *         válvula no está en el extremo aguas abajo de exactamente una tubería
+ */
+bool MOC_finalize(MOC_solver_t *s, float dt);
+
+/**
+ * @brief Régimen permanente de una tubería: caudal Q0 y pérdida lineal desde h_from
+ */
+void MOC_set_pipe_steady(MOC_solver_t *s, uint8_t pipe, float q0, float h_from);
+
+/**
+ * @brief Calibra una válvula con su punto de operación permanente (caudal y pérdida)
+ */
+void MOC_set_valve_steady(MOC_solver_t *s, uint8_t node, float q0, float dh0);
+
+/**
+ * @brief Cambia la apertura relativa de una válvula (0 = cerrada)
+ */
+void MOC_set_valve_opening(MOC_solver_t *s, uint8_t node, float tau);
+
+/**
+ * @brief Avanza el paso en curso como mucho 'max_points' puntos interiores
+ * @param max_points 0 = paso completo
+ * @return true si el paso terminó (el tiempo avanzó dt)
+ */
+bool MOC_step(MOC_solver_t *s, uint32_t max_points);
+
+float MOC_head(const MOC_solver_t *s, uint8_t pipe, uint16_t point);
+float MOC_flow(const MOC_solver_t *s, uint8_t pipe, uint16_t point);
+float MOC_node_head(const MOC_solver_t *s, uint8_t node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOC_AIOT_H
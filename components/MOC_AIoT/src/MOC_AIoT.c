@@ -0,0 +1,245 @@
+#include "MOC_AIoT.h"
+#include <math.h>
+#include <string.h>
+
+#define MOC_PI 3.14159265f
+
+// -----------------------------------------------------------------------------
+// Construcción de la red
+// -----------------------------------------------------------------------------
+
+void MOC_init(MOC_solver_t *s) {
+    memset(s, 0, sizeof(*s));
+}
+
+int MOC_add_node(MOC_solver_t *s, MOC_node_type_t type, float head, float demand) {
+    if (s->ready || s->node_count >= MOC_MAX_NODES) return -1;
+    MOC_node_t *n = &s->nodes[s->node_count];
+    memset(n, 0, sizeof(*n));
+    n->type = type;
+    n->head = head;
+    n->demand = demand;
+    n->tau = 1.0f;
+    s->node_h[s->node_count] = head;
+    return s->node_count++;
+}
+
+int MOC_add_pipe(MOC_solver_t *s, uint8_t from, uint8_t to, float length, float diameter,
+                 float wave_speed, float friction) {
+    if (s->ready || s->pipe_count >= MOC_MAX_PIPES) return -1;
+    if (from >= s->node_count || to >= s->node_count || from == to) return -1;
+    if (length <= 0.0f || diameter <= 0.0f || wave_speed <= 0.0f) return -1;
+
+    MOC_pipe_t *p = &s->pipes[s->pipe_count];
+    memset(p, 0, sizeof(*p));
+    p->from = from;
+    p->to = to;
+    p->length = length;
+    p->diameter = diameter;
+    p->wave_speed = wave_speed;
+    p->friction = friction;
+    s->nodes[from].pipe_count++;
+    s->nodes[to].pipe_count++;
+    return s->pipe_count++;
+}
+
+bool MOC_finalize(MOC_solver_t *s, float dt) {
+    if (s->ready || dt <= 0.0f || s->pipe_count == 0) return false;
+
+    uint32_t points = 0;
+    for (uint8_t i = 0; i < s->pipe_count; i++) {
+        MOC_pipe_t *p = &s->pipes[i];
+        int n = (int)lroundf(p->length / (p->wave_speed * dt));
+        if (n < 1) return false;                                // Tubería más corta que a*dt
+
+        p->first = (uint16_t)points;
+        p->reaches = (uint16_t)n;
+        points += (uint32_t)n + 1;
+        if (points > MOC_MAX_POINTS) return false;
+
+        float area = MOC_PI * p->diameter * p->diameter / 4.0f;
+        float dx = p->length / (float)n;
+        p->wave_speed_adj = dx / dt;
+        p->B = p->wave_speed_adj / (MOC_GRAVITY * area);
+        p->R = p->friction * dx / (2.0f * MOC_GRAVITY * p->diameter * area * area);
+
+        // La válvula solo se modela en el extremo aguas abajo de una única tubería
+        if (s->nodes[p->from].type == MOC_NODE_VALVE) return false;
+    }
+    for (uint8_t k = 0; k < s->node_count; k++) {
+        if (s->nodes[k].type == MOC_NODE_VALVE && s->nodes[k].pipe_count != 1) return false;
+        if (s->nodes[k].pipe_count == 0) return false;
+    }
+
+    s->dt = dt;
+    s->point_count = (uint16_t)points;
+    s->ready = true;
+    return true;
+}
+
+void MOC_set_pipe_steady(MOC_solver_t *s, uint8_t pipe, float q0, float h_from) {
+    if (!s->ready || pipe >= s->pipe_count) return;
+    const MOC_pipe_t *p = &s->pipes[pipe];
+    // Pérdida por tramo igual a la del esquema discreto: R Q |Q|
+    float loss = p->R * q0 * fabsf(q0);
+    for (uint16_t i = 0; i <= p->reaches; i++) {
+        for (int b = 0; b < 2; b++) {
+            s->h[b][p->first + i] = h_from - loss * (float)i;
+            s->q[b][p->first + i] = q0;
+        }
+    }
+    s->node_h[p->from] = h_from;
+    s->node_h[p->to] = h_from - loss * (float)p->reaches;
+}
+
+void MOC_set_valve_steady(MOC_solver_t *s, uint8_t node, float q0, float dh0) {
+    if (node >= s->node_count || s->nodes[node].type != MOC_NODE_VALVE || dh0 <= 0.0f) return;
+    s->nodes[node].valve_cv2 = q0 * q0 / (2.0f * dh0);
+}
+
+void MOC_set_valve_opening(MOC_solver_t *s, uint8_t node, float tau) {
+    if (node >= s->node_count || s->nodes[node].type != MOC_NODE_VALVE) return;
+    if (tau < 0.0f) tau = 0.0f;
+    s->nodes[node].tau = tau;
+}
+
+// -----------------------------------------------------------------------------
+// Paso de tiempo
+// -----------------------------------------------------------------------------
+
+// Características que llegan a los extremos desde el interior de la tubería
+static inline float char_plus(const float *h, const float *q, int a, float B, float R) {
+    return h[a] + B * q[a] - R * q[a] * fabsf(q[a]);
+}
+
+static inline float char_minus(const float *h, const float *q, int b, float B, float R) {
+    return h[b] - B * q[b] + R * q[b] * fabsf(q[b]);
+}
+
+static uint32_t step_interior(MOC_solver_t *s, uint32_t budget) {
+    const float *h = s->h[s->cur];
+    const float *q = s->q[s->cur];
+    float *hn = s->h[s->cur ^ 1];
+    float *qn = s->q[s->cur ^ 1];
+    uint32_t done = 0;
+
+    while (s->cursor_pipe < s->pipe_count && done < budget) {
+        const MOC_pipe_t *p = &s->pipes[s->cursor_pipe];
+        const float B = p->B, R = p->R, inv2B = 0.5f / p->B;
+        uint32_t last = p->reaches;                             // Interiores: 1 .. N-1
+        uint32_t i = s->cursor_point ? s->cursor_point : 1;
+        uint32_t end = last;
+        if (last - i > budget - done) end = i + (budget - done);
+
+        for (uint32_t k = p->first + i; k < p->first + end; k++) {
+            float cp = char_plus(h, q, (int)k - 1, B, R);
+            float cm = char_minus(h, q, (int)k + 1, B, R);
+            hn[k] = 0.5f * (cp + cm);
+            qn[k] = (cp - cm) * inv2B;
+        }
+        done += end - i;
+
+        if (end >= last) {
+            s->cursor_pipe++;
+            s->cursor_point = 0;
+        } else {
+            s->cursor_point = (uint16_t)end;
+        }
+    }
+    return done;
+}
+
+static void step_boundaries(MOC_solver_t *s) {
+    const float *h = s->h[s->cur];
+    const float *q = s->q[s->cur];
+    float *hn = s->h[s->cur ^ 1];
+    float *qn = s->q[s->cur ^ 1];
+    float sum_c[MOC_MAX_NODES] = {0};
+    float sum_inv_b[MOC_MAX_NODES] = {0};
+    float valve_cp[MOC_MAX_NODES];
+
+    // Continuidad en cada nodo: Q_in = (C+ - H) / B, Q_out = (H - C-) / B
+    for (uint8_t i = 0; i < s->pipe_count; i++) {
+        const MOC_pipe_t *p = &s->pipes[i];
+        int last = p->first + p->reaches;
+        float cp = char_plus(h, q, last - 1, p->B, p->R);
+        float cm = char_minus(h, q, p->first + 1, p->B, p->R);
+        sum_c[p->to] += cp / p->B;
+        sum_inv_b[p->to] += 1.0f / p->B;
+        sum_c[p->from] += cm / p->B;
+        sum_inv_b[p->from] += 1.0f / p->B;
+        valve_cp[p->to] = cp;
+    }
+
+    for (uint8_t k = 0; k < s->node_count; k++) {
+        const MOC_node_t *n = &s->nodes[k];
+        switch (n->type) {
+        case MOC_NODE_RESERVOIR:
+            s->node_h[k] = n->head;
+            break;
+        case MOC_NODE_JUNCTION:
+            s->node_h[k] = (sum_c[k] - n->demand) / sum_inv_b[k];
+            break;
+        case MOC_NODE_VALVE: {
+            // Q = -B Cv + sqrt((B Cv)^2 + 2 Cv (C+ - Hd)), con Cv = cv2 * tau^2
+            float B = 1.0f / sum_inv_b[k];
+            float cv = n->valve_cv2 * n->tau * n->tau;
+            float dh = valve_cp[k] - n->head;
+            float bcv = B * cv;
+            float qv;
+            if (cv <= 0.0f) qv = 0.0f;
+            else if (dh >= 0.0f) qv = -bcv + sqrtf(bcv * bcv + 2.0f * cv * dh);
+            else qv = bcv - sqrtf(bcv * bcv - 2.0f * cv * dh);
+            s->node_h[k] = valve_cp[k] - B * qv;
+            break;
+        }
+        }
+    }
+
+    for (uint8_t i = 0; i < s->pipe_count; i++) {
+        const MOC_pipe_t *p = &s->pipes[i];
+        int last = p->first + p->reaches;
+        float cp = char_plus(h, q, last - 1, p->B, p->R);
+        float cm = char_minus(h, q, p->first + 1, p->B, p->R);
+
+        hn[p->first] = s->node_h[p->from];
+        qn[p->first] = (s->node_h[p->from] - cm) / p->B;
+        hn[last] = s->node_h[p->to];
+        qn[last] = (cp - s->node_h[p->to]) / p->B;
+    }
+    s->stats.point_updates += 2u * s->pipe_count;
+}
+
+bool MOC_step(MOC_solver_t *s, uint32_t max_points) {
+    if (!s->ready) return false;
+    if (max_points == 0) max_points = UINT32_MAX;
+
+    s->stats.point_updates += step_interior(s, max_points);
+    if (s->cursor_pipe < s->pipe_count) return false;
+
+    step_boundaries(s);
+    s->cur ^= 1;
+    s->cursor_pipe = 0;
+    s->cursor_point = 0;
+    s->time += s->dt;
+    s->stats.steps++;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Consulta
+// -----------------------------------------------------------------------------
+
+float MOC_head(const MOC_solver_t *s, uint8_t pipe, uint16_t point) {
+    if (pipe >= s->pipe_count || point > s->pipes[pipe].reaches) return 0.0f;
+    return s->h[s->cur][s->pipes[pipe].first + point];
+}
+
+float MOC_flow(const MOC_solver_t *s, uint8_t pipe, uint16_t point) {
+    if (pipe >= s->pipe_count || point > s->pipes[pipe].reaches) return 0.0f;
+    return s->q[s->cur][s->pipes[pipe].first + point];
+}
+
+float MOC_node_head(const MOC_solver_t *s, uint8_t node) {
+    return (node < s->node_count) ? s->node_h[node] : 0.0f;
+}
@@ -0,0 +1,119 @@
+#ifndef SAMPLERING_AIOT_H
+#define SAMPLERING_AIOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Anillo lock-free de bloques de muestras (adquisición -> UI / DSP / red)
+//
+// - Un solo productor (tarea de adquisición, núcleo 1).
+// - Hasta SRING_MAX_CONSUMERS consumidores, cada uno con su propio cursor:
+//   cada par productor/consumidor es SPSC, sin mutex.
+// - Los consumidores leen el bloque en su lugar (sin copia) y lo liberan.
+// - El productor nunca bloquea: si el anillo está lleno descarta el bloque
+//   nuevo y cuenta un overrun.
+// -----------------------------------------------------------------------------
+
+#define SRING_CHANNELS          16
+#define SRING_BLOCK_SAMPLES     64      // Muestras por canal en cada bloque
+#define SRING_MAX_CONSUMERS     4
+
+/**
+ * @brief Bloque de muestras (estructura de arreglos: un arreglo contiguo por canal)
+ */
+typedef struct {
+    uint32_t seq;                       // Secuencia de bloque asignada por el productor
+    int64_t timestamp_us;               // Tiempo local (esp_timer) de la primera muestra
+    uint32_t sample_period_us;          // Periodo de muestreo
+    uint32_t node_time_us;              // Marca de tiempo enviada por el nodo
+    uint16_t channel_mask;              // Canales válidos (bit n = canal n)
+    uint8_t node;                       // Dirección del nodo de origen
+    uint8_t count;                      // Muestras válidas por canal (<= SRING_BLOCK_SAMPLES)
+    int16_t data[SRING_CHANNELS][SRING_BLOCK_SAMPLES];
+} SampleRing_block_t;
+
+typedef struct SampleRing SampleRing_t;
+
+/**
+ * @brief Contadores del anillo
+ */
+typedef struct {
+    uint32_t capacity;                  // Bloques totales
+    uint32_t committed;                 // Bloques publicados por el productor
+    uint32_t overruns;                  // Bloques descartados por anillo lleno
+    uint32_t high_water;                // Ocupación máxima observada (bloques)
+} SampleRing_stats_t;
+
+/**
+ * @brief Contadores por consumidor
+ */
+typedef struct {
+    uint32_t consumed;
+    uint32_t lag;                       // Bloques pendientes ahora mismo
+    uint32_t lag_high_water;            // Máximo retraso observado
+    uint32_t resyncs;                   // Veces que se reactivó y saltó al bloque más reciente
+    bool active;
+} SampleRing_consumer_stats_t;
+
+/**
+ * @brief Crea el anillo (una sola asignación, en PSRAM si existe)
+ * @param capacity_blocks Se redondea a potencia de dos
+ */
+SampleRing_t *SampleRing_create(uint32_t capacity_blocks);
+
+void SampleRing_destroy(SampleRing_t *ring);
+
+// --- PRODUCTOR ---------------------------------------------------------------
+
+/**
+ * @brief Reserva el siguiente bloque libre para escribir en su lugar
+ * @return NULL si el anillo está lleno (se cuenta un overrun)
+ */
+SampleRing_block_t *SampleRing_acquire(SampleRing_t *ring);
+
+/**
+ * @brief Publica el bloque reservado con SampleRing_acquire
+ */
+void SampleRing_commit(SampleRing_t *ring);
+
+// --- CONSUMIDORES ------------------------------------------------------------
+
+/**
+ * @brief Registra un consumidor (desde una sola tarea de inicialización)
+ * Empieza a leer desde el bloque más reciente; puede hacerse con el productor en marcha.
+ * @return Id del consumidor o -1 si no hay cupo
+ */
+int SampleRing_register_consumer(SampleRing_t *ring, const char *name);
+
+/**
+ * @brief Bloque más antiguo sin leer para este consumidor, o NULL
+ * El puntero es válido hasta SampleRing_release.
+ */
+const SampleRing_block_t *SampleRing_peek(SampleRing_t *ring, int consumer);
+
+/**
+ * @brief Libera el bloque devuelto por SampleRing_peek
+ */
+void SampleRing_release(SampleRing_t *ring, int consumer);
+
+/**
+ * @brief Activa o pausa un consumidor
+ * Un consumidor pausado no frena al productor; al reactivarse salta al bloque
+ * más reciente (p. ej. la UI con la pantalla apagada).
+ */
+void SampleRing_set_consumer_active(SampleRing_t *ring, int consumer, bool active);
+
+void SampleRing_get_stats(const SampleRing_t *ring, SampleRing_stats_t *stats);
+void SampleRing_get_consumer_stats(const SampleRing_t *ring, int consumer, SampleRing_consumer_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLERING_AIOT_H
@@ -0,0 +1,207 @@
+#include "SampleRing_AIoT.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+static const char *TAG = "SampleRing";
+#endif
+
+// Cada cursor en su propia línea de caché para que productor y consumidores
+// no se invaliden mutuamente.
+#define SRING_CACHE_LINE 32
+
+typedef struct {
+    _Alignas(SRING_CACHE_LINE) atomic_uint tail;   // Escrito solo por su consumidor
+    atomic_bool active;
+    const char *name;
+    uint32_t consumed;
+    uint32_t lag_high_water;
+    uint32_t resyncs;
+} sring_cursor_t;
+
+struct SampleRing {
+    _Alignas(SRING_CACHE_LINE) atomic_uint head;   // Escrito solo por el productor
+    uint32_t mask;
+    uint32_t committed;
+    uint32_t overruns;
+    uint32_t high_water;
+    atomic_int consumer_count;                     // Publicado tras inicializar el cursor
+    sring_cursor_t cursors[SRING_MAX_CONSUMERS];
+    SampleRing_block_t *blocks;                    // PSRAM
+};
+
+// -----------------------------------------------------------------------------
+// Memoria
+// -----------------------------------------------------------------------------
+
+static void *sring_alloc_blocks(size_t bytes) {
+#ifdef ESP_PLATFORM
+    void *p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!p) {
+        ESP_LOGW(TAG, "Sin PSRAM, usando RAM interna (%u bytes)", (unsigned)bytes);
+        p = heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
+    }
+    return p;
+#else
+    return malloc(bytes);
+#endif
+}
+
+static void sring_free_blocks(void *p) {
+#ifdef ESP_PLATFORM
+    heap_caps_free(p);
+#else
+    free(p);
+#endif
+}
+
+SampleRing_t *SampleRing_create(uint32_t capacity_blocks) {
+    uint32_t cap = 2;
+    while (cap < capacity_blocks) cap <<= 1;
+
+    SampleRing_t *ring = calloc(1, sizeof(SampleRing_t));
+    if (!ring) return NULL;
+
+    ring->blocks = sring_alloc_blocks((size_t)cap * sizeof(SampleRing_block_t));
+    if (!ring->blocks) {
+        free(ring);
+        return NULL;
+    }
+    ring->mask = cap - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->consumer_count, 0);
+    for (int i = 0; i < SRING_MAX_CONSUMERS; i++) {
+        atomic_init(&ring->cursors[i].tail, 0);
+        atomic_init(&ring->cursors[i].active, false);
+    }
+#ifdef ESP_PLATFORM
+    ESP_LOGI(TAG, "Anillo creado: %u bloques x %u bytes", (unsigned)cap, (unsigned)sizeof(SampleRing_block_t));
+#endif
+    return ring;
+}
+
+void SampleRing_destroy(SampleRing_t *ring) {
+    if (!ring) return;
+    sring_free_blocks(ring->blocks);
+    free(ring);
+}
+
+// -----------------------------------------------------------------------------
+// Productor
+// -----------------------------------------------------------------------------
+
+// Ocupación respecto al consumidor activo más retrasado
+static uint32_t sring_used(SampleRing_t *ring, uint32_t head) {
+    uint32_t used = 0;
+    int count = atomic_load_explicit(&ring->consumer_count, memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        sring_cursor_t *c = &ring->cursors[i];
+        if (!atomic_load_explicit(&c->active, memory_order_acquire)) continue;
+        uint32_t lag = head - atomic_load_explicit(&c->tail, memory_order_acquire);
+        if (lag > used) used = lag;
+    }
+    return used;
+}
+
+SampleRing_block_t *SampleRing_acquire(SampleRing_t *ring) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (sring_used(ring, head) > ring->mask) {
+        ring->overruns++;
+        return NULL;
+    }
+    return &ring->blocks[head & ring->mask];
+}
+
+void SampleRing_commit(SampleRing_t *ring) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    ring->blocks[head & ring->mask].seq = head;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    ring->committed++;
+
+    uint32_t used = sring_used(ring, head + 1);
+    if (used > ring->high_water) ring->high_water = used;
+}
+
+// -----------------------------------------------------------------------------
+// Consumidores
+// -----------------------------------------------------------------------------
+
+static bool sring_valid(const SampleRing_t *ring, int consumer) {
+    return consumer >= 0 &&
+           consumer < atomic_load_explicit(&((SampleRing_t *)ring)->consumer_count, memory_order_acquire);
+}
+
+int SampleRing_register_consumer(SampleRing_t *ring, const char *name) {
+    if (!ring) return -1;
+    int id = atomic_load_explicit(&ring->consumer_count, memory_order_relaxed);
+    if (id >= SRING_MAX_CONSUMERS) return -1;
+    sring_cursor_t *c = &ring->cursors[id];
+    c->name = name;
+    atomic_store_explicit(&c->tail, atomic_load_explicit(&ring->head, memory_order_acquire), memory_order_relaxed);
+    atomic_store_explicit(&c->active, true, memory_order_relaxed);
+    atomic_store_explicit(&ring->consumer_count, id + 1, memory_order_release);
+    return id;
+}
+
+const SampleRing_block_t *SampleRing_peek(SampleRing_t *ring, int consumer) {
+    if (!ring || !sring_valid(ring, consumer)) return NULL;
+    sring_cursor_t *c = &ring->cursors[consumer];
+    if (!atomic_load_explicit(&c->active, memory_order_relaxed)) return NULL;
+
+    uint32_t tail = atomic_load_explicit(&c->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail == head) return NULL;
+
+    uint32_t lag = head - tail;
+    if (lag > c->lag_high_water) c->lag_high_water = lag;
+    return &ring->blocks[tail & ring->mask];
+}
+
+void SampleRing_release(SampleRing_t *ring, int consumer) {
+    if (!ring || !sring_valid(ring, consumer)) return;
+    sring_cursor_t *c = &ring->cursors[consumer];
+    uint32_t tail = atomic_load_explicit(&c->tail, memory_order_relaxed);
+    if (tail == atomic_load_explicit(&ring->head, memory_order_acquire)) return;
+    atomic_store_explicit(&c->tail, tail + 1, memory_order_release);
+    c->consumed++;
+}
+
+void SampleRing_set_consumer_active(SampleRing_t *ring, int consumer, bool active) {
+    if (!ring || !sring_valid(ring, consumer)) return;
+    sring_cursor_t *c = &ring->cursors[consumer];
+    if (active == atomic_load_explicit(&c->active, memory_order_relaxed)) return;
+
+    if (active) {
+        // Al volver, lo pendiente ya no es válido: saltamos al bloque más reciente
+        atomic_store_explicit(&c->tail, atomic_load_explicit(&ring->head, memory_order_acquire), memory_order_relaxed);
+        atomic_store_explicit(&c->active, true, memory_order_seq_cst);
+        // El productor pudo reservar un bloque sin vernos activos y la cabeza
+        // leída arriba puede haberse quedado atrás: se vuelve a leer ya visibles
+        atomic_store_explicit(&c->tail, atomic_load_explicit(&ring->head, memory_order_seq_cst), memory_order_release);
+        c->resyncs++;
+        return;
+    }
+    atomic_store_explicit(&c->active, false, memory_order_release);
+}
+
+void SampleRing_get_stats(const SampleRing_t *ring, SampleRing_stats_t *stats) {
+    if (!ring || !stats) return;
+    stats->capacity = ring->mask + 1;
+    stats->committed = ring->committed;
+    stats->overruns = ring->overruns;
+    stats->high_water = ring->high_water;
+}
+
+void SampleRing_get_consumer_stats(const SampleRing_t *ring, int consumer, SampleRing_consumer_stats_t *stats) {
+    if (!ring || !stats || !sring_valid(ring, consumer)) return;
+    const sring_cursor_t *c = &ring->cursors[consumer];
+    uint32_t head = atomic_load_explicit(&((SampleRing_t *)ring)->head, memory_order_acquire);
+    stats->consumed = c->consumed;
+    stats->lag = head - atomic_load_explicit(&((sring_cursor_t *)c)->tail, memory_order_acquire);
+    stats->lag_high_water = c->lag_high_water;
+    stats->resyncs = c->resyncs;
+    stats->active = atomic_load_explicit(&((sring_cursor_t *)c)->active, memory_order_relaxed);
+}
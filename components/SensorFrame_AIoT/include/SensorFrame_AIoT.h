@@ -0,0 +1,162 @@
+#ifndef SENSORFRAME_AIOT_H
+#define SENSORFRAME_AIOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "UARTn_AIoT.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// FORMATO DE TRAMA BINARIA (nodos de 16 canales) - Little Endian
+//
+//  Offset  Bytes  Campo
+//  0       2      Sync 0xA5 0x5A
+//  2       1      Dirección del nodo
+//  3       1      Muestras por canal (1..SFRAME_MAX_SAMPLES)
+//  4       2      Número de secuencia (por nodo, incrementa de 1 en 1)
+//  6       2      Mapa de canales (bit n = canal n presente)
+//  8       4      Marca de tiempo del nodo (us)
+//  12      2*k*n  Muestras int16 intercaladas: s0[ch_a, ch_b, ...], s1[...], ...
+//  fin-2   2      CRC-16/CCITT-FALSE (desde el byte 2 hasta el último dato)
+// -----------------------------------------------------------------------------
+
+#define SFRAME_SYNC0            0xA5
+#define SFRAME_SYNC1            0x5A
+#define SFRAME_HEADER_LEN       12
+#define SFRAME_CRC_LEN          2
+#define SFRAME_MAX_CHANNELS     16
+#define SFRAME_MAX_SAMPLES      64
+#define SFRAME_MAX_PAYLOAD      (SFRAME_MAX_CHANNELS * SFRAME_MAX_SAMPLES * 2)
+#define SFRAME_MAX_FRAME_LEN    (SFRAME_HEADER_LEN + SFRAME_MAX_PAYLOAD + SFRAME_CRC_LEN)
+
+// -----------------------------------------------------------------------------
+// PETICIÓN DE SONDEO (maestro -> nodo), 8 bytes
+//
+//  0  2  Sync 0xC3 0x3C
+//  2  1  Dirección del nodo
+//  3  1  Máximo de muestras por canal a devolver
+//  4  2  Secuencia de la petición
+//  6  2  CRC-16/CCITT-FALSE (bytes 2..5)
+//
+// El nodo responde con una trama normal cuyo número de secuencia es el de la
+// petición: así el maestro distingue la respuesta a un intento ya vencido.
+// -----------------------------------------------------------------------------
+
+#define SFRAME_POLL_SYNC0       0xC3
+#define SFRAME_POLL_SYNC1       0x3C
+#define SFRAME_POLL_LEN         8
+
+/**
+ * @brief Vista sin copia de una trama completa y validada
+ *
+ * 'payload' apunta directamente al anillo RX del UART (o al buffer interno del
+ * decodificador si la trama quedó partida por el wrap del anillo). La vista es
+ * válida hasta la siguiente llamada a SensorFrame_poll / SensorFrame_release.
+ */
+typedef struct {
+    uint8_t node;
+    uint8_t samples_per_channel;
+    uint8_t channel_count;
+    uint16_t seq;
+    uint16_t channel_mask;
+    uint32_t node_time_us;
+    const uint8_t *payload;     // int16 LE intercalados, sin garantía de alineación
+    uint16_t frame_len;         // Longitud total en bytes (cabecera + datos + CRC)
+} SensorFrame_view_t;
+
+/**
+ * @brief Contadores del decodificador
+ */
+typedef struct {
+    uint32_t frames_ok;
+    uint32_t crc_errors;
+    uint32_t header_errors;     // Cabeceras imposibles (se resincroniza)
+    uint32_t seq_gap_events;    // Veces que se detectó un salto de secuencia
+    uint32_t seq_lost_frames;   // Total de tramas perdidas según la secuencia
+    uint32_t bytes_skipped;     // Basura descartada buscando el sync
+    uint32_t wrapped_frames;    // Tramas copiadas al buffer interno por el wrap del anillo
+} SensorFrame_stats_t;
+
+/**
+ * @brief Estado del decodificador (reanudable entre llamadas, sin memoria dinámica)
+ */
+typedef struct {
+    // Trama candidata en curso
+    uint16_t cand_len;          // 0 = aún sin cabecera válida
+    uint16_t crc_pos;           // Bytes ya incluidos en el CRC incremental
+    uint16_t crc;
+    // Trama entregada pendiente de liberar
+    uint16_t held_len;
+    UARTn_handle_t held_uart;
+    // Secuencia por nodo
+    uint16_t last_seq[256];
+    uint8_t seq_valid[256 / 8];
+    SensorFrame_stats_t stats;
+    uint8_t scratch[SFRAME_MAX_FRAME_LEN];
+} SensorFrame_decoder_t;
+
+/**
+ * @brief Inicializa (o reinicia) el decodificador
+ */
+void SensorFrame_decoder_init(SensorFrame_decoder_t *dec);
+
+/**
+ * @brief Decodifica sobre dos segmentos de bytes (núcleo portable, sin UART)
+ *
+ * @param skip      Bytes iniciales que el llamador debe descartar ya
+ * @param frame_len Si devuelve true, bytes de la trama (tras 'skip') a liberar después
+ * @return true si 'view' contiene una trama válida
+ */
+bool SensorFrame_decode(SensorFrame_decoder_t *dec,
+                        const uint8_t *p1, size_t n1, const uint8_t *p2, size_t n2,
+                        SensorFrame_view_t *view, size_t *skip, size_t *frame_len);
+
+/**
+ * @brief Extrae la siguiente trama del anillo RX del UART sin copiarla
+ *
+ * Libera automáticamente la trama entregada en la llamada anterior.
+ * @return true si 'view' contiene una trama nueva
+ */
+bool SensorFrame_poll(SensorFrame_decoder_t *dec, UARTn_handle_t uart, SensorFrame_view_t *view);
+
+/**
+ * @brief Libera explícitamente la última trama entregada por SensorFrame_poll
+ */
+void SensorFrame_release(SensorFrame_decoder_t *dec);
+
+/**
+ * @brief Construye una trama (lado nodo / simulación)
+ * @return Longitud escrita o 0 si no cabe / parámetros inválidos
+ */
+size_t SensorFrame_encode(uint8_t *out, size_t cap, uint8_t node, uint16_t seq,
+                          uint16_t channel_mask, uint8_t samples_per_channel,
+                          uint32_t node_time_us, const int16_t *samples);
+
+/**
+ * @brief Construye una petición de sondeo para un nodo
+ * @return SFRAME_POLL_LEN o 0 si no cabe
+ */
+size_t SensorFrame_encode_poll(uint8_t *out, size_t cap, uint8_t node, uint16_t seq, uint8_t max_samples);
+
+/**
+ * @brief CRC-16/CCITT-FALSE incremental (poly 0x1021, init 0xFFFF)
+ */
+uint16_t SensorFrame_crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief Muestra 'index' (intercalada) de una vista, leída byte a byte
+ */
+static inline int16_t SensorFrame_sample(const SensorFrame_view_t *view, size_t index) {
+    const uint8_t *p = view->payload + index * 2;
+    return (int16_t)(p[0] | (p[1] << 8));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SENSORFRAME_AIOT_H
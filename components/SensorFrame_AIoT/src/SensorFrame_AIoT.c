@@ -0,0 +1,250 @@
+#include "SensorFrame_AIoT.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// CRC-16/CCITT-FALSE por tabla (256 entradas en flash)
+// -----------------------------------------------------------------------------
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+uint16_t SensorFrame_crc16(uint16_t crc, const uint8_t *data, size_t len) {
+    while (len--) {
+        crc = (uint16_t)((crc << 8) ^ crc16_table[((crc >> 8) ^ *data++) & 0xFF]);
+    }
+    return crc;
+}
+
+// Acceso a un byte lógico repartido entre los dos segmentos del anillo
+#define SPAN_AT(i) (((i) < n1) ? p1[(i)] : p2[(i) - n1])
+
+// CRC sobre el rango lógico [from, to) sin copiar
+static uint16_t crc_spans(uint16_t crc, const uint8_t *p1, size_t n1, const uint8_t *p2,
+                          size_t from, size_t to) {
+    if (from < n1) {
+        size_t end = (to < n1) ? to : n1;
+        crc = SensorFrame_crc16(crc, p1 + from, end - from);
+        from = end;
+    }
+    if (from < to) {
+        crc = SensorFrame_crc16(crc, p2 + (from - n1), to - from);
+    }
+    return crc;
+}
+
+static void track_sequence(SensorFrame_decoder_t *dec, uint8_t node, uint16_t seq) {
+    uint8_t bit = (uint8_t)(1u << (node & 7));
+    if (dec->seq_valid[node >> 3] & bit) {
+        uint16_t expected = (uint16_t)(dec->last_seq[node] + 1);
+        if (seq != expected) {
+            uint16_t gap = (uint16_t)(seq - expected);
+            dec->stats.seq_gap_events++;
+            // Un salto "hacia atrás" indica reinicio del nodo, no tramas perdidas
+            if (gap < 0x8000) dec->stats.seq_lost_frames += gap;
+        }
+    }
+    dec->seq_valid[node >> 3] |= bit;
+    dec->last_seq[node] = seq;
+}
+
+// -----------------------------------------------------------------------------
+// API
+// -----------------------------------------------------------------------------
+
+void SensorFrame_decoder_init(SensorFrame_decoder_t *dec) {
+    memset(dec, 0, sizeof(*dec));
+}
+
+bool SensorFrame_decode(SensorFrame_decoder_t *dec,
+                        const uint8_t *p1, size_t n1, const uint8_t *p2, size_t n2,
+                        SensorFrame_view_t *view, size_t *skip, size_t *frame_len) {
+    size_t avail = n1 + n2;
+    size_t pos = 0;
+    bool found = false;
+
+    *frame_len = 0;
+
+    for (;;) {
+        // 1. Buscar sync y validar cabecera
+        if (dec->cand_len == 0) {
+            while (pos + 1 < avail && !(SPAN_AT(pos) == SFRAME_SYNC0 && SPAN_AT(pos + 1) == SFRAME_SYNC1)) {
+                pos++;
+            }
+            if (pos + 1 >= avail) {
+                // Conservamos un posible primer byte de sync al final
+                if (pos < avail && SPAN_AT(pos) != SFRAME_SYNC0) pos++;
+                break;
+            }
+            if (avail - pos < SFRAME_HEADER_LEN) break;
+
+            uint8_t n = SPAN_AT(pos + 3);
+            uint16_t mask = (uint16_t)(SPAN_AT(pos + 6) | (SPAN_AT(pos + 7) << 8));
+            if (n == 0 || n > SFRAME_MAX_SAMPLES || mask == 0) {
+                dec->stats.header_errors++;
+                pos++;
+                continue;
+            }
+            dec->cand_len = (uint16_t)(SFRAME_HEADER_LEN + 2u * (unsigned)__builtin_popcount(mask) * n + SFRAME_CRC_LEN);
+            dec->crc = 0xFFFF;
+            dec->crc_pos = 2;
+        }
+
+        // 2. CRC incremental: solo sobre los bytes nuevos desde la última llamada
+        size_t have = avail - pos;
+        size_t crc_end = dec->cand_len - SFRAME_CRC_LEN;
+        size_t upto = (have < crc_end) ? have : crc_end;
+        if (upto > dec->crc_pos) {
+            dec->crc = crc_spans(dec->crc, p1, n1, p2, pos + dec->crc_pos, pos + upto);
+            dec->crc_pos = (uint16_t)upto;
+        }
+        if (have < dec->cand_len) break;
+
+        uint16_t rx_crc = (uint16_t)(SPAN_AT(pos + crc_end) | (SPAN_AT(pos + crc_end + 1) << 8));
+        if (rx_crc != dec->crc) {
+            dec->stats.crc_errors++;
+            dec->cand_len = 0;
+            pos++;
+            continue;
+        }
+
+        // 3. Trama válida: vista directa al anillo, o copia si quedó partida
+        const uint8_t *base;
+        if (pos + dec->cand_len <= n1) {
+            base = p1 + pos;
+        } else {
+            for (size_t i = 0; i < dec->cand_len; i++) dec->scratch[i] = SPAN_AT(pos + i);
+            base = dec->scratch;
+            dec->stats.wrapped_frames++;
+        }
+
+        view->node = base[2];
+        view->samples_per_channel = base[3];
+        view->seq = (uint16_t)(base[4] | (base[5] << 8));
+        view->channel_mask = (uint16_t)(base[6] | (base[7] << 8));
+        view->channel_count = (uint8_t)__builtin_popcount(view->channel_mask);
+        view->node_time_us = (uint32_t)base[8] | ((uint32_t)base[9] << 8) |
+                             ((uint32_t)base[10] << 16) | ((uint32_t)base[11] << 24);
+        view->payload = base + SFRAME_HEADER_LEN;
+        view->frame_len = dec->cand_len;
+
+        track_sequence(dec, view->node, view->seq);
+        dec->stats.frames_ok++;
+
+        *frame_len = dec->cand_len;
+        dec->cand_len = 0;
+        found = true;
+        break;
+    }
+
+    *skip = pos;
+    dec->stats.bytes_skipped += pos;
+    return found;
+}
+
+void SensorFrame_release(SensorFrame_decoder_t *dec) {
+    if (dec->held_len && dec->held_uart) {
+        UARTn_consume(dec->held_uart, dec->held_len);
+    }
+    dec->held_len = 0;
+    dec->held_uart = NULL;
+}
+
+bool SensorFrame_poll(SensorFrame_decoder_t *dec, UARTn_handle_t uart, SensorFrame_view_t *view) {
+    SensorFrame_release(dec);
+
+    const uint8_t *p1, *p2;
+    size_t n1, n2;
+    if (UARTn_peek(uart, &p1, &n1, &p2, &n2) == 0) return false;
+
+    size_t skip, frame_len;
+    bool ok = SensorFrame_decode(dec, p1, n1, p2, n2, view, &skip, &frame_len);
+
+    // La basura se libera ya; la trama se retiene hasta la siguiente llamada
+    if (skip) UARTn_consume(uart, skip);
+    if (ok) {
+        dec->held_len = (uint16_t)frame_len;
+        dec->held_uart = uart;
+    }
+    return ok;
+}
+
+size_t SensorFrame_encode(uint8_t *out, size_t cap, uint8_t node, uint16_t seq,
+                          uint16_t channel_mask, uint8_t samples_per_channel,
+                          uint32_t node_time_us, const int16_t *samples) {
+    if (!out || !samples || channel_mask == 0 ||
+        samples_per_channel == 0 || samples_per_channel > SFRAME_MAX_SAMPLES) return 0;
+
+    size_t count = (size_t)__builtin_popcount(channel_mask) * samples_per_channel;
+    size_t len = SFRAME_HEADER_LEN + count * 2 + SFRAME_CRC_LEN;
+    if (len > cap) return 0;
+
+    out[0] = SFRAME_SYNC0;
+    out[1] = SFRAME_SYNC1;
+    out[2] = node;
+    out[3] = samples_per_channel;
+    out[4] = (uint8_t)(seq & 0xFF);
+    out[5] = (uint8_t)(seq >> 8);
+    out[6] = (uint8_t)(channel_mask & 0xFF);
+    out[7] = (uint8_t)(channel_mask >> 8);
+    out[8] = (uint8_t)(node_time_us & 0xFF);
+    out[9] = (uint8_t)((node_time_us >> 8) & 0xFF);
+    out[10] = (uint8_t)((node_time_us >> 16) & 0xFF);
+    out[11] = (uint8_t)(node_time_us >> 24);
+
+    uint8_t *p = out + SFRAME_HEADER_LEN;
+    for (size_t i = 0; i < count; i++) {
+        uint16_t v = (uint16_t)samples[i];
+        *p++ = (uint8_t)(v & 0xFF);
+        *p++ = (uint8_t)(v >> 8);
+    }
+
+    uint16_t crc = SensorFrame_crc16(0xFFFF, out + 2, len - 2 - SFRAME_CRC_LEN);
+    *p++ = (uint8_t)(crc & 0xFF);
+    *p = (uint8_t)(crc >> 8);
+    return len;
+}
+
+size_t SensorFrame_encode_poll(uint8_t *out, size_t cap, uint8_t node, uint16_t seq, uint8_t max_samples) {
+    if (!out || cap < SFRAME_POLL_LEN) return 0;
+    out[0] = SFRAME_POLL_SYNC0;
+    out[1] = SFRAME_POLL_SYNC1;
+    out[2] = node;
+    out[3] = max_samples;
+    out[4] = (uint8_t)(seq & 0xFF);
+    out[5] = (uint8_t)(seq >> 8);
+    uint16_t crc = SensorFrame_crc16(0xFFFF, out + 2, 4);
+    out[6] = (uint8_t)(crc & 0xFF);
+    out[7] = (uint8_t)(crc >> 8);
+    return SFRAME_POLL_LEN;
+}
@@ -0,0 +1,63 @@
+#ifndef TASKMONITOR_AIOT_H
+#define TASKMONITOR_AIOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Monitor de tareas: periodo, jitter y uso de CPU por tarea
+//
+// Cada tarea marca el inicio y el fin de su trabajo en cada vuelta:
+//
+//     int id = TaskMon_register("ui", 0);
+//     for (;;) { TaskMon_begin(id); ...trabajo...; TaskMon_end(id); esperar(); }
+//
+// Una vuelta va del primer TaskMon_begin al TaskMon_end (un begin repetido
+// sin end se ignora), así que un bucle que procesa varias tramas por
+// despertar puede llamar a begin en cada iteración y a end antes de dormir.
+//
+// Solo la propia tarea escribe en su entrada (campos de 32 bits), así que
+// cualquier otra tarea puede leer las estadísticas sin bloqueo.
+// -----------------------------------------------------------------------------
+
+#define TASKMON_MAX_TASKS       12
+#define TASKMON_WINDOW_US       1000000     // Ventana de cálculo del uso de CPU
+
+typedef struct {
+    const char *name;
+    uint32_t nominal_period_us;         // 0 = tarea por eventos
+    uint32_t runs;
+    uint32_t period_avg_us;             // Media móvil entre inicios consecutivos
+    uint32_t jitter_avg_us;             // |periodo - nominal| (o - media si es por eventos)
+    uint32_t jitter_max_us;
+    uint32_t exec_avg_us;
+    uint32_t exec_max_us;
+    uint16_t cpu_permille;              // Tiempo ocupado / tiempo real en la última ventana
+} TaskMon_stats_t;
+
+/**
+ * @brief Registra una tarea (llamar una vez, desde cualquier tarea)
+ * @return Id o -1 si no hay sitio
+ */
+int TaskMon_register(const char *name, uint32_t nominal_period_us);
+
+void TaskMon_begin(int id);
+void TaskMon_end(int id);
+
+int TaskMon_count(void);
+bool TaskMon_get_stats(int id, TaskMon_stats_t *stats);
+
+/**
+ * @brief Vuelca la tabla de todas las tareas al log
+ */
+void TaskMon_log_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASKMONITOR_AIOT_H
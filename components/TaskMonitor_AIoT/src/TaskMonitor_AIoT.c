@@ -0,0 +1,119 @@
+#include "TaskMonitor_AIoT.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "TaskMon";
+
+#define TASKMON_EWMA_SHIFT      3       // Medias móviles con peso 1/8
+
+typedef struct {
+    TaskMon_stats_t s;
+    int64_t last_start_us;
+    int64_t cur_start_us;
+    int64_t window_start_us;
+    uint32_t window_busy_us;
+} taskmon_entry_t;
+
+static taskmon_entry_t s_tasks[TASKMON_MAX_TASKS];
+static volatile int s_count = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline uint32_t ewma(uint32_t avg, uint32_t x) {
+    return (uint32_t)((int32_t)avg + (((int32_t)x - (int32_t)avg) >> TASKMON_EWMA_SHIFT));
+}
+
+// -----------------------------------------------------------------------------
+// Registro
+// -----------------------------------------------------------------------------
+
+int TaskMon_register(const char *name, uint32_t nominal_period_us) {
+    int id = -1;
+    taskENTER_CRITICAL(&s_lock);
+    if (s_count < TASKMON_MAX_TASKS) {
+        id = s_count;
+        memset(&s_tasks[id], 0, sizeof(s_tasks[id]));
+        s_tasks[id].s.name = name;
+        s_tasks[id].s.nominal_period_us = nominal_period_us;
+        s_count = id + 1;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+    if (id < 0) ESP_LOGW(TAG, "Sin sitio para la tarea %s", name);
+    return id;
+}
+
+// -----------------------------------------------------------------------------
+// Medición
+// -----------------------------------------------------------------------------
+
+void TaskMon_begin(int id) {
+    if (id < 0 || id >= s_count) return;
+    taskmon_entry_t *e = &s_tasks[id];
+    if (e->cur_start_us) return;                // Vuelta ya abierta: cuenta desde el primer begin
+    int64_t now = esp_timer_get_time();
+
+    if (e->last_start_us) {
+        uint32_t period = (uint32_t)(now - e->last_start_us);
+        // Primera medida: arranca la media en el valor real
+        e->s.period_avg_us = e->s.runs > 1 ? ewma(e->s.period_avg_us, period) : period;
+        uint32_t ref = e->s.nominal_period_us ? e->s.nominal_period_us : e->s.period_avg_us;
+        uint32_t jitter = period > ref ? period - ref : ref - period;
+        e->s.jitter_avg_us = ewma(e->s.jitter_avg_us, jitter);
+        if (jitter > e->s.jitter_max_us) e->s.jitter_max_us = jitter;
+    } else {
+        e->window_start_us = now;
+    }
+    e->last_start_us = now;
+    e->cur_start_us = now;
+}
+
+void TaskMon_end(int id) {
+    if (id < 0 || id >= s_count) return;
+    taskmon_entry_t *e = &s_tasks[id];
+    if (!e->cur_start_us) return;
+    int64_t now = esp_timer_get_time();
+
+    uint32_t exec = (uint32_t)(now - e->cur_start_us);
+    e->cur_start_us = 0;
+    e->s.exec_avg_us = e->s.runs ? ewma(e->s.exec_avg_us, exec) : exec;
+    if (exec > e->s.exec_max_us) e->s.exec_max_us = exec;
+    e->s.runs++;
+
+    // Uso de CPU: tiempo entre begin y end dentro de la ventana (incluye
+    // expropiaciones por tareas de más prioridad, es una cota superior)
+    e->window_busy_us += exec;
+    int64_t span = now - e->window_start_us;
+    if (span >= TASKMON_WINDOW_US) {
+        uint64_t pm = (uint64_t)e->window_busy_us * 1000u / (uint64_t)span;
+        e->s.cpu_permille = (uint16_t)(pm > 1000u ? 1000u : pm);
+        e->window_busy_us = 0;
+        e->window_start_us = now;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Consulta
+// -----------------------------------------------------------------------------
+
+int TaskMon_count(void) {
+    return s_count;
+}
+
+bool TaskMon_get_stats(int id, TaskMon_stats_t *stats) {
+    if (id < 0 || id >= s_count || !stats) return false;
+    *stats = s_tasks[id].s;
+    return true;
+}
+
+void TaskMon_log_all(void) {
+    for (int i = 0; i < s_count; i++) {
+        const TaskMon_stats_t *s = &s_tasks[i].s;
+        ESP_LOGI(TAG, "%-10s T=%6luus (nom %6lu) jit=%5lu/%5lu exec=%5lu/%5lu cpu=%u.%u%% n=%lu",
+                 s->name, (unsigned long)s->period_avg_us, (unsigned long)s->nominal_period_us,
+                 (unsigned long)s->jitter_avg_us, (unsigned long)s->jitter_max_us,
+                 (unsigned long)s->exec_avg_us, (unsigned long)s->exec_max_us,
+                 s->cpu_permille / 10u, s->cpu_permille % 10u, (unsigned long)s->runs);
+    }
+}
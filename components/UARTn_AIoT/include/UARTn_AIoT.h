@@ -12,6 +12,85 @@ extern "C" {
 // DEFINICIÓN DEL HANDLE OPACO
 typedef struct UARTn_Instance* UARTn_handle_t;
 
+/**
+ * @brief Modo de línea física
+ */
+typedef enum {
+    UARTN_MODE_UART = 0,            // Full-duplex sin control de flujo
+    UARTN_MODE_RTS_CTS,             // Control de flujo por hardware RTS/CTS
+    UARTN_MODE_RS485_HALF_DUPLEX,   // RS-485 semidúplex (RTS controla el DE del transceptor)
+} UARTn_mode_t;
+
+/**
+ * @brief Configuración completa de una instancia (ver UARTN_CONFIG_DEFAULT)
+ */
+typedef struct {
+    int uart_num;
+    int tx_pin;
+    int rx_pin;
+    int rts_pin;                    // -1 si no se usa (obligatorio en RTS/CTS y RS-485)
+    int cts_pin;                    // -1 si no se usa (obligatorio en RTS/CTS)
+    int baud_rate;
+    UARTn_mode_t mode;
+    uint32_t rx_buffer_size;        // Buffer RX del driver (bytes, > 128)
+    uint32_t rx_ring_size;          // Anillo del motor de recepción (se redondea a potencia de dos)
+    uint32_t tx_ring_size;          // Cola TX asíncrona (0 = UARTn_write bloqueante como antes)
+    uint8_t rx_timeout_symbols;     // Umbral de timeout RX en tiempos de símbolo (0 = por defecto)
+    uint8_t rx_full_threshold;      // Umbral de interrupción FIFO-RX llena (0 = por defecto)
+    uint8_t tx_empty_threshold;     // Umbral de interrupción FIFO-TX vacía (0 = por defecto)
+    uint8_t rx_flow_ctrl_thresh;    // Umbral RTS en modo RTS/CTS
+    int task_core;                  // Núcleo de las tareas RX/TX (-1 = sin afinidad)
+} UARTn_config_t;
+
+/**
+ * @brief Configuración por defecto: 8N1, sin control de flujo, RX 2 KiB, anillo 4 KiB, sin cola TX
+ *
+ * Sin cola TX UARTn_write sigue siendo bloqueante y no se crea tarea TX; para
+ * UARTn_write_async se activa con tx_ring_size (p. ej. 1024).
+ */
+#define UARTN_CONFIG_DEFAULT(num, tx, rx, baud) { \
+    .uart_num = (num),                          \
+    .tx_pin = (tx),                             \
+    .rx_pin = (rx),                             \
+    .rts_pin = -1,                              \
+    .cts_pin = -1,                              \
+    .baud_rate = (baud),                        \
+    .mode = UARTN_MODE_UART,                    \
+    .rx_buffer_size = 2048,                     \
+    .rx_ring_size = 4096,                       \
+    .tx_ring_size = 0,                          \
+    .rx_timeout_symbols = 0,                    \
+    .rx_full_threshold = 0,                     \
+    .tx_empty_threshold = 0,                    \
+    .rx_flow_ctrl_thresh = 122,                 \
+    .task_core = -1,                            \
+}
+
+/**
+ * @brief Callback de escritura completada (los bytes ya salieron por la línea)
+ * Se ejecuta en el contexto de la tarea TX de la instancia: debe ser breve.
+ */
+typedef void (*UARTn_tx_done_cb_t)(UARTn_handle_t handle, void *arg);
+
+/**
+ * @brief Contadores del motor de recepción (por instancia)
+ */
+typedef struct {
+    uint32_t rx_bytes;          // Bytes movidos del driver al anillo
+    uint32_t hw_overflows;      // Eventos UART_FIFO_OVF / UART_BUFFER_FULL (datos perdidos en el driver)
+    uint32_t ring_stalls;       // Veces que el anillo se llenó (los datos esperan en el driver)
+    uint32_t frame_errors;      // UART_FRAME_ERR
+    uint32_t parity_errors;     // UART_PARITY_ERR
+    uint32_t lines;             // Líneas completas entregadas
+    uint32_t lines_split;       // Líneas entregadas por trozos (más largas que el buffer del usuario)
+    uint32_t raw_reads;         // Entregas sin terminador de UARTn_read_until (modo raw)
+    uint32_t ring_size;         // Capacidad del anillo en bytes
+    uint32_t ring_high_water;   // Ocupación máxima observada
+    uint32_t tx_bytes;          // Bytes entregados al driver por la tarea TX
+    uint32_t tx_rejected;       // Escrituras asíncronas rechazadas por falta de espacio
+    uint32_t tx_high_water;     // Ocupación máxima de la cola TX
+} UARTn_stats_t;
+
 // -----------------------------------------------------------------------------
 // API PÚBLICA (Compatible con C)
 // -----------------------------------------------------------------------------
@@ -21,6 +100,11 @@ typedef struct UARTn_Instance* UARTn_handle_t;
  */
 UARTn_handle_t UARTn_create(int uart_num, int tx_pin, int rx_pin, int baud_rate);
 
+/**
+ * @brief Crea una instancia con configuración completa (alta velocidad, RS-485, RTS/CTS)
+ */
+UARTn_handle_t UARTn_create_with_config(const UARTn_config_t *config);
+
 /**
  * @brief Inicializa el hardware UART
  */
@@ -28,14 +112,71 @@ esp_err_t UARTn_init(UARTn_handle_t handle);
 
 /**
  * @brief Escribe datos en el UART
+ *
+ * Con cola TX (tx_ring_size > 0) solo encola y retorna; bloquea únicamente
+ * si la cola está llena. Sin cola TX espera a que los bytes lleguen a la FIFO.
  */
 void UARTn_write(UARTn_handle_t handle, const char *msg);
 
+/**
+ * @brief Encola bytes sin bloquear y notifica con 'cb' cuando salen por la línea
+ * @return ESP_OK, ESP_ERR_NO_MEM si no hay espacio en la cola TX,
+ *         ESP_ERR_INVALID_STATE si la instancia no tiene cola TX
+ */
+esp_err_t UARTn_write_async(UARTn_handle_t handle, const uint8_t *data, size_t len,
+                            UARTn_tx_done_cb_t cb, void *arg);
+
 /**
  * @brief Lee datos hasta encontrar un caracter terminador (ej. '\n')
+ *
+ * No bloquea y no asigna memoria. Devuelve la longitud de la línea (sin el
+ * terminador). Los bytes que siguen al terminador permanecen en el anillo
+ * para la siguiente llamada. Si la línea no cabe en 'buffer' se entrega en
+ * trozos de (max_len - 1) bytes. Como antes, si no hay terminador se entrega
+ * lo que haya (modo raw) y 0 es "sin datos" o una línea vacía (que sí se
+ * consume); UARTn_read_until_timeout los distingue.
  */
 int UARTn_read_until(UARTn_handle_t handle, char terminator, char *buffer, int max_len);
 
+/**
+ * @brief Espera hasta 'timeout_ms' a que llegue una línea completa
+ * @return Longitud de la línea (0 = línea vacía). Al vencer el plazo entrega
+ *         lo que haya sin terminador, como UARTn_read_until, o -1 si no hay nada
+ */
+int UARTn_read_until_timeout(UARTn_handle_t handle, char terminator, char *buffer, int max_len, uint32_t timeout_ms);
+
+/**
+ * @brief Lee hasta 'max_len' bytes crudos del anillo (no bloquea)
+ */
+int UARTn_read(UARTn_handle_t handle, uint8_t *buffer, int max_len);
+
+/**
+ * @brief Espera (sin sondeo) hasta que haya al menos 'min_bytes' en el anillo
+ * @return Bytes disponibles al salir (puede ser < min_bytes si venció el tiempo)
+ */
+size_t UARTn_wait_rx(UARTn_handle_t handle, size_t min_bytes, uint32_t timeout_ms);
+
+/**
+ * @brief Bytes pendientes en el anillo de recepción
+ */
+size_t UARTn_available(UARTn_handle_t handle);
+
+/**
+ * @brief Vista sin copia de los bytes pendientes (dos segmentos por el wrap del anillo)
+ * @return Total de bytes pendientes (n1 + n2)
+ */
+size_t UARTn_peek(UARTn_handle_t handle, const uint8_t **p1, size_t *n1, const uint8_t **p2, size_t *n2);
+
+/**
+ * @brief Libera 'len' bytes ya procesados tras UARTn_peek
+ */
+void UARTn_consume(UARTn_handle_t handle, size_t len);
+
+/**
+ * @brief Copia los contadores del motor de recepción
+ */
+void UARTn_get_stats(UARTn_handle_t handle, UARTn_stats_t *stats);
+
 /**
  * @brief Limpia el buffer de recepción (Flush Input)
  * Útil antes de enviar un comando para asegurar que la respuesta sea fresca.
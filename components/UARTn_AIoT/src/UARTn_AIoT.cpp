@@ -1,7 +1,14 @@
 #include "UARTn_AIoT.h"
+#include "UARTn_Ring.h"
 #include "driver/uart.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <atomic>
 #include <cstring>
 #include <cstdlib>
 
@@ -13,32 +20,219 @@ static const char *TAG = "UARTn_CLASS";
 class UARTn_AIoT {
 private:
     uart_port_t _uart_num;
-    int _tx_pin;
-    int _rx_pin;
-    int _baud_rate;
-    static const int BUF_SIZE = 1024;
+    UARTn_config_t _cfg;
+    static const int EVENT_QUEUE_LEN = 20;
+    static const int TX_DONE_QUEUE_LEN = 16;
+    static const uint32_t RX_TASK_STACK = 3072;
+    static const uint32_t TX_TASK_STACK = 2560;
+    static const UBaseType_t RX_TASK_PRIO = 12;
+    static const UBaseType_t TX_TASK_PRIO = 11;
+
+    // Contadores de UARTn_stats_t: los incrementan la tarea RX, la tarea TX y
+    // las tareas que leen o escriben, así que todos son atómicos
+    struct Counters {
+        std::atomic<uint32_t> rx_bytes{0};
+        std::atomic<uint32_t> hw_overflows{0};
+        std::atomic<uint32_t> ring_stalls{0};
+        std::atomic<uint32_t> frame_errors{0};
+        std::atomic<uint32_t> parity_errors{0};
+        std::atomic<uint32_t> lines{0};
+        std::atomic<uint32_t> lines_split{0};
+        std::atomic<uint32_t> raw_reads{0};
+        std::atomic<uint32_t> tx_bytes{0};
+        std::atomic<uint32_t> tx_rejected{0};
+        std::atomic<uint32_t> tx_high_water{0};
+    };
+
+    static void bump(std::atomic<uint32_t>& counter, uint32_t n = 1) {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Escritura pendiente de confirmar (fin de sus bytes en el contador TX)
+    struct TxDone {
+        uint32_t end;
+        UARTn_tx_done_cb_t cb;
+        void* arg;
+    };
+
+    // Motor de recepción por eventos
+    UARTn_Ring _rx;
+    uint8_t* _rx_storage = nullptr;
+    QueueHandle_t _event_queue = nullptr;
+    SemaphoreHandle_t _rx_sem = nullptr;     // Avisa al consumidor que llegaron datos
+    SemaphoreHandle_t _exit_sem = nullptr;   // Confirma el fin de la tarea RX
+    TaskHandle_t _rx_task = nullptr;
+    std::atomic<bool> _running{false};
+    Counters _stats;
+    uint32_t _ring_size = 0;
+
+    // Cola TX asíncrona (los que escriben no esperan a la FIFO)
+    UARTn_Ring _tx;
+    uint8_t* _tx_storage = nullptr;
+    SemaphoreHandle_t _tx_lock = nullptr;    // Serializa a los productores TX
+    SemaphoreHandle_t _tx_kick = nullptr;    // Despierta a la tarea TX
+    SemaphoreHandle_t _tx_space = nullptr;   // La tarea TX liberó espacio
+    QueueHandle_t _tx_done_queue = nullptr;
+    TaskHandle_t _tx_task = nullptr;
+    uint32_t _tx_enqueued = 0;               // Bytes encolados (contador libre, con wrap)
+    uint32_t _tx_sent = 0;                   // Bytes ya transmitidos
+
+    // Con ticks de 10 ms, esperas cortas no deben convertirse en sondeo activo
+    static TickType_t msToTicks(uint32_t ms) {
+        TickType_t t = pdMS_TO_TICKS(ms);
+        return (t == 0 && ms > 0) ? 1 : t;
+    }
+
+    static size_t roundPow2(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    static void rxTaskEntry(void* arg) {
+        static_cast<UARTn_AIoT*>(arg)->rxLoop();
+    }
+
+    // Tarea productora: espera eventos del driver y vacía su buffer en el anillo
+    void rxLoop() {
+        uart_event_t event;
+        while (_running.load()) {
+            if (xQueueReceive(_event_queue, &event, portMAX_DELAY) != pdTRUE) continue;
+            switch (event.type) {
+                case UART_DATA:
+                    pump();
+                    break;
+                case UART_FIFO_OVF:
+                case UART_BUFFER_FULL:
+                    // El driver ya perdió datos: rescatamos lo que cabe y resincronizamos
+                    bump(_stats.hw_overflows);
+                    pump();
+                    uart_flush_input(_uart_num);
+                    xQueueReset(_event_queue);
+                    break;
+                case UART_FRAME_ERR:
+                    bump(_stats.frame_errors);
+                    break;
+                case UART_PARITY_ERR:
+                    bump(_stats.parity_errors);
+                    break;
+                default:
+                    break;
+            }
+        }
+        xSemaphoreGive(_exit_sem);
+        vTaskDelete(NULL);
+    }
+
+    static void txTaskEntry(void* arg) {
+        static_cast<UARTn_AIoT*>(arg)->txLoop();
+    }
+
+    // Tarea consumidora TX: vacía la cola hacia el driver y confirma las escrituras
+    void txLoop() {
+        while (_running.load()) {
+            xSemaphoreTake(_tx_kick, portMAX_DELAY);
+            for (;;) {
+                const uint8_t *p1, *p2;
+                size_t n1, n2;
+                if (_tx.peek(&p1, &n1, &p2, &n2) == 0) break;
+                int n = uart_write_bytes(_uart_num, p1, n1);
+                if (n <= 0) break;
+                _tx.consume((size_t)n);
+                _tx_sent += (uint32_t)n;
+                bump(_stats.tx_bytes, (uint32_t)n);
+                xSemaphoreGive(_tx_space);
+            }
+
+            // Las confirmaciones solo se emiten cuando los bytes salieron del registro de desplazamiento
+            TxDone done;
+            if (xQueuePeek(_tx_done_queue, &done, 0) == pdTRUE) {
+                uart_wait_tx_done(_uart_num, portMAX_DELAY);
+                while (xQueuePeek(_tx_done_queue, &done, 0) == pdTRUE &&
+                       (int32_t)(_tx_sent - done.end) >= 0) {
+                    xQueueReceive(_tx_done_queue, &done, 0);
+                    if (done.cb) done.cb((UARTn_handle_t)this, done.arg);
+                }
+                xSemaphoreGive(_tx_space);
+            }
+        }
+        xSemaphoreGive(_exit_sem);
+        vTaskDelete(NULL);
+    }
+
+    // Copia directa del buffer del driver a la región libre del anillo (sin malloc)
+    void pump() {
+        size_t pending = 0;
+        uart_get_buffered_data_len(_uart_num, &pending);
+        while (pending > 0) {
+            uint8_t* dst;
+            size_t span = _rx.writeSpan(&dst);
+            if (span == 0) span = _rx.stall(&dst);
+            if (span == 0) {
+                // No se descarta nada: el resto espera en el driver hasta que el consumidor libere espacio
+                bump(_stats.ring_stalls);
+                break;
+            }
+            if (span > pending) span = pending;
+            int n = uart_read_bytes(_uart_num, dst, span, 0);
+            if (n <= 0) break;
+            _rx.commit((size_t)n);
+            bump(_stats.rx_bytes, (uint32_t)n);
+            pending -= n;
+        }
+        xSemaphoreGive(_rx_sem);
+    }
+
+    // Llamado por el consumidor tras liberar espacio: reanuda la tarea RX si estaba detenida
+    void resumeIfStalled() {
+        if (_rx.resume() && _event_queue) {
+            uart_event_t wake = {};
+            wake.type = UART_DATA;
+            xQueueSend(_event_queue, &wake, 0);
+        }
+    }
 
 public:
     // Constructor
-    UARTn_AIoT(int uart_num, int tx_pin, int rx_pin, int baud_rate) 
-        : _uart_num((uart_port_t)uart_num), _tx_pin(tx_pin), _rx_pin(rx_pin), _baud_rate(baud_rate) {}
+    explicit UARTn_AIoT(const UARTn_config_t& cfg)
+        : _uart_num((uart_port_t)cfg.uart_num), _cfg(cfg) {}
 
     // Inicialización del Hardware
     esp_err_t begin() {
         // [CORRECCIÓN] Inicializamos la estructura con ceros para evitar advertencias del compilador
         uart_config_t uart_config = {}; 
         
-        uart_config.baud_rate = _baud_rate;
+        uart_config.baud_rate = _cfg.baud_rate;
         uart_config.data_bits = UART_DATA_8_BITS;
         uart_config.parity = UART_PARITY_DISABLE;
         uart_config.stop_bits = UART_STOP_BITS_1;
-        uart_config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
-        uart_config.rx_flow_ctrl_thresh = 122; // Valor por defecto seguro
+        uart_config.flow_ctrl = (_cfg.mode == UARTN_MODE_RTS_CTS) ? UART_HW_FLOWCTRL_CTS_RTS : UART_HW_FLOWCTRL_DISABLE;
+        uart_config.rx_flow_ctrl_thresh = _cfg.rx_flow_ctrl_thresh ? _cfg.rx_flow_ctrl_thresh : 122; // Valor por defecto seguro
         uart_config.source_clk = UART_SCLK_DEFAULT;
 
-        // 1. Instalamos el driver (Buffer RX: 2048, TX: 0)
+        // 0. Anillos persistentes de la instancia (únicas asignaciones, en RAM interna)
+        if (!_rx_storage) {
+            size_t rx_ring = roundPow2(_cfg.rx_ring_size ? _cfg.rx_ring_size : 4096);
+            _rx_storage = (uint8_t*)heap_caps_malloc(rx_ring, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            if (!_rx_storage || !_rx.attach(_rx_storage, rx_ring)) {
+                ESP_LOGE(TAG, "Sin memoria para el anillo RX de UART%d", _uart_num);
+                return ESP_ERR_NO_MEM;
+            }
+            _ring_size = (uint32_t)rx_ring;
+        }
+        if (_cfg.tx_ring_size && !_tx_storage) {
+            size_t tx_ring = roundPow2(_cfg.tx_ring_size);
+            _tx_storage = (uint8_t*)heap_caps_malloc(tx_ring, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            if (!_tx_storage || !_tx.attach(_tx_storage, tx_ring)) {
+                ESP_LOGE(TAG, "Sin memoria para la cola TX de UART%d", _uart_num);
+                return ESP_ERR_NO_MEM;
+            }
+        }
+
+        // 1. Instalamos el driver (TX: 0, la cola asíncrona es propia) con cola de eventos
         // Usamos un buffer amplio para no perder datos del SIM800L
-        esp_err_t err = uart_driver_install(_uart_num, BUF_SIZE * 2, 0, 0, NULL, 0);
+        uint32_t rx_buffer = (_cfg.rx_buffer_size > SOC_UART_FIFO_LEN) ? _cfg.rx_buffer_size : 2048;
+        esp_err_t err = uart_driver_install(_uart_num, rx_buffer, 0, EVENT_QUEUE_LEN, &_event_queue, 0);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "Error instalando driver UART%d: %s", _uart_num, esp_err_to_name(err));
             return err;
@@ -51,72 +245,226 @@ public:
              return err;
         }
 
-        // 3. Asignamos pines
-        err = uart_set_pin(_uart_num, _tx_pin, _rx_pin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+        // 3. Asignamos pines (RTS hace de DE en RS-485)
+        int rts = (_cfg.mode != UARTN_MODE_UART && _cfg.rts_pin >= 0) ? _cfg.rts_pin : UART_PIN_NO_CHANGE;
+        int cts = (_cfg.mode == UARTN_MODE_RTS_CTS && _cfg.cts_pin >= 0) ? _cfg.cts_pin : UART_PIN_NO_CHANGE;
+        err = uart_set_pin(_uart_num, _cfg.tx_pin, _cfg.rx_pin, rts, cts);
         if (err != ESP_OK) {
              ESP_LOGE(TAG, "Error asignando pines: %s", esp_err_to_name(err));
              return err;
         }
 
-        ESP_LOGI(TAG, "UART%d Iniciado -> TX:%d RX:%d @ %d baud", _uart_num, _tx_pin, _rx_pin, _baud_rate);
+        if (_cfg.mode == UARTN_MODE_RS485_HALF_DUPLEX) {
+            err = uart_set_mode(_uart_num, UART_MODE_RS485_HALF_DUPLEX);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Error activando RS-485: %s", esp_err_to_name(err));
+                return err;
+            }
+        }
+
+        // Umbrales de interrupción: a alta velocidad conviene vaciar la FIFO en ráfagas grandes
+        if (_cfg.rx_timeout_symbols) uart_set_rx_timeout(_uart_num, _cfg.rx_timeout_symbols);
+        if (_cfg.rx_full_threshold) uart_set_rx_full_threshold(_uart_num, _cfg.rx_full_threshold);
+        if (_cfg.tx_empty_threshold) uart_set_tx_empty_threshold(_uart_num, _cfg.tx_empty_threshold);
+
+        // 4. Tarea productora dirigida por eventos
+        _rx_sem = xSemaphoreCreateBinary();
+        _exit_sem = xSemaphoreCreateBinary();
+        if (!_rx_sem || !_exit_sem) return ESP_ERR_NO_MEM;
+
+        _running.store(true);
+        BaseType_t core = (_cfg.task_core >= 0) ? _cfg.task_core : tskNO_AFFINITY;
+        if (xTaskCreatePinnedToCore(rxTaskEntry, "uartn_rx", RX_TASK_STACK, this, RX_TASK_PRIO, &_rx_task, core) != pdPASS) {
+            _running.store(false);
+            ESP_LOGE(TAG, "No se pudo crear la tarea RX de UART%d", _uart_num);
+            return ESP_ERR_NO_MEM;
+        }
+
+        // 5. Tarea TX (solo con cola asíncrona)
+        if (_tx_storage) {
+            _tx_lock = xSemaphoreCreateMutex();
+            _tx_kick = xSemaphoreCreateBinary();
+            _tx_space = xSemaphoreCreateBinary();
+            _tx_done_queue = xQueueCreate(TX_DONE_QUEUE_LEN, sizeof(TxDone));
+            if (!_tx_lock || !_tx_kick || !_tx_space || !_tx_done_queue) return ESP_ERR_NO_MEM;
+            if (xTaskCreatePinnedToCore(txTaskEntry, "uartn_tx", TX_TASK_STACK, this, TX_TASK_PRIO, &_tx_task, core) != pdPASS) {
+                ESP_LOGE(TAG, "No se pudo crear la tarea TX de UART%d", _uart_num);
+                return ESP_ERR_NO_MEM;
+            }
+        }
+
+        ESP_LOGI(TAG, "UART%d Iniciado -> TX:%d RX:%d @ %d baud (modo %d, cola TX %u)",
+                 _uart_num, _cfg.tx_pin, _cfg.rx_pin, _cfg.baud_rate, (int)_cfg.mode, (unsigned)_tx.capacity());
+        return ESP_OK;
+    }
+
+    // Encola en la cola TX. Con wait = 0 no bloquea nunca (todo o nada).
+    esp_err_t enqueue(const uint8_t* data, size_t len, UARTn_tx_done_cb_t cb, void* arg, TickType_t wait) {
+        if (!_tx_task) return ESP_ERR_INVALID_STATE;
+        if (len > _tx.capacity()) return ESP_ERR_INVALID_SIZE;
+
+        TickType_t start = xTaskGetTickCount();
+        xSemaphoreTake(_tx_lock, portMAX_DELAY);
+        while (_tx.freeSpace() < len ||
+               (cb && uxQueueSpacesAvailable(_tx_done_queue) == 0)) {
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= wait) {
+                xSemaphoreGive(_tx_lock);
+                bump(_stats.tx_rejected);
+                return ESP_ERR_NO_MEM;
+            }
+            xSemaphoreTake(_tx_space, wait - elapsed);
+        }
+        _tx.write(data, len);
+        _tx_enqueued += (uint32_t)len;
+        if (cb) {
+            TxDone done = { _tx_enqueued, cb, arg };
+            xQueueSend(_tx_done_queue, &done, 0);
+        }
+        size_t used = _tx.capacity() - _tx.freeSpace();
+        if (used > _stats.tx_high_water.load(std::memory_order_relaxed)) {
+            _stats.tx_high_water.store((uint32_t)used, std::memory_order_relaxed);
+        }
+        xSemaphoreGive(_tx_lock);
+        xSemaphoreGive(_tx_kick);
         return ESP_OK;
     }
 
-    // Método Write
+    esp_err_t writeAsync(const uint8_t* data, size_t len, UARTn_tx_done_cb_t cb, void* arg) {
+        if (!data || len == 0) return ESP_ERR_INVALID_ARG;
+        return enqueue(data, len, cb, arg, 0);
+    }
+
+    // Método Write: encola si hay cola TX; si no, escritura directa (bloqueante)
     void write(const char* text) {
-        if (text) {
-            uart_write_bytes(_uart_num, text, strlen(text));
+        if (!text) return;
+        size_t len = strlen(text);
+        if (_tx_task) {
+            // Mensajes mayores que la cola se parten para no rechazarlos
+            while (len > 0) {
+                size_t chunk = (len > _tx.capacity()) ? _tx.capacity() : len;
+                if (enqueue((const uint8_t*)text, chunk, nullptr, nullptr, portMAX_DELAY) != ESP_OK) return;
+                text += chunk;
+                len -= chunk;
+            }
+        } else {
+            uart_write_bytes(_uart_num, text, len);
         }
     }
 
-    // Método Read Until (Simplificado para robustez)
+    // Extrae una línea del anillo sin asignar memoria ni perder la cola.
+    // Devuelve los bytes consumidos (0 = nada) y en *len la longitud entregada.
+    size_t takeLine(char terminator, char* buffer, int max_len, int* len, bool raw) {
+        bool split = false;
+        size_t consumed = _rx.readLine((uint8_t)terminator, buffer, max_len, len, &split, raw);
+        if (consumed > 0) {
+            if (split) bump(_stats.lines_split);
+            else if (*len == (int)consumed - 1) bump(_stats.lines);
+            else bump(_stats.raw_reads);
+            resumeIfStalled();
+        }
+        return consumed;
+    }
+
+    // Método Read Until: como el original, sin terminador entrega lo que haya
     int readUntil(char terminator, char* buffer, int max_len) {
-        size_t length = 0;
-        uart_get_buffered_data_len(_uart_num, &length);
-        
-        if (length > 0) {
-            // Leemos todo lo disponible
-            uint8_t* temp_buf = (uint8_t*)malloc(length + 1);
-            if (!temp_buf) return 0; // Error de memoria
-
-            int read_len = uart_read_bytes(_uart_num, temp_buf, length, pdMS_TO_TICKS(20));
-            temp_buf[read_len] = '\0'; // Null termination
-
-            // Buscamos el terminador
-            char* found = strchr((char*)temp_buf, terminator);
-            int result_len = 0;
-
-            if (found) {
-                // Calcular longitud hasta el terminador
-                result_len = found - (char*)temp_buf;
-                
-                // Si el mensaje es más grande que el buffer del usuario, cortamos
-                if (result_len >= max_len) result_len = max_len - 1;
-                
-                strncpy(buffer, (char*)temp_buf, result_len);
-                buffer[result_len] = '\0'; // Asegurar string válido
-            } else {
-                // Si no hay terminador, copiamos todo lo que hay (modo raw)
-                if ((int)length >= max_len) length = max_len - 1;
-                strncpy(buffer, (char*)temp_buf, length);
-                buffer[length] = '\0';
-                result_len = length;
-            }
+        int len;
+        takeLine(terminator, buffer, max_len, &len, true);
+        return len;
+    }
+
+    // Espera (sin sondeo) a que la tarea RX publique una línea completa; al
+    // vencer el plazo entrega lo que haya sin terminador, como readUntil
+    int readUntilTimeout(char terminator, char* buffer, int max_len, uint32_t timeout_ms) {
+        TickType_t start = xTaskGetTickCount();
+        TickType_t limit = msToTicks(timeout_ms);
+        int len;
+        for (;;) {
+            if (takeLine(terminator, buffer, max_len, &len, false) > 0) return len;
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= limit || !_rx_sem) break;
+            xSemaphoreTake(_rx_sem, limit - elapsed);
+        }
+        return takeLine(terminator, buffer, max_len, &len, true) > 0 ? len : -1;
+    }
+
+    int read(uint8_t* buffer, int max_len) {
+        if (!buffer || max_len <= 0) return 0;
+        int n = (int)_rx.read(buffer, (size_t)max_len);
+        if (n > 0) resumeIfStalled();
+        return n;
+    }
+
+    size_t available() const { return _rx.available(); }
 
-            free(temp_buf);
-            return result_len;
+    size_t waitRx(size_t min_bytes, uint32_t timeout_ms) {
+        TickType_t start = xTaskGetTickCount();
+        TickType_t limit = msToTicks(timeout_ms);
+        size_t avail;
+        while ((avail = _rx.available()) < min_bytes && _rx_sem) {
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= limit) break;
+            xSemaphoreTake(_rx_sem, limit - elapsed);
         }
-        return 0;
+        return avail;
+    }
+
+    size_t peek(const uint8_t** p1, size_t* n1, const uint8_t** p2, size_t* n2) const {
+        return _rx.peek(p1, n1, p2, n2);
+    }
+
+    void consume(size_t len) {
+        _rx.consume(len);
+        resumeIfStalled();
+    }
+
+    void getStats(UARTn_stats_t* out) const {
+        out->rx_bytes = _stats.rx_bytes.load(std::memory_order_relaxed);
+        out->hw_overflows = _stats.hw_overflows.load(std::memory_order_relaxed);
+        out->ring_stalls = _stats.ring_stalls.load(std::memory_order_relaxed);
+        out->frame_errors = _stats.frame_errors.load(std::memory_order_relaxed);
+        out->parity_errors = _stats.parity_errors.load(std::memory_order_relaxed);
+        out->lines = _stats.lines.load(std::memory_order_relaxed);
+        out->lines_split = _stats.lines_split.load(std::memory_order_relaxed);
+        out->raw_reads = _stats.raw_reads.load(std::memory_order_relaxed);
+        out->ring_size = _ring_size;
+        out->ring_high_water = (uint32_t)_rx.highWater();
+        out->tx_bytes = _stats.tx_bytes.load(std::memory_order_relaxed);
+        out->tx_rejected = _stats.tx_rejected.load(std::memory_order_relaxed);
+        out->tx_high_water = _stats.tx_high_water.load(std::memory_order_relaxed);
     }
 
     // Método Flush: Limpia basura del buffer
     void flush() {
         uart_flush_input(_uart_num);
+        _rx.reset();
+        resumeIfStalled();
     }
 
     // Destructor
     ~UARTn_AIoT() {
+        _running.store(false);
+        if (_tx_task) {
+            // La tarea TX termina su ciclo actual y sale
+            xSemaphoreGive(_tx_kick);
+            xSemaphoreTake(_exit_sem, portMAX_DELAY);
+        }
+        if (_rx_task) {
+            // Despertamos la tarea RX con un evento neutro y esperamos a que termine
+            uart_event_t stop = {};
+            stop.type = UART_EVENT_MAX;
+            xQueueSend(_event_queue, &stop, portMAX_DELAY);
+            xSemaphoreTake(_exit_sem, portMAX_DELAY);
+        }
         uart_driver_delete(_uart_num);
+        if (_rx_sem) vSemaphoreDelete(_rx_sem);
+        if (_exit_sem) vSemaphoreDelete(_exit_sem);
+        if (_tx_lock) vSemaphoreDelete(_tx_lock);
+        if (_tx_kick) vSemaphoreDelete(_tx_kick);
+        if (_tx_space) vSemaphoreDelete(_tx_space);
+        if (_tx_done_queue) vQueueDelete(_tx_done_queue);
+        heap_caps_free(_rx_storage);
+        heap_caps_free(_tx_storage);
         ESP_LOGW(TAG, "UART Driver Eliminado");
     }
 };
@@ -128,7 +476,12 @@ public:
 extern "C" {
 
     UARTn_handle_t UARTn_create(int uart_num, int tx_pin, int rx_pin, int baud_rate) {
-        return (UARTn_handle_t) new UARTn_AIoT(uart_num, tx_pin, rx_pin, baud_rate);
+        UARTn_config_t cfg = UARTN_CONFIG_DEFAULT(uart_num, tx_pin, rx_pin, baud_rate);
+        return (UARTn_handle_t) new UARTn_AIoT(cfg);
+    }
+
+    UARTn_handle_t UARTn_create_with_config(const UARTn_config_t *config) {
+        return config ? (UARTn_handle_t) new UARTn_AIoT(*config) : NULL;
     }
 
     esp_err_t UARTn_init(UARTn_handle_t handle) {
@@ -141,11 +494,57 @@ extern "C" {
         if (obj) obj->write(msg);
     }
 
+    esp_err_t UARTn_write_async(UARTn_handle_t handle, const uint8_t *data, size_t len,
+                                UARTn_tx_done_cb_t cb, void *arg) {
+        UARTn_AIoT* obj = (UARTn_AIoT*)handle;
+        return obj ? obj->writeAsync(data, len, cb, arg) : ESP_ERR_INVALID_ARG;
+    }
+
     int UARTn_read_until(UARTn_handle_t handle, char terminator, char *buffer, int max_len) {
         UARTn_AIoT* obj = (UARTn_AIoT*)handle;
         return obj ? obj->readUntil(terminator, buffer, max_len) : 0;
     }
 
+    int UARTn_read_until_timeout(UARTn_handle_t handle, char terminator, char *buffer, int max_len, uint32_t timeout_ms) {
+        UARTn_AIoT* obj = (UARTn_AIoT*)handle;
+        return obj ? obj->readUntilTimeout(terminator, buffer, max_len, timeout_ms) : -1;
+    }
+
+    int UARTn_read(UARTn_handle_t handle, uint8_t *buffer, int max_len) {
+        UARTn_AIoT* obj = (UARTn_AIoT*)handle;
+        return obj ? obj->read(buffer, max_len) : 0;
+    }
+
+    size_t UARTn_wait_rx(UARTn_handle_t handle, size_t min_bytes, uint32_t timeout_ms) {
+        UARTn_AIoT* obj = (UARTn_AIoT*)handle;
+        return obj ? obj->waitRx(min_bytes, timeout_ms) : 0;
+    }
+
+    size_t UARTn_available(UARTn_handle_t handle) {
+        UARTn_AIoT* obj = (UARTn_AIoT*)handle;
+        return obj ? obj->available() : 0;
+    }
+
+    size_t UARTn_peek(UARTn_handle_t handle, const uint8_t **p1, size_t *n1, const uint8_t **p2, size_t *n2) {
+        UARTn_AIoT* obj = (UARTn_AIoT*)handle;
+        if (!obj) {
+            *p1 = *p2 = NULL;
+            *n1 = *n2 = 0;
+            return 0;
+        }
+        return obj->peek(p1, n1, p2, n2);
+    }
+
+    void UARTn_consume(UARTn_handle_t handle, size_t len) {
+        UARTn_AIoT* obj = (UARTn_AIoT*)handle;
+        if (obj) obj->consume(len);
+    }
+
+    void UARTn_get_stats(UARTn_handle_t handle, UARTn_stats_t *stats) {
+        UARTn_AIoT* obj = (UARTn_AIoT*)handle;
+        if (obj && stats) obj->getStats(stats);
+    }
+
     void UARTn_flush(UARTn_handle_t handle) {
         UARTn_AIoT* obj = (UARTn_AIoT*)handle;
         if (obj) obj->flush();
@@ -0,0 +1,209 @@
+#ifndef UARTN_RING_H
+#define UARTN_RING_H
+
+// -----------------------------------------------------------------------------
+// Anillo de bytes SPSC (un productor / un consumidor) sin asignaciones.
+//
+// - RX: productor = tarea de eventos UART, consumidor = UARTn_read_until / UARTn_read.
+// - TX: productor = UARTn_write / UARTn_write_async, consumidor = tarea TX.
+//
+// No depende de ESP-IDF: se puede compilar en Linux y alimentarse desde un
+// pty o un buffer en memoria para pruebas unitarias.
+// -----------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class UARTn_Ring {
+private:
+    uint8_t* _buf = nullptr;
+    size_t _mask = 0;
+    std::atomic<size_t> _head{0};   // Escrito solo por el productor
+    std::atomic<size_t> _tail{0};   // Escrito solo por el consumidor
+    size_t _scan = 0;               // Bytes ya revisados sin terminador (consumidor)
+    size_t _high_water = 0;         // Ocupación máxima observada (productor)
+    std::atomic<bool> _stalled{false};  // Productor detenido con el anillo lleno
+
+public:
+    // Asocia un almacenamiento externo. El tamaño debe ser potencia de dos.
+    bool attach(uint8_t* storage, size_t size) {
+        if (!storage || size < 2 || (size & (size - 1)) != 0) return false;
+        _buf = storage;
+        _mask = size - 1;
+        _head.store(0, std::memory_order_relaxed);
+        _tail.store(0, std::memory_order_relaxed);
+        _scan = 0;
+        _high_water = 0;
+        _stalled.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t capacity() const { return _mask + 1; }
+    size_t highWater() const { return _high_water; }
+
+    size_t available() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+    }
+
+    size_t freeSpace() const {
+        return capacity() - (_head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_acquire));
+    }
+
+    // --- LADO PRODUCTOR ------------------------------------------------------
+
+    // Región contigua libre donde se puede escribir directamente (sin copia extra).
+    size_t writeSpan(uint8_t** ptr) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t free_total = capacity() - (head - _tail.load(std::memory_order_acquire));
+        size_t idx = head & _mask;
+        size_t contiguous = capacity() - idx;
+        *ptr = _buf + idx;
+        return (free_total < contiguous) ? free_total : contiguous;
+    }
+
+    void commit(size_t n) {
+        size_t head = _head.load(std::memory_order_relaxed) + n;
+        _head.store(head, std::memory_order_release);
+        size_t used = head - _tail.load(std::memory_order_relaxed);
+        if (used > _high_water) _high_water = used;
+    }
+
+    // Copia desde una fuente en memoria. Devuelve los bytes aceptados.
+    size_t write(const uint8_t* src, size_t n) {
+        size_t done = 0;
+        while (done < n) {
+            uint8_t* dst;
+            size_t span = writeSpan(&dst);
+            if (span == 0) break;
+            if (span > n - done) span = n - done;
+            memcpy(dst, src + done, span);
+            commit(span);
+            done += span;
+        }
+        return done;
+    }
+
+    // Con writeSpan() == 0 el productor deja el resto en su origen y marca la
+    // parada; después vuelve a mirar, porque el consumidor puede haber liberado
+    // espacio (y llamado a resume() sin ver la marca) justo antes. Si hay sitio,
+    // anula la parada y lo devuelve; 0 = detenido hasta que resume() lo avise.
+    size_t stall(uint8_t** ptr) {
+        _stalled.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        size_t span = writeSpan(ptr);
+        if (span) _stalled.store(false, std::memory_order_relaxed);
+        return span;
+    }
+
+    // --- LADO CONSUMIDOR -----------------------------------------------------
+
+    // Tras liberar espacio: true si el productor estaba detenido y hay que
+    // despertarlo (la marca se consume; como mucho sobra un aviso)
+    bool resume() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return _stalled.exchange(false, std::memory_order_relaxed);
+    }
+
+    uint8_t at(size_t offset) const {
+        return _buf[(_tail.load(std::memory_order_relaxed) + offset) & _mask];
+    }
+
+    // Vista sin copia de los datos pendientes (hasta dos segmentos por el wrap).
+    size_t peek(const uint8_t** p1, size_t* n1, const uint8_t** p2, size_t* n2) const {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t avail = _head.load(std::memory_order_acquire) - tail;
+        size_t idx = tail & _mask;
+        size_t first = capacity() - idx;
+        if (first > avail) first = avail;
+        *p1 = _buf + idx;
+        *n1 = first;
+        *p2 = _buf;
+        *n2 = avail - first;
+        return avail;
+    }
+
+    void consume(size_t n) {
+        size_t avail = available();
+        if (n > avail) n = avail;
+        _tail.store(_tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+        _scan = (_scan > n) ? _scan - n : 0;
+    }
+
+    size_t read(uint8_t* dst, size_t n) {
+        size_t avail = available();
+        if (n > avail) n = avail;
+        copyOut(dst, n);
+        consume(n);
+        return n;
+    }
+
+    // Busca el terminador continuando desde donde quedó la búsqueda anterior,
+    // así cada byte se revisa una sola vez aunque la línea llegue por partes.
+    long find(uint8_t terminator) {
+        size_t avail = available();
+        for (; _scan < avail; _scan++) {
+            if (at(_scan) == terminator) return (long)_scan;
+        }
+        return -1;
+    }
+
+    // Extrae una línea. Devuelve los bytes consumidos del anillo (0 = no se
+    // entregó nada) y en *len la longitud copiada a 'buffer' (sin terminador,
+    // terminado en '\0'). Una línea vacía consume 1 byte con *len = 0.
+    // Si la línea no cabe en 'buffer', se entrega por trozos de max_len-1 bytes
+    // y *split se pone a true; el resto queda en el anillo para la siguiente llamada.
+    // Sin terminador en el anillo: con raw = true se entrega lo que haya
+    // (como el UARTn_read_until original); con raw = false no se toca nada.
+    size_t readLine(uint8_t terminator, char* buffer, int max_len, int* len, bool* split, bool raw) {
+        *len = 0;
+        *split = false;
+        if (!buffer || max_len <= 0) return 0;
+        buffer[0] = '\0';
+        size_t room = (size_t)max_len - 1;
+        if (room == 0) return 0;
+
+        long pos = find(terminator);
+        if (pos >= 0 && (size_t)pos <= room) {
+            copyOut((uint8_t*)buffer, (size_t)pos);
+            buffer[pos] = '\0';
+            consume((size_t)pos + 1);
+            *len = (int)pos;
+            return (size_t)pos + 1;
+        }
+        size_t n = available();
+        if (pos >= 0 || n >= room) {
+            n = room;
+            *split = true;
+        } else if (!raw || n == 0) {
+            return 0;
+        }
+        copyOut((uint8_t*)buffer, n);
+        buffer[n] = '\0';
+        consume(n);
+        *len = (int)n;
+        return n;
+    }
+
+    // Descarta todo lo pendiente (solo desde el consumidor).
+    void reset() {
+        _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+        _scan = 0;
+    }
+
+private:
+    void copyOut(uint8_t* dst, size_t n) const {
+        const uint8_t *p1, *p2;
+        size_t n1, n2;
+        peek(&p1, &n1, &p2, &n2);
+        if (n <= n1) {
+            memcpy(dst, p1, n);
+        } else {
+            memcpy(dst, p1, n1);
+            memcpy(dst + n1, p2, n - n1);
+        }
+    }
+};
+
+#endif // UARTN_RING_H
@@ -0,0 +1,96 @@
+#ifndef WAVEFORM_AIOT_H
+#define WAVEFORM_AIOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+#include "SampleRing_AIoT.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Osciloscopio de desplazamiento para los 16 canales de presión
+//
+// - Lee los bloques del anillo de muestras como un consumidor más y reduce
+//   cada grupo de samples_per_column muestras a un mínimo/máximo por canal:
+//   una columna de píxeles (no se pierden picos al diezmar).
+// - Solo se dibujan las columnas nuevas, en un búfer RGB565 circular del
+//   tamaño del widget. El desplazamiento se hace al pintar: dos copias del
+//   búfer (parte antigua y parte nueva) sin recalcular ni mover nada.
+// - Hasta 16 canales superpuestos, cada uno con su color y activable.
+// - Con la pantalla del widget oculta el consumidor se pausa (no frena a la
+//   adquisición) y al volver salta al bloque más reciente.
+// - Todas las funciones se llaman desde la tarea de LVGL.
+// -----------------------------------------------------------------------------
+
+#define WAVE_CHANNELS           SRING_CHANNELS
+#define WAVE_NODE_ANY           0xFF        // Sigue al primer nodo que llegue
+#define WAVE_STATS_WINDOW_US    1000000
+
+typedef struct {
+    uint16_t samples_per_column;            // Diezmado: muestras por columna
+    int16_t y_min;                          // Escala vertical (cuentas del nodo)
+    int16_t y_max;
+    uint8_t node;                           // Nodo a mostrar o WAVE_NODE_ANY
+    uint16_t channel_mask;                  // Canales activos al crear
+} Waveform_config_t;
+
+#define WAVEFORM_CONFIG_DEFAULT() {         \
+    .samples_per_column = 10,               \
+    .y_min = -32768,                        \
+    .y_max = 32767,                         \
+    .node = WAVE_NODE_ANY,                  \
+    .channel_mask = 0xFFFF,                 \
+}
+
+typedef struct {
+    uint32_t blocks;                        // Bloques consumidos
+    uint32_t columns;                       // Columnas dibujadas (total)
+    uint32_t frames;                        // Repintados del widget (total)
+    uint32_t fps;                           // Repintados por segundo (última ventana)
+    uint32_t columns_per_s;
+    uint32_t update_us_avg;                 // Diezmado + columnas por llamada con datos
+    uint32_t update_us_max;
+    uint32_t cpu_permille;                  // Tiempo de Waveform_AIoT_update / tiempo real
+} Waveform_stats_t;
+
+/**
+ * @brief Crea el widget como hijo de parent (un contenedor de EEZ)
+ * @param cfg NULL = WAVEFORM_CONFIG_DEFAULT()
+ * @return Objeto LVGL o NULL sin memoria / sin cupo de consumidor
+ */
+lv_obj_t *Waveform_AIoT_create(lv_obj_t *parent, SampleRing_t *ring, const Waveform_config_t *cfg);
+
+/**
+ * @brief Consume los bloques pendientes y dibuja las columnas nuevas
+ * Llamar en cada vuelta de la tarea de UI.
+ */
+void Waveform_AIoT_update(lv_obj_t *wave);
+
+/**
+ * @brief Como Waveform_AIoT_update, pero deja de consumir bloques al pasar
+ * deadline_us (esp_timer); los pendientes se dibujan en la llamada siguiente.
+ * Siempre consume al menos un bloque.
+ */
+void Waveform_AIoT_update_until(lv_obj_t *wave, int64_t deadline_us);
+
+void Waveform_AIoT_set_channel_enabled(lv_obj_t *wave, uint8_t channel, bool enabled);
+bool Waveform_AIoT_get_channel_enabled(lv_obj_t *wave, uint8_t channel);
+void Waveform_AIoT_set_channel_color(lv_obj_t *wave, uint8_t channel, lv_color_t color);
+lv_color_t Waveform_AIoT_get_channel_color(lv_obj_t *wave, uint8_t channel);
+
+/**
+ * @brief Cambia escala o diezmado; borra la traza
+ */
+void Waveform_AIoT_set_config(lv_obj_t *wave, const Waveform_config_t *cfg);
+
+void Waveform_AIoT_get_stats(lv_obj_t *wave, Waveform_stats_t *stats);
+void Waveform_AIoT_log_stats(lv_obj_t *wave);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WAVEFORM_AIOT_H
@@ -0,0 +1,384 @@
+#include "Waveform_AIoT.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "Waveform";
+
+#define WAVE_EWMA_SHIFT         3       // Medias móviles con peso 1/8
+#define WAVE_GRID_ROWS          4       // Líneas horizontales de rejilla
+#define WAVE_GRID_COLUMNS       50      // Marca vertical cada N columnas (se desplaza con la traza)
+
+typedef struct {
+    SampleRing_t *ring;
+    int consumer;
+    bool active;
+    Waveform_config_t cfg;
+    uint16_t enabled;
+    lv_color_t color_lv[WAVE_CHANNELS];
+    uint16_t color[WAVE_CHANNELS];      // Mismo color en RGB565
+    uint16_t bg;
+    uint16_t grid;
+
+    // Búfer circular de columnas (RGB565, fila a fila, stride = w)
+    uint16_t *buf;
+    int32_t w;
+    int32_t h;
+    int32_t head;                       // Próxima columna a escribir = columna más antigua
+    lv_image_dsc_t img_old;             // [head, w): parte izquierda en pantalla
+    lv_image_dsc_t img_new;             // [0, head): parte derecha en pantalla
+
+    // Diezmado min/max de la columna en curso
+    uint8_t node;
+    uint16_t count;
+    uint16_t acc_valid;
+    uint16_t prev_valid;
+    int16_t acc_min[WAVE_CHANNELS];
+    int16_t acc_max[WAVE_CHANNELS];
+    int16_t acc_last[WAVE_CHANNELS];
+    int16_t prev_last[WAVE_CHANNELS];   // Último valor de la columna anterior (une trazos)
+
+    // Estadísticas
+    Waveform_stats_t st;
+    int64_t window_start_us;
+    uint32_t window_frames;
+    uint32_t window_columns;
+    uint32_t window_busy_us;
+} wave_t;
+
+static const uint32_t default_palette[WAVE_CHANNELS] = {
+    0xE6194B, 0x3CB44B, 0xFFE119, 0x4363D8, 0xF58231, 0x911EB4, 0x42D4F4, 0xF032E6,
+    0xBFEF45, 0xFABED4, 0x469990, 0xDCBEFF, 0x9A6324, 0xFFFAC8, 0xAAFFC3, 0xFFFFFF,
+};
+
+static inline uint32_t ewma(uint32_t avg, uint32_t x) {
+    return (uint32_t)((int32_t)avg + (((int32_t)x - (int32_t)avg) >> WAVE_EWMA_SHIFT));
+}
+
+// -----------------------------------------------------------------------------
+// Columnas
+// -----------------------------------------------------------------------------
+
+static inline int32_t scale_y(const wave_t *w, int32_t v) {
+    int32_t range = (int32_t)w->cfg.y_max - w->cfg.y_min;
+    int32_t y = (w->h - 1) - (int32_t)(((int64_t)(v - w->cfg.y_min) * (w->h - 1)) / range);
+    if (y < 0) return 0;
+    if (y > w->h - 1) return w->h - 1;
+    return y;
+}
+
+static void render_column(wave_t *w) {
+    uint16_t *col = w->buf + w->head;
+    bool mark = (w->st.columns % WAVE_GRID_COLUMNS) == 0;
+    int32_t grid_step = w->h / WAVE_GRID_ROWS;
+
+    for (int32_t y = 0; y < w->h; y++) {
+        col[y * w->w] = (mark || (grid_step && y % grid_step == 0)) ? w->grid : w->bg;
+    }
+
+    uint16_t draw = w->acc_valid & w->enabled;
+    for (int ch = 0; ch < WAVE_CHANNELS; ch++) {
+        if (!(draw & (1u << ch))) continue;
+        int32_t lo = w->acc_min[ch], hi = w->acc_max[ch];
+        // Unir con la columna anterior para que los flancos no dejen huecos
+        if (w->prev_valid & (1u << ch)) {
+            if (w->prev_last[ch] < lo) lo = w->prev_last[ch];
+            if (w->prev_last[ch] > hi) hi = w->prev_last[ch];
+        }
+        int32_t y_top = scale_y(w, hi), y_bot = scale_y(w, lo);
+        uint16_t c = w->color[ch];
+        for (int32_t y = y_top; y <= y_bot; y++) col[y * w->w] = c;
+    }
+
+    memcpy(w->prev_last, w->acc_last, sizeof(w->prev_last));
+    w->prev_valid = w->acc_valid;
+    w->acc_valid = 0;
+    w->count = 0;
+    w->head = (w->head + 1) % w->w;
+    w->st.columns++;
+    w->window_columns++;
+}
+
+static void consume_block(wave_t *w, const SampleRing_block_t *b) {
+    if (w->node == WAVE_NODE_ANY) w->node = b->node;
+    if (b->node != w->node) return;
+
+    uint16_t mask = b->channel_mask & w->enabled;
+    uint32_t n = b->count, i = 0;
+    while (i < n) {
+        uint32_t take = w->cfg.samples_per_column - w->count;
+        if (take > n - i) take = n - i;
+
+        for (int ch = 0; ch < WAVE_CHANNELS; ch++) {
+            if (!(mask & (1u << ch))) continue;
+            const int16_t *s = &b->data[ch][i];
+            int16_t lo, hi;
+            if (w->acc_valid & (1u << ch)) {
+                lo = w->acc_min[ch];
+                hi = w->acc_max[ch];
+            } else {
+                lo = hi = s[0];
+            }
+            for (uint32_t k = 0; k < take; k++) {
+                if (s[k] < lo) lo = s[k];
+                if (s[k] > hi) hi = s[k];
+            }
+            w->acc_min[ch] = lo;
+            w->acc_max[ch] = hi;
+            w->acc_last[ch] = s[take - 1];
+        }
+        w->acc_valid |= mask;
+
+        w->count += take;
+        i += take;
+        if (w->count >= w->cfg.samples_per_column) render_column(w);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Búfer
+// -----------------------------------------------------------------------------
+
+static void clear_trace(wave_t *w) {
+    w->head = 0;
+    w->count = 0;
+    w->acc_valid = 0;
+    w->prev_valid = 0;
+    if (!w->buf) return;
+    for (int32_t i = 0; i < w->w * w->h; i++) w->buf[i] = w->bg;
+}
+
+// El tamaño real solo se conoce tras el layout de LVGL
+static bool ensure_buffer(wave_t *w, lv_obj_t *obj) {
+    int32_t cw = lv_obj_get_content_width(obj);
+    int32_t ch = lv_obj_get_content_height(obj);
+    if (cw <= 0 || ch <= 0) return false;
+    if (w->buf && cw == w->w && ch == w->h) return true;
+
+    heap_caps_free(w->buf);
+    size_t size = (size_t)cw * ch * sizeof(uint16_t);
+    w->buf = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!w->buf) w->buf = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    if (!w->buf) {
+        ESP_LOGE(TAG, "Sin memoria para %ldx%ld", (long)cw, (long)ch);
+        w->w = w->h = 0;
+        return false;
+    }
+    w->w = cw;
+    w->h = ch;
+
+    lv_image_dsc_t *imgs[2] = { &w->img_old, &w->img_new };
+    for (int i = 0; i < 2; i++) {
+        memset(imgs[i], 0, sizeof(*imgs[i]));
+        imgs[i]->header.magic = LV_IMAGE_HEADER_MAGIC;
+        imgs[i]->header.cf = LV_COLOR_FORMAT_RGB565;
+        imgs[i]->header.h = ch;
+        imgs[i]->header.stride = cw * sizeof(uint16_t);
+    }
+    clear_trace(w);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Eventos LVGL
+// -----------------------------------------------------------------------------
+
+static void draw_part(lv_layer_t *layer, lv_image_dsc_t *img, const uint16_t *data, int32_t cols,
+                      int32_t x1, int32_t y1) {
+    if (cols <= 0) return;
+    img->header.w = cols;
+    img->data = (const uint8_t *)data;
+    // La última fila termina en la última columna de esta parte
+    img->data_size = img->header.stride * (img->header.h - 1) + (uint32_t)cols * sizeof(uint16_t);
+
+    lv_draw_image_dsc_t dsc;
+    lv_draw_image_dsc_init(&dsc);
+    dsc.src = img;
+    lv_area_t area = { x1, y1, x1 + cols - 1, y1 + img->header.h - 1 };
+    lv_draw_image(layer, &dsc, &area);
+}
+
+static void wave_event_cb(lv_event_t *e) {
+    wave_t *w = (wave_t *)lv_event_get_user_data(e);
+    lv_obj_t *obj = lv_event_get_current_target(e);
+
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_DRAW_MAIN: {
+            if (!w->buf) return;
+            lv_area_t c;
+            lv_obj_get_content_coords(obj, &c);
+            // Columna más antigua a la izquierda: desplazamiento sin mover memoria
+            int32_t old_cols = w->w - w->head;
+            lv_layer_t *layer = lv_event_get_layer(e);
+            draw_part(layer, &w->img_old, w->buf + w->head, old_cols, c.x1, c.y1);
+            draw_part(layer, &w->img_new, w->buf, w->head, c.x1 + old_cols, c.y1);
+            w->st.frames++;
+            w->window_frames++;
+            break;
+        }
+        case LV_EVENT_SIZE_CHANGED:
+            ensure_buffer(w, obj);
+            break;
+        case LV_EVENT_DELETE:
+            SampleRing_set_consumer_active(w->ring, w->consumer, false);
+            heap_caps_free(w->buf);
+            heap_caps_free(w);
+            break;
+        default:
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// API
+// -----------------------------------------------------------------------------
+
+lv_obj_t *Waveform_AIoT_create(lv_obj_t *parent, SampleRing_t *ring, const Waveform_config_t *cfg) {
+    if (!ring) return NULL;
+    wave_t *w = heap_caps_calloc(1, sizeof(wave_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!w) return NULL;
+
+    w->consumer = SampleRing_register_consumer(ring, "wave");
+    if (w->consumer < 0) {
+        ESP_LOGE(TAG, "Sin cupo de consumidor en el anillo");
+        heap_caps_free(w);
+        return NULL;
+    }
+    w->ring = ring;
+    w->active = true;
+
+    Waveform_config_t def = WAVEFORM_CONFIG_DEFAULT();
+    w->cfg = cfg ? *cfg : def;
+    if (!w->cfg.samples_per_column) w->cfg.samples_per_column = 1;
+    if (w->cfg.y_max <= w->cfg.y_min) w->cfg.y_max = w->cfg.y_min + 1;
+    w->enabled = w->cfg.channel_mask;
+    w->node = w->cfg.node;
+    for (int ch = 0; ch < WAVE_CHANNELS; ch++) {
+        w->color_lv[ch] = lv_color_hex(default_palette[ch]);
+        w->color[ch] = lv_color_to_u16(w->color_lv[ch]);
+    }
+    w->bg = lv_color_to_u16(lv_color_hex(0x101418));
+    w->grid = lv_color_to_u16(lv_color_hex(0x303840));
+    w->window_start_us = esp_timer_get_time();
+
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_remove_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_user_data(obj, w);
+    lv_obj_add_event_cb(obj, wave_event_cb, LV_EVENT_DRAW_MAIN, w);
+    lv_obj_add_event_cb(obj, wave_event_cb, LV_EVENT_SIZE_CHANGED, w);
+    lv_obj_add_event_cb(obj, wave_event_cb, LV_EVENT_DELETE, w);
+    return obj;
+}
+
+static void stats_window(wave_t *w, int64_t now) {
+    int64_t span = now - w->window_start_us;
+    if (span < WAVE_STATS_WINDOW_US) return;
+    w->st.fps = (uint32_t)((uint64_t)w->window_frames * 1000000u / (uint64_t)span);
+    w->st.columns_per_s = (uint32_t)((uint64_t)w->window_columns * 1000000u / (uint64_t)span);
+    w->st.cpu_permille = (uint32_t)((uint64_t)w->window_busy_us * 1000u / (uint64_t)span);
+    w->window_frames = 0;
+    w->window_columns = 0;
+    w->window_busy_us = 0;
+    w->window_start_us = now;
+}
+
+void Waveform_AIoT_update(lv_obj_t *obj) {
+    Waveform_AIoT_update_until(obj, INT64_MAX);
+}
+
+void Waveform_AIoT_update_until(lv_obj_t *obj, int64_t deadline_us) {
+    wave_t *w = obj ? (wave_t *)lv_obj_get_user_data(obj) : NULL;
+    if (!w) return;
+    int64_t t0 = esp_timer_get_time();
+
+    // Oculto (otra pantalla u otra pestaña): no consumir ni frenar al productor
+    bool visible = lv_obj_is_visible(obj);
+    if (visible != w->active) {
+        w->active = visible;
+        SampleRing_set_consumer_active(w->ring, w->consumer, visible);
+        if (visible) {
+            w->count = 0;
+            w->acc_valid = 0;
+            w->prev_valid = 0;
+        }
+    }
+    if (!visible || !ensure_buffer(w, obj)) {
+        stats_window(w, t0);
+        return;
+    }
+
+    uint32_t columns = w->st.columns;
+    const SampleRing_block_t *b;
+    while ((b = SampleRing_peek(w->ring, w->consumer)) != NULL) {
+        consume_block(w, b);
+        SampleRing_release(w->ring, w->consumer);
+        w->st.blocks++;
+        if (esp_timer_get_time() >= deadline_us) break;
+    }
+
+    if (w->st.columns != columns) {
+        lv_obj_invalidate(obj);
+        int64_t t1 = esp_timer_get_time();
+        uint32_t dt = (uint32_t)(t1 - t0);
+        w->st.update_us_avg = w->st.update_us_avg ? ewma(w->st.update_us_avg, dt) : dt;
+        if (dt > w->st.update_us_max) w->st.update_us_max = dt;
+        w->window_busy_us += dt;
+        stats_window(w, t1);
+        return;
+    }
+    stats_window(w, t0);
+}
+
+void Waveform_AIoT_set_channel_enabled(lv_obj_t *obj, uint8_t channel, bool enabled) {
+    wave_t *w = obj ? (wave_t *)lv_obj_get_user_data(obj) : NULL;
+    if (!w || channel >= WAVE_CHANNELS) return;
+    if (enabled) w->enabled |= (uint16_t)(1u << channel);
+    else w->enabled &= (uint16_t)~(1u << channel);
+}
+
+bool Waveform_AIoT_get_channel_enabled(lv_obj_t *obj, uint8_t channel) {
+    wave_t *w = obj ? (wave_t *)lv_obj_get_user_data(obj) : NULL;
+    return w && channel < WAVE_CHANNELS && (w->enabled & (1u << channel));
+}
+
+void Waveform_AIoT_set_channel_color(lv_obj_t *obj, uint8_t channel, lv_color_t color) {
+    wave_t *w = obj ? (wave_t *)lv_obj_get_user_data(obj) : NULL;
+    if (!w || channel >= WAVE_CHANNELS) return;
+    w->color_lv[channel] = color;
+    w->color[channel] = lv_color_to_u16(color);
+}
+
+lv_color_t Waveform_AIoT_get_channel_color(lv_obj_t *obj, uint8_t channel) {
+    wave_t *w = obj ? (wave_t *)lv_obj_get_user_data(obj) : NULL;
+    if (!w || channel >= WAVE_CHANNELS) return lv_color_hex(default_palette[0]);
+    return w->color_lv[channel];
+}
+
+void Waveform_AIoT_set_config(lv_obj_t *obj, const Waveform_config_t *cfg) {
+    wave_t *w = obj ? (wave_t *)lv_obj_get_user_data(obj) : NULL;
+    if (!w || !cfg) return;
+    w->cfg = *cfg;
+    if (!w->cfg.samples_per_column) w->cfg.samples_per_column = 1;
+    if (w->cfg.y_max <= w->cfg.y_min) w->cfg.y_max = w->cfg.y_min + 1;
+    w->enabled = w->cfg.channel_mask;
+    w->node = w->cfg.node;
+    clear_trace(w);
+    lv_obj_invalidate(obj);
+}
+
+void Waveform_AIoT_get_stats(lv_obj_t *obj, Waveform_stats_t *stats) {
+    wave_t *w = obj ? (wave_t *)lv_obj_get_user_data(obj) : NULL;
+    if (w && stats) *stats = w->st;
+}
+
+void Waveform_AIoT_log_stats(lv_obj_t *obj) {
+    wave_t *w = obj ? (wave_t *)lv_obj_get_user_data(obj) : NULL;
+    if (!w) return;
+    ESP_LOGI(TAG, "%lu fps, %lu col/s, update %lu us (máx %lu), CPU %lu.%lu%%, %lu bloques",
+             (unsigned long)w->st.fps, (unsigned long)w->st.columns_per_s,
+             (unsigned long)w->st.update_us_avg, (unsigned long)w->st.update_us_max,
+             (unsigned long)(w->st.cpu_permille / 10), (unsigned long)(w->st.cpu_permille % 10),
+             (unsigned long)w->st.blocks);
+}
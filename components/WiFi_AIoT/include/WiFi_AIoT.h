@@ -32,6 +32,46 @@ int64_t get_wifi_connection_duration_us(void);
  */
 void WiFi_Get_Connection_Time_String(char *buffer, size_t len);
 
+// -------------------------------------------------------------------------
+// Network Worker Task
+// -------------------------------------------------------------------------
+// Scans and connects run in a low-priority task so the UI never blocks on
+// the radio. Requests are queued; the scan result is left in a slot that
+// the UI polls from its own loop.
+
+#define WIFI_TASK_CORE      0
+#define WIFI_TASK_PRIO      2
+#define WIFI_TASK_STACK     4096
+#define WIFI_TASK_QUEUE     4
+
+/**
+ * @brief Starts the network worker (call after wifi_init_sta).
+ */
+void WiFi_AIoT_Start_Task(void);
+
+/**
+ * @brief Queues an asynchronous scan.
+ * @return false if the worker is not running or the queue is full.
+ */
+bool WiFi_Request_Scan(void);
+
+/**
+ * @brief Queues an asynchronous connect (strings are copied).
+ */
+bool WiFi_Request_Connect(const char *ssid, const char *password);
+
+/**
+ * @brief Takes the latest scan result, if any.
+ * @return Newline-separated SSID list (caller frees) or NULL if none is pending.
+ */
+char* WiFi_Take_Scan_Result(void);
+
+/**
+ * @brief Holds or releases the max-CPU-frequency PM lock taken at init.
+ * Released while the screen is suspended. No-op without CONFIG_PM_ENABLE.
+ */
+void WiFi_Set_Power_Lock(bool hold);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
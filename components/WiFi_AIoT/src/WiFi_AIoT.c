@@ -10,6 +10,8 @@
 #include <stdlib.h>
 #include <stdio.h> 
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
 #include "esp_wifi.h"
 #include "esp_log.h"
 #include "esp_event.h"
@@ -17,6 +19,7 @@
 #include "esp_netif.h"
 #include "esp_timer.h" 
 #include "esp_pm.h" // Power Management
+#include "TaskMonitor_AIoT.h"
 
 static const char *TAG = "Wifi_AIoT";
 
@@ -33,6 +36,7 @@ static int64_t connection_start_time = 0;
 // Power Management Lock Handle (Safe guard)
 #if CONFIG_PM_ENABLE
 static esp_pm_lock_handle_t cpu_freq_lock;
+static bool cpu_freq_locked = false;
 #endif
 
 // -------------------------------------------------------------------------
@@ -104,6 +108,7 @@ void wifi_init_sta(void)
     // Only locks CPU if Power Management is enabled in menuconfig
     if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "rgb_fix", &cpu_freq_lock) == ESP_OK) {
         esp_pm_lock_acquire(cpu_freq_lock);
+        cpu_freq_locked = true;
         ESP_LOGI(TAG, "CPU Frequency Locked (Stability Mode Active)");
     }
     #else
@@ -154,6 +159,110 @@ char* wifi_scan_networks_get_list(void)
     return list_buffer;
 }
 
+// -------------------------------------------------------------------------
+// Network Worker Task
+// -------------------------------------------------------------------------
+typedef enum {
+    WIFI_CMD_SCAN,
+    WIFI_CMD_CONNECT,
+} wifi_cmd_type_t;
+
+typedef struct {
+    wifi_cmd_type_t type;
+    char ssid[33];
+    char password[65];
+} wifi_cmd_t;
+
+static QueueHandle_t wifi_cmd_queue = NULL;
+static char *scan_result = NULL;
+static portMUX_TYPE scan_result_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void wifi_worker_task(void *arg)
+{
+    int mon_id = TaskMon_register("net", 0);
+    wifi_cmd_t cmd;
+
+    for (;;) {
+        if (xQueueReceive(wifi_cmd_queue, &cmd, portMAX_DELAY) != pdTRUE) continue;
+        TaskMon_begin(mon_id);
+
+        if (cmd.type == WIFI_CMD_SCAN) {
+            char *list = wifi_scan_networks_get_list();
+            // An empty scan still publishes a result so the UI can clear its list
+            if (!list) list = (char *)calloc(1, 1);
+
+            taskENTER_CRITICAL(&scan_result_lock);
+            char *old = scan_result;
+            scan_result = list;
+            taskEXIT_CRITICAL(&scan_result_lock);
+            free(old);
+        } else {
+            wifi_connect(cmd.ssid, cmd.password);
+        }
+
+        TaskMon_end(mon_id);
+    }
+}
+
+void WiFi_AIoT_Start_Task(void)
+{
+    if (wifi_cmd_queue) return;
+    wifi_cmd_queue = xQueueCreate(WIFI_TASK_QUEUE, sizeof(wifi_cmd_t));
+    if (!wifi_cmd_queue) {
+        ESP_LOGE(TAG, "Failed to create command queue");
+        return;
+    }
+    if (xTaskCreatePinnedToCore(wifi_worker_task, "wifi_worker", WIFI_TASK_STACK, NULL,
+                                WIFI_TASK_PRIO, NULL, WIFI_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create worker task");
+        vQueueDelete(wifi_cmd_queue);
+        wifi_cmd_queue = NULL;
+    }
+}
+
+bool WiFi_Request_Scan(void)
+{
+    if (!wifi_cmd_queue) return false;
+    wifi_cmd_t cmd = { .type = WIFI_CMD_SCAN };
+    return xQueueSend(wifi_cmd_queue, &cmd, 0) == pdTRUE;
+}
+
+bool WiFi_Request_Connect(const char *ssid, const char *password)
+{
+    if (!wifi_cmd_queue || !ssid) return false;
+    wifi_cmd_t cmd = { .type = WIFI_CMD_CONNECT };
+    strncpy(cmd.ssid, ssid, sizeof(cmd.ssid) - 1);
+    if (password) strncpy(cmd.password, password, sizeof(cmd.password) - 1);
+    return xQueueSend(wifi_cmd_queue, &cmd, 0) == pdTRUE;
+}
+
+char* WiFi_Take_Scan_Result(void)
+{
+    taskENTER_CRITICAL(&scan_result_lock);
+    char *list = scan_result;
+    scan_result = NULL;
+    taskEXIT_CRITICAL(&scan_result_lock);
+    return list;
+}
+
+// -------------------------------------------------------------------------
+// Power Management
+// -------------------------------------------------------------------------
+void WiFi_Set_Power_Lock(bool hold)
+{
+    #if CONFIG_PM_ENABLE
+    // The lock only exists to keep the RGB scanout stable: with the screen
+    // suspended DFS may scale the CPU down (WiFi keeps its own modem locks)
+    if (!cpu_freq_lock || cpu_freq_locked == hold) return;
+    if (hold) esp_pm_lock_acquire(cpu_freq_lock);
+    else      esp_pm_lock_release(cpu_freq_lock);
+    cpu_freq_locked = hold;
+    ESP_LOGI(TAG, "CPU Frequency Lock %s", hold ? "held" : "released");
+    #else
+    (void)hold;
+    #endif
+}
+
 // -------------------------------------------------------------------------
 // Getters & Utils
 // -------------------------------------------------------------------------
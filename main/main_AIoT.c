@@ -7,17 +7,129 @@
 
 // COMPONENTS
 #include "Configuracion_AIoT.h"
+#include "Display_Tuner_AIoT.h"
+#include "Frame_Sched_AIoT.h"
+#include "Display_Power_AIoT.h"
+#include "xpt2046_lvgl9.h"
+#include "Touch_Calib_AIoT.h"
+#include "Input_Rec_AIoT.h"
+#include "Asset_Cache_AIoT.h"
 #include "WiFi_AIoT.h"
 #include "IO_AIoT.h"
+#include "SampleRing_AIoT.h"
+#include "Acquisition_AIoT.h"
+#include "HammerDetect_AIoT.h"
+#include "TaskMonitor_AIoT.h"
 // #include "Bluetooth_AIoT.h" // REMOVED: Bluetooth module disabled
 #include "ui.h" 
+#include "screens.h"
+#include "images.h"
 #include "lvgl.h"
 
 // External declaration
 extern void ui_update_periodic_task(void);
+extern void ui_waveform_attach(SampleRing_t *ring);
+extern void ui_set_frame_deadline(int64_t deadline_us);
 
 static const char *TAG = "Main_App";
 
+// Sample path: acquisition (core 1) -> ring (PSRAM) -> UI / storage / network
+static SampleRing_t *g_sample_ring = NULL;
+
+// Task layout:
+//   core 1: acquisition (prio 20) -> ring -> water-hammer detector (prio 15)
+//   core 0: UI / LVGL / EEZ flow (prio 5), network worker (prio 2)
+#define UI_TASK_CORE            0
+#define UI_TASK_PRIO            5
+#define UI_TASK_STACK           20480   // Same budget the UI had as the main task
+#define UI_STATS_PERIOD_MS      60000
+
+// Screen suspend / wake from IO_Task_Manager (UI task): rendering, scanout
+// and the CPU frequency lock follow the backlight
+static void ui_power_cb(bool dimmed)
+{
+    if (dimmed) Display_Power_suspend();
+    else        Display_Power_resume();
+    WiFi_Set_Power_Lock(!dimmed);
+}
+
+static void ui_task(void *arg)
+{
+    // All LVGL objects are created and serviced from this task only
+    ui_init();
+    ui_waveform_attach(g_sample_ring);
+
+    // Hold the settings title bar to recalibrate the touch panel
+    if (objects.container_main2) {
+        Touch_Calib_AIoT_Attach_Hold(lv_obj_get_child(objects.container_main2, 0));
+    }
+
+    // Decode the EEZ images to RGB565 once instead of reading ARGB8888 from flash on every redraw
+    for (size_t i = 0; i < sizeof(images) / sizeof(images[0]); i++) {
+        Asset_Cache_AIoT_Preload(images[i].img_dsc);
+    }
+#if AIOT_ASSET_CACHE_BENCHMARK
+    Asset_Cache_AIoT_Benchmark(20, NULL, NULL);
+#endif
+    esp_task_wdt_add(NULL);
+
+    IO_Set_Suspend_Callback(ui_power_cb);
+
+    int mon_id = TaskMon_register("ui", 0);
+    uint32_t last_stats_ms = 0;
+
+    ESP_LOGI(TAG, "UI task running on core %d", xPortGetCoreID());
+
+    uint32_t time_until_next = 0;
+    for (;;) {
+        // A. Sleep until the next panel refresh slot (VSYNC / divisor); arms
+        //    at most one LVGL refresh for it. While the screen is suspended
+        //    the loop runs every DPOWER_IDLE_PERIOD_MS or on a touch IRQ,
+        //    which redraws a full frame right here
+        Frame_Sched_wait(time_until_next);
+        Display_Power_poll();
+
+        TaskMon_begin(mon_id);
+
+        // B. LVGL timers (renders only if the slot was armed)
+        time_until_next = lv_timer_handler();
+
+        // C. EEZ Flow Tick (bounded by the flow itself)
+        ui_tick();
+
+        // D. Custom UI Logic (Clock, WiFi status, Power, waveform): moved to
+        //    the next frame when the render already used the frame budget
+        if (!Frame_Sched_should_defer()) {
+            ui_set_frame_deadline(Frame_Sched_deadline_us());
+            ui_update_periodic_task();
+        }
+
+        // E. Watchdog Reset
+        esp_task_wdt_reset();
+
+        // F. Power Management Task (Auto-Sleep)
+        IO_Task_Manager();
+
+        // G. Display tuning (pixel clock vs. load)
+        Display_Tuner_set_wifi_active(get_wifi_is_connected());
+        Display_Tuner_update();
+
+        Frame_Sched_end();
+        TaskMon_end(mon_id);
+
+        // H. Periodic task report (period, jitter, CPU share, frame pacing)
+        uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        if ((now_ms - last_stats_ms) >= UI_STATS_PERIOD_MS) {
+            TaskMon_log_all();
+            Frame_Sched_log_stats();
+            Display_Power_log_stats();
+            xpt2046_log_stats();
+            Input_Rec_AIoT_Log_Stats();
+            last_stats_ms = now_ms;
+        }
+    }
+}
+
 void app_main(void)
 {
     // 1. Initialize NVS (Non-Volatile Storage)
@@ -37,34 +149,24 @@ void app_main(void)
     // Bluetooth_AIoT_Init(); // REMOVED
     wifi_init_sta();       // WiFi Station Mode
     
-    // 3. Initialize UI (EEZ Studio / LVGL)
-    ui_init(); 
-    
-    // 4. Add Main Task to Watchdog
-    esp_task_wdt_add(NULL);
-
-    ESP_LOGI(TAG, "System Initialized. Entering Main Loop...");
-
-    for (;;) {
-        // A. LVGL Tick Handler
-        uint32_t time_until_next = lv_timer_handler();
-        
-        // B. EEZ Flow Tick
-        ui_tick();
-        
-        // C. Custom UI Logic (Clock, WiFi status, Power)
-        ui_update_periodic_task();
-        
-        // D. Watchdog Reset
-        esp_task_wdt_reset();
-
-        // E. Intelligent Delay to prevent starvation
-        if (time_until_next > 10) time_until_next = 10;
-        if (time_until_next < 1) time_until_next = 1;
+    // 3. Sensor Acquisition (UART task pinned to core 1 feeding the sample ring)
+    g_sample_ring = SampleRing_create(ACQ_RING_BLOCKS);
+    if (g_sample_ring == NULL || Acquisition_AIoT_Start(g_sample_ring) != ESP_OK) {
+        ESP_LOGE(TAG, "Sensor acquisition not started!");
+    } else if (HammerDetect_AIoT_Start(g_sample_ring, NULL) != ESP_OK) {
+        ESP_LOGE(TAG, "Water-hammer detector not started!");
+    }
 
-        // F. Power Management Task (Auto-Sleep)
-        IO_Task_Manager();
+    // 4. Network worker (scan / connect off the UI thread)
+    WiFi_AIoT_Start_Task();
 
-        vTaskDelay(pdMS_TO_TICKS(time_until_next));
+    // 5. UI task (EEZ Studio / LVGL) pinned to core 0; app_main returns and
+    //    its stack is released
+    if (xTaskCreatePinnedToCore(ui_task, "ui", UI_TASK_STACK, NULL,
+                                UI_TASK_PRIO, NULL, UI_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "UI task not started!");
+        return;
     }
-}
\ No newline at end of file
+
+    ESP_LOGI(TAG, "System Initialized. Tasks running.");
+}
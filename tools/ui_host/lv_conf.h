@@ -0,0 +1,66 @@
+// -----------------------------------------------------------------------------
+// lv_conf.h del banco de pruebas en PC
+//
+// Copia de las opciones de LVGL de sdkconfig que cambian el coste de render o
+// el uso de memoria; el resto queda con los valores por defecto de LVGL
+// (lv_conf_internal.h), que son los mismos que deja menuconfig.
+// -----------------------------------------------------------------------------
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+// --- Color y memoria (CONFIG_LV_COLOR_DEPTH, CONFIG_LV_MEM_SIZE_KILOBYTES) ---
+#define LV_COLOR_DEPTH                      16
+#define LV_USE_STDLIB_MALLOC                LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_STRING                LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_SPRINTF               LV_STDLIB_BUILTIN
+#define LV_MEM_SIZE                         (64 * 1024U)
+
+// --- Refresco y sistema operativo ---
+#define LV_DEF_REFR_PERIOD                  33
+#define LV_DPI_DEF                          130
+#define LV_USE_OS                           LV_OS_NONE
+
+// --- Render por software ---
+#define LV_DRAW_BUF_STRIDE_ALIGN            1
+#define LV_DRAW_BUF_ALIGN                   4
+#define LV_DRAW_LAYER_SIMPLE_BUF_SIZE       (24 * 1024)
+#define LV_USE_DRAW_SW                      1
+#define LV_DRAW_SW_DRAW_UNIT_CNT            1
+#define LV_CACHE_DEF_SIZE                   0
+
+// Núcleos RGB565 de Draw_Accel_AIoT, como CONFIG_LV_DRAW_SW_ASM_CUSTOM
+#if AIOT_HOST_DRAW_ACCEL
+#define LV_USE_DRAW_SW_ASM                  LV_DRAW_SW_ASM_CUSTOM
+#define LV_DRAW_SW_ASM_CUSTOM_INCLUDE       "Draw_Accel_AIoT_lvgl.h"
+#else
+#define LV_USE_DRAW_SW_ASM                  LV_DRAW_SW_ASM_NONE
+#endif
+
+// --- Depuración (desactivada en sdkconfig) ---
+#define LV_USE_LOG                          0
+#define LV_USE_ASSERT_NULL                  0
+#define LV_USE_ASSERT_MALLOC                0
+#define LV_USE_ASSERT_STYLE                 0
+#define LV_USE_ASSERT_MEM_INTEGRITY         0
+#define LV_USE_ASSERT_OBJ                   0
+
+// --- Fuentes (screens.c solo registra las que estén activas) ---
+#define LV_FONT_MONTSERRAT_14               1
+#define LV_FONT_MONTSERRAT_16               1
+#define LV_FONT_DEFAULT                     &lv_font_montserrat_14
+#define LV_USE_FONT_PLACEHOLDER             1
+
+// --- Temas y diseños ---
+#define LV_USE_THEME_DEFAULT                1
+#define LV_USE_THEME_SIMPLE                 1
+#define LV_USE_FLEX                         1
+#define LV_USE_GRID                         1
+#define LV_USE_OBSERVER                     1
+
+// --- Sin controladores de PC: la pantalla y el puntero son del banco ---
+#define LV_USE_SDL                          0
+#define LV_USE_X11                          0
+#define LV_USE_LINUX_FBDEV                  0
+#define LV_BUILD_EXAMPLES                   0
+
+#endif // LV_CONF_H
@@ -0,0 +1,245 @@
+#include "Host_Platform_AIoT.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/task.h"
+#include "WiFi_AIoT.h"
+#include "IO_AIoT.h"
+
+// Latencias simuladas del trabajador de red
+#define HOST_WIFI_SCAN_MS       800
+#define HOST_WIFI_CONNECT_MS    1500
+
+static uint32_t now_ms = 0;
+static bool verbose = false;
+
+// -----------------------------------------------------------------------------
+// Reloj, tareas y log
+// -----------------------------------------------------------------------------
+
+static void wifi_poll(void);
+
+uint32_t host_now_ms(void) {
+    return now_ms;
+}
+
+void host_advance_ms(uint32_t ms) {
+    now_ms += ms;
+    wifi_poll();
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)now_ms;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    host_advance_ms(ticks);
+}
+
+int64_t esp_timer_get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void host_set_verbose(bool v) {
+    verbose = v;
+}
+
+void host_log(char level, const char *tag, const char *fmt, ...) {
+    if (!verbose && level != 'E' && level != 'W') return;
+    va_list ap;
+    va_start(ap, fmt);
+    fprintf(stderr, "%c (%u) %s: ", level, (unsigned)now_ms, tag);
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+}
+
+// -----------------------------------------------------------------------------
+// heap_caps con contabilidad
+// -----------------------------------------------------------------------------
+
+// Cabecera delante de cada bloque; 16 bytes para no romper la alineación
+typedef struct {
+    size_t size;
+    uint32_t spiram;
+    uint32_t pad;
+} heap_hdr_t;
+
+static Host_heap_stats_t heap_st;
+
+static void heap_account(size_t size, bool spiram, bool add) {
+    size_t *cur = spiram ? &heap_st.spiram_bytes : &heap_st.internal_bytes;
+    size_t *peak = spiram ? &heap_st.spiram_peak : &heap_st.internal_peak;
+    if (add) {
+        *cur += size;
+        if (*cur > *peak) *peak = *cur;
+    } else {
+        *cur -= size;
+    }
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+    heap_hdr_t *h = malloc(sizeof(heap_hdr_t) + size);
+    if (!h) return NULL;
+    h->size = size;
+    h->spiram = (caps & MALLOC_CAP_SPIRAM) ? 1 : 0;
+    heap_account(size, h->spiram, true);
+    return h + 1;
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+    if (size && n > SIZE_MAX / size) return NULL;
+    void *p = heap_caps_malloc(n * size, caps);
+    if (p) memset(p, 0, n * size);
+    return p;
+}
+
+void heap_caps_free(void *ptr) {
+    if (!ptr) return;
+    heap_hdr_t *h = (heap_hdr_t *)ptr - 1;
+    heap_account(h->size, h->spiram, false);
+    free(h);
+}
+
+void host_get_heap_stats(Host_heap_stats_t *stats) {
+    if (stats) *stats = heap_st;
+}
+
+// -----------------------------------------------------------------------------
+// WiFi_AIoT simulado
+// -----------------------------------------------------------------------------
+
+static bool wifi_connected = false;
+static char wifi_ssid[33] = "";
+static uint32_t wifi_connected_ms = 0;
+
+static char *scan_list = NULL;                  // Lista que devolverá el próximo escaneo
+static uint32_t scan_due_ms = 0;                // 0 = sin escaneo en curso
+static bool scan_ready = false;
+
+static char pending_ssid[33] = "";
+static uint32_t connect_due_ms = 0;
+
+static void wifi_poll(void) {
+    if (scan_due_ms && now_ms >= scan_due_ms) {
+        scan_due_ms = 0;
+        scan_ready = true;
+    }
+    if (connect_due_ms && now_ms >= connect_due_ms) {
+        connect_due_ms = 0;
+        host_wifi_set_connected(true, pending_ssid);
+    }
+}
+
+void host_wifi_set_connected(bool connected, const char *ssid) {
+    wifi_connected = connected;
+    wifi_connected_ms = now_ms;
+    snprintf(wifi_ssid, sizeof(wifi_ssid), "%s", connected && ssid ? ssid : "");
+}
+
+void host_wifi_set_scan_result(const char *list) {
+    free(scan_list);
+    scan_list = list ? strdup(list) : NULL;
+}
+
+void wifi_init_sta(void) {}
+void WiFi_AIoT_Start_Task(void) {}
+
+char *wifi_scan_networks_get_list(void) {
+    return strdup(scan_list ? scan_list : "");
+}
+
+void wifi_connect(const char *ssid, const char *password) {
+    (void)password;
+    host_wifi_set_connected(true, ssid);
+}
+
+bool get_wifi_is_connected(void) {
+    return wifi_connected;
+}
+
+char *get_wifi_ssid(void) {
+    return wifi_connected ? wifi_ssid : "---";
+}
+
+char *get_wifi_ip(void) {
+    return wifi_connected ? "192.168.1.50" : "0.0.0.0";
+}
+
+char *get_wifi_dns(void) {
+    return wifi_connected ? "192.168.1.1" : "0.0.0.0";
+}
+
+char *get_wifi_mac(void) {
+    return "24:0A:C4:00:00:01";
+}
+
+int64_t get_wifi_connection_duration_us(void) {
+    return wifi_connected ? (int64_t)(now_ms - wifi_connected_ms) * 1000 : 0;
+}
+
+static void format_dhms(char *buffer, size_t len, uint32_t seconds) {
+    snprintf(buffer, len, "%ud %02u:%02u:%02u", seconds / 86400, (seconds / 3600) % 24,
+             (seconds / 60) % 60, seconds % 60);
+}
+
+void WiFi_Get_Connection_Time_String(char *buffer, size_t len) {
+    format_dhms(buffer, len, (uint32_t)(get_wifi_connection_duration_us() / 1000000));
+}
+
+bool WiFi_Request_Scan(void) {
+    if (scan_due_ms) return false;
+    scan_due_ms = now_ms + HOST_WIFI_SCAN_MS;
+    return true;
+}
+
+bool WiFi_Request_Connect(const char *ssid, const char *password) {
+    (void)password;
+    if (!ssid || connect_due_ms) return false;
+    snprintf(pending_ssid, sizeof(pending_ssid), "%s", ssid);
+    connect_due_ms = now_ms + HOST_WIFI_CONNECT_MS;
+    return true;
+}
+
+char *WiFi_Take_Scan_Result(void) {
+    if (!scan_ready) return NULL;
+    scan_ready = false;
+    return wifi_scan_networks_get_list();
+}
+
+// -----------------------------------------------------------------------------
+// IO_AIoT simulado
+// -----------------------------------------------------------------------------
+
+static int32_t io_brillo = 100;
+static int32_t io_suspension = 0;
+
+void IO_AIoT_Init(void) {}
+void IO_Task_Manager(void) {}
+
+void IO_Set_Brillo_Manual(int32_t percentage) {
+    io_brillo = percentage;
+}
+
+void IO_Set_Tiempo_Suspension(int32_t index) {
+    io_suspension = index;
+}
+
+void IO_Get_Uptime(char *buffer, size_t len) {
+    format_dhms(buffer, len, now_ms / 1000);
+}
+
+int32_t host_io_get_brillo(void) {
+    return io_brillo;
+}
+
+int32_t host_io_get_suspension(void) {
+    return io_suspension;
+}
@@ -0,0 +1,335 @@
+// Simulador en el PC de varios nodos respondiendo al sondeo de BusScheduler_AIoT.
+//
+// Reloj simulado en µs. El maestro hace lo mismo que la tarea de adquisición:
+// BusSched_check_timeouts, BusSched_next_request -> SensorFrame_encode_poll,
+// y cada respuesta pasa por SensorFrame_decode antes de BusSched_on_response.
+// Los nodos:
+//   - acumulan muestras a su ritmo en un buffer de NODE_BUFFER muestras por
+//     canal (lo que no cabe se pierde) y responden con hasta 64 por canal,
+//     repitiendo la secuencia de la petición
+//   - tardan en responder un tiempo aleatorio; algunos se retrasan más que
+//     el timeout (respuesta tardía) o pierden la respuesta
+//   - un nodo deja de responder durante el tercio central de la simulación
+// Las peticiones salen por la línea TX y las respuestas comparten la línea RX,
+// una detrás de otra, al baud rate configurado.
+//
+// El maestro tiene hasta IN_FLIGHT peticiones en vuelo (ACQ_BUS_MAX_IN_FLIGHT):
+// la siguiente petición sale por TX mientras la respuesta anterior sigue en RX,
+// y el timeout cubre las tramas máximas que pueden ir delante en la línea.
+//
+// Comprueba que las respuestas tardías se descartan (stale) y las demás se
+// aceptan, que el periodo se adapta al ritmo de cada nodo, que el nodo caído
+// acumula fallos, que la ocupación del bus cubre la carga de datos y que los
+// nodos vivos no pierden muestras (el rápido, como mucho un 1 ‰).
+// Termina con código 1 ante cualquier diferencia.
+
+#include "BusScheduler_AIoT.h"
+#include "SensorFrame_AIoT.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BAUD            921600
+#define NODES           6
+#define NODE_BUFFER     256             // Muestras por canal en el nodo
+#define PERIOD_US       20000
+#define REPLY_US        5000            // ACQ_NODE_TIMEOUT_US: respuesta del nodo sin la transmisión
+#define FRAME_WIRE_US   ((int64_t)SFRAME_MAX_FRAME_LEN * 10 * 1000000 / BAUD)
+#define RETRIES         2
+#define IN_FLIGHT       2               // ACQ_BUS_MAX_IN_FLIGHT
+#define MAX_PENDING     64
+
+// SensorFrame_AIoT.c enlaza con UARTn_peek/UARTn_consume (SensorFrame_poll),
+// que aquí no se usan: se decodifica cada respuesta con SensorFrame_decode.
+size_t UARTn_peek(UARTn_handle_t handle, const uint8_t **p1, size_t *n1, const uint8_t **p2, size_t *n2) {
+    (void)handle; (void)p1; (void)n1; (void)p2; (void)n2;
+    return 0;
+}
+void UARTn_consume(UARTn_handle_t handle, size_t len) {
+    (void)handle; (void)len;
+}
+
+typedef struct {
+    const char *name;
+    uint16_t mask;                      // Canales
+    uint32_t rate_hz;                   // Muestras por segundo y canal
+    uint32_t delay_min_us, delay_max_us;
+    uint32_t late_pct;                  // % de respuestas más tardías que el timeout
+    uint32_t drop_pct;                  // % de respuestas perdidas
+    bool goes_down;                     // Sin respuesta en el tercio central
+    // Estado
+    double buffered;                    // Muestras por canal pendientes
+    uint64_t lost_samples;
+    int64_t busy_until;
+    uint16_t node_seq;
+    // Esperado por el simulador
+    uint32_t on_time, late, dropped;
+} sim_node_t;
+
+#define SIM_NODE(n, m, hz, dmin, dmax, late, drop, down) \
+    { .name = n, .mask = m, .rate_hz = hz, .delay_min_us = dmin, .delay_max_us = dmax, \
+      .late_pct = late, .drop_pct = drop, .goes_down = down }
+
+static sim_node_t g_nodes[NODES] = {
+    SIM_NODE("rápido",  0x000F, 2000, 200,  600,  0, 2, false),
+    SIM_NODE("normal",  0x00FF,  500, 200,  600,  0, 2, false),
+    SIM_NODE("normal",  0x00FF,  500, 300,  900,  0, 2, false),
+    SIM_NODE("lento",   0xFFFF,  100, 200,  600,  0, 2, false),
+    SIM_NODE("tardío",  0x00FF,  500, 300, 2000, 10, 2, false),
+    SIM_NODE("caído",   0x00FF,  500, 200,  600,  0, 2, true),
+};
+
+// Respuesta en la línea RX
+typedef struct {
+    int node;
+    int64_t start_us;                   // Primer bit en la línea
+    int64_t end_us;                     // Último bit recibido
+    int64_t sent_us;                    // Envío de la petición que contesta
+    bool late;
+    size_t len;
+    uint8_t bytes[SFRAME_MAX_FRAME_LEN];
+} arrival_t;
+
+static arrival_t g_arrivals[MAX_PENDING];
+static int g_arrival_count;
+
+// Respuesta del nodo más las tramas que pueden ir delante en la línea RX
+static int64_t g_timeout_us;
+
+static uint32_t g_rng = 99;
+static uint32_t rnd(uint32_t n) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return (g_rng >> 8) % n;
+}
+
+static int64_t wire_us(size_t bytes) {
+    return (int64_t)((bytes * 10 * 1000000ull + BAUD - 1) / BAUD);
+}
+
+static void node_accumulate(sim_node_t *n, int64_t dt_us) {
+    n->buffered += (double)n->rate_hz * dt_us / 1e6;
+    if (n->buffered > NODE_BUFFER) {
+        n->lost_samples += (uint64_t)(n->buffered - NODE_BUFFER);
+        n->buffered = NODE_BUFFER;
+    }
+}
+
+// Primer hueco de la línea RX desde 'ready' en el que cabe una trama de 'us'
+static int64_t rx_slot(int64_t ready, int64_t us) {
+    int64_t start = ready;
+    bool moved = true;
+    while (moved) {
+        moved = false;
+        for (int k = 0; k < g_arrival_count; k++) {
+            const arrival_t *a = &g_arrivals[k];
+            if (start < a->end_us && start + us > a->start_us) {
+                start = a->end_us;
+                moved = true;
+            }
+        }
+    }
+    return start;
+}
+
+// El nodo recibe la petición (último bit en 'at_us') y prepara su respuesta
+static void node_request(int idx, uint16_t seq, int64_t sent_us, int64_t at_us, int64_t duration_us) {
+    sim_node_t *n = &g_nodes[idx];
+    if (n->goes_down && at_us > duration_us / 3 && at_us < 2 * duration_us / 3) return;
+    if (rnd(100) < n->drop_pct) {
+        n->dropped++;
+        return;
+    }
+    if (g_arrival_count == MAX_PENDING) return;
+
+    uint32_t delay = n->delay_min_us + rnd(n->delay_max_us - n->delay_min_us + 1);
+    if (rnd(100) < n->late_pct) delay = (uint32_t)g_timeout_us + 500 + rnd(4000);
+    int64_t ready = at_us + delay;
+    if (ready < n->busy_until) ready = n->busy_until;
+
+    uint8_t spc = (uint8_t)(n->buffered < 1 ? 1 : (n->buffered > SFRAME_MAX_SAMPLES ? SFRAME_MAX_SAMPLES : n->buffered));
+    n->buffered -= spc;
+    if (n->buffered < 0) n->buffered = 0;
+
+    static int16_t samples[SFRAME_MAX_CHANNELS * SFRAME_MAX_SAMPLES];
+    static arrival_t a_new;
+    arrival_t *a = &a_new;
+    a->node = idx;
+    a->sent_us = sent_us;
+    a->len = SensorFrame_encode(a->bytes, sizeof(a->bytes), (uint8_t)(idx + 1), seq, n->mask, spc,
+                                (uint32_t)ready, samples);
+    // La línea RX es compartida: la respuesta ocupa el primer hueco libre desde
+    // que está lista, sin esperar a respuestas que saldrán más tarde
+    a->start_us = rx_slot(ready, wire_us(a->len));
+    a->end_us = a->start_us + wire_us(a->len);
+    n->busy_until = a->end_us;
+    // El maestro la procesa en end_us, tras BusSched_check_timeouts del mismo instante
+    a->late = a->end_us - sent_us >= g_timeout_us;
+    if (a->late) n->late++;
+    else n->on_time++;
+    g_arrivals[g_arrival_count++] = *a;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    double seconds = 60;
+    int in_flight = IN_FLIGHT;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--in-flight") && i + 1 < argc) in_flight = atoi(argv[++i]);
+        else {
+            printf("Uso: %s [--seconds S] [--in-flight N]   (tiempo simulado)\n", argv[0]);
+            return 2;
+        }
+    }
+    if (in_flight < 1 || in_flight > NODES) in_flight = 1;
+    int64_t duration = (int64_t)(seconds * 1e6);
+    g_timeout_us = REPLY_US + in_flight * FRAME_WIRE_US;
+
+    BusSched_t bus;
+    BusSched_config_t cfg = { .max_in_flight = (uint8_t)in_flight, .baud_rate = BAUD };
+    BusSched_init(&bus, &cfg, 0);
+    for (int i = 0; i < NODES; i++) BusSched_add_node(&bus, (uint8_t)(i + 1), PERIOD_US, (uint32_t)g_timeout_us, RETRIES);
+
+    static SensorFrame_decoder_t dec;
+    SensorFrame_decoder_init(&dec);
+
+    int64_t now = 0, last = 0, tx_free = 0;
+    uint32_t decode_errors = 0, accepted = 0, rejected = 0, events = 0;
+    double t0 = now_s();
+    while (now < duration) {
+        for (int i = 0; i < NODES; i++) node_accumulate(&g_nodes[i], now - last);
+        last = now;
+
+        // 1. Timeouts y peticiones (como bus_dispatch)
+        BusSched_check_timeouts(&bus, now);
+        uint8_t address;
+        uint16_t seq;
+        while (BusSched_next_request(&bus, now, &address, &seq)) {
+            uint8_t poll[SFRAME_POLL_LEN];
+            size_t len = SensorFrame_encode_poll(poll, sizeof(poll), address, seq, SFRAME_MAX_SAMPLES);
+            BusSched_on_sent(&bus, len);
+            int64_t start = (now > tx_free) ? now : tx_free;
+            tx_free = start + wire_us(len);
+            node_request(address - 1, seq, now, tx_free, duration);
+        }
+
+        // 2. Respuestas completas hasta ahora, en orden de llegada
+        for (int k = 0; k < g_arrival_count;) {
+            arrival_t *a = &g_arrivals[k];
+            if (a->end_us > now) {
+                k++;
+                continue;
+            }
+            SensorFrame_view_t view;
+            size_t skip, frame_len;
+            if (!SensorFrame_decode(&dec, a->bytes, a->len, NULL, 0, &view, &skip, &frame_len)) {
+                decode_errors++;
+            } else {
+                uint8_t fill_q8 = (uint8_t)((view.samples_per_channel * 255u) / SFRAME_MAX_SAMPLES);
+                bool ok = BusSched_on_response(&bus, view.node, view.seq, view.frame_len, fill_q8, now);
+                if (ok == a->late) {
+                    if (decode_errors++ < 10)
+                        printf("  FALLO: nodo %u seq %u %s y el planificador la %s\n", view.node, view.seq,
+                               a->late ? "tardía" : "a tiempo", ok ? "aceptó" : "rechazó");
+                }
+                if (ok) accepted++;
+                else rejected++;
+            }
+            *a = g_arrivals[--g_arrival_count];
+        }
+
+        // 3. Siguiente evento: planificador o llegada de una respuesta
+        int64_t next = now + BusSched_time_to_next_event(&bus, now);
+        for (int k = 0; k < g_arrival_count; k++) {
+            if (g_arrivals[k].end_us < next) next = g_arrivals[k].end_us;
+        }
+        if (next <= now) next = now + 1;
+        now = next;
+        events++;
+    }
+    double dt = now_s() - t0;
+
+    printf("%.0f s simulados a %d baud, %d nodos, timeout %lld us: %u eventos en %.3f s reales\n",
+           seconds, BAUD, NODES, (long long)g_timeout_us, events, dt);
+    printf("  %-3s %-7s %3s %6s %9s %8s %8s %7s %6s %6s %7s %7s %7s %9s\n", "n", "nodo", "can", "Hz", "periodo", "peticion",
+           "respuest", "timeout", "fallo", "tarde", "p50", "p99", "máx", "perdidas");
+    bool ok = decode_errors == 0;
+    uint32_t expected_late = 0, stale = 0;
+    for (int i = 0; i < NODES; i++) {
+        BusSched_node_stats_t st;
+        BusSched_get_node_stats(&bus, i, &st);
+        sim_node_t *n = &g_nodes[i];
+        printf("  %-3u %-7s %3d %6u %9u %8u %8u %7u %6u %6u %7u %7u %7u %9llu\n", st.address, n->name,
+               __builtin_popcount(n->mask), n->rate_hz,
+               st.period_us, st.requests, st.responses, st.timeouts, st.failures, st.stale,
+               st.latency_p50_us, st.latency_p99_us, st.latency_max_us, (unsigned long long)n->lost_samples);
+        expected_late += n->late;
+        stale += st.stale;
+        // Las que siguen en la línea al acabar no han llegado
+        uint32_t pending_on_time = 0;
+        for (int k = 0; k < g_arrival_count; k++) {
+            if (g_arrivals[k].node == i && !g_arrivals[k].late) pending_on_time++;
+        }
+        if (st.responses != n->on_time - pending_on_time) {
+            printf("  FALLO nodo %u: %u respuestas aceptadas, %u a tiempo\n", st.address, st.responses,
+                   n->on_time - pending_on_time);
+            ok = false;
+        }
+    }
+    for (int k = 0; k < g_arrival_count; k++) {
+        if (g_arrivals[k].late) expected_late--;
+    }
+    // Carga de datos de los nodos vivos (2 bytes por muestra, 10 bits por byte),
+    // sin el tercio en que el nodo caído no produce respuestas
+    double payload_bps = 0.0;
+    for (int i = 0; i < NODES; i++) {
+        double share = g_nodes[i].goes_down ? 2.0 / 3.0 : 1.0;
+        payload_bps += share * __builtin_popcount(g_nodes[i].mask) * g_nodes[i].rate_hz * 2 * 10;
+    }
+    uint32_t payload_permille = (uint32_t)(payload_bps * 1000 / BAUD);
+    uint32_t utilisation = BusSched_utilisation_permille(&bus, now);
+    printf("  ocupación del bus %u ‰ (datos %u ‰), %d en vuelo, tardías descartadas %u (esperadas %u), "
+           "saltos de secuencia %u\n", utilisation, payload_permille, in_flight, stale, expected_late,
+           dec.stats.seq_gap_events);
+
+    BusSched_node_stats_t fast, slow, late, down;
+    BusSched_get_node_stats(&bus, 0, &fast);
+    BusSched_get_node_stats(&bus, 3, &slow);
+    BusSched_get_node_stats(&bus, 4, &late);
+    BusSched_get_node_stats(&bus, 5, &down);
+    if (stale != expected_late || late.stale == 0) {
+        printf("  FALLO: respuestas tardías descartadas %u, esperadas %u\n", stale, expected_late);
+        ok = false;
+    }
+    if (fast.period_us >= PERIOD_US || slow.period_us <= PERIOD_US) {
+        printf("  FALLO: el periodo no se adapta (rápido %u us, lento %u us)\n", fast.period_us, slow.period_us);
+        ok = false;
+    }
+    // Todo lo que producen los nodos vivos cruza la línea, y solo el rápido
+    // puede perder algo (hasta un 1 ‰) cuando los sondeos en vuelo esperan al caído
+    if (utilisation < payload_permille || utilisation > 1000) {
+        printf("  FALLO: ocupación del bus %u ‰ con %u ‰ de datos\n", utilisation, payload_permille);
+        ok = false;
+    }
+    for (int i = 0; i < NODES; i++) {
+        const sim_node_t *n = &g_nodes[i];
+        uint64_t limit = (i == 0) ? (uint64_t)(n->rate_hz * seconds / 1000) : 0;
+        if (!n->goes_down && n->lost_samples > limit) {
+            printf("  FALLO: nodo %d pierde %llu muestras por canal (límite %llu)\n", i + 1,
+                   (unsigned long long)n->lost_samples, (unsigned long long)limit);
+            ok = false;
+        }
+    }
+    if (down.failures == 0 || down.responses == 0) {
+        printf("  FALLO: el nodo caído no acumula fallos o no se recupera\n");
+        ok = false;
+    }
+    printf(ok ? "OK\n" : "FALLO\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,457 @@
+// Exactitud y latencia en el PC del motor int8 de CNN1D_AIoT.
+//
+// Construye una red 1D con pesos aleatorios (CONV1D, MAXPOOL1D, DWCONV1D,
+// AVGPOOL1D y DENSE), la ejecuta en float como referencia y la cuantiza como
+// lo haría el conversor: pesos int8 simétricos por canal de salida, sesgos
+// int32, activaciones int8 afines por tensor calibradas con ventanas de
+// ejemplo y recuantización Q31 + desplazamiento.
+//   - Exactitud: sobre ventanas distintas de las de calibración, compara la
+//     salida de CNN1D_run (descuantizada) con la float: error máximo y RMS en
+//     escalas de salida y coincidencia de la clase ganadora (argmax).
+//   - Ventana por nodo: bloques de dos nodos intercalados al azar llenan una
+//     ventana de cada nodo (y una que sigue al primero que llega), que deben
+//     dar las mismas entradas que ventanas alimentadas solo con su nodo.
+//   - Latencia: µs por inferencia de CNN1D_run y de la referencia float, y
+//     millones de MAC por segundo.
+//
+// Termina con código 1 si el error supera los límites.
+
+#include "CNN1D_AIoT.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#define IN_LEN          128
+#define IN_CH           16
+#define CLASSES         8
+#define CALIB_WINDOWS   256
+#define CALIB_MARGIN    1.25f           // Holgura sobre el rango visto al calibrar
+#define TEST_WINDOWS    256
+
+static uint32_t g_rng = 31;
+static float frand(void) {             // Uniforme en [-1, 1)
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return (float)((g_rng >> 8) & 0xFFFF) / 32768.0f - 1.0f;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// -----------------------------------------------------------------------------
+// Red en float (misma disposición de pesos que CNN1D_layer_t)
+// -----------------------------------------------------------------------------
+
+struct FloatLayer {
+    CNN1D_layer_type_t type;
+    uint16_t kernel, stride, out_channels;
+    bool relu;
+    std::vector<float> w, b;
+};
+
+struct Shape {
+    uint16_t len, ch;
+};
+
+static Shape out_shape(const FloatLayer& ly, Shape in) {
+    switch (ly.type) {
+    case CNN1D_LAYER_CONV1D:
+        return { (uint16_t)((in.len - ly.kernel) / ly.stride + 1), ly.out_channels };
+    case CNN1D_LAYER_DENSE:
+        return { 1, ly.out_channels };
+    default:
+        return { (uint16_t)((in.len - ly.kernel) / ly.stride + 1), in.ch };
+    }
+}
+
+static void float_layer(const FloatLayer& ly, const std::vector<float>& x, Shape in, std::vector<float>& y) {
+    Shape out = out_shape(ly, in);
+    y.assign((size_t)out.len * out.ch, 0.0f);
+    for (uint16_t t = 0; t < out.len; t++) {
+        for (uint16_t o = 0; o < out.ch; o++) {
+            float acc = 0.0f;
+            switch (ly.type) {
+            case CNN1D_LAYER_CONV1D:
+                acc = ly.b[o];
+                for (uint16_t k = 0; k < ly.kernel; k++)
+                    for (uint16_t c = 0; c < in.ch; c++)
+                        acc += x[((size_t)t * ly.stride + k) * in.ch + c] * ly.w[((size_t)o * ly.kernel + k) * in.ch + c];
+                break;
+            case CNN1D_LAYER_DENSE:
+                acc = ly.b[o];
+                for (size_t i = 0; i < (size_t)in.len * in.ch; i++) acc += x[i] * ly.w[(size_t)o * in.len * in.ch + i];
+                break;
+            case CNN1D_LAYER_DWCONV1D:
+                acc = ly.b[o];
+                for (uint16_t k = 0; k < ly.kernel; k++)
+                    acc += x[((size_t)t * ly.stride + k) * in.ch + o] * ly.w[(size_t)k * in.ch + o];
+                break;
+            case CNN1D_LAYER_MAXPOOL1D:
+                acc = -INFINITY;
+                for (uint16_t k = 0; k < ly.kernel; k++) acc = fmaxf(acc, x[((size_t)t * ly.stride + k) * in.ch + o]);
+                break;
+            case CNN1D_LAYER_AVGPOOL1D:
+                for (uint16_t k = 0; k < ly.kernel; k++) acc += x[((size_t)t * ly.stride + k) * in.ch + o];
+                acc /= ly.kernel;
+                break;
+            }
+            if (ly.relu && acc < 0.0f) acc = 0.0f;
+            y[(size_t)t * out.ch + o] = acc;
+        }
+    }
+}
+
+static uint64_t layer_macs(const FloatLayer& ly, Shape in) {
+    Shape out = out_shape(ly, in);
+    switch (ly.type) {
+    case CNN1D_LAYER_CONV1D: return (uint64_t)out.len * out.ch * ly.kernel * in.ch;
+    case CNN1D_LAYER_DENSE: return (uint64_t)out.ch * in.len * in.ch;
+    case CNN1D_LAYER_DWCONV1D: return (uint64_t)out.len * out.ch * ly.kernel;
+    default: return 0;
+    }
+}
+
+static void make_layer(std::vector<FloatLayer>& net, CNN1D_layer_type_t type, uint16_t kernel, uint16_t stride,
+                       uint16_t out_ch, bool relu, Shape in) {
+    FloatLayer ly = { type, kernel, stride, out_ch, relu, {}, {} };
+    size_t fan_in = 0, nw = 0;
+    switch (type) {
+    case CNN1D_LAYER_CONV1D: fan_in = (size_t)kernel * in.ch; nw = out_ch * fan_in; break;
+    case CNN1D_LAYER_DENSE: fan_in = (size_t)in.len * in.ch; nw = out_ch * fan_in; break;
+    case CNN1D_LAYER_DWCONV1D: fan_in = kernel; nw = (size_t)kernel * in.ch; ly.out_channels = in.ch; break;
+    default: break;
+    }
+    // Inicialización tipo He: la varianza de las activaciones se mantiene entre capas
+    float gain = fan_in ? sqrtf(3.0f * 2.0f / (float)fan_in) : 0.0f;
+    for (size_t i = 0; i < nw; i++) ly.w.push_back(frand() * gain);
+    if (fan_in) {
+        uint16_t nb = (type == CNN1D_LAYER_DWCONV1D) ? in.ch : out_ch;
+        for (uint16_t i = 0; i < nb; i++) ly.b.push_back(frand() * 0.1f);
+    }
+    net.push_back(ly);
+}
+
+static void float_run(const std::vector<FloatLayer>& net, const std::vector<float>& input,
+                      std::vector<std::vector<float>>& acts) {
+    acts.resize(net.size() + 1);
+    acts[0] = input;
+    Shape s = { IN_LEN, IN_CH };
+    for (size_t i = 0; i < net.size(); i++) {
+        float_layer(net[i], acts[i], s, acts[i + 1]);
+        s = out_shape(net[i], s);
+    }
+}
+
+// Ventana de entrada: senoides por canal con ruido (como presiones normalizadas)
+static void make_window(std::vector<float>& x) {
+    x.resize((size_t)IN_LEN * IN_CH);
+    float f[IN_CH], ph[IN_CH], amp[IN_CH];
+    for (int c = 0; c < IN_CH; c++) {
+        f[c] = 0.02f + 0.2f * (frand() + 1.0f);
+        ph[c] = 3.14159f * frand();
+        amp[c] = 0.3f + 0.3f * (frand() + 1.0f);
+    }
+    for (int t = 0; t < IN_LEN; t++)
+        for (int c = 0; c < IN_CH; c++) x[(size_t)t * IN_CH + c] = amp[c] * sinf(f[c] * t + ph[c]) + 0.1f * frand();
+}
+
+// -----------------------------------------------------------------------------
+// Cuantización
+// -----------------------------------------------------------------------------
+
+struct QParams {
+    float scale;
+    int8_t zp;
+};
+
+static QParams affine(float lo, float hi) {
+    if (lo > 0.0f) lo = 0.0f;
+    if (hi < 0.0f) hi = 0.0f;
+    float scale = (hi - lo) / 255.0f;
+    if (scale <= 0.0f) scale = 1e-6f;
+    long zp = lrintf(-128.0f - lo / scale);
+    if (zp < -128) zp = -128;
+    if (zp > 127) zp = 127;
+    return { scale, (int8_t)zp };
+}
+
+static CNN1D_requant_t requant_of(double real) {
+    int exp;
+    double mant = frexp(real, &exp);            // real = mant * 2^exp, mant en [0.5, 1)
+    int64_t m = llround(mant * 2147483648.0);
+    if (m == 2147483648ll) {
+        m /= 2;
+        exp++;
+    }
+    return { (int32_t)m, (int8_t)exp };
+}
+
+static int8_t quantize(float v, QParams q) {
+    long r = lrintf(v / q.scale) + q.zp;
+    return (int8_t)(r < -128 ? -128 : (r > 127 ? 127 : r));
+}
+
+struct QuantModel {
+    std::vector<CNN1D_layer_t> layers;
+    std::vector<std::vector<int8_t>> w;
+    std::vector<std::vector<int32_t>> b;
+    std::vector<std::vector<CNN1D_requant_t>> rq;
+    CNN1D_model_t model;
+};
+
+static void quantize_net(const std::vector<FloatLayer>& net, const std::vector<QParams>& act, QuantModel& qm) {
+    size_t n = net.size();
+    qm.layers.resize(n);
+    qm.w.resize(n);
+    qm.b.resize(n);
+    qm.rq.resize(n);
+    Shape s = { IN_LEN, IN_CH };
+    for (size_t i = 0; i < n; i++) {
+        const FloatLayer& ly = net[i];
+        CNN1D_layer_t& q = qm.layers[i];
+        memset(&q, 0, sizeof(q));
+        q.type = ly.type;
+        q.kernel = ly.kernel;
+        q.stride = ly.stride;
+        q.out_channels = ly.out_channels;
+        q.relu = ly.relu;
+        q.out_scale = act[i + 1].scale;
+        q.out_zero_point = act[i + 1].zp;
+
+        if (!ly.w.empty()) {
+            bool dw = ly.type == CNN1D_LAYER_DWCONV1D;
+            uint16_t outs = dw ? s.ch : ly.out_channels;
+            size_t per = ly.w.size() / outs;
+            qm.w[i].resize(ly.w.size());
+            for (uint16_t o = 0; o < outs; o++) {
+                // Pesos del canal de salida o: contiguos en CONV1D/DENSE, con salto 'ch' en DWCONV1D
+                auto idx = [&](size_t j) { return dw ? j * s.ch + o : (size_t)o * per + j; };
+                float maxabs = 0.0f;
+                for (size_t j = 0; j < per; j++) maxabs = fmaxf(maxabs, fabsf(ly.w[idx(j)]));
+                float ws = maxabs > 0.0f ? maxabs / 127.0f : 1.0f;
+                for (size_t j = 0; j < per; j++) qm.w[i][idx(j)] = (int8_t)lrintf(ly.w[idx(j)] / ws);
+                double acc_scale = (double)act[i].scale * ws;
+                qm.b[i].push_back((int32_t)llround(ly.b[o] / acc_scale));
+                qm.rq[i].push_back(requant_of(acc_scale / act[i + 1].scale));
+            }
+            q.weights = qm.w[i].data();
+            q.bias = qm.b[i].data();
+            q.requant = qm.rq[i].data();
+        }
+        s = out_shape(ly, s);
+    }
+    qm.model.input_length = IN_LEN;
+    qm.model.input_channels = IN_CH;
+    qm.model.input_scale = act[0].scale;
+    qm.model.input_zero_point = act[0].zp;
+    qm.model.layer_count = (uint8_t)n;
+    qm.model.layers = qm.layers.data();
+}
+
+// -----------------------------------------------------------------------------
+// Ventana con dos nodos intercalados
+// -----------------------------------------------------------------------------
+
+#define NODE_A          3
+#define NODE_B          7
+#define NODE_BLOCKS     40
+#define WINDOW_HOP      32
+
+// Bloque k de un nodo: rampas distintas por nodo y canal
+static void make_block(SampleRing_block_t& b, uint8_t node, uint32_t k) {
+    memset(&b, 0, sizeof(b));
+    b.node = node;
+    b.seq = k;
+    b.channel_mask = 0xFFFF;
+    b.count = (uint8_t)(16 + (k * 13) % (SRING_BLOCK_SAMPLES - 15));
+    for (int c = 0; c < SRING_CHANNELS; c++)
+        for (int i = 0; i < b.count; i++) {
+            int32_t v = (node == NODE_A ? 1 : -1) * (int32_t)((k * SRING_BLOCK_SAMPLES + i) * 5 % 4000) + c * 500;
+            b.data[c][i] = (int16_t)v;
+        }
+}
+
+// Ventanas listas al alimentar 'w' con los bloques, como la tarea de inferencia
+static std::vector<std::vector<int8_t>> feed(CNN1D_window_t& w, const std::vector<SampleRing_block_t>& blocks) {
+    std::vector<std::vector<int8_t>> out;
+    size_t bytes = (size_t)w.length * w.channels;
+    for (const SampleRing_block_t& b : blocks) {
+        size_t i = 0;
+        while (i < b.count) {
+            i = CNN1D_window_push(&w, &b, i);
+            const int8_t* input = CNN1D_window_take(&w);
+            if (input) out.emplace_back(input, input + bytes);
+        }
+    }
+    return out;
+}
+
+static bool check_window_nodes(const CNN1D_model_t* model) {
+    std::vector<SampleRing_block_t> only_a(NODE_BLOCKS), only_b(NODE_BLOCKS), mixed;
+    for (uint32_t k = 0; k < NODE_BLOCKS; k++) {
+        make_block(only_a[k], NODE_A, k);
+        make_block(only_b[k], NODE_B, k);
+    }
+    // Intercalado al azar, empezando por NODE_B
+    size_t ia = 0, ib = 1;
+    mixed.push_back(only_b[0]);
+    while (ia < NODE_BLOCKS || ib < NODE_BLOCKS) {
+        bool take_a = ib == NODE_BLOCKS || (ia < NODE_BLOCKS && frand() < 0.0f);
+        mixed.push_back(take_a ? only_a[ia++] : only_b[ib++]);
+    }
+
+    struct Case {
+        const char* name;
+        uint8_t node;
+        const std::vector<SampleRing_block_t>* ref;
+    } cases[] = {
+        { "nodo A", NODE_A, &only_a },
+        { "nodo B", NODE_B, &only_b },
+        { "cualquiera", CNN1D_NODE_ANY, &only_b },      // El primer bloque es de NODE_B
+    };
+    static int8_t store_mixed[2 * IN_LEN * IN_CH], store_ref[2 * IN_LEN * IN_CH];
+    bool ok = true;
+    for (const Case& c : cases) {
+        CNN1D_window_t wm, wr;
+        if (!CNN1D_window_init(&wm, store_mixed, WINDOW_HOP, 0xFFFF, c.node, 1.0f / 4096.0f, model) ||
+            !CNN1D_window_init(&wr, store_ref, WINDOW_HOP, 0xFFFF, c.node, 1.0f / 4096.0f, model)) {
+            printf("  FALLO: CNN1D_window_init rechaza la ventana\n");
+            return false;
+        }
+        std::vector<std::vector<int8_t>> got = feed(wm, mixed), want = feed(wr, *c.ref);
+        bool same = !want.empty() && got == want;
+        printf("  ventana %-10s: %zu bloques intercalados, %zu ventanas (%zu esperadas), %s\n", c.name,
+               mixed.size(), got.size(), want.size(), same ? "iguales" : "distintas");
+        if (!same) {
+            printf("  FALLO: ventana %s: mezcla bloques de otro nodo\n", c.name);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    double seconds = 0.5;
+    bool do_bench = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--check-only")) do_bench = false;
+        else {
+            printf("Uso: %s [--seconds S] [--check-only]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Red: 128x16 -> conv5 32 -> max2 -> dw3 -> conv3 32 -> avg2 -> dense 8
+    std::vector<FloatLayer> net;
+    Shape s = { IN_LEN, IN_CH };
+    make_layer(net, CNN1D_LAYER_CONV1D, 5, 1, 32, true, s);     s = out_shape(net.back(), s);
+    make_layer(net, CNN1D_LAYER_MAXPOOL1D, 2, 2, 0, false, s);  s = out_shape(net.back(), s);
+    make_layer(net, CNN1D_LAYER_DWCONV1D, 3, 1, 0, true, s);    s = out_shape(net.back(), s);
+    make_layer(net, CNN1D_LAYER_CONV1D, 3, 1, 32, true, s);     s = out_shape(net.back(), s);
+    make_layer(net, CNN1D_LAYER_AVGPOOL1D, 2, 2, 0, false, s);  s = out_shape(net.back(), s);
+    make_layer(net, CNN1D_LAYER_DENSE, 0, 0, CLASSES, false, s);
+
+    uint64_t macs = 0;
+    s = { IN_LEN, IN_CH };
+    for (const FloatLayer& ly : net) {
+        macs += layer_macs(ly, s);
+        s = out_shape(ly, s);
+    }
+
+    // Calibración: rango de cada tensor sobre ventanas de ejemplo
+    std::vector<float> lo(net.size() + 1, 0.0f), hi(net.size() + 1, 0.0f);
+    std::vector<float> x;
+    std::vector<std::vector<float>> acts;
+    for (int w = 0; w < CALIB_WINDOWS; w++) {
+        make_window(x);
+        float_run(net, x, acts);
+        for (size_t i = 0; i < acts.size(); i++)
+            for (float v : acts[i]) {
+                lo[i] = fminf(lo[i], v);
+                hi[i] = fmaxf(hi[i], v);
+            }
+    }
+    std::vector<QParams> act(net.size() + 1);
+    for (size_t i = 0; i <= net.size(); i++) act[i] = affine(lo[i] * CALIB_MARGIN, hi[i] * CALIB_MARGIN);
+    // El pooling no recuantiza: su salida conserva la cuantización de la entrada
+    for (size_t i = 0; i < net.size(); i++) {
+        if (net[i].type == CNN1D_LAYER_MAXPOOL1D || net[i].type == CNN1D_LAYER_AVGPOOL1D) act[i + 1] = act[i];
+    }
+
+    QuantModel qm;
+    quantize_net(net, act, qm);
+    CNN1D_plan_t plan;
+    if (!CNN1D_plan(&qm.model, &plan)) {
+        printf("FALLO: CNN1D_plan rechaza el modelo\n");
+        return 1;
+    }
+    std::vector<int8_t> arena(plan.arena_size);
+    std::vector<int8_t> qin((size_t)IN_LEN * IN_CH);
+    float out_scale = act[net.size()].scale;
+
+    printf("Red %ux%u -> %u clases, %zu capas, %.2f M MAC, arena %zu bytes\n", IN_LEN, IN_CH, CLASSES,
+           net.size(), macs / 1e6, plan.arena_size);
+
+    // Exactitud sobre ventanas nuevas
+    double err_max = 0.0, err_sq = 0.0;
+    unsigned agree = 0;
+    for (int w = 0; w < TEST_WINDOWS; w++) {
+        make_window(x);
+        float_run(net, x, acts);
+        for (size_t i = 0; i < x.size(); i++) qin[i] = quantize(x[i], act[0]);
+        const int8_t* y = CNN1D_run(&qm.model, &plan, arena.data(), arena.size(), qin.data());
+        if (!y) {
+            printf("FALLO: CNN1D_run devolvió NULL\n");
+            return 1;
+        }
+        const std::vector<float>& ref = acts.back();
+        int best_q = 0, best_f = 0;
+        for (int c = 0; c < CLASSES; c++) {
+            double e = fabs((double)CNN1D_dequantize(&qm.model, y[c]) - ref[c]) / out_scale;
+            if (e > err_max) err_max = e;
+            err_sq += e * e;
+            if (y[c] > y[best_q]) best_q = c;
+            if (ref[c] > ref[best_f]) best_f = c;
+        }
+        if (best_q == best_f) agree++;
+    }
+    double err_rms = sqrt(err_sq / (TEST_WINDOWS * CLASSES));
+    printf("  int8 frente a float (%d ventanas): error máx %.2f y RMS %.2f escalas de salida, argmax igual %.1f %%\n",
+           TEST_WINDOWS, err_max, err_rms, 100.0 * agree / TEST_WINDOWS);
+
+    bool windows_ok = check_window_nodes(&qm.model);
+
+    if (do_bench) {
+        double t0 = now_s(), dt;
+        unsigned runs = 0;
+        do {
+            for (int k = 0; k < 16; k++) CNN1D_run(&qm.model, &plan, arena.data(), arena.size(), qin.data());
+            runs += 16;
+            dt = now_s() - t0;
+        } while (dt < seconds);
+        double q_us = dt * 1e6 / runs;
+
+        t0 = now_s();
+        unsigned fruns = 0;
+        do {
+            float_run(net, x, acts);
+            fruns++;
+            dt = now_s() - t0;
+        } while (dt < seconds);
+        double f_us = dt * 1e6 / fruns;
+        printf("  latencia: int8 %.1f us (%.0f M MAC/s), float de referencia %.1f us\n", q_us, macs / q_us, f_us);
+    }
+
+    // Límites: cada capa redondea media escala; el error acumulado debe ser de pocas escalas
+    bool ok = err_max <= 4.0 && err_rms <= 1.0 && agree >= TEST_WINDOWS * 95 / 100;
+    if (!ok) printf("FALLO: error de cuantización fuera de límites\n");
+    ok &= windows_ok;
+    printf(ok ? "OK\n" : "FALLO\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+// Comprobación y rendimiento en el PC de Draw_Accel_AIoT.
+//
+// La referencia reproduce el camino C de LVGL 9 para RGB565
+// (lv_draw_sw_blend_to_rgb565.c): lv_color_16_16_mix tal cual, LV_OPA_MIX2
+// para máscara con opacidad y opacidades >= LV_OPA_MAX tratadas como
+// opacas, igual que Draw_Accel_AIoT_lvgl.h.
+//   - Comprobación: rellenos y mezclas de imagen opacos, con opacidad, con
+//     máscara y con máscara y opacidad, con anchos de 1 a 37 píxeles, destino
+//     y origen alineados o no a 4 bytes, máscara en los 4 desplazamientos,
+//     strides con relleno y máscaras con tramos de 4 bytes vacíos, llenos y
+//     mezclados. El resultado debe ser idéntico píxel a píxel y los bytes
+//     fuera del rectángulo (relleno del stride y guardas) no deben cambiar.
+//   - Rendimiento: Mpíxeles/s de núcleo y referencia en un área de 320x40
+//     con una máscara de texto (tramos vacíos y llenos) y sin máscara.
+//
+// Termina con código 1 ante cualquier diferencia.
+
+#define _POSIX_C_SOURCE 200809L
+#include "Draw_Accel_AIoT.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LV_OPA_MAX      253
+#define MAX_W           40
+#define MAX_H           6
+#define PAD             8               // Bytes de relleno máximos por fila
+#define GUARD           16
+#define GUARD_BYTE      0xA5
+
+static uint32_t g_rng = 3;
+static uint32_t rnd(uint32_t n) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return (g_rng >> 8) % n;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// -----------------------------------------------------------------------------
+// Referencia (LVGL 9, lv_color.h y lv_draw_sw_blend_to_rgb565.c)
+// -----------------------------------------------------------------------------
+
+static uint16_t lv_color_16_16_mix(uint16_t c1, uint16_t c2, uint8_t mix) {
+    if (mix == 255) return c1;
+    if (mix == 0) return c2;
+    if (c1 == c2) return c1;
+
+    mix = (uint8_t)(((uint32_t)mix + 4) >> 3);
+    uint32_t bg = (uint32_t)(c2 | ((uint32_t)c2 << 16)) & 0x7E0F81F;
+    uint32_t fg = (uint32_t)(c1 | ((uint32_t)c1 << 16)) & 0x7E0F81F;
+    uint32_t result = ((((fg - bg) * mix) >> 5) + bg) & 0x7E0F81F;
+    return (uint16_t)((result >> 16) | result);
+}
+
+#define LV_OPA_MIX2(a1, a2) (((int32_t)(a1) * (a2)) >> 8)
+
+static void ref_fill(uint8_t *dst, int32_t w, int32_t h, int32_t dst_stride, uint16_t color, uint8_t opa,
+                     const uint8_t *mask, int32_t mask_stride) {
+    for (int32_t y = 0; y < h; y++, dst += dst_stride) {
+        uint16_t *d = (uint16_t *)dst;
+        for (int32_t x = 0; x < w; x++) {
+            if (!mask) d[x] = opa >= LV_OPA_MAX ? color : lv_color_16_16_mix(color, d[x], opa);
+            else if (opa >= LV_OPA_MAX) d[x] = lv_color_16_16_mix(color, d[x], mask[x]);
+            else d[x] = lv_color_16_16_mix(color, d[x], (uint8_t)LV_OPA_MIX2(mask[x], opa));
+        }
+        if (mask) mask += mask_stride;
+    }
+}
+
+static void ref_blit(uint8_t *dst, int32_t dst_stride, const uint8_t *src, int32_t src_stride, int32_t w,
+                     int32_t h, uint8_t opa, const uint8_t *mask, int32_t mask_stride) {
+    for (int32_t y = 0; y < h; y++, dst += dst_stride, src += src_stride) {
+        uint16_t *d = (uint16_t *)dst;
+        const uint16_t *s = (const uint16_t *)src;
+        for (int32_t x = 0; x < w; x++) {
+            if (!mask) d[x] = opa >= LV_OPA_MAX ? s[x] : lv_color_16_16_mix(s[x], d[x], opa);
+            else if (opa >= LV_OPA_MAX) d[x] = lv_color_16_16_mix(s[x], d[x], mask[x]);
+            else d[x] = lv_color_16_16_mix(s[x], d[x], (uint8_t)LV_OPA_MIX2(mask[x], opa));
+        }
+        if (mask) mask += mask_stride;
+    }
+}
+
+// Como Draw_Accel_AIoT_lvgl.h
+static uint8_t hook_opa(uint8_t opa) {
+    return opa >= LV_OPA_MAX ? 255 : opa;
+}
+
+// -----------------------------------------------------------------------------
+// Comprobación
+// -----------------------------------------------------------------------------
+
+#define BUF_SIZE    (GUARD + MAX_H * (MAX_W * 2 + PAD) + 4 + GUARD)
+
+// Alineados a 4 bytes: los desplazamientos de cada caso fijan la alineación
+typedef struct {
+    _Alignas(4) uint8_t ref[BUF_SIZE];
+    _Alignas(4) uint8_t out[BUF_SIZE];
+    _Alignas(4) uint8_t src[BUF_SIZE];
+    _Alignas(4) uint8_t mask[BUF_SIZE];
+} case_bufs_t;
+
+static uint16_t color(void) {
+    static const uint16_t fixed[] = { 0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F, 0x8410 };
+    return rnd(3) ? (uint16_t)rnd(0x10000) : fixed[rnd(6)];
+}
+
+static uint8_t opacity(void) {
+    static const uint8_t fixed[] = { 0, 1, 2, 7, 8, 127, 128, 252, 253, 254, 255 };
+    return rnd(3) ? fixed[rnd(11)] : (uint8_t)rnd(256);
+}
+
+// Máscara por bloques de 4 bytes: vacíos, llenos o valores sueltos
+static void fill_mask(uint8_t *m, size_t n) {
+    for (size_t i = 0; i < n; i += 4) {
+        uint32_t kind = rnd(4);
+        for (size_t k = i; k < i + 4 && k < n; k++) {
+            m[k] = kind == 0 ? 0 : kind == 1 ? 255 : (rnd(4) == 0 ? (uint8_t)(rnd(2) * 255) : (uint8_t)rnd(256));
+        }
+    }
+}
+
+static bool check(uint32_t cases) {
+    static case_bufs_t b;
+    uint32_t diffs = 0, guards = 0, counts[2][4] = { { 0 } };
+    for (uint32_t c = 0; c < cases; c++) {
+        bool blit = rnd(2);
+        int32_t w = 1 + (int32_t)rnd(37), h = 1 + (int32_t)rnd(MAX_H);
+        int32_t dst_off = GUARD + 2 * (int32_t)rnd(2);          // Alineado o no a 4 bytes
+        int32_t src_off = GUARD + 2 * (int32_t)rnd(2);
+        int32_t mask_off = GUARD + (int32_t)rnd(4);
+        int32_t dst_stride = w * 2 + 2 * (int32_t)rnd(PAD / 2 + 1);
+        int32_t src_stride = w * 2 + 2 * (int32_t)rnd(PAD / 2 + 1);
+        int32_t mask_stride = w + (int32_t)rnd(PAD + 1);
+        uint8_t opa = opacity();
+        bool masked = rnd(2);
+
+        // Fondo con colores repetidos (la caché de la mezcla con opacidad) y guardas
+        memset(b.ref, GUARD_BYTE, sizeof(b.ref));
+        uint16_t bg[4] = { color(), color(), color(), color() };
+        for (int32_t y = 0; y < h; y++) {
+            uint16_t *d = (uint16_t *)(b.ref + dst_off + y * dst_stride);
+            for (int32_t x = 0; x < w; x++) d[x] = bg[rnd(3) ? 0 : rnd(4)];
+        }
+        memcpy(b.out, b.ref, sizeof(b.out));
+        for (size_t i = 0; i < sizeof(b.src); i += 2) {
+            uint16_t v = rnd(4) ? bg[rnd(4)] : color();        // A veces igual al fondo (c1 == c2)
+            memcpy(b.src + i, &v, 2);
+        }
+        fill_mask(b.mask + mask_off, sizeof(b.mask) - (size_t)mask_off);
+        const uint8_t *mask = masked ? b.mask + mask_off : NULL;
+
+        if (blit) {
+            ref_blit(b.ref + dst_off, dst_stride, b.src + src_off, src_stride, w, h, opa, mask, mask_stride);
+            Draw_Accel_blit_rgb565(b.out + dst_off, dst_stride, b.src + src_off, src_stride, w, h, hook_opa(opa),
+                                   mask, mask_stride);
+        } else {
+            uint16_t col = rnd(4) ? color() : bg[0];
+            ref_fill(b.ref + dst_off, w, h, dst_stride, col, opa, mask, mask_stride);
+            Draw_Accel_fill_rgb565(b.out + dst_off, w, h, dst_stride, col, hook_opa(opa), mask, mask_stride);
+        }
+        counts[blit][(masked ? 2 : 0) + (opa < LV_OPA_MAX)]++;
+
+        // Bytes fuera del rectángulo: la referencia no los toca
+        bool outside = false, inside = false;
+        for (int32_t i = 0; i < (int32_t)sizeof(b.ref); i++) {
+            if (b.ref[i] == b.out[i]) continue;
+            int32_t rel = i - dst_off;
+            bool in_rect = rel >= 0 && rel / dst_stride < h && rel % dst_stride < w * 2;
+            if (in_rect) inside = true;
+            else outside = true;
+        }
+        if (inside && diffs++ < 5) {
+            printf("  FALLO: %s %dx%d, opa %u, %s, destino +%d, máscara +%d: píxeles distintos\n",
+                   blit ? "imagen" : "relleno", w, h, opa, masked ? "con máscara" : "sin máscara",
+                   (dst_off - GUARD) % 4, (mask_off - GUARD) % 4);
+        }
+        if (outside && guards++ < 5) {
+            printf("  FALLO: %s %dx%d, stride %d: escribe fuera del rectángulo\n", blit ? "imagen" : "relleno", w,
+                   h, dst_stride);
+        }
+    }
+    static const char *const names[] = { "opaco", "opacidad", "máscara", "máscara y opacidad" };
+    for (int k = 0; k < 2; k++) {
+        printf("  %-8s", k ? "imagen" : "relleno");
+        for (int m = 0; m < 4; m++) printf("  %s %u", names[m], counts[k][m]);
+        printf("\n");
+    }
+    printf("  %u casos: %u con píxeles distintos, %u con escrituras fuera\n", cases, diffs, guards);
+    return diffs == 0 && guards == 0;
+}
+
+// -----------------------------------------------------------------------------
+// Rendimiento
+// -----------------------------------------------------------------------------
+
+#define BENCH_W     320
+#define BENCH_H     40
+
+typedef void (*blend_fn)(uint8_t *dst, const uint8_t *src, const uint8_t *mask, uint8_t opa);
+
+static void k_fill(uint8_t *dst, const uint8_t *src, const uint8_t *mask, uint8_t opa) {
+    (void)src;
+    Draw_Accel_fill_rgb565(dst, BENCH_W, BENCH_H, BENCH_W * 2, 0x39E7, hook_opa(opa), mask, BENCH_W);
+}
+static void r_fill(uint8_t *dst, const uint8_t *src, const uint8_t *mask, uint8_t opa) {
+    (void)src;
+    ref_fill(dst, BENCH_W, BENCH_H, BENCH_W * 2, 0x39E7, opa, mask, BENCH_W);
+}
+static void k_blit(uint8_t *dst, const uint8_t *src, const uint8_t *mask, uint8_t opa) {
+    Draw_Accel_blit_rgb565(dst, BENCH_W * 2, src, BENCH_W * 2, BENCH_W, BENCH_H, hook_opa(opa), mask, BENCH_W);
+}
+static void r_blit(uint8_t *dst, const uint8_t *src, const uint8_t *mask, uint8_t opa) {
+    ref_blit(dst, BENCH_W * 2, src, BENCH_W * 2, BENCH_W, BENCH_H, opa, mask, BENCH_W);
+}
+
+static double mpix(blend_fn fn, uint8_t *dst, const uint8_t *src, const uint8_t *mask, uint8_t opa,
+                   double seconds) {
+    uint32_t n = 0;
+    double t0 = now_s(), t;
+    do {
+        for (int k = 0; k < 16; k++) fn(dst, src, mask, opa);
+        n += 16;
+        t = now_s() - t0;
+    } while (t < seconds);
+    return (double)n * BENCH_W * BENCH_H / t / 1e6;
+}
+
+static void bench(double seconds) {
+    static uint16_t dst[BENCH_W * BENCH_H], src[BENCH_W * BENCH_H];
+    static uint8_t text[BENCH_W * BENCH_H];
+    for (int i = 0; i < BENCH_W * BENCH_H; i++) {
+        dst[i] = (uint16_t)(0x1082 * (i / 97 % 3));
+        src[i] = (uint16_t)rnd(0x10000);
+    }
+    // Texto: glifos de 8 columnas con bordes suavizados separados por huecos
+    for (int y = 0; y < BENCH_H; y++) {
+        for (int x = 0; x < BENCH_W; x++) {
+            int gx = x % 12, gy = y % 20;
+            text[y * BENCH_W + x] = gx >= 8 || gy >= 16 ? 0 : (gx == 0 || gx == 7 || gy == 0) ? 96 : 255;
+        }
+    }
+    static const struct {
+        const char *name;
+        blend_fn kernel, ref;
+        bool masked;
+        uint8_t opa;
+    } cases[] = {
+        { "relleno opaco", k_fill, r_fill, false, 255 },
+        { "relleno opacidad 50 %", k_fill, r_fill, false, 128 },
+        { "relleno texto", k_fill, r_fill, true, 255 },
+        { "imagen opaca", k_blit, r_blit, false, 255 },
+        { "imagen opacidad 50 %", k_blit, r_blit, false, 128 },
+        { "imagen con máscara", k_blit, r_blit, true, 255 },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const uint8_t *mask = cases[i].masked ? text : NULL;
+        double k = mpix(cases[i].kernel, (uint8_t *)dst, (const uint8_t *)src, mask, cases[i].opa, seconds / 12);
+        double r = mpix(cases[i].ref, (uint8_t *)dst, (const uint8_t *)src, mask, cases[i].opa, seconds / 12);
+        printf("  %-22s núcleo %7.1f Mpx/s, referencia %7.1f Mpx/s (x%.2f)\n", cases[i].name, k, r, k / r);
+    }
+}
+
+int main(int argc, char **argv) {
+    double seconds = 1.0;
+    bool do_check = true, do_bench = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--no-check")) do_check = false;
+        else if (!strcmp(argv[i], "--check-only")) do_bench = false;
+        else {
+            printf("Uso: %s [--seconds S] [--no-check | --check-only]\n", argv[0]);
+            return 2;
+        }
+    }
+    bool ok = true;
+    if (do_check) {
+        printf("Comprobación (núcleos frente a lv_color_16_16_mix)\n");
+        ok &= check(200000);
+    }
+    if (do_bench) {
+        printf("Rendimiento (%dx%d RGB565)\n", BENCH_W, BENCH_H);
+        bench(seconds);
+    }
+    if (do_check) printf(ok ? "OK\n" : "FALLO\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,362 @@
+// Evaluador de expresiones de EEZ flow en el PC: intérprete frente a código
+// enhebrado (components/EEZ_AIoT/src/eez_flow_eval.inc).
+//
+// Compila eez-flow.cpp como en el equipo (con el parche de eez_flow_patch.cmake)
+// pero con EEZ_FLOW_EVAL_THREADED=1 y un lvgl.h mínimo (stubs/no_lvgl), y
+// carga los assets de ui.c (copiados al configurar, ver CMakeLists.txt).
+//   - Comprobación: cada propiedad de cada flujo de ui.c se evalúa por los
+//     dos caminos con las variables nativas cambiando en cada ronda; y
+//     programas sintéticos con las operaciones que tienen camino rápido
+//     (ADD/SUB/MUL/DIV, comparaciones, AND/OR/NOT, más y menos unarios y ?:)
+//     se evalúan con operandos de todos los tipos (int32, bool, float con
+//     unidades, double, int64, cadenas, undefined, null, error, punteros a
+//     valor y variables nativas). Resultado, tipo y bytes consumidos deben
+//     coincidir.
+//   - Rendimiento: ns por evaluación de las propiedades de ui.c (todas, las
+//     vacías o de un solo push y las demás) y evaluaciones/s de una
+//     expresión aritmética sintética, por los dos caminos.
+//
+// Termina con código 1 ante cualquier diferencia.
+
+#include "eez-flow.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+using namespace eez;
+using namespace eez::flow;
+
+// components/EEZ_AIoT/src/eez_flow_eval.inc (EEZ_FLOW_EVAL_BENCH)
+namespace eez {
+namespace flow {
+extern bool g_evalThreaded;
+void getEvalInfo(uint32_t &programs, uint32_t &ops, uint32_t &bytes);
+void evalStartForBench(Assets *assets);
+bool evalExpressionForBench(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result,
+                            int *numInstructionBytes);
+}
+}
+
+extern "C" const uint8_t assets[];
+extern "C" const uint32_t assets_size;
+
+static uint32_t g_rng = 1;
+static uint32_t rnd() {
+    g_rng = g_rng * 1103515245u + 12345u;
+    return g_rng >> 8;
+}
+
+static double now_s() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// -----------------------------------------------------------------------------
+// Variables nativas de ui.c (sustituyen a las de vars.cpp en la tabla copiada)
+// -----------------------------------------------------------------------------
+
+static int32_t g_int = 5;
+static bool g_bool = true;
+
+extern "C" {
+int32_t eval_get_integer(void) { return g_int; }
+void eval_set_integer(int32_t value) { g_int = value; }
+bool eval_get_boolean(void) { return g_bool; }
+void eval_set_boolean(bool value) { g_bool = value; }
+float eval_get_float(void) { return (float)g_int * 0.5f; }
+void eval_set_float(float value) { (void)value; }
+double eval_get_double(void) { return (double)g_int * 0.25; }
+void eval_set_double(double value) { (void)value; }
+// Cambia en cada lectura: los dos caminos la leen con la misma semilla
+const char *eval_get_string(void) { return (rnd() & 1) ? "abc" : ""; }
+void eval_set_string(const char *value) { (void)value; }
+
+// eez-flow.cpp las nombra aunque aquí no se creen pantallas ni widgets
+void create_screens(void) {}
+}
+uint32_t lv_tick_get(void) { return 1234; }
+const lv_obj_class_t lv_btnmatrix_class = { 0 }, lv_buttonmatrix_class = { 0 };
+
+// -----------------------------------------------------------------------------
+// Comprobación
+// -----------------------------------------------------------------------------
+
+static bool same(const Value &a, const Value &b) {
+    if (a.type != b.type) return false;
+    if (a.isString()) return !strcmp(a.getString() ? a.getString() : "", b.getString() ? b.getString() : "");
+    if (a.options & VALUE_OPTIONS_REF) return true;
+    switch (a.type) {
+    case VALUE_TYPE_FLOAT:
+        return a.unit == b.unit && a.options == b.options && !memcmp(&a.floatValue, &b.floatValue, sizeof(float));
+    case VALUE_TYPE_DOUBLE:
+        return !memcmp(&a.doubleValue, &b.doubleValue, sizeof(double));
+    case VALUE_TYPE_INT64:
+    case VALUE_TYPE_UINT64:
+        return a.int64Value == b.int64Value;
+    case VALUE_TYPE_VALUE_PTR:
+        return a.pValueValue == b.pValueValue && a.dstValueType == b.dstValueType;
+    case VALUE_TYPE_INT8:
+    case VALUE_TYPE_UINT8:
+        return a.uint8Value == b.uint8Value;
+    case VALUE_TYPE_INT16:
+    case VALUE_TYPE_UINT16:
+        return a.uint16Value == b.uint16Value;
+    default:
+        return a.int32Value == b.int32Value && a.unit == b.unit;
+    }
+}
+
+struct EvalItem {
+    FlowState *flow_state;
+    int component;
+    const uint8_t *instructions;
+};
+
+static bool is_short(const uint8_t *instructions) {
+    return (instructions[1] >> 5) == 7 || (instructions[3] >> 5) == 7;
+}
+
+// Evalúa por los dos caminos con la misma semilla; true si coinciden
+static bool both_paths(FlowState *fs, int component, const uint8_t *instructions) {
+    Value r1, r2;
+    int n1 = -1, n2 = -1;
+    uint32_t seed = g_rng;
+    g_evalThreaded = false;
+    bool ok1 = evalExpressionForBench(fs, component, instructions, r1, &n1);
+    g_rng = seed;
+    g_evalThreaded = true;
+    bool ok2 = evalExpressionForBench(fs, component, instructions, r2, &n2);
+    return ok1 == ok2 && n1 == n2 && (!ok1 || (same(r1, r2) && same(r1.getValue(), r2.getValue())));
+}
+
+static bool check_assets(const std::vector<EvalItem> &items) {
+    uint32_t evals = 0, diffs = 0;
+    for (int round = 0; round < 200; round++) {
+        g_int = (int32_t)(rnd() % 5) - 2;
+        g_bool = rnd() & 1;
+        for (const EvalItem &it : items) {
+            evals++;
+            if (!both_paths(it.flow_state, it.component, it.instructions) && diffs++ < 5) {
+                printf("  FALLO: componente %d, el código enhebrado no da lo mismo que el intérprete\n", it.component);
+            }
+        }
+    }
+    printf("  ui.c: %zu propiedades x 200 rondas = %u evaluaciones, %u diferencias\n", items.size(), evals, diffs);
+    return diffs == 0;
+}
+
+// Operando aleatorio; los punteros a valor apuntan a 'target'
+static Value operand(uint32_t k, Value *target) {
+    static const float floats[] = { 0.0f, -0.0f, 1.5f, -2.25f, NAN, 3.0f, 1e30f };
+    switch (k % 16) {
+    case 0: return Value((int)(rnd() % 7) - 3, VALUE_TYPE_INT32);
+    case 1: return Value((int)rnd(), VALUE_TYPE_INT32);
+    case 2: return Value((int)(rnd() & 1), VALUE_TYPE_BOOLEAN);
+    case 3: return Value(floats[rnd() % 7], VALUE_TYPE_FLOAT);
+    case 4: return Value(floats[rnd() % 7], (Unit)(rnd() % 3));
+    case 5: return Value((double)(rnd() % 5) - 2.0, VALUE_TYPE_DOUBLE);
+    case 6: return Value((int64_t)(rnd() % 5) - 2, VALUE_TYPE_INT64);
+    case 7: return Value((uint32_t)(rnd() % 5), VALUE_TYPE_UINT32);
+    case 8: return Value((int8_t)(rnd() % 5 - 2), VALUE_TYPE_INT8);
+    case 9: return Value((rnd() & 1) ? "abc" : "2", VALUE_TYPE_STRING);
+    case 10: return Value();
+    case 11: return Value(0, VALUE_TYPE_NULL);
+    case 12: return Value::makeError();
+    case 13:
+        *target = operand(rnd() % 10, nullptr);
+        return Value(target, VALUE_TYPE_VALUE_PTR);
+    case 14: return Value((int)(1 + rnd() % 3), VALUE_TYPE_NATIVE_VARIABLE);
+    default: return Value((int)(rnd() % 3), VALUE_TYPE_INT32);
+    }
+}
+
+typedef std::vector<uint8_t> program_t;
+
+static void put(program_t &p, uint16_t instruction) {
+    p.push_back((uint8_t)instruction);
+    p.push_back((uint8_t)(instruction >> 8));
+}
+
+static program_t operation(int inputs, int op) {
+    program_t p;
+    for (int i = 0; i < inputs; i++) put(p, EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT | i);
+    put(p, EXPR_EVAL_INSTRUCTION_TYPE_OPERATION | op);
+    put(p, EXPR_EVAL_INSTRUCTION_TYPE_END);
+    return p;
+}
+
+// (in0 + in1) < in2 && in0
+static program_t arithmetic() {
+    program_t p;
+    put(p, EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT | 0);
+    put(p, EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT | 1);
+    put(p, EXPR_EVAL_INSTRUCTION_TYPE_OPERATION | defs_v3::OPERATION_TYPE_ADD);
+    put(p, EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT | 2);
+    put(p, EXPR_EVAL_INSTRUCTION_TYPE_OPERATION | defs_v3::OPERATION_TYPE_LESS);
+    put(p, EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT | 0);
+    put(p, EXPR_EVAL_INSTRUCTION_TYPE_OPERATION | defs_v3::OPERATION_TYPE_LOGICAL_AND);
+    put(p, EXPR_EVAL_INSTRUCTION_TYPE_END);
+    return p;
+}
+
+static std::vector<program_t> synthetic_programs() {
+    static const int binary[] = {
+        defs_v3::OPERATION_TYPE_ADD, defs_v3::OPERATION_TYPE_SUB, defs_v3::OPERATION_TYPE_MUL,
+        defs_v3::OPERATION_TYPE_DIV, defs_v3::OPERATION_TYPE_EQUAL, defs_v3::OPERATION_TYPE_NOT_EQUAL,
+        defs_v3::OPERATION_TYPE_LESS, defs_v3::OPERATION_TYPE_GREATER, defs_v3::OPERATION_TYPE_LESS_OR_EQUAL,
+        defs_v3::OPERATION_TYPE_GREATER_OR_EQUAL, defs_v3::OPERATION_TYPE_LOGICAL_AND,
+        defs_v3::OPERATION_TYPE_LOGICAL_OR,
+    };
+    static const int unary[] = {
+        defs_v3::OPERATION_TYPE_UNARY_PLUS, defs_v3::OPERATION_TYPE_UNARY_MINUS, defs_v3::OPERATION_TYPE_NOT,
+    };
+    std::vector<program_t> programs;
+    for (int op : binary) programs.push_back(operation(2, op));
+    for (int op : unary) programs.push_back(operation(1, op));
+    programs.push_back(operation(3, defs_v3::OPERATION_TYPE_CONDITIONAL));
+    programs.push_back(arithmetic());
+    return programs;
+}
+
+// Flujo con más entradas: los programas sintéticos leen in0..in2
+static FlowState *widest(const std::vector<FlowState *> &states) {
+    FlowState *fs = states[0];
+    for (FlowState *s : states) {
+        if (s->flow->componentInputs.count > fs->flow->componentInputs.count) fs = s;
+    }
+    return fs;
+}
+
+static bool check_synthetic(FlowState *fs, const std::vector<program_t> &programs) {
+    static Value targets[3];
+    uint32_t evals = 0, diffs = 0;
+    int inputs = fs->flow->componentInputs.count < 3 ? (int)fs->flow->componentInputs.count : 3;
+    for (int it = 0; it < 300000; it++) {
+        for (int k = 0; k < inputs; k++) fs->values[k] = operand(rnd(), &targets[k]);
+        g_int = (int32_t)(rnd() % 5) - 2;
+        g_bool = rnd() & 1;
+        const program_t &p = programs[rnd() % programs.size()];
+        if (p.size() / 2 - 1 > (size_t)inputs + 5) continue;
+        evals++;
+        if (!both_paths(fs, 0, p.data()) && diffs++ < 5) {
+            printf("  FALLO: operación %d con entradas de tipo %d/%d/%d\n", p[p.size() - 4] | (p[p.size() - 3] & 0x1F) << 8,
+                   fs->values[0].type, inputs > 1 ? fs->values[1].type : 0, inputs > 2 ? fs->values[2].type : 0);
+        }
+    }
+    uint32_t decoded, ops, bytes;
+    getEvalInfo(decoded, ops, bytes);
+    printf("  sintéticos: %zu programas, %u evaluaciones sobre %d entradas, %u diferencias (%u programas, %u ops, "
+           "%u bytes en la tabla)\n", programs.size(), evals, inputs, diffs, decoded, ops, bytes);
+    return inputs == 3 && diffs == 0 && decoded > 0;
+}
+
+// -----------------------------------------------------------------------------
+// Rendimiento
+// -----------------------------------------------------------------------------
+
+// Mínimo de muchas pasadas alternando caminos (lo menos afectado por el ruido)
+static void bench_assets(const std::vector<EvalItem> &all, double seconds) {
+    static const char *const names[] = { "todas", "vacías o un push", "el resto" };
+    for (int sel = 0; sel < 3; sel++) {
+        std::vector<EvalItem> items;
+        for (const EvalItem &it : all) {
+            if (sel == 0 || (sel == 1) == is_short(it.instructions)) items.push_back(it);
+        }
+        if (items.empty()) continue;
+        double best[2] = { 1e9, 1e9 }, t_end = now_s() + seconds / 3;
+        Value r;
+        int n;
+        for (int pass = 0; now_s() < t_end; pass++) {
+            int mode = pass & 1;
+            g_evalThreaded = mode;
+            double t0 = now_s();
+            for (const EvalItem &it : items) evalExpressionForBench(it.flow_state, it.component, it.instructions, r, &n);
+            double t = (now_s() - t0) / items.size();
+            if (t < best[mode]) best[mode] = t;
+        }
+        printf("  ui.c, %-17s (%3zu): intérprete %7.2f ns, enhebrado %7.2f ns\n", names[sel], items.size(),
+               best[0] * 1e9, best[1] * 1e9);
+    }
+}
+
+static void bench_arithmetic(FlowState *fs, double seconds) {
+    program_t p = arithmetic();
+    double rate[2];
+    for (int mode = 0; mode < 2; mode++) {
+        g_evalThreaded = mode;
+        fs->values[0] = Value(3, VALUE_TYPE_INT32);
+        fs->values[1] = Value(4.5f, VALUE_TYPE_FLOAT);
+        fs->values[2] = Value(1, VALUE_TYPE_BOOLEAN);
+        uint64_t n = 0;
+        double t0 = now_s(), t;
+        Value r;
+        int bytes;
+        do {
+            for (int k = 0; k < 10000; k++) evalExpressionForBench(fs, 0, p.data(), r, &bytes);
+            n += 10000;
+            t = now_s() - t0;
+        } while (t < seconds / 2);
+        rate[mode] = n / t;
+    }
+    printf("  (in0 + in1) < in2 && in0: intérprete %.2f M eval/s, enhebrado %.2f M eval/s (x%.2f)\n", rate[0] / 1e6,
+           rate[1] / 1e6, rate[1] / rate[0]);
+}
+
+int main(int argc, char **argv) {
+    double seconds = 1.0;
+    bool do_check = true, do_bench = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--no-check")) do_check = false;
+        else if (!strcmp(argv[i], "--check-only")) do_bench = false;
+        else {
+            printf("Uso: %s [--seconds S] [--no-check | --check-only]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    loadMainAssets(assets, assets_size);
+    start(g_mainAssets);
+    uint32_t decoded, ops, bytes;
+    getEvalInfo(decoded, ops, bytes);
+    // Los assets de ui.c no tienen nada que decodificar: tabla solo para los sintéticos
+    evalStartForBench(g_mainAssets);
+
+    auto flowDefinition = static_cast<FlowDefinition *>(g_mainAssets->flowDefinition);
+    std::vector<FlowState *> states;
+    std::vector<EvalItem> items;
+    for (uint32_t f = 0; f < flowDefinition->flows.count; f++) {
+        FlowState *fs = initPageFlowState(g_mainAssets, (int)f, nullptr, -1);
+        states.push_back(fs);
+        for (uint32_t c = 0; c < fs->flow->components.count; c++) {
+            auto component = fs->flow->components[c];
+            for (uint32_t p = 0; p < component->properties.count; p++) {
+                items.push_back({ fs, (int)c, component->properties[p]->evalInstructions });
+            }
+        }
+    }
+    size_t short_items = 0;
+    for (const EvalItem &it : items) short_items += is_short(it.instructions);
+    printf("ui.c: %u flujos, %zu propiedades (%zu vacías o de un push), %u decodificadas al arrancar\n",
+           flowDefinition->flows.count, items.size(), short_items, decoded);
+
+    std::vector<program_t> programs = synthetic_programs();
+    FlowState *fs = widest(states);
+    bool ok = true;
+    if (do_check) {
+        printf("Comprobación (intérprete frente a código enhebrado)\n");
+        ok &= check_assets(items);
+        ok &= check_synthetic(fs, programs);
+    }
+    if (do_bench) {
+        printf("Rendimiento\n");
+        bench_assets(items, seconds / 2);
+        bench_arithmetic(fs, seconds / 2);
+    }
+    if (do_check) printf(ok ? "OK\n" : "FALLO\n");
+    return ok ? 0 : 1;
+}
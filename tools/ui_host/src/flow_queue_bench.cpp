@@ -0,0 +1,371 @@
+// -----------------------------------------------------------------------------
+// Micro-benchmark de la cola de ejecución de EEZ flow
+//
+// Compara la cola original de eez-flow.cpp (anillo de 1000 entradas con
+// módulo y búsquedas lineales) con components/EEZ_AIoT/src/eez_flow_queue.inc
+// sobre un flujo sintético que repite lo que hace eez::flow::tick():
+//   - tareas continuas que se vuelven a encolar en cada vuelta
+//   - componentes que al ejecutarse propagan a sus sucesores si no están ya
+//     en la cola (isInQueue, como el camino de componentes asíncronos)
+//   - FlowStates de acciones que se destruyen con tareas pendientes
+//     (removeTasksFromQueueForFlowState) y se vuelven a crear
+// Antes de medir, --check (por defecto) pasa la misma secuencia aleatoria por
+// las dos colas y compara cada resultado.
+//
+// No necesita LVGL: los tipos del motor se reducen a lo que usa la cola.
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#define EEZ_FLOW_QUEUE_SIZE 1000        // Como ui/eez-flow.h
+
+namespace eez {
+void *alloc(size_t size, uint32_t id) {
+    (void)id;
+    return malloc(size);
+}
+void free(void *ptr) {
+    ::free(ptr);
+}
+namespace flow {
+struct Flow {
+    struct {
+        uint32_t count;
+    } components;
+};
+struct FlowState {
+    Flow *flow;
+    FlowState *parentFlowState;
+    uint32_t refCounter;
+};
+static unsigned g_errors;
+void throwError(FlowState *, int, const char *) {
+    g_errors++;
+}
+void onAddToQueue(FlowState *, int, int, unsigned, int) {
+}
+void onRemoveFromQueue() {
+}
+void incRefCounterForFlowState(FlowState *flowState) {
+    for (auto fs = flowState; fs; fs = fs->parentFlowState) fs->refCounter++;
+}
+void decRefCounterForFlowState(FlowState *flowState) {
+    for (auto fs = flowState; fs; fs = fs->parentFlowState) fs->refCounter--;
+}
+
+// --- Cola original (copia literal de la sección flow/queue.cpp) ---
+namespace legacy {
+static const unsigned QUEUE_SIZE = EEZ_FLOW_QUEUE_SIZE;
+static struct {
+	FlowState *flowState;
+	unsigned componentIndex;
+    bool continuousTask;
+} g_queue[QUEUE_SIZE];
+static unsigned g_queueHead;
+static unsigned g_queueTail;
+static unsigned g_queueMax;
+static bool g_queueIsFull = false;
+unsigned g_numNonContinuousTaskInQueue;
+void queueReset() {
+	g_queueHead = 0;
+	g_queueTail = 0;
+	g_queueMax  = 0;
+	g_queueIsFull = false;
+    g_numNonContinuousTaskInQueue = 0;
+}
+size_t getQueueSize() {
+	if (g_queueHead == g_queueTail) {
+		if (g_queueIsFull) {
+			return QUEUE_SIZE;
+		}
+		return 0;
+	}
+	if (g_queueHead < g_queueTail) {
+		return g_queueTail - g_queueHead;
+	}
+	return QUEUE_SIZE - g_queueHead + g_queueTail;
+}
+bool addToQueue(FlowState *flowState, unsigned componentIndex, int sourceComponentIndex, int sourceOutputIndex, int targetInputIndex, bool continuousTask) {
+	if (g_queueIsFull) {
+        throwError(flowState, componentIndex, "Execution queue is full\n");
+		return false;
+	}
+	g_queue[g_queueTail].flowState = flowState;
+	g_queue[g_queueTail].componentIndex = componentIndex;
+    g_queue[g_queueTail].continuousTask = continuousTask;
+	g_queueTail = (g_queueTail + 1) % QUEUE_SIZE;
+	if (g_queueHead == g_queueTail) {
+		g_queueIsFull = true;
+	}
+	size_t queueSize = getQueueSize();
+	g_queueMax = g_queueMax < queueSize ? queueSize : g_queueMax;
+    if (!continuousTask) {
+        ++g_numNonContinuousTaskInQueue;
+	    onAddToQueue(flowState, sourceComponentIndex, sourceOutputIndex, componentIndex, targetInputIndex);
+    }
+    incRefCounterForFlowState(flowState);
+	return true;
+}
+bool peekNextTaskFromQueue(FlowState *&flowState, unsigned &componentIndex, bool &continuousTask) {
+	if (g_queueHead == g_queueTail && !g_queueIsFull) {
+		return false;
+	}
+	flowState = g_queue[g_queueHead].flowState;
+	componentIndex = g_queue[g_queueHead].componentIndex;
+    continuousTask = g_queue[g_queueHead].continuousTask;
+	return true;
+}
+void removeNextTaskFromQueue() {
+	auto flowState = g_queue[g_queueHead].flowState;
+    decRefCounterForFlowState(flowState);
+    auto continuousTask = g_queue[g_queueHead].continuousTask;
+	g_queueHead = (g_queueHead + 1) % QUEUE_SIZE;
+	g_queueIsFull = false;
+    if (!continuousTask) {
+        --g_numNonContinuousTaskInQueue;
+	    onRemoveFromQueue();
+    }
+}
+bool isInQueue(FlowState *flowState, unsigned componentIndex) {
+	if (g_queueHead == g_queueTail && !g_queueIsFull) {
+		return false;
+	}
+    unsigned int it = g_queueHead;
+    while (true) {
+		if (g_queue[it].flowState == flowState && g_queue[it].componentIndex == componentIndex) {
+            return true;
+		}
+        it = (it + 1) % QUEUE_SIZE;
+        if (it == g_queueTail) {
+            break;
+        }
+	}
+    return false;
+}
+void removeTasksFromQueueForFlowState(FlowState *flowState) {
+	if (g_queueHead == g_queueTail && !g_queueIsFull) {
+		return;
+	}
+    unsigned int it = g_queueHead;
+    while (true) {
+		if (g_queue[it].flowState == flowState) {
+            g_queue[it].flowState = 0;
+		}
+        it = (it + 1) % QUEUE_SIZE;
+        if (it == g_queueTail) {
+            break;
+        }
+	}
+}
+} // namespace legacy
+} // namespace flow
+} // namespace eez
+
+// --- Cola nueva (la misma que compila el equipo) ---
+#include "eez_flow_queue.inc"
+
+using namespace eez::flow;
+
+struct QueueApi {
+    const char *name;
+    void (*reset)();
+    size_t (*size)();
+    bool (*add)(FlowState *, unsigned, int, int, int, bool);
+    bool (*peek)(FlowState *&, unsigned &, bool &);
+    void (*pop)();
+    bool (*isIn)(FlowState *, unsigned);
+    void (*removeFor)(FlowState *);
+};
+
+static const QueueApi LEGACY = { "original", legacy::queueReset, legacy::getQueueSize, legacy::addToQueue,
+                                 legacy::peekNextTaskFromQueue, legacy::removeNextTaskFromQueue,
+                                 legacy::isInQueue, legacy::removeTasksFromQueueForFlowState };
+static const QueueApi FLAT = { "plana", queueReset, getQueueSize, addToQueue, peekNextTaskFromQueue,
+                               removeNextTaskFromQueue, isInQueue, removeTasksFromQueueForFlowState };
+
+static uint32_t rng_state = 1;
+static uint32_t rnd(uint32_t n) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state % n;
+}
+
+// -----------------------------------------------------------------------------
+// Flujo sintético
+// -----------------------------------------------------------------------------
+
+struct Synth {
+    Flow flow;
+    FlowState page;                     // FlowState de la página (no se destruye)
+    std::vector<FlowState *> actions;   // FlowStates de acciones (hijos de la página)
+    std::vector<FlowState *> retired;   // Acciones terminadas (sus tareas siguen en el anillo)
+    unsigned continuous;
+    unsigned target;                    // Tareas no continuas que se intentan mantener
+};
+
+static void synth_init(Synth &s, const QueueApi &q, unsigned components, unsigned actions, unsigned continuous,
+                       unsigned target) {
+    s.flow.components.count = components;
+    s.page = { &s.flow, nullptr, 0 };
+    s.continuous = continuous;
+    s.target = target;
+    s.actions.clear();
+    for (unsigned i = 0; i < actions; i++) s.actions.push_back(new FlowState{ &s.flow, &s.page, 0 });
+    q.reset();
+    for (unsigned i = 0; i < continuous; i++) q.add(&s.page, i, -1, -1, -1, true);
+    for (unsigned i = 0; i < target; i++) {
+        FlowState *fs = s.actions[rnd(actions)];
+        unsigned c = continuous + rnd(components - continuous);
+        if (!q.isIn(fs, c)) q.add(fs, c, -1, -1, -1, false);
+    }
+}
+
+static void synth_free(Synth &s) {
+    for (auto fs : s.actions) delete fs;
+    for (auto fs : s.retired) delete fs;
+    s.actions.clear();
+    s.retired.clear();
+}
+
+// Una vuelta de tick(): devuelve las operaciones de cola realizadas
+static uint64_t synth_tick(Synth &s, const QueueApi &q, uint32_t tick_no) {
+    uint64_t ops = 0;
+    size_t n = q.size();
+    for (size_t i = 0; i < n; i++) {
+        FlowState *fs;
+        unsigned c;
+        bool cont;
+        if (!q.peek(fs, c, cont)) break;
+        q.pop();
+        ops += 2;
+        if (!fs) continue;
+        if (cont) {
+            q.add(fs, c, -1, -1, -1, true);
+            ops++;
+            continue;
+        }
+        // Propaga a dos sucesores mientras la cola esté por debajo del objetivo
+        for (unsigned k = 0; k < 2 && q.size() < s.continuous + s.target; k++) {
+            FlowState *dst = s.actions[rnd((uint32_t)s.actions.size())];
+            unsigned succ = s.continuous + rnd(s.flow.components.count - s.continuous);
+            ops++;
+            if (!q.isIn(dst, succ)) {
+                q.add(dst, succ, -1, -1, -1, false);
+                ops++;
+            }
+        }
+    }
+    // Cada 4 vueltas termina una acción con tareas pendientes y empieza otra
+    if ((tick_no & 3) == 0) {
+        unsigned a = rnd((uint32_t)s.actions.size());
+        q.removeFor(s.actions[a]);
+        ops++;
+        s.retired.push_back(s.actions[a]);
+        s.actions[a] = new FlowState{ &s.flow, &s.page, 0 };
+    }
+    return ops;
+}
+
+// -----------------------------------------------------------------------------
+// Comprobación cruzada
+// -----------------------------------------------------------------------------
+
+static bool check(uint32_t steps) {
+    Flow flow = { { 48 } };
+    FlowState page = { &flow, nullptr, 0 };
+    std::vector<FlowState *> fs;
+    for (int i = 0; i < 24; i++) fs.push_back(new FlowState{ &flow, &page, 0 });
+    std::vector<FlowState *> retired;
+    legacy::queueReset();
+    queueReset();
+    for (uint32_t step = 0; step < steps; step++) {
+        uint32_t op = rnd(100);
+        FlowState *f = rnd(8) == 0 ? &page : fs[rnd((uint32_t)fs.size())];
+        unsigned c = rnd(flow.components.count);
+        bool ok = true;
+        if (op < 45 && legacy::getQueueSize() < EEZ_FLOW_QUEUE_SIZE - 1) {
+            bool cont = rnd(4) == 0;
+            ok = legacy::addToQueue(f, c, -1, -1, -1, cont) == addToQueue(f, c, -1, -1, -1, cont);
+        } else if (op < 85) {
+            FlowState *f1 = nullptr, *f2 = nullptr;
+            unsigned c1 = 0, c2 = 0;
+            bool k1 = false, k2 = false;
+            bool r1 = legacy::peekNextTaskFromQueue(f1, c1, k1), r2 = peekNextTaskFromQueue(f2, c2, k2);
+            ok = r1 == r2 && (!r1 || (f1 == f2 && c1 == c2 && k1 == k2));
+            if (r1) {
+                legacy::removeNextTaskFromQueue();
+                removeNextTaskFromQueue();
+            }
+        } else if (op < 97) {
+            ok = legacy::isInQueue(f, c) == isInQueue(f, c);
+        } else if (f != &page) {
+            legacy::removeTasksFromQueueForFlowState(f);
+            removeTasksFromQueueForFlowState(f);
+            for (auto &p : fs) {
+                if (p == f) p = new FlowState{ &flow, &page, 0 };
+            }
+            retired.push_back(f);
+        }
+        ok = ok && legacy::getQueueSize() == getQueueSize() &&
+             legacy::g_numNonContinuousTaskInQueue == eez::flow::g_numNonContinuousTaskInQueue;
+        if (!ok) {
+            printf("Diferencia en el paso %u (operación %u)\n", step, op);
+            return false;
+        }
+    }
+    for (auto p : fs) delete p;
+    for (auto p : retired) delete p;
+    printf("Comprobación: %u operaciones idénticas en las dos colas\n", steps);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Medida
+// -----------------------------------------------------------------------------
+
+static double now_s() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench(const QueueApi &q, unsigned target, uint32_t ticks) {
+    Synth s;
+    rng_state = 12345;
+    synth_init(s, q, 64, 16, 8, target);
+    uint64_t ops = 0;
+    double t0 = now_s();
+    for (uint32_t t = 0; t < ticks; t++) ops += synth_tick(s, q, t);
+    double dt = now_s() - t0;
+    printf("  %-9s %6u %9.2f %12.0f %9.1f\n", q.name, target, dt * 1e6 / ticks, ticks / dt, dt * 1e9 / ops);
+    synth_free(s);
+}
+
+int main(int argc, char **argv) {
+    uint32_t ticks = 20000;
+    bool do_check = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--no-check")) do_check = false;
+        else if (!strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else {
+            printf("Uso: %s [--ticks N] [--no-check]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (do_check && !check(2000000)) return 1;
+
+    printf("\nFlujo sintético: 64 componentes, 16 acciones, 8 tareas continuas, %u vueltas\n", ticks);
+    printf("  %-9s %6s %9s %12s %9s\n", "cola", "tareas", "us/vuelta", "vueltas/s", "ns/op");
+    const unsigned targets[] = { 16, 64, 256, 900 };
+    for (unsigned target : targets) {
+        bench(LEGACY, target, ticks);
+        bench(FLAT, target, ticks);
+    }
+    if (g_errors) printf("Errores de cola llena: %u\n", g_errors);
+    return 0;
+}
@@ -0,0 +1,222 @@
+// Tiempo de resolución y comprobación en el PC de GradientSolver_AIoT.
+//
+// Redes en malla (cuadrícula de uniones con lazos) alimentadas por un
+// depósito, de 10 a 1000 tuberías con diámetros aleatorios y una demanda
+// en cada unión.
+//   - Comprobación: tras converger, cada unión cumple la continuidad y cada
+//     tubería la pérdida de Darcy-Weisbach entre sus extremos; y una
+//     resolución en caliente tras cambiar demandas (refactorización
+//     incremental) da las mismas alturas que una red nueva resuelta en frío.
+//   - Rendimiento: tiempo de GGA_solve en frío (desde el caudal inicial) y
+//     en caliente tras cambiar la demanda de una unión, con iteraciones y
+//     filas refactorizadas.
+//
+// Termina con código 1 ante cualquier diferencia.
+
+#define _POSIX_C_SOURCE 200809L
+#include "GradientSolver_AIoT.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define GRAVITY         9.81
+#define PIPE_LENGTH     100.0
+#define FRICTION        0.02
+#define H_RESERVOIR     100.0
+#define DEMAND          0.0005          // m^3/s por unión
+#define SOLVE_TOL       1e-9
+#define MAX_ITER        50
+#define CHECK_TOL       1e-6            // Caudal (m^3/s) y altura (m)
+
+static const uint16_t SIZES[] = { 10, 30, 100, 300, 1000 };
+#define SIZE_COUNT      (sizeof(SIZES) / sizeof(SIZES[0]))
+
+static uint32_t g_rng;
+static uint32_t rnd(uint32_t n) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return (g_rng >> 8) % n;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Red de prueba: depósito (nodo 0) -> unión 1 y cuadrícula de uniones de
+// 'cols' columnas, cada una unida a la de su izquierda y a la de arriba
+typedef struct {
+    GGA_t *g;
+    uint16_t pipes, junctions;
+    double diameter[1024];
+    uint16_t from[1024], to[1024];
+} net_t;
+
+static bool build(net_t *net, uint16_t pipes, double demand_scale) {
+    uint16_t cols = 1;
+    while ((uint32_t)cols * cols * 2 < pipes) cols++;
+    net->g = GGA_create((uint16_t)(pipes + 2), pipes);
+    if (!net->g) return false;
+    g_rng = pipes;                                      // Misma red para el mismo tamaño
+    GGA_add_reservoir(net->g, H_RESERVOIR);
+
+    uint16_t links = 0;
+    net->junctions = 0;
+    while (links < pipes) {
+        uint16_t j = net->junctions++;
+        int node = GGA_add_junction(net->g, DEMAND * demand_scale);
+        uint16_t r = j / cols, c = j % cols;
+        uint16_t ends[2];
+        int n_ends = 0;
+        if (j == 0) ends[n_ends++] = 0;                 // Depósito
+        if (c > 0) ends[n_ends++] = (uint16_t)(node - 1);
+        if (r > 0) ends[n_ends++] = (uint16_t)(node - cols);
+        for (int e = 0; e < n_ends && links < pipes; e++) {
+            double d = 0.10 + 0.05 * rnd(5);
+            net->from[links] = ends[e];
+            net->to[links] = (uint16_t)node;
+            net->diameter[links] = d;
+            if (GGA_add_pipe(net->g, ends[e], (uint16_t)node, PIPE_LENGTH, d, FRICTION) < 0) return false;
+            links++;
+        }
+    }
+    net->pipes = links;
+    return GGA_finalize(net->g);
+}
+
+// Continuidad en cada unión y Darcy-Weisbach en cada tubería
+static bool balanced(const net_t *net, double demand, double *worst_q, double *worst_h) {
+    static double net_in[1100];
+    memset(net_in, 0, sizeof(net_in));
+    *worst_q = 0.0;
+    *worst_h = 0.0;
+    for (uint16_t k = 0; k < net->pipes; k++) {
+        double q = GGA_flow(net->g, k);
+        net_in[net->to[k]] += q;
+        net_in[net->from[k]] -= q;
+        double area = 3.14159265358979 * net->diameter[k] * net->diameter[k] / 4.0;
+        double r = FRICTION * PIPE_LENGTH / (2.0 * GRAVITY * net->diameter[k] * area * area);
+        double dh = GGA_head(net->g, net->from[k]) - GGA_head(net->g, net->to[k]);
+        double e = fabs(dh - r * q * fabs(q));
+        if (e > *worst_h) *worst_h = e;
+    }
+    for (uint16_t j = 1; j <= net->junctions; j++) {
+        double e = fabs(net_in[j] - demand);
+        if (e > *worst_q) *worst_q = e;
+    }
+    return *worst_q <= CHECK_TOL && *worst_h <= CHECK_TOL;
+}
+
+// -----------------------------------------------------------------------------
+// Comprobación
+// -----------------------------------------------------------------------------
+
+static bool check(uint16_t pipes) {
+    static net_t warm, cold;
+    bool ok = true;
+    if (!build(&warm, pipes, 1.0) || !build(&cold, pipes, 1.1)) {
+        printf("  FALLO: no se pudo construir la red de %u tuberías\n", pipes);
+        return false;
+    }
+    // En caliente: resuelve con la demanda base y después con +10 %
+    int it0 = GGA_solve(warm.g, MAX_ITER, SOLVE_TOL);
+    for (uint16_t j = 1; j <= warm.junctions; j++) GGA_set_demand(warm.g, j, DEMAND * 1.1);
+    int it1 = GGA_solve(warm.g, MAX_ITER, SOLVE_TOL);
+    int it2 = GGA_solve(cold.g, MAX_ITER, SOLVE_TOL);
+    if (it0 < 0 || it1 < 0 || it2 < 0) {
+        printf("  FALLO: %u tuberías, sin convergencia (%d / %d / %d iteraciones)\n", pipes, it0, it1, it2);
+        GGA_destroy(warm.g);
+        GGA_destroy(cold.g);
+        return false;
+    }
+
+    double eq, eh, diff = 0.0;
+    if (!balanced(&warm, DEMAND * 1.1, &eq, &eh)) {
+        printf("  FALLO: %u tuberías, continuidad %.2e m3/s, pérdida %.2e m\n", pipes, eq, eh);
+        ok = false;
+    }
+    for (uint16_t j = 1; j <= warm.junctions; j++) {
+        double d = fabs(GGA_head(warm.g, j) - GGA_head(cold.g, j));
+        if (d > diff) diff = d;
+    }
+    if (diff > CHECK_TOL) {
+        printf("  FALLO: %u tuberías, en caliente y en frío difieren %.2e m\n", pipes, diff);
+        ok = false;
+    }
+    printf("  %4u tuberías, %4u uniones: continuidad %.1e m3/s, pérdida %.1e m, caliente/frío %.1e m\n",
+           warm.pipes, warm.junctions, eq, eh, diff);
+    GGA_destroy(warm.g);
+    GGA_destroy(cold.g);
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Rendimiento
+// -----------------------------------------------------------------------------
+
+static void bench(uint16_t pipes, double seconds) {
+    static net_t net;
+    GGA_stats_t st;
+
+    // En frío: red nueva cada vez (solo se cronometra GGA_solve)
+    double cold_t = 0.0;
+    uint32_t cold_n = 0, cold_it = 0;
+    do {
+        if (!build(&net, pipes, 1.0)) return;
+        double t0 = now_s();
+        int it = GGA_solve(net.g, MAX_ITER, SOLVE_TOL);
+        cold_t += now_s() - t0;
+        cold_it = (uint32_t)it;
+        cold_n++;
+        if (cold_t < seconds / 2) GGA_destroy(net.g);
+    } while (cold_t < seconds / 2);
+    GGA_get_stats(net.g, &st);
+    uint32_t profile = st.profile_size;
+
+    // En caliente: la demanda de una unión alterna entre dos valores
+    double warm_t = 0.0;
+    uint32_t warm_n = 0, warm_it = 0, rows = 0;
+    uint16_t j = (uint16_t)(net.junctions / 2 + 1);
+    do {
+        GGA_set_demand(net.g, j, DEMAND * ((warm_n & 1) ? 1.0 : 3.0));
+        double t0 = now_s();
+        int it = GGA_solve(net.g, MAX_ITER, SOLVE_TOL);
+        warm_t += now_s() - t0;
+        GGA_get_stats(net.g, &st);
+        warm_it += (uint32_t)it;
+        rows += st.rows_factored;
+        warm_n++;
+    } while (warm_t < seconds / 2);
+    GGA_destroy(net.g);
+
+    printf("  %4u tuberías, perfil %6u: frío %8.1f us (%2u it), caliente %8.1f us (%.1f it, %.0f filas)\n",
+           net.pipes, profile, cold_t * 1e6 / cold_n, cold_it, warm_t * 1e6 / warm_n,
+           (double)warm_it / warm_n, (double)rows / warm_n);
+}
+
+int main(int argc, char **argv) {
+    double seconds = 0.4;
+    bool do_check = true, do_bench = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--no-check")) do_check = false;
+        else if (!strcmp(argv[i], "--check-only")) do_bench = false;
+        else {
+            printf("Uso: %s [--seconds S] [--no-check | --check-only]\n", argv[0]);
+            return 2;
+        }
+    }
+    bool ok = true;
+    if (do_check) {
+        printf("Comprobación (balance de la solución y caliente frente a frío)\n");
+        for (size_t i = 0; i < SIZE_COUNT; i++) ok &= check(SIZES[i]);
+    }
+    if (do_bench) {
+        printf("Rendimiento de GGA_solve (%.1f s por tamaño)\n", seconds);
+        for (size_t i = 0; i < SIZE_COUNT; i++) bench(SIZES[i], seconds);
+    }
+    if (do_check) printf(ok ? "OK\n" : "FALLO\n");
+    return ok ? 0 : 1;
+}
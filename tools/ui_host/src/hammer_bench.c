@@ -0,0 +1,283 @@
+// Rendimiento y comprobación en el PC de HammerDetect_AIoT.
+//
+// Genera bloques de SampleRing (16 canales x 64 muestras) de varios nodos con
+// ruido acotado alrededor de una línea base e inyecta pulsos de presión del
+// tamaño de un golpe de ariete (Joukowsky) en canales y momentos aleatorios.
+//   - Comprobación: cada pulso debe dar exactamente un evento, en su canal y
+//     en su primera muestra, y el ruido ninguno.
+//   - Escalón persistente: un canal que sube y se queda (+200 y +4000
+//     cuentas) da un solo evento, se rearma tras reiniciar la media al nivel
+//     nuevo y detecta después un pulso encima de ese nivel.
+//   - Rendimiento: muestras/s y ns por muestra de HammerDetect_process_block
+//     (el mismo código que la tarea del equipo), con el equivalente en canales
+//     de 1 kHz que se podrían procesar en tiempo real en este PC.
+//
+// Termina con código 1 ante cualquier diferencia.
+
+#define _POSIX_C_SOURCE 200809L
+#include "HammerDetect_AIoT.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NODES           4
+#define BASELINE        10000
+#define PULSE_COUNTS    4000            // > 0.5 * rho*a*dv = 2495 cuentas con la configuración por defecto
+#define PULSE_SAMPLES   40
+#define PULSE_SPACING   3000            // Muestras mínimas entre pulsos de un canal (> warmup y holdoff)
+
+static uint32_t g_rng = 7;
+static uint32_t rnd(uint32_t n) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return (g_rng >> 8) % n;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Estado del generador por nodo y canal
+typedef struct {
+    uint64_t next_pulse;                // Índice de muestra del próximo pulso
+    uint64_t pulse_end;
+} gen_channel_t;
+
+typedef struct {
+    gen_channel_t ch[NODES][SRING_CHANNELS];
+    uint64_t sample[NODES];             // Muestras generadas por canal y nodo
+    uint32_t pulses;
+} generator_t;
+
+// Pulso esperado, para casar con los eventos
+typedef struct {
+    uint8_t node, channel;
+    int64_t timestamp_us;
+    bool matched;
+} pulse_t;
+
+static pulse_t *g_pulses;
+static uint32_t g_pulse_cap;
+
+static void gen_block(generator_t *g, int node, SampleRing_block_t *b, uint32_t seq, bool record) {
+    uint64_t t0 = g->sample[node];
+    b->seq = seq;
+    b->node = (uint8_t)(node + 1);
+    b->channel_mask = 0xFFFF;
+    b->count = SRING_BLOCK_SAMPLES;
+    b->sample_period_us = 1000;
+    b->timestamp_us = (int64_t)t0 * 1000;
+    for (int c = 0; c < SRING_CHANNELS; c++) {
+        gen_channel_t *gc = &g->ch[node][c];
+        for (int i = 0; i < SRING_BLOCK_SAMPLES; i++) {
+            uint64_t t = t0 + (uint64_t)i;
+            // Ruido: suma de 4 uniformes en [-15, 15] (sigma ~17, |ruido| <= 60)
+            int32_t v = BASELINE + (int32_t)(rnd(31) + rnd(31) + rnd(31) + rnd(31)) - 60;
+            if (t == gc->next_pulse) {
+                gc->pulse_end = t + PULSE_SAMPLES;
+                gc->next_pulse = t + PULSE_SPACING + rnd(PULSE_SPACING);
+                g->pulses++;
+                if (record && g->pulses <= g_pulse_cap) {
+                    g_pulses[g->pulses - 1] = (pulse_t){ (uint8_t)(node + 1), (uint8_t)c, (int64_t)t * 1000, false };
+                }
+            }
+            if (t < gc->pulse_end) v += PULSE_COUNTS;
+            b->data[c][i] = (int16_t)v;
+        }
+    }
+    g->sample[node] = t0 + SRING_BLOCK_SAMPLES;
+}
+
+static void gen_init(generator_t *g) {
+    memset(g, 0, sizeof(*g));
+    for (int n = 0; n < NODES; n++) {
+        for (int c = 0; c < SRING_CHANNELS; c++) g->ch[n][c].next_pulse = 1000 + rnd(PULSE_SPACING);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Comprobación
+// -----------------------------------------------------------------------------
+
+static bool check(uint32_t blocks_per_node) {
+    static HammerDetect_t det;
+    static generator_t gen;
+    HammerDetect_config_t cfg = HAMMERDETECT_CONFIG_DEFAULT();
+    HammerDetect_init(&det, &cfg);
+    gen_init(&gen);
+
+    g_pulse_cap = blocks_per_node * SRING_BLOCK_SAMPLES / PULSE_SPACING * SRING_CHANNELS * NODES + 64;
+    g_pulses = calloc(g_pulse_cap, sizeof(pulse_t));
+    if (!g_pulses) return false;
+
+    SampleRing_block_t block;
+    uint32_t false_events = 0, late_events = 0;
+    for (uint32_t b = 0; b < blocks_per_node; b++) {
+        for (int n = 0; n < NODES; n++) {
+            gen_block(&gen, n, &block, b * NODES + (uint32_t)n, true);
+            HammerDetect_process_block(&det, &block);
+            HammerDetect_event_t ev;
+            while (HammerDetect_pop_event(&det, &ev)) {
+                pulse_t *match = NULL;
+                for (uint32_t k = gen.pulses; k-- > 0 && k + 256 > gen.pulses;) {
+                    pulse_t *p = &g_pulses[k];
+                    if (p->node == ev.node && p->channel == ev.channel && !p->matched) {
+                        match = p;
+                        break;
+                    }
+                }
+                if (!match) {
+                    if (false_events++ < 5) printf("  FALLO: evento sin pulso en nodo %u canal %u\n", ev.node, ev.channel);
+                } else if (match->timestamp_us != ev.timestamp_us) {
+                    if (late_events++ < 5)
+                        printf("  FALLO: nodo %u canal %u, evento en %lld us y pulso en %lld us\n", ev.node,
+                               ev.channel, (long long)ev.timestamp_us, (long long)match->timestamp_us);
+                    match->matched = true;
+                } else {
+                    match->matched = true;
+                }
+            }
+        }
+    }
+
+    // Los pulsos durante el calentamiento no pueden detectarse
+    uint32_t missed = 0, warmup = 0;
+    for (uint32_t k = 0; k < gen.pulses && k < g_pulse_cap; k++) {
+        if (g_pulses[k].matched) continue;
+        if (g_pulses[k].timestamp_us < (int64_t)cfg.warmup_samples * 1000) {
+            warmup++;
+            continue;
+        }
+        if (missed++ < 5) printf("  FALLO: pulso sin evento en nodo %u canal %u\n", g_pulses[k].node, g_pulses[k].channel);
+    }
+    printf("  %u nodos x %u bloques: %u pulsos, %u eventos, %u sin detectar, %u falsos, %u desplazados, %u perdidos\n",
+           NODES, blocks_per_node, gen.pulses, det.stats.events, missed, false_events, late_events,
+           det.stats.events_dropped);
+    free(g_pulses);
+    return gen.pulses > 0 && gen.pulses <= g_pulse_cap && missed == 0 && false_events == 0 &&
+           late_events == 0 && warmup == 0 && det.stats.events_dropped == 0;
+}
+
+// Escalón persistente en un canal de un nodo, seguido de un pulso encima del
+// nivel nuevo cuando el canal ya debería haberse rearmado
+#define STEP_CHANNEL    3
+#define STEP_AT         2000
+
+static bool check_step(int32_t step) {
+    static HammerDetect_t det;
+    HammerDetect_config_t cfg = HAMMERDETECT_CONFIG_DEFAULT();
+    HammerDetect_init(&det, &cfg);
+    const uint64_t pulse_at = STEP_AT + cfg.rebase_samples + cfg.holdoff_samples + 1000;
+    const uint64_t end = pulse_at + PULSE_SAMPLES + cfg.holdoff_samples + 1000;
+
+    SampleRing_block_t b;
+    int64_t when[4];
+    uint32_t events = 0, other = 0;
+    for (uint64_t t0 = 0; t0 < end; t0 += SRING_BLOCK_SAMPLES) {
+        b.seq = (uint32_t)(t0 / SRING_BLOCK_SAMPLES);
+        b.node = 1;
+        b.channel_mask = 0xFFFF;
+        b.count = SRING_BLOCK_SAMPLES;
+        b.sample_period_us = 1000;
+        b.timestamp_us = (int64_t)t0 * 1000;
+        for (int c = 0; c < SRING_CHANNELS; c++) {
+            for (int i = 0; i < SRING_BLOCK_SAMPLES; i++) {
+                uint64_t t = t0 + (uint64_t)i;
+                int32_t v = BASELINE + (int32_t)(rnd(31) + rnd(31) + rnd(31) + rnd(31)) - 60;
+                if (c == STEP_CHANNEL && t >= STEP_AT) v += step;
+                if (c == STEP_CHANNEL && t >= pulse_at && t < pulse_at + PULSE_SAMPLES) v += PULSE_COUNTS;
+                b.data[c][i] = (int16_t)v;
+            }
+        }
+        HammerDetect_process_block(&det, &b);
+        HammerDetect_event_t ev;
+        while (HammerDetect_pop_event(&det, &ev)) {
+            if (ev.channel != STEP_CHANNEL) other++;
+            else if (events < 4) when[events++] = ev.timestamp_us;
+            else events++;
+        }
+    }
+
+    const HammerDetect_node_t *n = &det.nodes[0];
+    int32_t mean = n->mean_q8[STEP_CHANNEL] >> 8;
+    printf("  escalón de %+d cuentas: %u eventos, %u reinicios de media, media final %d, %s\n", step, events,
+           det.stats.rebaselines, mean, n->alarmed[STEP_CHANNEL] ? "en alarma" : "rearmado");
+    bool ok = true;
+    if (events != 2 || other != 0) {
+        printf("  FALLO: escalón de %+d, %u eventos en el canal y %u en otros (esperados 2 y 0)\n", step, events, other);
+        ok = false;
+    } else if (when[0] != STEP_AT * 1000 || when[1] != (int64_t)pulse_at * 1000) {
+        printf("  FALLO: escalón de %+d, eventos en %lld y %lld us, esperados en %lld y %lld us\n", step,
+               (long long)when[0], (long long)when[1], (long long)STEP_AT * 1000, (long long)pulse_at * 1000);
+        ok = false;
+    }
+    if (n->alarmed[STEP_CHANNEL] || mean < BASELINE + step - 30 || mean > BASELINE + step + 30) {
+        printf("  FALLO: escalón de %+d, el canal no vuelve a la normalidad en el nivel nuevo\n", step);
+        ok = false;
+    }
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Rendimiento
+// -----------------------------------------------------------------------------
+
+#define BENCH_BLOCKS    256
+
+static void bench(double seconds) {
+    static HammerDetect_t det;
+    static generator_t gen;
+    static SampleRing_block_t blocks[BENCH_BLOCKS];
+    HammerDetect_config_t cfg = HAMMERDETECT_CONFIG_DEFAULT();
+    HammerDetect_init(&det, &cfg);
+    gen_init(&gen);
+    for (int b = 0; b < BENCH_BLOCKS; b++) gen_block(&gen, b % NODES, &blocks[b], (uint32_t)b, false);
+
+    uint64_t samples = 0;
+    double t0 = now_s(), dt;
+    uint32_t b = 0;
+    do {
+        for (int k = 0; k < 64; k++) {
+            HammerDetect_process_block(&det, &blocks[b]);
+            b = (b + 1) % BENCH_BLOCKS;
+            HammerDetect_event_t ev;
+            while (HammerDetect_pop_event(&det, &ev)) {}
+        }
+        samples += 64u * SRING_CHANNELS * SRING_BLOCK_SAMPLES;
+        dt = now_s() - t0;
+    } while (dt < seconds);
+
+    printf("  %.1f M muestras/s, %.2f ns/muestra, %.0f canales de 1 kHz en tiempo real (%u eventos)\n",
+           samples / dt / 1e6, dt * 1e9 / (double)samples, samples / dt / 1000.0, det.stats.events);
+}
+
+int main(int argc, char **argv) {
+    uint32_t blocks = 2000;
+    double seconds = 1.0;
+    bool do_check = true, do_bench = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--blocks") && i + 1 < argc) blocks = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--no-check")) do_check = false;
+        else if (!strcmp(argv[i], "--check-only")) do_bench = false;
+        else {
+            printf("Uso: %s [--blocks N] [--seconds S] [--no-check | --check-only]\n", argv[0]);
+            return 2;
+        }
+    }
+    bool ok = true;
+    if (do_check) {
+        printf("Comprobación (pulsos de %d cuentas durante %d muestras)\n", PULSE_COUNTS, PULSE_SAMPLES);
+        ok = check(blocks);
+        ok &= check_step(200);
+        ok &= check_step(PULSE_COUNTS);
+    }
+    if (do_bench) {
+        printf("Rendimiento de HammerDetect_process_block\n");
+        bench(seconds);
+    }
+    if (do_check) printf(ok ? "OK\n" : "FALLO\n");
+    return ok ? 0 : 1;
+}
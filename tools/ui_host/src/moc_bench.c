@@ -0,0 +1,225 @@
+// Exactitud y rendimiento en el PC de MOC_AIoT.
+//
+// Comprobación con la red clásica depósito - tubería - válvula y cierre
+// instantáneo de la válvula en t = 0:
+//   - Joukowsky: la altura en la válvula debe subir dH = a dV / g (con la
+//     celeridad ajustada a la malla) y mantenerse mientras la onda va y
+//     vuelve al depósito (0 < t < 2L/a); sin fricción, en 2L/a < t < 4L/a
+//     debe bajar otro tanto por debajo de la inicial.
+//   - La onda llega al centro de la tubería L/(2a) después de que la válvula
+//     vea el cierre (al final del primer paso), ni antes ni después.
+//   - Con fricción, el primer salto en la válvula sigue siendo a dV / g.
+//   - Repartir cada paso en trozos de pocos puntos (max_points) da
+//     exactamente el mismo resultado que el paso completo.
+// Rendimiento: puntos de malla actualizados por segundo con la malla llena
+// (MOC_MAX_POINTS) y el factor de tiempo real resultante.
+//
+// Termina con código 1 ante cualquier diferencia.
+
+#define _POSIX_C_SOURCE 200809L
+#include "MOC_AIoT.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PIPE_LENGTH     1000.0f
+#define PIPE_DIAMETER   0.5f
+#define WAVE_SPEED      1000.0f
+#define DT              0.02f           // 50 tramos exactos
+#define H_RESERVOIR     100.0f
+#define Q0              0.2f
+#define TOLERANCE       0.005f          // 0.5 % de a dV / g
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Depósito -> tubería -> válvula en régimen permanente con caudal Q0
+static bool build_line(MOC_solver_t *s, float friction, int *valve) {
+    MOC_init(s);
+    int res = MOC_add_node(s, MOC_NODE_RESERVOIR, H_RESERVOIR, 0.0f);
+    *valve = MOC_add_node(s, MOC_NODE_VALVE, 0.0f, 0.0f);
+    if (res < 0 || *valve < 0) return false;
+    if (MOC_add_pipe(s, (uint8_t)res, (uint8_t)*valve, PIPE_LENGTH, PIPE_DIAMETER, WAVE_SPEED, friction) < 0) return false;
+    if (!MOC_finalize(s, DT)) return false;
+    MOC_set_pipe_steady(s, 0, Q0, H_RESERVOIR);
+    float h_valve = MOC_node_head(s, (uint8_t)*valve);
+    MOC_set_valve_steady(s, (uint8_t)*valve, Q0, h_valve);
+    return true;
+}
+
+static bool near(float v, float expected, float scale) {
+    return fabsf(v - expected) <= TOLERANCE * scale;
+}
+
+static bool check_joukowsky(void) {
+    static MOC_solver_t s;
+    int valve;
+    if (!build_line(&s, 0.0f, &valve)) {
+        printf("  FALLO: no se pudo construir la red\n");
+        return false;
+    }
+    const MOC_pipe_t *p = &s.pipes[0];
+    float area = 3.14159265f * PIPE_DIAMETER * PIPE_DIAMETER / 4.0f;
+    float dv = Q0 / area;
+    float dh = p->wave_speed_adj * dv / MOC_GRAVITY;
+    float h0 = MOC_node_head(&s, (uint8_t)valve);
+    uint32_t n = p->reaches;                    // Pasos que tarda la onda en recorrer L
+    uint16_t mid = (uint16_t)(n / 2);
+
+    // Antes de 2L/a la válvula ve +dH; de 2L/a a 4L/a, -dH
+    MOC_set_valve_opening(&s, (uint8_t)valve, 0.0f);
+    bool ok = true;
+    float hv_max = -INFINITY, hv_min = INFINITY, hmid_first = NAN;
+    uint32_t mid_arrival = 0;
+    for (uint32_t k = 1; k < 4 * n; k++) {
+        MOC_step(&s, 0);
+        float hv = MOC_node_head(&s, (uint8_t)valve);
+        if (k < 2 * n) {
+            if (!near(hv - h0, dh, dh)) {
+                if (ok) printf("  FALLO: paso %u, subida en la válvula %.3f m, esperada %.3f m\n", k, hv - h0, dh);
+                ok = false;
+            }
+            if (hv > hv_max) hv_max = hv;
+        } else if (k > 2 * n) {
+            if (!near(hv - h0, -dh, dh)) {
+                if (ok) printf("  FALLO: paso %u, bajada en la válvula %.3f m, esperada %.3f m\n", k, hv - h0, -dh);
+                ok = false;
+            }
+            if (hv < hv_min) hv_min = hv;
+        }
+        float hm = MOC_head(&s, 0, mid);
+        if (!mid_arrival && hm - h0 > 0.5f * dh) {
+            mid_arrival = k;
+            hmid_first = hm;
+        }
+    }
+    // El cierre actúa en el contorno del primer paso; de ahí al centro, n - mid pasos
+    if (mid_arrival != 1 + n - mid) {
+        printf("  FALLO: la onda llega al centro en el paso %u, esperado %u\n", mid_arrival, 1 + n - mid);
+        ok = false;
+    } else if (!near(hmid_first - h0, dh, dh)) {
+        printf("  FALLO: subida en el centro %.3f m, esperada %.3f m\n", hmid_first - h0, dh);
+        ok = false;
+    }
+    printf("  sin fricción: a dV/g = %.2f m, válvula +%.2f / %.2f m, onda al centro en %.2f s\n", dh,
+           hv_max - h0, hv_min - h0, mid_arrival * s.dt);
+    return ok;
+}
+
+static bool check_friction(void) {
+    static MOC_solver_t s;
+    int valve;
+    if (!build_line(&s, 0.02f, &valve)) {
+        printf("  FALLO: no se pudo construir la red con fricción\n");
+        return false;
+    }
+    const MOC_pipe_t *p = &s.pipes[0];
+    float area = 3.14159265f * PIPE_DIAMETER * PIPE_DIAMETER / 4.0f;
+    float dh = p->wave_speed_adj * (Q0 / area) / MOC_GRAVITY;
+    float h0 = MOC_node_head(&s, (uint8_t)valve);
+    MOC_set_valve_opening(&s, (uint8_t)valve, 0.0f);
+    MOC_step(&s, 0);
+    float jump = MOC_node_head(&s, (uint8_t)valve) - h0;
+    printf("  con fricción: pérdida %.2f m, primer salto %.2f m\n", H_RESERVOIR - h0, jump);
+    if (!near(jump, dh, dh)) {
+        printf("  FALLO: primer salto %.3f m, esperado %.3f m\n", jump, dh);
+        return false;
+    }
+    return true;
+}
+
+static bool check_partial_steps(void) {
+    static MOC_solver_t full, part;
+    int valve;
+    if (!build_line(&full, 0.02f, &valve) || !build_line(&part, 0.02f, &valve)) return false;
+    MOC_set_valve_opening(&full, (uint8_t)valve, 0.0f);
+    MOC_set_valve_opening(&part, (uint8_t)valve, 0.0f);
+    uint32_t calls = 0;
+    for (int k = 0; k < 200; k++) {
+        MOC_step(&full, 0);
+        do {
+            calls++;
+        } while (!MOC_step(&part, 7));
+    }
+    bool same = full.cur == part.cur && full.stats.point_updates == part.stats.point_updates &&
+                !memcmp(full.h[full.cur], part.h[part.cur], sizeof(full.h[0])) &&
+                !memcmp(full.q[full.cur], part.q[part.cur], sizeof(full.q[0]));
+    printf("  pasos troceados: 200 pasos en %u llamadas de 7 puntos, %s\n", calls, same ? "iguales" : "distintos");
+    if (!same) printf("  FALLO: el paso troceado no coincide con el completo\n");
+    return same;
+}
+
+// -----------------------------------------------------------------------------
+// Rendimiento
+// -----------------------------------------------------------------------------
+
+static void bench(double seconds) {
+    static MOC_solver_t s;
+    // Cadena depósito - uniones - válvula con todos los nodos, que llena la malla
+    MOC_init(&s);
+    int prev = MOC_add_node(&s, MOC_NODE_RESERVOIR, H_RESERVOIR, 0.0f);
+    const int pipes = MOC_MAX_NODES - 1;
+    float reach = WAVE_SPEED * DT;
+    int per_pipe = MOC_MAX_POINTS / pipes - 1;
+    for (int i = 0; i < pipes; i++) {
+        int next = MOC_add_node(&s, i == pipes - 1 ? MOC_NODE_VALVE : MOC_NODE_JUNCTION, 0.0f, 0.0f);
+        MOC_add_pipe(&s, (uint8_t)prev, (uint8_t)next, reach * (float)per_pipe, PIPE_DIAMETER, WAVE_SPEED, 0.02f);
+        prev = next;
+    }
+    if (!MOC_finalize(&s, DT)) {
+        printf("  FALLO: no se pudo construir la red de rendimiento\n");
+        return;
+    }
+    float h = H_RESERVOIR;
+    for (uint8_t i = 0; i < s.pipe_count; i++) {
+        MOC_set_pipe_steady(&s, i, Q0, h);
+        h = MOC_head(&s, i, s.pipes[i].reaches);
+    }
+    MOC_set_valve_steady(&s, (uint8_t)prev, Q0, h);
+    MOC_set_valve_opening(&s, (uint8_t)prev, 0.0f);
+
+    double t0 = now_s(), dt;
+    uint64_t u0 = s.stats.point_updates, steps = 0;
+    do {
+        for (int k = 0; k < 64; k++) MOC_step(&s, 0);
+        steps += 64;
+        dt = now_s() - t0;
+    } while (dt < seconds);
+    double updates = (double)(s.stats.point_updates - u0);
+    printf("  %u tuberías, %u puntos: %.1f M puntos/s, %.2f us por paso, %.0f veces el tiempo real\n",
+           s.pipe_count, s.point_count, updates / dt / 1e6, dt * 1e6 / (double)steps,
+           (double)steps * s.dt / dt);
+}
+
+int main(int argc, char **argv) {
+    double seconds = 1.0;
+    bool do_check = true, do_bench = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--no-check")) do_check = false;
+        else if (!strcmp(argv[i], "--check-only")) do_bench = false;
+        else {
+            printf("Uso: %s [--seconds S] [--no-check | --check-only]\n", argv[0]);
+            return 2;
+        }
+    }
+    bool ok = true;
+    if (do_check) {
+        printf("Comprobación (cierre instantáneo, L = %.0f m, a = %.0f m/s, Q0 = %.2f m3/s)\n",
+               PIPE_LENGTH, WAVE_SPEED, Q0);
+        ok &= check_joukowsky();
+        ok &= check_friction();
+        ok &= check_partial_steps();
+    }
+    if (do_bench) {
+        printf("Rendimiento de MOC_step\n");
+        bench(seconds);
+    }
+    if (do_check) printf(ok ? "OK\n" : "FALLO\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,316 @@
+// Fuzz y rendimiento en el PC del decodificador SensorFrame_AIoT.
+//
+// 1. Comprobación: genera tramas de varios nodos con SensorFrame_encode, las
+//    estropea (bytes cambiados, tramas perdidas, basura entre tramas y tramas
+//    cortadas) y las pasa por SensorFrame_poll sobre un anillo UARTn_Ring
+//    alimentado por trozos, como en el equipo. Cada trama entregada debe ser
+//    idéntica a una trama intacta enviada, no debe faltar ninguna intacta y
+//    las tramas perdidas según la secuencia deben cuadrar con las estropeadas.
+// 2. Rendimiento: tramas/s y MB/s del decodificador sobre un buffer plano
+//    (SensorFrame_decode) y sobre el anillo (SensorFrame_poll), sin errores y
+//    con el porcentaje de corrupción indicado.
+//
+// Termina con código 1 ante cualquier diferencia.
+
+#include "SensorFrame_AIoT.h"
+#include "UARTn_Ring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// UARTn_peek / UARTn_consume sobre un anillo en memoria (sin driver)
+// -----------------------------------------------------------------------------
+
+struct UARTn_Instance {
+    UARTn_Ring ring;
+};
+
+extern "C" size_t UARTn_peek(UARTn_handle_t handle, const uint8_t **p1, size_t *n1,
+                             const uint8_t **p2, size_t *n2) {
+    return handle->ring.peek(p1, n1, p2, n2);
+}
+
+extern "C" void UARTn_consume(UARTn_handle_t handle, size_t len) {
+    handle->ring.consume(len);
+}
+
+static uint32_t g_rng = 2024;
+static uint32_t rnd(uint32_t n) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return (g_rng >> 8) % n;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#define NODES 8
+
+// Trama enviada y lo que se le hizo por el camino
+struct Sent {
+    uint8_t node;
+    uint16_t seq;
+    size_t offset;      // Posición en el flujo (si se envió)
+    size_t len;
+    bool intact;
+    bool received;
+};
+
+struct Stream {
+    std::vector<uint8_t> bytes;
+    std::vector<Sent> frames;
+    unsigned flipped = 0, dropped = 0, truncated = 0, garbage = 0;
+};
+
+// Genera 'count' tramas; 'corrupt_pct' de ellas sufren algún daño
+static void build_stream(Stream& s, unsigned count, unsigned corrupt_pct) {
+    uint16_t seq[NODES] = {0};
+    int16_t samples[SFRAME_MAX_CHANNELS * SFRAME_MAX_SAMPLES];
+    uint8_t frame[SFRAME_MAX_FRAME_LEN];
+    s.bytes.clear();
+    s.frames.clear();
+    for (unsigned i = 0; i < count; i++) {
+        uint8_t node = (uint8_t)rnd(NODES);
+        // Casi siempre 16 canales x 16 muestras (el caso del equipo); a veces otros tamaños
+        uint16_t mask = rnd(4) ? 0xFFFF : (uint16_t)(1 + rnd(0xFFFF));
+        uint8_t spc = rnd(4) ? 16 : (uint8_t)(1 + rnd(SFRAME_MAX_SAMPLES));
+        size_t count_samples = (size_t)__builtin_popcount(mask) * spc;
+        for (size_t k = 0; k < count_samples; k++) samples[k] = (int16_t)(rnd(65536) - 32768);
+        size_t len = SensorFrame_encode(frame, sizeof(frame), node, seq[node]++, mask, spc, i * 1000u, samples);
+
+        Sent f = { node, (uint16_t)(seq[node] - 1), s.bytes.size(), len, true, false };
+        if (rnd(100) < corrupt_pct) {
+            switch (rnd(4)) {
+            case 0:     // Byte cambiado (cabecera, datos o CRC)
+                frame[rnd((uint32_t)len)] ^= (uint8_t)(1 + rnd(255));
+                f.intact = false;
+                s.flipped++;
+                break;
+            case 1:     // Trama perdida
+                f.intact = false;
+                f.len = 0;
+                s.dropped++;
+                break;
+            case 2:     // Trama cortada (el nodo se reinició a mitad)
+                f.len = 1 + rnd((uint32_t)len - 1);
+                f.intact = false;
+                s.truncated++;
+                break;
+            default: {  // Basura antes de la trama (a veces con un sync falso)
+                unsigned n = 1 + rnd(40);
+                for (unsigned k = 0; k < n; k++) s.bytes.push_back((uint8_t)rnd(256));
+                if (rnd(2)) {
+                    s.bytes.push_back(SFRAME_SYNC0);
+                    s.bytes.push_back(SFRAME_SYNC1);
+                }
+                f.offset = s.bytes.size();
+                s.garbage++;
+                break;
+            }
+            }
+        }
+        s.bytes.insert(s.bytes.end(), frame, frame + f.len);
+        s.frames.push_back(f);
+    }
+}
+
+// Tramas perdidas que el decodificador puede ver: las no intactas de un nodo
+// seguidas más tarde por una intacta del mismo nodo
+static void expected_losses(const Stream& s, uint32_t* lost, uint32_t* events) {
+    *lost = 0;
+    *events = 0;
+    for (unsigned node = 0; node < NODES; node++) {
+        bool seen = false;
+        uint32_t pending = 0;
+        for (const Sent& f : s.frames) {
+            if (f.node != node) continue;
+            if (!f.intact) {
+                pending++;
+                continue;
+            }
+            if (seen && pending) {
+                *lost += pending;
+                (*events)++;
+            }
+            seen = true;
+            pending = 0;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Comprobación
+// -----------------------------------------------------------------------------
+
+static bool check(unsigned count, unsigned corrupt_pct, size_t ring_size) {
+    Stream s;
+    build_stream(s, count, corrupt_pct);
+
+    std::vector<uint8_t> storage(ring_size);
+    UARTn_Instance uart;
+    uart.ring.attach(storage.data(), ring_size);
+    static SensorFrame_decoder_t dec;
+    SensorFrame_decoder_init(&dec);
+
+    // Tramas intactas por (nodo, seq) en orden de envío
+    size_t next_intact = 0;
+    unsigned errors = 0, unexpected = 0;
+    size_t fed = 0;
+    SensorFrame_view_t view;
+    while (fed < s.bytes.size()) {
+        size_t chunk = 1 + rnd(120);
+        if (chunk > s.bytes.size() - fed) chunk = s.bytes.size() - fed;
+        fed += uart.ring.write(&s.bytes[fed], chunk);
+        while (SensorFrame_poll(&dec, &uart, &view)) {
+            while (next_intact < s.frames.size() && !s.frames[next_intact].intact) next_intact++;
+            if (next_intact == s.frames.size()) {
+                unexpected++;
+                continue;
+            }
+            Sent& f = s.frames[next_intact];
+            const uint8_t* sent = &s.bytes[f.offset];
+            if (view.node != f.node || view.seq != f.seq || view.frame_len != f.len ||
+                memcmp(view.payload, sent + SFRAME_HEADER_LEN, f.len - SFRAME_HEADER_LEN - SFRAME_CRC_LEN) != 0) {
+                // Una trama falsa (CRC casual sobre bytes estropeados) no avanza la lista
+                if (view.frame_len != f.len || view.seq != f.seq) {
+                    unexpected++;
+                    continue;
+                }
+                if (errors++ < 10) printf("  FALLO: trama %zu (nodo %u seq %u) con datos distintos\n",
+                                          next_intact, f.node, f.seq);
+            }
+            f.received = true;
+            next_intact++;
+        }
+    }
+    SensorFrame_release(&dec);
+
+    unsigned intact = 0, missing = 0;
+    for (const Sent& f : s.frames) {
+        if (!f.intact) continue;
+        intact++;
+        if (!f.received) {
+            if (missing++ < 10) printf("  FALLO: falta la trama nodo %u seq %u\n", f.node, f.seq);
+        }
+    }
+    uint32_t lost, events;
+    expected_losses(s, &lost, &events);
+    const SensorFrame_stats_t& st = dec.stats;
+
+    printf("  %u tramas, %u%% dañadas (%u bytes cambiados, %u perdidas, %u cortadas, %u con basura)\n",
+           count, corrupt_pct, s.flipped, s.dropped, s.truncated, s.garbage);
+    printf("  ok %u de %u intactas, crc %u, cabecera %u, resync %u bytes, envueltas %u\n",
+           st.frames_ok, intact, st.crc_errors, st.header_errors, st.bytes_skipped, st.wrapped_frames);
+    printf("  secuencia: %u saltos, %u perdidas (esperadas %u y %u)\n",
+           st.seq_gap_events, st.seq_lost_frames, events, lost);
+
+    bool ok = errors == 0 && missing == 0 && unexpected == 0 && st.frames_ok == intact;
+    if (unexpected) printf("  FALLO: %u tramas no enviadas\n", unexpected);
+    if (st.seq_lost_frames != lost || st.seq_gap_events != events) {
+        printf("  FALLO: pérdidas por secuencia no cuadran\n");
+        ok = false;
+    }
+    if (corrupt_pct && (st.crc_errors == 0 || st.bytes_skipped == 0)) {
+        printf("  FALLO: la corrupción no llegó al decodificador\n");
+        ok = false;
+    }
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Rendimiento
+// -----------------------------------------------------------------------------
+
+static void bench(unsigned count, unsigned corrupt_pct, double seconds) {
+    Stream s;
+    build_stream(s, count, corrupt_pct);
+    static SensorFrame_decoder_t dec;
+    SensorFrame_view_t view;
+
+    // Buffer plano: el caso sin wrap (vista directa)
+    uint64_t frames = 0, bytes = 0;
+    double t0 = now_s(), dt;
+    do {
+        SensorFrame_decoder_init(&dec);
+        size_t pos = 0;
+        while (pos < s.bytes.size()) {
+            size_t skip, frame_len;
+            bool ok = SensorFrame_decode(&dec, &s.bytes[pos], s.bytes.size() - pos, NULL, 0,
+                                         &view, &skip, &frame_len);
+            pos += skip + frame_len;
+            if (!ok) break;
+            frames++;
+        }
+        bytes += s.bytes.size();
+        dt = now_s() - t0;
+    } while (dt < seconds);
+    printf("  %-7s %3u%% %12.0f %9.1f %9.2f\n", "plano", corrupt_pct, frames / dt, bytes / dt / 1e6,
+           dt * 1e9 / (double)frames);
+
+    // Anillo de 4 KiB alimentado en trozos de hasta 120 bytes
+    std::vector<uint8_t> storage(4096);
+    UARTn_Instance uart;
+    frames = 0;
+    bytes = 0;
+    t0 = now_s();
+    do {
+        uart.ring.attach(storage.data(), storage.size());
+        SensorFrame_decoder_init(&dec);
+        size_t fed = 0;
+        while (fed < s.bytes.size()) {
+            size_t chunk = 1 + rnd(120);
+            if (chunk > s.bytes.size() - fed) chunk = s.bytes.size() - fed;
+            fed += uart.ring.write(&s.bytes[fed], chunk);
+            while (SensorFrame_poll(&dec, &uart, &view)) frames++;
+        }
+        SensorFrame_release(&dec);
+        bytes += s.bytes.size();
+        dt = now_s() - t0;
+    } while (dt < seconds);
+    printf("  %-7s %3u%% %12.0f %9.1f %9.2f   (resync %u, crc %u, perdidas %u)\n", "anillo", corrupt_pct,
+           frames / dt, bytes / dt / 1e6, dt * 1e9 / (double)frames,
+           dec.stats.bytes_skipped, dec.stats.crc_errors, dec.stats.seq_lost_frames);
+}
+
+int main(int argc, char** argv) {
+    unsigned frames = 20000, corrupt = 5;
+    double seconds = 0.5;
+    bool do_check = true, do_bench = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = (unsigned)strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "--corrupt") && i + 1 < argc) corrupt = (unsigned)strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--no-check")) do_check = false;
+        else if (!strcmp(argv[i], "--check-only")) do_bench = false;
+        else {
+            printf("Uso: %s [--frames N] [--corrupt %%] [--seconds S] [--no-check | --check-only]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (corrupt > 100) corrupt = 100;
+
+    bool ok = true;
+    if (do_check) {
+        printf("Comprobación\n");
+        ok &= check(frames, 0, 4096);
+        ok &= check(frames, corrupt, 4096);
+        ok &= check(frames, 50, 4096);
+    }
+    if (do_bench) {
+        printf("\nRendimiento: %u tramas, %.1f s por caso\n", frames, seconds);
+        printf("  %-7s %4s %12s %9s %9s\n", "fuente", "daño", "tramas/s", "MB/s", "ns/trama");
+        bench(frames, 0, seconds);
+        bench(frames, corrupt, seconds);
+    }
+    if (!ok) {
+        printf("FALLO\n");
+        return 1;
+    }
+    if (do_check) printf("OK\n");
+    return 0;
+}
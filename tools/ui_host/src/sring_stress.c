@@ -0,0 +1,217 @@
+// Prueba de estrés en el PC de SampleRing_AIoT con hilos reales (pthreads).
+//
+// Un productor (como la tarea de adquisición) publica bloques cuyo contenido
+// se deriva de su secuencia y tres consumidores los leen en su lugar:
+//   - rápido:  lee sin pausas
+//   - lento:   se duerme de vez en cuando y hace que el anillo se llene
+//   - pausado: se desactiva y se reactiva (como la UI con la pantalla apagada)
+// Se comprueba:
+//   - orden: cada consumidor ve secuencias consecutivas (salvo el salto
+//     esperado al reactivarse, que solo puede ir hacia delante)
+//   - sin desgarro: el bloque leído no cambia mientras se tiene (se verifica
+//     entero y se relee la cabecera al final)
+//   - overruns: los NULL de SampleRing_acquire que ve el productor coinciden
+//     con stats.overruns y committed + overruns = intentos
+//
+// Termina con código 1 ante cualquier diferencia.
+
+#define _POSIX_C_SOURCE 200809L
+#include "SampleRing_AIoT.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+enum { C_FAST, C_SLOW, C_PAUSED, C_COUNT };
+static const char *const NAMES[C_COUNT] = { "rápido", "lento", "pausado" };
+
+typedef struct {
+    int id;
+    int kind;
+    uint32_t blocks;        // Bloques leídos
+    uint32_t jumps;         // Saltos de secuencia tras reactivarse
+    uint32_t pauses;
+    uint32_t order_errors;
+    uint32_t tear_errors;
+} consumer_t;
+
+static SampleRing_t *g_ring;
+static uint32_t g_total;
+static atomic_bool g_done;
+
+static int16_t pattern(uint32_t seq, int ch, int i) {
+    return (int16_t)(seq * 2654435761u + (uint32_t)ch * 97u + (uint32_t)i * 7u);
+}
+
+static void fill_block(SampleRing_block_t *b, uint32_t seq) {
+    b->timestamp_us = (int64_t)seq * 64000;
+    b->sample_period_us = 1000;
+    b->node_time_us = seq ^ 0xA5A5A5A5u;
+    b->channel_mask = (uint16_t)(seq | 1);
+    b->node = (uint8_t)seq;
+    b->count = SRING_BLOCK_SAMPLES;
+    for (int ch = 0; ch < SRING_CHANNELS; ch++) {
+        for (int i = 0; i < SRING_BLOCK_SAMPLES; i++) b->data[ch][i] = pattern(seq, ch, i);
+    }
+}
+
+static bool block_ok(const SampleRing_block_t *b) {
+    uint32_t seq = b->seq;
+    if (b->node_time_us != (seq ^ 0xA5A5A5A5u) || b->node != (uint8_t)seq ||
+        b->channel_mask != (uint16_t)(seq | 1) || b->timestamp_us != (int64_t)seq * 64000) return false;
+    for (int ch = 0; ch < SRING_CHANNELS; ch++) {
+        for (int i = 0; i < SRING_BLOCK_SAMPLES; i++) {
+            if (b->data[ch][i] != pattern(seq, ch, i)) return false;
+        }
+    }
+    // Si el productor lo pisó mientras lo leíamos, la cabecera ya no cuadra
+    return b->seq == seq && b->node_time_us == (seq ^ 0xA5A5A5A5u);
+}
+
+static void sleep_us(long us) {
+    struct timespec ts = { 0, us * 1000 };
+    nanosleep(&ts, NULL);
+}
+
+static void *consumer_thread(void *arg) {
+    consumer_t *c = arg;
+    bool have_last = false;
+    uint32_t last = 0;
+    bool resumed = false;
+    for (;;) {
+        const SampleRing_block_t *b = SampleRing_peek(g_ring, c->id);
+        if (!b) {
+            if (atomic_load(&g_done) && !SampleRing_peek(g_ring, c->id)) break;
+            sched_yield();
+            continue;
+        }
+        uint32_t seq = b->seq;
+        if (have_last) {
+            if (resumed ? (int32_t)(seq - last) <= 0 : seq != last + 1) {
+                if (c->order_errors++ < 5) printf("  FALLO %s: secuencia %u tras %u\n", NAMES[c->kind], seq, last);
+            } else if (resumed && seq != last + 1) {
+                c->jumps++;
+            }
+        }
+        if (!block_ok(b)) {
+            if (c->tear_errors++ < 5) printf("  FALLO %s: bloque %u desgarrado\n", NAMES[c->kind], seq);
+        }
+        SampleRing_release(g_ring, c->id);
+        last = seq;
+        have_last = true;
+        resumed = false;
+        c->blocks++;
+        if (seq == g_total - 1) break;
+
+        if (c->kind == C_SLOW && (c->blocks & 63) == 0) {
+            sleep_us(200);
+        } else if (c->kind == C_PAUSED && (c->blocks % 1000) == 0) {
+            SampleRing_set_consumer_active(g_ring, c->id, false);
+            sleep_us(500);
+            SampleRing_set_consumer_active(g_ring, c->id, true);
+            c->pauses++;
+            resumed = true;
+        }
+    }
+    return NULL;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool run(uint32_t capacity, uint32_t total) {
+    g_ring = SampleRing_create(capacity);
+    if (!g_ring) return false;
+    g_total = total;
+    atomic_store(&g_done, false);
+
+    consumer_t cons[C_COUNT];
+    pthread_t threads[C_COUNT];
+    memset(cons, 0, sizeof(cons));
+    for (int k = 0; k < C_COUNT; k++) {
+        cons[k].kind = k;
+        cons[k].id = SampleRing_register_consumer(g_ring, NAMES[k]);
+    }
+    for (int k = 0; k < C_COUNT; k++) pthread_create(&threads[k], NULL, consumer_thread, &cons[k]);
+
+    // Productor en este hilo: nunca bloquea, reintenta el mismo bloque
+    uint32_t attempts = 0, refused = 0, seq = 0;
+    double t0 = now_s();
+    while (seq < total) {
+        attempts++;
+        SampleRing_block_t *b = SampleRing_acquire(g_ring);
+        if (!b) {
+            refused++;
+            sched_yield();
+            continue;
+        }
+        fill_block(b, seq);
+        SampleRing_commit(g_ring);
+        seq++;
+    }
+    atomic_store(&g_done, true);
+    for (int k = 0; k < C_COUNT; k++) pthread_join(threads[k], NULL);
+    double dt = now_s() - t0;
+
+    SampleRing_stats_t st;
+    SampleRing_get_stats(g_ring, &st);
+    bool ok = true;
+    printf("  capacidad %u: %u bloques en %.2f s (%.0f bloques/s), %u overruns, máx %u\n",
+           st.capacity, st.committed, dt, st.committed / dt, st.overruns, st.high_water);
+    if (st.committed != total || st.overruns != refused || st.committed + st.overruns != attempts) {
+        printf("  FALLO: committed %u, overruns %u, rechazos vistos %u, intentos %u\n",
+               st.committed, st.overruns, refused, attempts);
+        ok = false;
+    }
+    if (st.high_water > st.capacity) {
+        printf("  FALLO: ocupación máxima %u > capacidad\n", st.high_water);
+        ok = false;
+    }
+    if (refused == 0) {
+        printf("  FALLO: el consumidor lento nunca llenó el anillo\n");
+        ok = false;
+    }
+    for (int k = 0; k < C_COUNT; k++) {
+        SampleRing_consumer_stats_t cs;
+        SampleRing_get_consumer_stats(g_ring, cons[k].id, &cs);
+        printf("    %-8s %8u bloques, retraso máx %3u, %u pausas, %u saltos\n",
+               NAMES[k], cs.consumed, cs.lag_high_water, cons[k].pauses, cons[k].jumps);
+        if (cons[k].order_errors || cons[k].tear_errors) ok = false;
+        if (cs.consumed != cons[k].blocks || cs.resyncs != cons[k].pauses || cs.lag_high_water > st.capacity) {
+            printf("  FALLO %s: consumed %u / %u, resyncs %u / %u\n", NAMES[k],
+                   cs.consumed, cons[k].blocks, cs.resyncs, cons[k].pauses);
+            ok = false;
+        }
+        // Los que nunca se pausan ven todos los bloques publicados
+        if (k != C_PAUSED && cs.consumed != total) {
+            printf("  FALLO %s: %u de %u bloques\n", NAMES[k], cs.consumed, total);
+            ok = false;
+        }
+    }
+    SampleRing_destroy(g_ring);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    uint32_t total = 100000;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--blocks") && i + 1 < argc) total = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else {
+            printf("Uso: %s [--blocks N]\n", argv[0]);
+            return 2;
+        }
+    }
+    bool ok = true;
+    printf("Productor + 3 consumidores, %u bloques de %u bytes\n", total, (unsigned)sizeof(SampleRing_block_t));
+    ok &= run(4, total);
+    ok &= run(64, total);
+    printf(ok ? "OK\n" : "FALLO\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+// Reproduce en el PC trazas del táctil XPT2046 a través de Touch_Filter_AIoT.
+//
+// Entrada: el log de la consola del equipo compilado con XPT2046_TRACE = 1
+// (se usan solo las líneas que contienen "XPT,"):
+//     XPT,z1,z2,x0,...,xN-1,y0,...,yN-1     una muestra
+//     XPT,UP                                lápiz levantado
+//
+// Salida: contadores del filtro y temblor por pulsación (media de |salto|
+// entre puntos consecutivos, en píxeles) de la conversión original (media de
+// las N conversiones) frente a la del filtro. Con --csv, un punto por línea.
+
+#include "Touch_Filter_AIoT.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define H_RES 480
+#define V_RES 272
+
+typedef struct {
+    bool have;
+    Touch_point_t last;
+    uint64_t sum;                           // Suma de |dx| + |dy| (píxeles)
+    uint32_t steps;
+} jitter_t;
+
+static void jitter_add(jitter_t *j, Touch_point_t p) {
+    if (j->have) {
+        j->sum += (uint64_t)(labs(p.x - j->last.x) + labs(p.y - j->last.y));
+        j->steps++;
+    }
+    j->last = p;
+    j->have = true;
+}
+
+static bool parse_sample(const char *s, Touch_raw_t *raw, int n) {
+    unsigned v[2 + 2 * TFILT_MAX_SAMPLES];
+    int count = 2 + 2 * n;
+    for (int i = 0; i < count; i++) {
+        char *end;
+        v[i] = (unsigned)strtoul(s, &end, 10);
+        if (end == s) return false;
+        s = end;
+        if (i + 1 < count) {
+            if (*s != ',') return false;
+            s++;
+        }
+    }
+    raw->n = (uint8_t)n;
+    raw->z1 = (uint16_t)v[0];
+    raw->z2 = (uint16_t)v[1];
+    for (int i = 0; i < n; i++) {
+        raw->x[i] = (uint16_t)v[2 + i];
+        raw->y[i] = (uint16_t)v[2 + n + i];
+    }
+    return true;
+}
+
+// Conversiones por muestra deducidas del número de campos de la línea
+static int fields_to_samples(const char *s) {
+    int commas = 0;
+    for (; *s && *s != '\n' && *s != '\r'; s++) {
+        if (*s == ',') commas++;
+    }
+    int n = (commas + 1 - 2) / 2;
+    return (n >= 1 && n <= TFILT_MAX_SAMPLES && commas + 1 == 2 + 2 * n) ? n : 0;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "Uso: %s [opciones] traza.log\n"
+            "  --csv            un punto por línea: raw_x,raw_y,x,y,media_x,media_y\n"
+            "  --z N            umbral de presión (por defecto 350)\n"
+            "  --spread N       rango intercuartil máximo (por defecto 48)\n"
+            "  --alpha-min N    alfa del IIR en reposo, /256 (por defecto 48)\n"
+            "  --alpha-gain N   alfa por cuenta de salto, /256 (por defecto 4)\n"
+            "  --cal a,b,c,d,e,f  matriz Q16 (la del log de Touch_Calib)\n",
+            argv0);
+}
+
+int main(int argc, char **argv) {
+    Touch_filter_config_t cfg = TOUCH_FILTER_CONFIG_DEFAULT();
+    Touch_calib_t cal;
+    Touch_calib_default(&cal, H_RES, V_RES);
+    Touch_calib_t cal_default = cal;
+    bool csv = false;
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!strcmp(a, "--csv")) {
+            csv = true;
+        } else if (!strcmp(a, "--z") && val) {
+            cfg.z_threshold = (uint16_t)atoi(val); i++;
+        } else if (!strcmp(a, "--spread") && val) {
+            cfg.spread_max = (uint16_t)atoi(val); i++;
+        } else if (!strcmp(a, "--alpha-min") && val) {
+            cfg.alpha_min_q8 = (uint8_t)atoi(val); i++;
+        } else if (!strcmp(a, "--alpha-gain") && val) {
+            cfg.alpha_gain_q8 = (uint8_t)atoi(val); i++;
+        } else if (!strcmp(a, "--cal") && val) {
+            long m[6];
+            if (sscanf(val, "%ld,%ld,%ld,%ld,%ld,%ld", &m[0], &m[1], &m[2], &m[3], &m[4], &m[5]) != 6) {
+                usage(argv[0]);
+                return 2;
+            }
+            cal = (Touch_calib_t){ (int32_t)m[0], (int32_t)m[1], (int32_t)m[2],
+                                   (int32_t)m[3], (int32_t)m[4], (int32_t)m[5] };
+            i++;
+        } else if (a[0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            path = a;
+        }
+    }
+    if (!path) {
+        usage(argv[0]);
+        return 2;
+    }
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+
+    Touch_filter_t flt;
+    Touch_filter_init(&flt, &cfg);
+    jitter_t j_old = { 0 }, j_new = { 0 };
+    uint32_t strokes = 0, lines = 0, bad = 0;
+    bool in_stroke = false;
+    char line[512];
+
+    if (csv) printf("raw_x,raw_y,x,y,media_x,media_y\n");
+    while (fgets(line, sizeof(line), f)) {
+        const char *p = strstr(line, "XPT,");
+        if (!p) continue;
+        p += 4;
+        if (!strncmp(p, "UP", 2)) {
+            Touch_filter_reset(&flt);
+            if (in_stroke) strokes++;
+            in_stroke = false;
+            j_old.have = j_new.have = false;
+            continue;
+        }
+        lines++;
+        Touch_raw_t raw;
+        int n = fields_to_samples(p);
+        if (!n || !parse_sample(p, &raw, n)) {
+            bad++;
+            continue;
+        }
+        in_stroke = true;
+
+        // Conversión original: media de las N conversiones y recta fija
+        Touch_point_t avg = { 0, 0 };
+        for (int i = 0; i < n; i++) {
+            avg.x += raw.x[i];
+            avg.y += raw.y[i];
+        }
+        avg.x /= n;
+        avg.y /= n;
+        Touch_point_t old = Touch_calib_apply(&cal_default, avg, H_RES, V_RES);
+        jitter_add(&j_old, old);
+
+        Touch_point_t pos;
+        if (!Touch_filter_process(&flt, &raw, &pos)) continue;
+        Touch_point_t scr = Touch_calib_apply(&cal, pos, H_RES, V_RES);
+        jitter_add(&j_new, scr);
+        if (csv) {
+            printf("%ld,%ld,%ld,%ld,%ld,%ld\n", (long)pos.x, (long)pos.y, (long)scr.x, (long)scr.y,
+                   (long)old.x, (long)old.y);
+        }
+    }
+    fclose(f);
+    if (in_stroke) strokes++;
+
+    FILE *out = csv ? stderr : stdout;
+    fprintf(out, "muestras %u (mal formadas %u), pulsaciones %u\n", lines, bad, strokes);
+    fprintf(out, "filtro: aceptadas %u, presión baja %u, ruido %u\n", flt.stats.accepted,
+            flt.stats.low_pressure, flt.stats.noisy);
+    fprintf(out, "temblor medio (px/muestra): original %.2f, filtro %.2f\n",
+            j_old.steps ? (double)j_old.sum / j_old.steps : 0.0,
+            j_new.steps ? (double)j_new.sum / j_new.steps : 0.0);
+    return 0;
+}
@@ -0,0 +1,388 @@
+// Prueba en el PC del motor de recepción de UARTn_AIoT (UARTn_Ring).
+//
+// Alimenta el anillo con trozos de tamaño aleatorio, como los entrega el
+// driver (eventos UART_DATA de 1 a 120 bytes), y comprueba:
+//   - readLine: líneas completas (también a través del wrap), líneas vacías,
+//     líneas más largas que el buffer del usuario (por trozos) y entrega sin
+//     terminador solo en modo raw.
+//   - read / peek / consume: bytes crudos en orden.
+//   - desbordamiento: con el anillo lleno write() acepta menos bytes (el resto
+//     espera en el driver) y no se pierde ni se corrompe nada.
+//   - un productor y un consumidor en hilos distintos (como la tarea de
+//     eventos y la aplicación).
+//   - parada y reanudación entre hilos (pump / resumeIfStalled): el productor
+//     se detiene con el anillo lleno y solo sigue con el aviso del consumidor;
+//     un aviso perdido deja el anillo vacío con datos esperando en el driver.
+//
+// Termina con código 1 ante cualquier diferencia.
+
+#include "UARTn_Ring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static unsigned g_fails = 0;
+
+#define EXPECT(cond, ...)                                                   \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            if (g_fails++ < 20) {                                           \
+                printf("  FALLO %s:%d: ", __func__, __LINE__);              \
+                printf(__VA_ARGS__);                                        \
+                printf("\n");                                               \
+            }                                                               \
+        }                                                                   \
+    } while (0)
+
+static uint32_t g_rng = 12345;
+static uint32_t rnd(uint32_t n) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return (g_rng >> 8) % n;
+}
+
+// Líneas de prueba: longitudes de 0 a max_len, contenido imprimible.
+static std::vector<std::string> make_lines(unsigned count, unsigned max_len) {
+    std::vector<std::string> lines;
+    for (unsigned i = 0; i < count; i++) {
+        std::string s;
+        unsigned len = (i % 7 == 0) ? 0 : rnd(max_len + 1);
+        for (unsigned k = 0; k < len; k++) s.push_back((char)('!' + rnd(90)));
+        lines.push_back(s);
+    }
+    return lines;
+}
+
+// -----------------------------------------------------------------------------
+// Líneas por trozos (un solo hilo, productor y consumidor alternados)
+// -----------------------------------------------------------------------------
+
+static void test_lines(size_t ring_size, int user_len) {
+    std::vector<uint8_t> storage(ring_size);
+    UARTn_Ring ring;
+    EXPECT(ring.attach(storage.data(), ring_size), "attach(%zu)", ring_size);
+
+    std::vector<std::string> lines = make_lines(3000, (unsigned)user_len * 2);
+    std::string stream;
+    for (const std::string& l : lines) stream += l + "\n";
+
+    std::vector<char> buffer((size_t)user_len);
+    size_t fed = 0, next = 0;
+    std::string partial;
+    unsigned splits = 0, stalls = 0;
+    for (unsigned iter = 0; next < lines.size(); iter++) {
+        if (fed < stream.size()) {
+            size_t chunk = 1 + rnd(120);
+            if (chunk > stream.size() - fed) chunk = stream.size() - fed;
+            size_t took = ring.write((const uint8_t*)stream.data() + fed, chunk);
+            if (took < chunk) stalls++;
+            fed += took;
+        }
+        // El consumidor no siempre llega a tiempo: en una de cada cuatro
+        // rachas de 200 vueltas no lee y el anillo se llena
+        int reads = ((iter / 200) % 4 == 3) ? 0 : (int)rnd(3);
+        for (int r = 0; r < reads && next < lines.size(); r++) {
+            int len;
+            bool split;
+            size_t used = ring.readLine('\n', buffer.data(), user_len, &len, &split, false);
+            if (used == 0) {
+                EXPECT(len == 0 && !split && buffer[0] == '\0', "sin datos con len %d", len);
+                break;
+            }
+            EXPECT((int)strlen(buffer.data()) == len, "len %d y strlen %zu", len, strlen(buffer.data()));
+            partial.append(buffer.data(), (size_t)len);
+            if (split) {
+                splits++;
+                EXPECT(used == (size_t)len && len == user_len - 1, "trozo de %d bytes", len);
+                continue;
+            }
+            EXPECT(used == (size_t)len + 1, "línea de %d bytes consumió %zu", len, used);
+            EXPECT(partial == lines[next], "línea %zu: '%s' != '%s'", next, partial.c_str(), lines[next].c_str());
+            partial.clear();
+            next++;
+        }
+    }
+    EXPECT(ring.available() == 0, "quedan %zu bytes", ring.available());
+    EXPECT(ring.highWater() <= ring_size, "highWater %zu > %zu", ring.highWater(), ring_size);
+    EXPECT(splits > 0, "ninguna línea partida");
+    EXPECT(stalls > 0 || ring_size > stream.size(), "el anillo nunca se llenó");
+    printf("  anillo %5zu, buffer %3d: %zu líneas, %u trozos, %u llenados, máx %zu\n",
+           ring_size, user_len, lines.size(), splits, stalls, ring.highWater());
+}
+
+// -----------------------------------------------------------------------------
+// Casos límite de readLine
+// -----------------------------------------------------------------------------
+
+static void test_edges() {
+    uint8_t storage[16];
+    UARTn_Ring ring;
+    char buf[8];
+    int len;
+    bool split;
+
+    EXPECT(!ring.attach(storage, 12), "attach acepta 12 bytes");
+    EXPECT(ring.attach(storage, sizeof(storage)), "attach(16)");
+
+    // Sin datos: 0 en cualquier modo
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, true) == 0 && len == 0, "vacío raw");
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 0, "vacío");
+
+    // Línea vacía: consume el terminador y se distingue de "sin datos"
+    ring.write((const uint8_t*)"\n\nab\n", 5);
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 1 && len == 0, "línea vacía 1");
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 1 && len == 0, "línea vacía 2");
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 3 && len == 2 && !strcmp(buf, "ab"),
+           "línea 'ab'");
+
+    // Sin terminador: solo el modo raw entrega (y consume) lo pendiente
+    ring.write((const uint8_t*)"xyz", 3);
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 0 && ring.available() == 3,
+           "sin terminador no raw");
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, true) == 3 && len == 3 && !split
+           && !strcmp(buf, "xyz") && ring.available() == 0, "sin terminador raw");
+
+    // El terminador llega después: la búsqueda sigue donde quedó
+    ring.write((const uint8_t*)"12", 2);
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 0, "a medias");
+    ring.write((const uint8_t*)"34\n", 3);
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 5 && !strcmp(buf, "1234"), "completada");
+
+    // Línea exactamente del tamaño del buffer (7 + '\0') y una más larga
+    ring.write((const uint8_t*)"1234567\n12345678\n", 17);
+    EXPECT(ring.available() == 16, "anillo lleno: %zu", ring.available());
+    EXPECT(ring.freeSpace() == 0, "freeSpace %zu", ring.freeSpace());
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 8 && len == 7 && !split, "7 bytes");
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 7 && len == 7 && split, "trozo");
+    EXPECT(ring.available() == 1 && ring.at(0) == '8', "resto '%c'", ring.at(0));
+    ring.write((const uint8_t*)"\n", 1);
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 2 && !strcmp(buf, "8"), "fin del trozo");
+
+    // Sin terminador y más largo que el buffer: se entrega por trozos aun sin raw
+    ring.write((const uint8_t*)"abcdefghij", 10);
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 7 && split, "trozo sin terminador");
+    EXPECT(ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 0, "resto sin terminador");
+    ring.reset();
+    EXPECT(ring.available() == 0, "reset");
+
+    // Buffer de usuario inválido
+    EXPECT(ring.readLine('\n', buf, 1, &len, &split, true) == 0, "max_len 1");
+    EXPECT(ring.readLine('\n', nullptr, 8, &len, &split, true) == 0, "buffer nulo");
+}
+
+// -----------------------------------------------------------------------------
+// Lectura cruda y desbordamiento
+// -----------------------------------------------------------------------------
+
+static void test_raw(size_t ring_size) {
+    std::vector<uint8_t> storage(ring_size);
+    UARTn_Ring ring;
+    ring.attach(storage.data(), ring_size);
+
+    const size_t total = 200000;
+    uint8_t out_seq = 0, in_seq = 0;
+    size_t sent = 0, received = 0, refused = 0;
+    uint8_t chunk[256];
+    for (unsigned iter = 0; received < total; iter++) {
+        if (sent < total) {
+            size_t n = 1 + rnd(sizeof(chunk));
+            if (n > total - sent) n = total - sent;
+            for (size_t i = 0; i < n; i++) chunk[i] = (uint8_t)(out_seq + i);
+            size_t free_before = ring.freeSpace();
+            size_t took = ring.write(chunk, n);
+            EXPECT(took == (n < free_before ? n : free_before), "write %zu con %zu libres aceptó %zu",
+                   n, free_before, took);
+            // Lo rechazado se reintenta, como hace la tarea RX con el driver
+            refused += n - took;
+            out_seq = (uint8_t)(out_seq + took);
+            sent += took;
+        }
+        uint8_t dst[300];
+        size_t n;
+        if ((iter / 200) % 4 == 3 && sent < total) {
+            n = 0;
+        } else if (rnd(2)) {
+            n = ring.read(dst, 1 + rnd(sizeof(dst)));
+        } else {
+            const uint8_t *p1, *p2;
+            size_t n1, n2;
+            size_t avail = ring.peek(&p1, &n1, &p2, &n2);
+            EXPECT(avail == n1 + n2, "peek %zu != %zu + %zu", avail, n1, n2);
+            n = avail < sizeof(dst) ? avail : sizeof(dst);
+            size_t a = n < n1 ? n : n1;
+            memcpy(dst, p1, a);
+            memcpy(dst + a, p2, n - a);
+            ring.consume(n);
+        }
+        for (size_t i = 0; i < n; i++) {
+            EXPECT(dst[i] == in_seq, "byte %zu: %u != %u", received + i, dst[i], in_seq);
+            in_seq++;
+        }
+        received += n;
+    }
+    EXPECT(refused > 0, "el anillo nunca se llenó");
+    EXPECT(ring.highWater() == ring_size, "highWater %zu != %zu", ring.highWater(), ring_size);
+    printf("  anillo %5zu: %zu bytes crudos, %zu rechazados por anillo lleno\n", ring_size, received, refused);
+}
+
+// -----------------------------------------------------------------------------
+// Productor y consumidor en hilos
+// -----------------------------------------------------------------------------
+
+static void test_threads(size_t ring_size) {
+    std::vector<uint8_t> storage(ring_size);
+    UARTn_Ring ring;
+    ring.attach(storage.data(), ring_size);
+
+    std::vector<std::string> lines = make_lines(200000, 40);
+    std::string stream;
+    for (const std::string& l : lines) stream += l + "\n";
+
+    std::thread producer([&] {
+        uint32_t seed = 777;
+        size_t fed = 0;
+        while (fed < stream.size()) {
+            seed = seed * 1664525u + 1013904223u;
+            size_t chunk = 1 + (seed >> 8) % 120;
+            if (chunk > stream.size() - fed) chunk = stream.size() - fed;
+            size_t took = ring.write((const uint8_t*)stream.data() + fed, chunk);
+            if (took == 0) std::this_thread::yield();
+            fed += took;
+        }
+    });
+
+    char buf[64];
+    size_t next = 0;
+    while (next < lines.size()) {
+        int len;
+        bool split;
+        if (ring.readLine('\n', buf, sizeof(buf), &len, &split, false) == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT(!split && lines[next] == buf, "línea %zu: '%s' != '%s'", next, buf, lines[next].c_str());
+        next++;
+    }
+    producer.join();
+    EXPECT(ring.available() == 0, "quedan %zu bytes", ring.available());
+    printf("  anillo %5zu: %zu líneas entre hilos, máx %zu\n", ring_size, lines.size(), ring.highWater());
+}
+
+// -----------------------------------------------------------------------------
+// Parada y reanudación del productor en hilos
+// -----------------------------------------------------------------------------
+
+// El productor hace lo mismo que UARTn_AIoT::pump con todo el flujo ya en el
+// driver y una cola de eventos; el consumidor, lo mismo que UARTn_read tras
+// consumir (resumeIfStalled).
+static void test_stall_resume(size_t ring_size, size_t total) {
+    std::vector<uint8_t> storage(ring_size);
+    UARTn_Ring ring;
+    ring.attach(storage.data(), ring_size);
+
+    std::mutex m;
+    std::condition_variable cv;
+    unsigned events = 1;                        // UART_DATA inicial
+    unsigned stalls = 0, cancelled = 0, lost = 0, wakes = 0;
+    std::atomic<bool> gave_up{false};
+
+    std::thread producer([&] {
+        uint32_t seed = 4242;
+        size_t sent = 0;
+        while (sent < total) {
+            {
+                std::unique_lock<std::mutex> lk(m);
+                while (events == 0) {
+                    if (cv.wait_for(lk, std::chrono::milliseconds(200)) == std::cv_status::timeout &&
+                        events == 0 && ring.available() == 0) {
+                        lost++;                 // Consumidor sin datos y productor sin aviso
+                        gave_up.store(true);
+                        return;
+                    }
+                }
+                events--;
+            }
+            while (sent < total) {
+                uint8_t* dst;
+                size_t span = ring.writeSpan(&dst);
+                if (span == 0) {
+                    // Como si la tarea perdiera la CPU justo aquí (una vez de cada
+                    // dos): el consumidor libera espacio y avisa antes de la marca
+                    if (seed & 0x100) std::this_thread::yield();
+                    span = ring.stall(&dst);
+                    if (span == 0) {
+                        stalls++;
+                        break;
+                    }
+                    cancelled++;
+                }
+                seed = seed * 1664525u + 1013904223u;
+                size_t n = 1 + (seed >> 8) % 120;
+                if (n > span) n = span;
+                if (n > total - sent) n = total - sent;
+                for (size_t i = 0; i < n; i++) dst[i] = (uint8_t)((sent + i) * 7 + ((sent + i) >> 8));
+                ring.commit(n);
+                sent += n;
+            }
+        }
+    });
+
+    uint32_t seed = 99;
+    size_t received = 0, bad = 0;
+    uint8_t buf[97];
+    while (received < total && !gave_up.load()) {
+        seed = seed * 1664525u + 1013904223u;
+        size_t n = ring.read(buf, 1 + (seed >> 8) % sizeof(buf));
+        for (size_t i = 0; i < n; i++, received++) {
+            if (buf[i] != (uint8_t)(received * 7 + (received >> 8))) bad++;
+        }
+        if (n > 0 && ring.resume()) {
+            std::lock_guard<std::mutex> lk(m);
+            events++;
+            wakes++;
+            cv.notify_one();
+        }
+        if (n == 0 || (seed >> 28) == 0) std::this_thread::yield();
+    }
+    producer.join();
+    EXPECT(bad == 0, "%zu bytes cambiados", bad);
+    EXPECT(lost == 0, "aviso perdido tras %zu bytes", received);
+    EXPECT(stalls > 0, "el productor nunca se detuvo");
+    printf("  anillo %5zu: %zu bytes, %u paradas, %u anuladas al volver a mirar, %u avisos\n", ring_size, total,
+           stalls, cancelled, wakes);
+}
+
+int main(int argc, char** argv) {
+    (void)argv;
+    if (argc > 1) {
+        printf("Uso: %s\n", argv[0]);
+        return 2;
+    }
+    printf("Casos límite de readLine\n");
+    test_edges();
+    printf("Líneas por trozos\n");
+    test_lines(64, 16);
+    test_lines(256, 100);
+    test_lines(4096, 256);
+    printf("Lectura cruda y anillo lleno\n");
+    test_raw(64);
+    test_raw(1024);
+    printf("Dos hilos\n");
+    test_threads(128);
+    test_threads(4096);
+    printf("Parada y reanudación del productor\n");
+    test_stall_resume(64, 4000000);
+    test_stall_resume(1024, 16000000);
+
+    if (g_fails) {
+        printf("%u fallos\n", g_fails);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
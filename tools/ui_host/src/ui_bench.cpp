@@ -0,0 +1,765 @@
+// -----------------------------------------------------------------------------
+// Banco de pruebas de la UI en PC (LVGL + EEZ flow sin hardware)
+//
+// Ejecuta la misma vuelta que ui_task (main_AIoT.c) sobre una pantalla en
+// memoria de 480x272 RGB565, con un puntero que sigue un guion de toques y
+// un reloj simulado. Mide con el reloj real del PC:
+//   - lv_timer_handler, ui_tick y ui_update_periodic_task por vuelta
+//   - tiempo de cada refresco (LV_EVENT_REFR_START -> LV_EVENT_REFR_READY)
+//   - profundidad de la cola de EEZ flow
+//   - heap de LVGL (lv_mem_monitor) y heap_caps (PSRAM / interna)
+//   - latencia toque -> redibujo por flanco (Input_Rec_AIoT), con el guion o
+//     reproduciendo una traza grabada en el equipo
+//   - con --eval, evaluaciones/s de las expresiones de ui.c con el intérprete
+//     original y con el código pre-decodificado (eez_flow_eval.inc)
+// -----------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "lvgl.h"
+#include "ui.h"
+#include "screens.h"
+#include "images.h"
+#include "eez-flow.h"
+
+#include "Host_Platform_AIoT.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "Asset_Cache_AIoT.h"
+#include "Draw_Accel_AIoT.h"
+#include "Input_Rec_AIoT.h"
+#include "SampleRing_AIoT.h"
+#include "Waveform_AIoT.h"
+
+extern "C" void ui_update_periodic_task(void);
+extern "C" void ui_waveform_attach(SampleRing_t *ring);
+
+// components/EEZ_AIoT/src/eez_flow_eval.inc (EEZ_FLOW_EVAL_BENCH)
+namespace eez {
+namespace flow {
+extern bool g_evalThreaded;
+void getEvalInfo(uint32_t &programs, uint32_t &ops, uint32_t &bytes);
+bool evalExpressionForBench(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result,
+                            int *numInstructionBytes);
+}
+}
+
+#define HOR_RES                 480
+#define VER_RES                 272
+#define UI_MAX_DELAY_MS         10      // Igual que ui_task
+#define TAP_HOLD_MS             80      // Duración de un "tap"
+#define WAVE_RING_BLOCKS        64      // ACQ_RING_BLOCKS
+#define WAVE_SAMPLE_PERIOD_US   1000    // ACQ_SAMPLE_PERIOD_US
+
+static const char *TAG = "ui_bench";
+
+// -----------------------------------------------------------------------------
+// Opciones
+// -----------------------------------------------------------------------------
+
+struct Options {
+    const char *script = NULL;
+    const char *csv = NULL;
+    const char *dump = NULL;
+    const char *record = NULL;
+    const char *replay = NULL;
+    lv_display_render_mode_t mode = LV_DISPLAY_RENDER_MODE_DIRECT;
+    uint32_t partial_lines = 40;
+    uint32_t repeat = 1;
+    uint32_t wave_hz = 1000000 / WAVE_SAMPLE_PERIOD_US;
+    uint32_t idle_ms = 0;
+    uint32_t eval_ms = 0;
+    bool accel = true;
+    bool cache = true;
+    bool realtime = false;
+};
+
+static void usage(const char *prog) {
+    printf("Uso: %s [opciones] [guion.txt]\n"
+           "  --mode direct|full|partial  Modo de render (por defecto direct, como el panel RGB)\n"
+           "  --lines N                   Líneas del búfer en modo partial (40)\n"
+           "  --repeat N                  Repite el guion N veces\n"
+           "  --idle MS                   Tiempo simulado sin tocar al final\n"
+           "  --eval MS                   Al final, mide el evaluador de expresiones EEZ (MS por modo)\n"
+           "  --wave-hz HZ                Muestras sintéticas para el osciloscopio (0 = sin pestaña)\n"
+           "  --no-accel                  Sin los núcleos RGB565 de Draw_Accel_AIoT\n"
+           "  --no-cache                  Sin la caché de imágenes RGB565\n"
+           "  --realtime                  Espera el tiempo simulado (para mirar con un visor)\n"
+           "  --csv FICHERO               Una fila por vuelta del bucle\n"
+           "  --dump FICHERO.ppm          Último fotograma\n"
+           "  --record FICHERO            Graba la entrada del guion (líneas INREC)\n"
+           "  --replay FICHERO            Reproduce una traza INREC (log del equipo o --record)\n"
+           "  --verbose                   Muestra ESP_LOGI/ESP_LOGD\n", prog);
+}
+
+static bool parse_args(int argc, char **argv, Options *o) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool has_val = i + 1 < argc;
+        if (a == "--mode" && has_val) {
+            std::string m = argv[++i];
+            if (m == "direct") o->mode = LV_DISPLAY_RENDER_MODE_DIRECT;
+            else if (m == "full") o->mode = LV_DISPLAY_RENDER_MODE_FULL;
+            else if (m == "partial") o->mode = LV_DISPLAY_RENDER_MODE_PARTIAL;
+            else return false;
+        } else if (a == "--lines" && has_val) {
+            o->partial_lines = (uint32_t)strtoul(argv[++i], NULL, 0);
+            if (o->partial_lines == 0 || o->partial_lines > VER_RES) return false;
+        } else if (a == "--repeat" && has_val) {
+            o->repeat = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (a == "--idle" && has_val) {
+            o->idle_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (a == "--eval" && has_val) {
+            o->eval_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (a == "--wave-hz" && has_val) {
+            o->wave_hz = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (a == "--csv" && has_val) {
+            o->csv = argv[++i];
+        } else if (a == "--dump" && has_val) {
+            o->dump = argv[++i];
+        } else if (a == "--record" && has_val) {
+            o->record = argv[++i];
+        } else if (a == "--replay" && has_val) {
+            o->replay = argv[++i];
+        } else if (a == "--no-accel") {
+            o->accel = false;
+        } else if (a == "--no-cache") {
+            o->cache = false;
+        } else if (a == "--realtime") {
+            o->realtime = true;
+        } else if (a == "--verbose") {
+            host_set_verbose(true);
+        } else if (a[0] != '-' && !o->script) {
+            o->script = argv[i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Guion de toques
+//
+//   wait MS                      avanza el reloj sin tocar
+//   tap X Y | tap_obj NOMBRE     pulsación corta en un punto o en el centro
+//                                de un objeto de EEZ (nombre de screens.h)
+//   press X Y | move X Y | release
+//   drag X1 Y1 X2 Y2 MS          arrastre lineal
+//   wifi_connect SSID | wifi_off
+//   scan_result SSID1,SSID2,...  lista que devolverá el próximo escaneo
+// -----------------------------------------------------------------------------
+
+enum CmdType { CMD_WAIT, CMD_TAP, CMD_TAP_OBJ, CMD_PRESS, CMD_MOVE, CMD_RELEASE, CMD_DRAG,
+               CMD_WIFI_ON, CMD_WIFI_OFF, CMD_SCAN_RESULT };
+
+struct Cmd {
+    CmdType type;
+    int32_t a[5];
+    std::string text;
+    int line;
+};
+
+static bool load_script(const char *path, std::vector<Cmd> *cmds) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        ESP_LOGE(TAG, "No se puede abrir %s", path);
+        return false;
+    }
+    char buf[256];
+    int line = 0;
+    bool ok = true;
+    while (fgets(buf, sizeof(buf), f)) {
+        line++;
+        char *hash = strchr(buf, '#');
+        if (hash) *hash = '\0';
+        char op[32], arg[200] = "";
+        int32_t v[5] = {0};
+        int n = sscanf(buf, "%31s", op);
+        if (n != 1) continue;
+
+        Cmd c = {};
+        c.line = line;
+        const char *rest = buf + strspn(buf, " \t") + strlen(op);
+        int nv = sscanf(rest, "%d %d %d %d %d", &v[0], &v[1], &v[2], &v[3], &v[4]);
+        int want = -1;
+        std::string o = op;
+        if (o == "wait") { c.type = CMD_WAIT; want = 1; }
+        else if (o == "tap") { c.type = CMD_TAP; want = 2; }
+        else if (o == "press") { c.type = CMD_PRESS; want = 2; }
+        else if (o == "move") { c.type = CMD_MOVE; want = 2; }
+        else if (o == "release") { c.type = CMD_RELEASE; want = 0; }
+        else if (o == "drag") { c.type = CMD_DRAG; want = 5; }
+        else if (o == "wifi_off") { c.type = CMD_WIFI_OFF; want = 0; }
+        else if (o == "tap_obj" || o == "wifi_connect" || o == "scan_result") {
+            c.type = o == "tap_obj" ? CMD_TAP_OBJ : o == "wifi_connect" ? CMD_WIFI_ON : CMD_SCAN_RESULT;
+            want = sscanf(rest, "%199s", arg) == 1 ? 0 : 1;
+            nv = 0;
+            c.text = arg;
+            if (c.type == CMD_SCAN_RESULT) std::replace(c.text.begin(), c.text.end(), ',', '\n');
+        }
+        if (want < 0 || (want > 0 && nv < want)) {
+            ESP_LOGE(TAG, "%s:%d: orden no válida: %s", path, line, op);
+            ok = false;
+            continue;
+        }
+        memcpy(c.a, v, sizeof(v));
+        cmds->push_back(c);
+    }
+    fclose(f);
+    return ok;
+}
+
+// Resuelve el nombre de EEZ con la misma tabla que usa el flujo
+static lv_obj_t *find_object(const char *name) {
+    const int32_t count = (int32_t)(sizeof(objects) / sizeof(lv_obj_t *));
+    for (int32_t i = 0; i < count; i++) {
+        const char *n = eez::flow::getLvglObjectNameFromIndexHook(i);
+        if (n && strcmp(n, name) == 0) return ((lv_obj_t **)&objects)[i];
+    }
+    return NULL;
+}
+
+struct Player {
+    const std::vector<Cmd> *cmds = NULL;
+    size_t pc = 0;
+    uint32_t busy_until = 0;            // Reloj simulado en el que acaba la orden actual
+    bool in_cmd = false;
+    // Estado del puntero que lee LVGL
+    int32_t x = 0, y = 0;
+    bool pressed = false;
+    // Arrastre / tap en curso
+    const Cmd *cur = NULL;
+    uint32_t start = 0;
+    uint32_t taps = 0;
+    uint32_t errors = 0;
+};
+
+static Player player;
+
+static void pointer_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+    (void)indev;
+    data->point.x = player.x;
+    data->point.y = player.y;
+    data->state = player.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+// Avanza el guion hasta el reloj simulado actual; false al terminar
+static bool player_step(uint32_t now) {
+    while (true) {
+        if (player.in_cmd) {
+            const Cmd *c = player.cur;
+            if (c->type == CMD_DRAG) {
+                uint32_t dur = c->a[4] > 0 ? (uint32_t)c->a[4] : 1;
+                uint32_t t = std::min(now - player.start, dur);
+                player.x = c->a[0] + (int32_t)((int64_t)(c->a[2] - c->a[0]) * t / dur);
+                player.y = c->a[1] + (int32_t)((int64_t)(c->a[3] - c->a[1]) * t / dur);
+            }
+            if ((int32_t)(now - player.busy_until) < 0) return true;
+            if (c->type == CMD_TAP || c->type == CMD_TAP_OBJ || c->type == CMD_DRAG) player.pressed = false;
+            player.in_cmd = false;
+            // Deja una vuelta con el puntero suelto para que LVGL vea el RELEASE
+            if (!player.pressed && c->type != CMD_WAIT) return true;
+        }
+        if (player.pc >= player.cmds->size()) return false;
+
+        const Cmd *c = &(*player.cmds)[player.pc++];
+        player.cur = c;
+        player.start = now;
+        switch (c->type) {
+        case CMD_WAIT:
+            player.busy_until = now + (uint32_t)c->a[0];
+            player.in_cmd = true;
+            break;
+        case CMD_TAP_OBJ: {
+            lv_obj_t *obj = find_object(c->text.c_str());
+            if (!obj || !lv_obj_is_visible(obj)) {
+                ESP_LOGW(TAG, "línea %d: %s no existe o no está visible", c->line, c->text.c_str());
+                player.errors++;
+                continue;
+            }
+            lv_area_t a;
+            lv_obj_get_coords(obj, &a);
+            player.x = (a.x1 + a.x2) / 2;
+            player.y = (a.y1 + a.y2) / 2;
+            player.pressed = true;
+            player.busy_until = now + TAP_HOLD_MS;
+            player.in_cmd = true;
+            player.taps++;
+            break;
+        }
+        case CMD_TAP:
+            player.x = c->a[0];
+            player.y = c->a[1];
+            player.pressed = true;
+            player.busy_until = now + TAP_HOLD_MS;
+            player.in_cmd = true;
+            player.taps++;
+            break;
+        case CMD_PRESS:
+        case CMD_MOVE:
+            player.x = c->a[0];
+            player.y = c->a[1];
+            player.pressed = true;
+            return true;
+        case CMD_RELEASE:
+            player.pressed = false;
+            return true;
+        case CMD_DRAG:
+            player.x = c->a[0];
+            player.y = c->a[1];
+            player.pressed = true;
+            player.busy_until = now + (uint32_t)c->a[4];
+            player.in_cmd = true;
+            break;
+        case CMD_WIFI_ON:
+            host_wifi_set_connected(true, c->text.c_str());
+            break;
+        case CMD_WIFI_OFF:
+            host_wifi_set_connected(false, NULL);
+            break;
+        case CMD_SCAN_RESULT:
+            host_wifi_set_scan_result(c->text.c_str());
+            break;
+        }
+        if (player.in_cmd) return true;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Pantalla en memoria
+// -----------------------------------------------------------------------------
+
+static uint16_t *fb_shadow = NULL;      // Lo que "se ve": copia de cada flush
+static bool fb_whole = true;            // El búfer de render es la pantalla entera
+static int64_t refr_start_us = 0;
+static uint32_t flushes = 0;
+static uint64_t flushed_px = 0;
+static std::vector<uint32_t> frame_us;
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+    flushes++;
+    flushed_px += (uint64_t)w * (uint64_t)h;
+
+    // En direct/full el búfer es la pantalla entera; en partial, solo el área
+    bool whole = fb_whole;
+    uint32_t src_stride = whole ? HOR_RES : (uint32_t)w;
+    const uint16_t *src = (const uint16_t *)px_map;
+    for (int32_t y = 0; y < h; y++) {
+        const uint16_t *s = whole ? src + (area->y1 + y) * src_stride + area->x1 : src + y * src_stride;
+        memcpy(&fb_shadow[(area->y1 + y) * HOR_RES + area->x1], s, (size_t)w * 2);
+    }
+    lv_display_flush_ready(disp);
+}
+
+static void refr_event_cb(lv_event_t *e) {
+    if (lv_event_get_code(e) == LV_EVENT_REFR_START) {
+        refr_start_us = esp_timer_get_time();
+    } else if (refr_start_us) {
+        frame_us.push_back((uint32_t)(esp_timer_get_time() - refr_start_us));
+        refr_start_us = 0;
+    }
+}
+
+static uint32_t tick_cb(void) {
+    return host_now_ms();
+}
+
+static bool dump_ppm(const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", HOR_RES, VER_RES);
+    for (int i = 0; i < HOR_RES * VER_RES; i++) {
+        uint16_t c = fb_shadow[i];
+        uint8_t rgb[3] = { (uint8_t)(((c >> 11) & 0x1F) * 255 / 31), (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+                           (uint8_t)((c & 0x1F) * 255 / 31) };
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Señal sintética para el osciloscopio (sustituye a Acquisition_AIoT)
+// -----------------------------------------------------------------------------
+
+struct WaveFeed {
+    SampleRing_t *ring = NULL;
+    uint32_t hz = 0;
+    uint64_t samples = 0;               // Muestras por canal generadas
+    uint32_t seq = 0;
+};
+
+static WaveFeed feed;
+
+static int16_t synth(uint8_t ch, uint64_t n, uint32_t hz) {
+    // Rampa triangular distinta por canal y un golpe de ariete cada 2 s
+    uint32_t period = hz / 2 + ch * 37;
+    uint32_t p = (uint32_t)(n % period);
+    int32_t tri = (int32_t)(p < period / 2 ? p : period - p) * 40000 / (int32_t)period - 10000;
+    if (n % (hz * 2) < hz / 50) tri += 18000 - ch * 600;
+    return (int16_t)std::max<int32_t>(-32768, std::min<int32_t>(32767, tri + ch * 1500 - 12000));
+}
+
+static void wave_feed(uint32_t now_ms) {
+    if (!feed.ring) return;
+    uint64_t due = (uint64_t)now_ms * feed.hz / 1000;
+    while (feed.samples + SRING_BLOCK_SAMPLES <= due) {
+        SampleRing_block_t *b = SampleRing_acquire(feed.ring);
+        if (!b) {
+            feed.samples += SRING_BLOCK_SAMPLES;    // Overrun: lo cuenta el anillo
+            continue;
+        }
+        b->seq = feed.seq++;
+        b->timestamp_us = (int64_t)(feed.samples * 1000000 / feed.hz);
+        b->sample_period_us = 1000000 / feed.hz;
+        b->node_time_us = (uint32_t)b->timestamp_us;
+        b->channel_mask = 0xFFFF;
+        b->node = 1;
+        b->count = SRING_BLOCK_SAMPLES;
+        for (uint8_t ch = 0; ch < SRING_CHANNELS; ch++) {
+            for (uint32_t i = 0; i < SRING_BLOCK_SAMPLES; i++) b->data[ch][i] = synth(ch, feed.samples + i, feed.hz);
+        }
+        SampleRing_commit(feed.ring);
+        feed.samples += SRING_BLOCK_SAMPLES;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Estadísticas
+// -----------------------------------------------------------------------------
+
+struct Series {
+    const char *name;
+    std::vector<uint32_t> v;
+};
+
+static void print_series(const Series &s, const char *unit) {
+    if (s.v.empty()) {
+        printf("  %-22s %8s\n", s.name, "-");
+        return;
+    }
+    std::vector<uint32_t> v = s.v;
+    std::sort(v.begin(), v.end());
+    uint64_t sum = 0;
+    for (uint32_t x : v) sum += x;
+    auto pct = [&](unsigned p) { return v[std::min(v.size() - 1, v.size() * p / 100)]; };
+    printf("  %-22s %8zu %8u %8.1f %8u %8u %8u %8u  %s\n", s.name, v.size(), v.front(),
+           (double)sum / v.size(), pct(50), pct(95), pct(99), v.back(), unit);
+}
+
+// -----------------------------------------------------------------------------
+// Trazas de entrada (mismo formato que Input_Rec_AIoT_Dump en el equipo)
+// -----------------------------------------------------------------------------
+
+static bool load_trace(const char *path, std::vector<Input_rec_entry_t> *trace) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        ESP_LOGE(TAG, "No se puede abrir %s", path);
+        return false;
+    }
+    char buf[256];
+    Input_rec_entry_t e;
+    while (fgets(buf, sizeof(buf), f)) {
+        if (Input_Rec_AIoT_Parse_Line(buf, &e)) trace->push_back(e);
+    }
+    fclose(f);
+    if (trace->empty()) ESP_LOGE(TAG, "%s: sin líneas INREC", path);
+    return !trace->empty();
+}
+
+static bool save_trace(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+    char line[64];
+    Input_rec_entry_t e;
+    for (size_t i = 0; Input_Rec_AIoT_Get(i, &e); i++) {
+        Input_Rec_AIoT_Format_Line(&e, line, sizeof(line));
+        fprintf(f, "%s\n", line);
+    }
+    fclose(f);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Evaluador de expresiones EEZ flow (--eval)
+// -----------------------------------------------------------------------------
+
+struct EvalItem {
+    eez::flow::FlowState *flow_state;
+    int component;
+    const uint8_t *instructions;
+};
+
+static void collect_eval_items(eez::flow::FlowState *fs, std::vector<EvalItem> *items) {
+    for (; fs; fs = fs->nextSibling) {
+        for (uint32_t c = 0; c < fs->flow->components.count; c++) {
+            auto comp = fs->flow->components[c];
+            for (uint32_t p = 0; p < comp->properties.count; p++) {
+                items->push_back({ fs, (int)c, comp->properties[p]->evalInstructions });
+            }
+        }
+        collect_eval_items(fs->firstChild, items);
+    }
+}
+
+// Todas las propiedades de los FlowStates vivos: primero compara los dos
+// caminos (resultado y bytes consumidos), después mide cada uno durante ms
+static bool eval_bench(uint32_t ms) {
+    using namespace eez;
+    using namespace eez::flow;
+    std::vector<EvalItem> items;
+    collect_eval_items(g_firstFlowState, &items);
+    if (items.empty()) {
+        ESP_LOGW(TAG, "--eval: no hay FlowStates vivos");
+        return true;
+    }
+
+    unsigned mismatches = 0;
+    for (const auto &it : items) {
+        Value r1, r2;
+        int n1 = -1, n2 = -1;
+        g_evalThreaded = false;
+        bool ok1 = evalExpressionForBench(it.flow_state, it.component, it.instructions, r1, &n1);
+        g_evalThreaded = true;
+        bool ok2 = evalExpressionForBench(it.flow_state, it.component, it.instructions, r2, &n2);
+        if (ok1 != ok2 || n1 != n2 || (ok1 && (r1.type != r2.type || r1.getValue() != r2.getValue()))) {
+            if (mismatches++ < 10) {
+                ESP_LOGE(TAG, "--eval: componente %d distinto (ok %d/%d, bytes %d/%d, tipo %d/%d)", it.component,
+                         ok1, ok2, n1, n2, (int)r1.type, (int)r2.type);
+            }
+        }
+    }
+
+    double rate[2];
+    for (int threaded = 0; threaded < 2; threaded++) {
+        g_evalThreaded = threaded;
+        uint64_t n = 0;
+        int64_t t0 = esp_timer_get_time(), t;
+        Value r;
+        int nb;
+        do {
+            for (const auto &it : items) {
+                evalExpressionForBench(it.flow_state, it.component, it.instructions, r, &nb);
+            }
+            n += items.size();
+            t = esp_timer_get_time() - t0;
+        } while (t < (int64_t)ms * 1000);
+        rate[threaded] = n * 1e6 / t;
+    }
+    g_evalThreaded = true;
+
+    uint32_t programs, ops, bytes;
+    getEvalInfo(programs, ops, bytes);
+    printf("\nEvaluador EEZ: %zu propiedades, %u diferencias\n", items.size(), mismatches);
+    printf("  intérprete       %8.2f M eval/s (%.1f ns)\n", rate[0] / 1e6, 1e9 / rate[0]);
+    printf("  pre-decodificado %8.2f M eval/s (%.1f ns)\n", rate[1] / 1e6, 1e9 / rate[1]);
+    printf("  %u programas, %u ops, %u B%s\n", programs, ops, bytes,
+           programs ? "" : " (nada que decodificar: los dos caminos son el intérprete)");
+    return mismatches == 0;
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parse_args(argc, argv, &opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<Cmd> cmds;
+    if (opt.script && !load_script(opt.script, &cmds)) return 2;
+    std::vector<Input_rec_entry_t> trace;
+    if (opt.replay && !load_trace(opt.replay, &trace)) return 2;
+
+    // --- LVGL y pantalla en memoria (mismo orden que Configuracion_AIoT_Init) ---
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    if (opt.cache) Asset_Cache_AIoT_Init();
+    Draw_Accel_AIoT_Init();
+    Draw_Accel_AIoT_Set_Enabled(opt.accel);
+
+    lv_display_t *disp = lv_display_create(HOR_RES, VER_RES);
+    uint32_t buf_bytes = HOR_RES * (opt.mode == LV_DISPLAY_RENDER_MODE_PARTIAL ? opt.partial_lines : VER_RES) * 2;
+    void *buf1 = aligned_alloc(64, buf_bytes);
+    void *buf2 = aligned_alloc(64, buf_bytes);
+    fb_shadow = (uint16_t *)calloc(HOR_RES * VER_RES, sizeof(uint16_t));
+    if (!buf1 || !buf2 || !fb_shadow) {
+        ESP_LOGE(TAG, "Sin memoria para los búferes");
+        return 1;
+    }
+    fb_whole = opt.mode != LV_DISPLAY_RENDER_MODE_PARTIAL;
+    lv_display_set_buffers(disp, buf1, buf2, buf_bytes, opt.mode);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_REFR_READY, NULL);
+
+    lv_indev_t *indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(indev, pointer_read_cb);
+    Input_Rec_AIoT_Init(disp, indev, pointer_read_cb);
+
+    // --- UI (igual que ui_task) ---
+    int64_t t0 = esp_timer_get_time();
+    ui_init();
+    if (opt.wave_hz) {
+        feed.hz = opt.wave_hz;
+        feed.ring = SampleRing_create(WAVE_RING_BLOCKS);
+    }
+    ui_waveform_attach(feed.ring);
+    for (size_t i = 0; opt.cache && i < sizeof(images) / sizeof(images[0]); i++) {
+        Asset_Cache_AIoT_Preload(images[i].img_dsc);
+    }
+    uint32_t init_us = (uint32_t)(esp_timer_get_time() - t0);
+
+    // --- Bucle principal ---
+    Series s_timer = { "lv_timer_handler", {} };
+    Series s_tick = { "ui_tick", {} };
+    Series s_periodic = { "ui_update_periodic", {} };
+    Series s_loop = { "vuelta completa", {} };
+    Series s_queue = { "cola EEZ flow", {} };
+    FILE *csv = opt.csv ? fopen(opt.csv, "w") : NULL;
+    if (opt.csv && !csv) ESP_LOGW(TAG, "No se puede crear %s", opt.csv);
+    if (csv) fprintf(csv, "t_ms,timer_us,tick_us,periodic_us,frame_us,queue,lv_mem_used\n");
+
+    uint32_t lv_mem_max_used = 0;
+    uint32_t run = 0;
+    bool script_done = cmds.empty();
+    uint32_t idle_until = 0;
+    player.cmds = &cmds;
+    if (opt.record) Input_Rec_AIoT_Start_Record();
+    if (opt.replay) {
+        Input_Rec_AIoT_Load(trace.data(), trace.size());
+        Input_Rec_AIoT_Replay();
+    }
+
+    for (;;) {
+        uint32_t now = host_now_ms();
+        if (!script_done && !player_step(now)) {
+            if (++run < opt.repeat) {
+                player.pc = 0;
+                continue;
+            }
+            script_done = true;
+            idle_until = now + opt.idle_ms;
+        }
+        if (script_done && (int32_t)(now - idle_until) >= 0 && Input_Rec_AIoT_Get_Mode() != INREC_MODE_REPLAY) break;
+
+        wave_feed(now);
+        size_t frames_before = frame_us.size();
+
+        int64_t a = esp_timer_get_time();
+        uint32_t time_until_next = lv_timer_handler();
+        int64_t b = esp_timer_get_time();
+        ui_tick();
+        int64_t c = esp_timer_get_time();
+        ui_update_periodic_task();
+        int64_t d = esp_timer_get_time();
+
+        s_timer.v.push_back((uint32_t)(b - a));
+        s_tick.v.push_back((uint32_t)(c - b));
+        s_periodic.v.push_back((uint32_t)(d - c));
+        s_loop.v.push_back((uint32_t)(d - a));
+        uint32_t queue = (uint32_t)eez::flow::getQueueSize();
+        s_queue.v.push_back(queue);
+
+        lv_mem_monitor_t mon;
+        lv_mem_monitor(&mon);
+        lv_mem_max_used = std::max<uint32_t>(lv_mem_max_used, (uint32_t)mon.max_used);
+
+        if (csv) {
+            fprintf(csv, "%u,%u,%u,%u,%u,%u,%u\n", now, (uint32_t)(b - a), (uint32_t)(c - b), (uint32_t)(d - c),
+                    frame_us.size() > frames_before ? frame_us.back() : 0, queue,
+                    (uint32_t)(mon.total_size - mon.free_size));
+        }
+
+        // Mismo reparto de tiempo que ui_task: hasta que LVGL tenga trabajo, máx. 10 ms
+        if (time_until_next > UI_MAX_DELAY_MS) time_until_next = UI_MAX_DELAY_MS;
+        if (time_until_next == 0) time_until_next = 1;
+        if (opt.realtime) {
+            int64_t spent = esp_timer_get_time() - a;
+            int64_t left = (int64_t)time_until_next * 1000 - spent;
+            if (left > 0) {
+                struct timespec ts = { 0, (long)left * 1000 };
+                nanosleep(&ts, NULL);
+            }
+        }
+        host_advance_ms(time_until_next);
+    }
+    if (csv) fclose(csv);
+    if (opt.record) {
+        Input_Rec_AIoT_Stop();
+        if (!save_trace(opt.record)) ESP_LOGW(TAG, "No se puede crear %s", opt.record);
+    }
+
+    // --- Informe ---
+    Series s_frame = { "refresco (render)", frame_us };
+    Series s_latency = { "toque -> redibujo", {} };
+    Input_rec_entry_t rec;
+    bool rec_prev = false;
+    for (size_t i = 0; (opt.record || opt.replay) && Input_Rec_AIoT_Get(i, &rec); i++) {
+        if (rec.pressed != rec_prev && rec.latency_us) s_latency.v.push_back(rec.latency_us);
+        rec_prev = rec.pressed;
+    }
+    Input_rec_stats_t rs;
+    Input_Rec_AIoT_Get_Stats(&rs);
+    uint32_t sim_ms = host_now_ms();
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    Host_heap_stats_t heap;
+    host_get_heap_stats(&heap);
+
+    const char *mode_name = opt.mode == LV_DISPLAY_RENDER_MODE_DIRECT ? "direct"
+                          : opt.mode == LV_DISPLAY_RENDER_MODE_FULL ? "full" : "partial";
+    printf("\nUI host bench: %s, modo %s, Draw_Accel %s, caché %s, osciloscopio %u Hz\n",
+           opt.script ? opt.script : "(sin guion)", mode_name, opt.accel ? "sí" : "no",
+           opt.cache ? "sí" : "no", opt.wave_hz);
+    printf("Tiempo simulado %u ms, %zu vueltas, %u toques, ui_init %u us\n\n", sim_ms, s_loop.v.size(),
+           player.taps, init_us);
+    printf("  %-22s %8s %8s %8s %8s %8s %8s %8s\n", "", "n", "min", "media", "p50", "p95", "p99", "max");
+    print_series(s_timer, "us");
+    print_series(s_tick, "us");
+    print_series(s_periodic, "us");
+    print_series(s_loop, "us");
+    print_series(s_frame, "us");
+    print_series(s_latency, "us");
+    print_series(s_queue, "mensajes");
+
+    printf("\nRefrescos: %zu (%.1f fps simulados), flush: %u, píxeles enviados: %.2f pantallas/refresco\n",
+           frame_us.size(), sim_ms ? frame_us.size() * 1000.0 / sim_ms : 0.0, flushes,
+           frame_us.empty() ? 0.0 : (double)flushed_px / frame_us.size() / (HOR_RES * VER_RES));
+    printf("Flancos del puntero: %u redibujados, %u sin redibujo%s%s\n", (unsigned)rs.events,
+           (unsigned)rs.no_redraw, opt.replay ? ", traza " : "", opt.replay ? opt.replay : "");
+    printf("Cola EEZ flow: máximo histórico %zu de %u\n", eez::flow::getMaxQueueSize(), (unsigned)EEZ_FLOW_QUEUE_SIZE);
+    printf("Heap LVGL: usado %u / %u B (máx. %u, fragmentación %u%%)\n",
+           (unsigned)(mon.total_size - mon.free_size), (unsigned)mon.total_size, lv_mem_max_used,
+           (unsigned)mon.frag_pct);
+    printf("heap_caps: interna %zu B (pico %zu), PSRAM %zu B (pico %zu)\n", heap.internal_bytes,
+           heap.internal_peak, heap.spiram_bytes, heap.spiram_peak);
+
+    if (opt.cache) {
+        Asset_cache_stats_t cs;
+        Asset_Cache_AIoT_Get_Stats(&cs);
+        printf("Caché de imágenes: %u aciertos, %u fallos, %u desalojos, %u B de %u\n", (unsigned)cs.hits,
+               (unsigned)cs.misses, (unsigned)cs.evictions, (unsigned)cs.bytes_used, (unsigned)cs.bytes_budget);
+    }
+    Draw_accel_stats_t ds;
+    Draw_Accel_AIoT_Get_Stats(&ds);
+    printf("Draw_Accel: %u rellenos, %u copias, %u mezclas\n", (unsigned)ds.fills, (unsigned)ds.copies,
+           (unsigned)ds.blends);
+    printf("IO simulado: brillo %d%%, suspensión índice %d\n", (int)host_io_get_brillo(),
+           (int)host_io_get_suspension());
+
+    if (opt.dump) {
+        if (dump_ppm(opt.dump)) printf("Fotograma final: %s\n", opt.dump);
+        else ESP_LOGW(TAG, "No se puede crear %s", opt.dump);
+    }
+    bool eval_ok = !opt.eval_ms || eval_bench(opt.eval_ms);
+    return player.errors || !eval_ok ? 1 : 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Plataforma simulada del banco de pruebas de la UI en PC
+//
+// - Reloj simulado en ms: lo usan el tick de LVGL, xTaskGetTickCount y los
+//   temporizadores de EEZ. Avanza solo cuando el bucle principal lo pide, así
+//   cada guion de toques se reproduce igual en cualquier máquina.
+// - Estado falso de WiFi / IO que los guiones pueden cambiar.
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    size_t internal_bytes;                  // Bytes vivos por heap_caps (interna)
+    size_t internal_peak;
+    size_t spiram_bytes;                    // Bytes vivos por heap_caps (PSRAM)
+    size_t spiram_peak;
+} Host_heap_stats_t;
+
+uint32_t host_now_ms(void);
+void host_advance_ms(uint32_t ms);
+
+void host_set_verbose(bool verbose);
+void host_log(char level, const char *tag, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+void host_get_heap_stats(Host_heap_stats_t *stats);
+
+/**
+ * @brief Estado simulado de la red (lo que leen las acciones de EEZ)
+ */
+void host_wifi_set_connected(bool connected, const char *ssid);
+void host_wifi_set_scan_result(const char *list);
+
+/**
+ * @brief Últimos valores recibidos por IO_AIoT (para comprobar los guiones)
+ */
+int32_t host_io_get_brillo(void);
+int32_t host_io_get_suspension(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// esp_heap_caps.h para el banco de pruebas en PC
+// Se asigna con malloc y se cuentan los bytes vivos por tipo de memoria
+// (PSRAM / interna) para el informe de uso de heap.
+// -----------------------------------------------------------------------------
+#include <stddef.h>
+#include "Host_Platform_AIoT.h"
+
+#define MALLOC_CAP_EXEC         (1 << 0)
+#define MALLOC_CAP_32BIT        (1 << 1)
+#define MALLOC_CAP_8BIT         (1 << 2)
+#define MALLOC_CAP_DMA          (1 << 3)
+#define MALLOC_CAP_SPIRAM       (1 << 10)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+#define MALLOC_CAP_DEFAULT      (1 << 12)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void *heap_caps_malloc(size_t size, uint32_t caps);
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void heap_caps_free(void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
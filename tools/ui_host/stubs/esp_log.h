@@ -0,0 +1,12 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// esp_log.h para el banco de pruebas en PC
+// Errores y avisos siempre; info/debug solo con --verbose.
+// -----------------------------------------------------------------------------
+#include "Host_Platform_AIoT.h"
+
+#define ESP_LOGE(tag, fmt, ...) host_log('E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) host_log('W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) host_log('I', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) host_log('D', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) host_log('V', tag, fmt, ##__VA_ARGS__)
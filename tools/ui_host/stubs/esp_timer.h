@@ -0,0 +1,15 @@
+#pragma once
+#include "Host_Platform_AIoT.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Tiempo real (CLOCK_MONOTONIC) en µs: mide costes, no el reloj simulado
+ */
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
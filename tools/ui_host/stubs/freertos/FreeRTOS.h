@@ -0,0 +1,19 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// FreeRTOS mínimo para el banco de pruebas en PC: un solo hilo y un tick de
+// 1 ms que sigue al reloj simulado (host_now_ms)
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include "Host_Platform_AIoT.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE                 0
+#define pdTRUE                  1
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+#define portTICK_PERIOD_MS      1
+#define portMAX_DELAY           0xFFFFFFFFu
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
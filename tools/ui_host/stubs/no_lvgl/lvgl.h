@@ -0,0 +1,118 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// lvgl.h mínimo para compilar eez-flow.cpp sin LVGL (tools/ui_host eval_check)
+//
+// Solo lo que el motor de EEZ flow nombra: tipos, constantes y funciones
+// que devuelven cero. Las llamadas a widgets que usan las acciones del
+// motor aceptan cualquier argumento y no hacen nada. Declara la API de
+// LVGL 9.1 para que eez-flow.h no busque lvgl_private.h. No sirve para
+// dibujar: ui_bench sigue usando el LVGL real.
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#define LVGL_VERSION_MAJOR 9
+#define LVGL_VERSION_MINOR 1
+#define LV_MEM_SIZE (64*1024)
+#define LV_USE_QRCODE 0
+#define LV_STDLIB_CLIB 1
+#define LV_USE_STDLIB_MALLOC 0
+#define LV_LOG_ERROR(...)
+#define LV_LOG_USER(...)
+#define LV_ANIM_OFF 0
+#define LV_ANIM_ON 1
+#define LV_DIR_NONE 0
+enum { LV_EVENT_GESTURE=1, LV_EVENT_KEY, LV_EVENT_ROTARY, LV_EVENT_SCREEN_UNLOADED, LV_EVENT_VALUE_CHANGED };
+enum { LV_OBJ_FLAG_HIDDEN=1 };
+enum { LV_PART_MAIN=0 };
+enum { LV_STATE_CHECKED=1, LV_STATE_DISABLED=2 };
+enum { LV_STYLE_ARC_COLOR=1, LV_STYLE_ARC_IMAGE_SRC, LV_STYLE_ARC_IMG_SRC, LV_STYLE_BG_COLOR, LV_STYLE_BG_GRAD_COLOR, LV_STYLE_BG_IMAGE_RECOLOR, LV_STYLE_BG_IMAGE_SRC, LV_STYLE_BG_IMG_RECOLOR, LV_STYLE_BG_IMG_SRC, LV_STYLE_BORDER_COLOR, LV_STYLE_IMG_RECOLOR, LV_STYLE_LINE_COLOR, LV_STYLE_OUTLINE_COLOR, LV_STYLE_SHADOW_COLOR, LV_STYLE_TEXT_COLOR, LV_STYLE_TEXT_FONT };
+typedef struct _lv_obj_t lv_obj_t;
+typedef struct _lv_event_t { void *p; } lv_event_t;
+typedef struct _lv_group_t lv_group_t;
+typedef struct _lv_roller_t lv_roller_t;
+typedef struct _lv_obj_class_t { int x; } lv_obj_class_t;
+typedef struct { const void *data; uint32_t data_size; } lv_img_dsc_t;
+typedef struct { int32_t x1, y1, x2, y2; } lv_area_t;
+typedef struct { uint8_t blue, green, red; } lv_color_t;
+typedef struct { uint32_t full; } lv_color32_t;
+typedef struct { size_t total_size, free_cnt, free_size, free_biggest_size, used_cnt, max_used; uint8_t used_pct, frag_pct; } lv_mem_monitor_t;
+typedef struct { uint16_t year; int8_t month; int8_t day; } lv_calendar_date_t;
+typedef union { int32_t num; const void *ptr; lv_color_t color; } lv_style_value_t;
+typedef int lv_event_code_t;
+typedef uint32_t lv_state_t;
+typedef uint32_t lv_obj_flag_t;
+typedef uint32_t lv_style_prop_t;
+typedef uint32_t lv_style_selector_t;
+typedef uint8_t lv_opa_t;
+typedef int32_t lv_coord_t;
+typedef int lv_scr_load_anim_t;
+typedef int lv_screen_load_anim_t;
+typedef int lv_roller_mode_t;
+typedef uint32_t lv_btnmatrix_ctrl_t;
+typedef uint32_t lv_buttonmatrix_ctrl_t;
+typedef uintptr_t lv_uintptr_t;
+typedef void (*lv_anim_exec_xcb_t)(void *, int32_t);
+typedef struct _lv_anim_t lv_anim_t;
+typedef int32_t (*lv_anim_get_value_cb_t)(lv_anim_t *);
+typedef int32_t (*lv_anim_path_cb_t)(const lv_anim_t *);
+struct _lv_anim_t { void *var; void *user_data; int32_t start_value, end_value; };
+typedef void (*lv_event_cb_t)(lv_event_t *);
+extern const lv_obj_class_t lv_btnmatrix_class, lv_buttonmatrix_class;
+#ifdef __cplusplus
+struct lv_any { template<class T> operator T() const { return T(); } };
+#define LVF(name) template<class... A> static inline lv_any name(A...) { return lv_any(); }
+static inline void *lv_malloc(size_t s) { return malloc(s); }
+static inline void lv_free(void *p) { free(p); }
+static inline void *lv_mem_alloc(size_t s) { return malloc(s); }
+static inline void lv_mem_free(void *p) { free(p); }
+static inline void lv_mem_monitor(lv_mem_monitor_t *m) { memset(m, 0, sizeof(*m)); }
+uint32_t lv_tick_get(void);
+static inline lv_color_t lv_color_hex(uint32_t c) { lv_color_t r = { (uint8_t)c, (uint8_t)(c>>8), (uint8_t)(c>>16) }; return r; }
+static inline lv_color_t lv_color_darken(lv_color_t c, lv_opa_t) { return c; }
+static inline lv_color_t lv_color_lighten(lv_color_t c, lv_opa_t) { return c; }
+static inline uint32_t lv_color_to_u32(lv_color_t c) { return c.red<<16|c.green<<8|c.blue; }
+static inline lv_color32_t lv_color_to32(lv_color_t c) { lv_color32_t r = { lv_color_to_u32(c) }; return r; }
+static inline int32_t lv_obj_get_width(const lv_obj_t *) { return 0; }
+static inline int32_t lv_obj_get_height(const lv_obj_t *) { return 0; }
+static inline int32_t lv_obj_get_x(const lv_obj_t *) { return 0; }
+static inline int32_t lv_obj_get_y(const lv_obj_t *) { return 0; }
+static inline int32_t lv_obj_get_x_aligned(const lv_obj_t *) { return 0; }
+static inline int32_t lv_obj_get_y_aligned(const lv_obj_t *) { return 0; }
+static inline int32_t lv_img_get_angle(const lv_obj_t *) { return 0; }
+static inline int32_t lv_img_get_zoom(const lv_obj_t *) { return 0; }
+static inline uint32_t lv_roller_get_option_cnt(const lv_obj_t *) { return 0; }
+static inline uint32_t lv_roller_get_option_count(const lv_obj_t *) { return 0; }
+static inline uint32_t lv_tabview_get_tab_act(const lv_obj_t *) { return 0; }
+static inline uint32_t lv_tabview_get_tab_active(const lv_obj_t *) { return 0; }
+static inline lv_opa_t lv_obj_get_style_opa(const lv_obj_t *, uint32_t) { return 0; }
+static inline bool lv_obj_has_flag(const lv_obj_t *, uint32_t) { return false; }
+static inline bool lv_obj_has_state(const lv_obj_t *, uint32_t) { return false; }
+static inline bool lv_obj_check_type(const lv_obj_t *, const lv_obj_class_t *) { return false; }
+static inline lv_event_code_t lv_event_get_code(lv_event_t *) { return 0; }
+static inline int32_t lv_event_get_rotary_diff(lv_event_t *) { return 0; }
+static inline void *lv_event_get_user_data(lv_event_t *) { return 0; }
+static inline void *lv_event_get_param(lv_event_t *) { return 0; }
+static inline lv_obj_t *lv_event_get_target(lv_event_t *) { return 0; }
+static inline lv_obj_t *lv_event_get_current_target(lv_event_t *) { return 0; }
+static inline int lv_indev_get_gesture_dir(void *) { return 0; }
+static inline int32_t lv_anim_path_linear(const lv_anim_t *) { return 0; }
+static inline int32_t lv_anim_path_ease_in(const lv_anim_t *) { return 0; }
+static inline int32_t lv_anim_path_ease_out(const lv_anim_t *) { return 0; }
+static inline int32_t lv_anim_path_ease_in_out(const lv_anim_t *) { return 0; }
+static inline int32_t lv_anim_path_overshoot(const lv_anim_t *) { return 0; }
+static inline int32_t lv_anim_path_bounce(const lv_anim_t *) { return 0; }
+LVF(lv_anim_init) LVF(lv_anim_set_delay) LVF(lv_anim_set_early_apply) LVF(lv_anim_set_exec_cb) LVF(lv_anim_set_get_value_cb)
+LVF(lv_anim_set_path_cb) LVF(lv_anim_set_time) LVF(lv_anim_set_user_data) LVF(lv_anim_set_values) LVF(lv_anim_set_var) LVF(lv_anim_start)
+LVF(lv_arc_rotate_obj_to_angle) LVF(lv_arc_set_value) LVF(lv_bar_set_value) LVF(lv_btnmatrix_set_btn_ctrl) LVF(lv_buttonmatrix_clear_button_ctrl)
+LVF(lv_buttonmatrix_set_button_ctrl) LVF(lv_calendar_get_pressed_date) LVF(lv_calendar_set_highlighted_dates) LVF(lv_calendar_set_showed_date)
+LVF(lv_calendar_set_today_date) LVF(lv_dropdown_set_selected) LVF(lv_group_focus_freeze) LVF(lv_group_focus_next) LVF(lv_group_focus_obj)
+LVF(lv_group_focus_prev) LVF(lv_group_get_focused) LVF(lv_group_set_editing) LVF(lv_group_set_wrap) LVF(lv_img_set_angle) LVF(lv_img_set_src)
+LVF(lv_img_set_zoom) LVF(lv_indev_active) LVF(lv_indev_get_act) LVF(lv_indev_wait_release) LVF(lv_keyboard_set_textarea) LVF(lv_label_set_text)
+LVF(lv_obj_add_event_cb) LVF(lv_obj_add_flag) LVF(lv_obj_add_state) LVF(lv_obj_clear_flag) LVF(lv_obj_clear_state) LVF(lv_obj_get_coords)
+LVF(lv_obj_set_height) LVF(lv_obj_set_local_style_prop) LVF(lv_obj_set_style_opa) LVF(lv_obj_set_width) LVF(lv_obj_set_x) LVF(lv_obj_set_y)
+LVF(lv_obj_update_layout) LVF(lv_qrcode_update) LVF(lv_roller_set_selected) LVF(lv_scr_load_anim) LVF(lv_screen_load_anim) LVF(lv_slider_set_left_value)
+LVF(lv_slider_set_range) LVF(lv_slider_set_value) LVF(lv_tabview_set_act) LVF(lv_tabview_set_active)
+#endif